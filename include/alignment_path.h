@@ -0,0 +1,158 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_ALIGNMENTPATH_H_
+#define OTLS_LINEANALYZER_ALIGNMENTPATH_H_
+
+#include <list>
+#include <vector>
+
+#include "models/transmissionline/alignment.h"
+
+#include "plan_grid.h"
+
+/// \par OVERVIEW
+///
+/// This class is the plan view path of a transmission line alignment. It
+/// converts between plan coordinates (x, y) and alignment coordinates
+/// (station, offset).
+///
+/// \par COORDINATES
+///
+/// The path starts at the origin and heads along the x axis. At each
+/// alignment point after the first, the path turns by the point rotation
+/// (positive is counter-clockwise). Offsets are measured perpendicular to
+/// the path, and positive offsets are to the left when facing up-station.
+///
+/// \par PROJECTION
+///
+/// Projecting a point finds the nearest path segment within the search
+/// distance. The segments are indexed in a uniform plan grid, so a
+/// projection only tests the few segments that are near the point, and
+/// points that aren't near the path are rejected with a single lookup.
+class AlignmentPath {
+ public:
+  /// \brief Constructor.
+  AlignmentPath();
+
+  /// \brief Builds the path.
+  /// \param[in] points
+  ///   The alignment points, sorted by station.
+  /// \param[in] distance_search
+  ///   The maximum distance from the path that points are projected from.
+  /// \return If the path was built. At least two points are required.
+  bool Build(const std::list<AlignmentPoint>& points,
+             const double& distance_search);
+
+  /// \brief Gets the plan direction of the path at a station.
+  /// \param[in] station
+  ///   The station.
+  /// \param[out] x
+  ///   The x component of the unit direction vector.
+  /// \param[out] y
+  ///   The y component of the unit direction vector.
+  /// At an alignment point, this is the direction of the segment that starts
+  /// at the point.
+  void Direction(const double& station, double& x, double& y) const;
+
+  /// \brief Gets the alignment elevation at a station.
+  /// \param[in] station
+  ///   The station.
+  /// \return The elevation, which is interpolated between the alignment
+  ///   points.
+  double Elevation(const double& station) const;
+
+  /// \brief Gets the plan coordinates of an alignment coordinate.
+  /// \param[in] station
+  ///   The station.
+  /// \param[in] offset
+  ///   The offset.
+  /// \param[out] x
+  ///   The x coordinate.
+  /// \param[out] y
+  ///   The y coordinate.
+  void PointXy(const double& station, const double& offset,
+               double& x, double& y) const;
+
+  /// \brief Projects a plan point onto the path.
+  /// \param[in] x
+  ///   The x coordinate.
+  /// \param[in] y
+  ///   The y coordinate.
+  /// \param[out] station
+  ///   The station.
+  /// \param[out] offset
+  ///   The offset.
+  /// \return If the point is within the search distance of the path, and
+  ///   between the path ends.
+  bool Project(const double& x, const double& y,
+               double& station, double& offset) const;
+
+  /// \brief Gets the station at the end of the path.
+  /// \return The station at the end of the path.
+  double station_end() const;
+
+  /// \brief Gets the station at the start of the path.
+  /// \return The station at the start of the path.
+  double station_start() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct is a straight section of the path between two alignment
+  /// points.
+  struct Segment {
+    /// \var direction_x
+    ///   The x component of the unit direction vector.
+    double direction_x;
+
+    /// \var direction_y
+    ///   The y component of the unit direction vector.
+    double direction_y;
+
+    /// \var elevation_end
+    ///   The elevation at the end of the segment.
+    double elevation_end;
+
+    /// \var elevation_start
+    ///   The elevation at the start of the segment.
+    double elevation_start;
+
+    /// \var length
+    ///   The plan length.
+    double length;
+
+    /// \var station
+    ///   The station at the start of the segment.
+    double station;
+
+    /// \var x
+    ///   The x coordinate at the start of the segment.
+    double x;
+
+    /// \var y
+    ///   The y coordinate at the start of the segment.
+    double y;
+  };
+
+  /// \brief Gets the segment that contains a station.
+  /// \param[in] station
+  ///   The station.
+  /// \return The segment index. Stations outside of the path return the
+  ///   first or last segment.
+  int IndexSegment(const double& station) const;
+
+  /// \var distance_search_
+  ///   The maximum distance from the path that points are projected from.
+  double distance_search_;
+
+  /// \var grid_
+  ///   The grid that the segments are registered in.
+  PlanGrid grid_;
+
+  /// \var segments_
+  ///   The path segments, sorted by station.
+  std::vector<Segment> segments_;
+};
+
+#endif  // OTLS_LINEANALYZER_ALIGNMENTPATH_H_
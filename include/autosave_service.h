@@ -0,0 +1,136 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_AUTOSAVESERVICE_H_
+#define OTLS_LINEANALYZER_AUTOSAVESERVICE_H_
+
+#include <string>
+
+#include "wx/timer.h"
+#include "wx/wx.h"
+
+#include "line_analyzer_config.h"
+#include "line_analyzer_doc.h"
+
+/// \par OVERVIEW
+///
+/// This class periodically saves a modified document to a recovery file, so
+/// that changes survive an application crash. This includes documents that
+/// have never been saved, which the command journal can't cover.
+///
+/// \par RECOVERY FILE
+///
+/// The recovery file is an ordinary document file that is stored next to the
+/// document file, with '.autosave' added to the name. Untitled documents are
+/// stored in the temp directory. The recovery file is removed when the
+/// document is saved or closed, so a recovery file that is found when a
+/// document is opened is left over from a crash.
+///
+/// \par SCHEDULING
+///
+/// An autosave is started on idle, once the document has enough unsaved
+/// changes or the oldest unsaved change reaches the configured interval. The
+/// snapshot is taken on the main thread, and the file is written on a worker
+/// thread, so editing continues while the file is written.
+///
+/// \par THROTTLING
+///
+/// Autosaves are limited to a fraction of wall time (the budget). When a
+/// save takes longer than the budget allows (i.e. large documents or slow
+/// storage), the next save is delayed until the budget is met again.
+class AutosaveService : public wxEvtHandler {
+ public:
+  /// \brief Constructor.
+  /// \param[in] config
+  ///   The application config, which contains the interval and budget.
+  AutosaveService(const LineAnalyzerConfig* config);
+
+  /// \brief Destructor.
+  ~AutosaveService();
+
+  /// \brief Gets the recovery file path for a document.
+  /// \param[in] doc
+  ///   The document.
+  /// \return The recovery file path.
+  static std::string FilePath(const LineAnalyzerDoc& doc);
+
+  /// \brief Checks if an autosave is due, and starts it.
+  /// \param[in] doc
+  ///   The current document. This can be a nullptr if no document is open.
+  /// This should be called when the application is idle.
+  void OnIdle(LineAnalyzerDoc* doc);
+
+ private:
+  /// \brief Starts writing the recovery file.
+  void BeginSave();
+
+  /// \brief Finishes writing the recovery file.
+  /// \param[in] status
+  ///   If the file was written successfully.
+  /// \param[in] count_changes
+  ///   The document change count when the snapshot was taken.
+  /// \param[in] id
+  ///   The document id when the save was started.
+  void EndSave(const bool& status, const int& count_changes, const int& id);
+
+  /// \brief Handles the timer event, which wakes up the idle handler.
+  /// \param[in] event
+  ///   The event.
+  void OnTimer(wxTimerEvent& event);
+
+  /// \brief Removes the recovery file, if it was written by this service.
+  void RemoveFile();
+
+  /// \brief Resets the service for a new document.
+  /// \param[in] doc
+  ///   The document.
+  void Reset(LineAnalyzerDoc* doc);
+
+  /// \var config_
+  ///   The application config.
+  const LineAnalyzerConfig* config_;
+
+  /// \var count_saved_
+  ///   The document change count that is included in the recovery file, or
+  ///   the saved document file.
+  int count_saved_;
+
+  /// \var doc_
+  ///   The document.
+  LineAnalyzerDoc* doc_;
+
+  /// \var filepath_
+  ///   The recovery file that was last written.
+  std::string filepath_;
+
+  /// \var id_
+  ///   The document id, which is changed when the document changes. This is
+  ///   used to ignore saves that finish for a previous document.
+  int id_;
+
+  /// \var is_written_
+  ///   An indicator that tells if the recovery file was written by this
+  ///   service.
+  bool is_written_;
+
+  /// \var time_allowed_
+  ///   The earliest time the next autosave can start, in milliseconds.
+  wxLongLong time_allowed_;
+
+  /// \var time_changed_
+  ///   The time of the oldest change that isn't in the recovery file, in
+  ///   milliseconds. This is zero if there are no unsaved changes.
+  wxLongLong time_changed_;
+
+  /// \var time_start_
+  ///   The time the current autosave started, in milliseconds.
+  wxLongLong time_start_;
+
+  /// \var timer_
+  ///   The timer that wakes up the idle handler when an autosave is due.
+  wxTimer timer_;
+
+  DECLARE_EVENT_TABLE()
+};
+
+#endif  // OTLS_LINEANALYZER_AUTOSAVESERVICE_H_
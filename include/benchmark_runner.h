@@ -0,0 +1,127 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_BENCHMARKRUNNER_H_
+#define OTLS_LINEANALYZER_BENCHMARKRUNNER_H_
+
+#include <functional>
+#include <list>
+#include <string>
+
+/// \par OVERVIEW
+///
+/// This struct contains the timing statistics for a benchmark.
+struct BenchmarkResult {
+ public:
+  /// \var mad
+  ///   The median absolute deviation of the samples, in milliseconds.
+  double mad;
+
+  /// \var max
+  ///   The slowest sample, in milliseconds.
+  double max;
+
+  /// \var median
+  ///   The median sample, in milliseconds.
+  double median;
+
+  /// \var min
+  ///   The fastest sample, in milliseconds.
+  double min;
+
+  /// \var name
+  ///   The benchmark name.
+  std::string name;
+
+  /// \var samples
+  ///   The number of timed samples.
+  int samples;
+};
+
+/// \par OVERVIEW
+///
+/// This class runs benchmarks, and compares the results against a stored
+/// baseline to detect performance regressions.
+///
+/// \par SAMPLING
+///
+/// Each benchmark is run once untimed to warm caches, and then timed for the
+/// requested number of samples. The median and median absolute deviation
+/// (MAD) are used instead of the mean and standard deviation, so that a few
+/// samples that are interrupted by the OS do not skew the results.
+///
+/// \par REGRESSIONS
+///
+/// A benchmark has regressed if the median is slower than the baseline
+/// median by more than the threshold fraction, and the slowdown is also
+/// larger than the combined noise of both runs. The noise of a run is
+/// estimated from its MAD, so noisy benchmarks need a larger slowdown before
+/// they are flagged.
+///
+/// \par BASELINE FILES
+///
+/// Baselines are stored as JSON, with one object per benchmark. Timings are
+/// specific to the machine and build configuration they were recorded on, so
+/// a baseline should be re-saved when either changes. The machine, build,
+/// date, document, and sample count are recorded after the benchmarks, so a
+/// baseline can be matched to where it came from.
+class BenchmarkRunner {
+ public:
+  /// \brief Constructor.
+  /// \param[in] samples
+  ///   The number of timed samples for each benchmark.
+  BenchmarkRunner(const int& samples);
+
+  /// \brief Compares the results to a baseline and prints a table.
+  /// \param[in] baseline
+  ///   The baseline results.
+  /// \param[in] threshold
+  ///   The allowable slowdown, as a fraction of the baseline median.
+  /// \return The number of benchmarks that have regressed.
+  /// Benchmarks that are not in the baseline are reported, but are not
+  /// counted as regressions.
+  int Compare(const std::list<BenchmarkResult>& baseline,
+              const double& threshold) const;
+
+  /// \brief Loads baseline results from a file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[out] results
+  ///   The results that are populated.
+  /// \return 0 if no errors, -1 if file related errors, or 1 if parsing
+  ///   errors are encountered.
+  static int LoadBaseline(const std::string& filepath,
+                          std::list<BenchmarkResult>& results);
+
+  /// \brief Runs a benchmark and prints the result.
+  /// \param[in] name
+  ///   The benchmark name.
+  /// \param[in] func
+  ///   The function to time.
+  void Run(const std::string& name, const std::function<void()>& func);
+
+  /// \brief Saves the results as a baseline file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] filepath_document
+  ///   The reference document that the benchmarks ran on. This is recorded
+  ///   with the machine settings.
+  /// \return If the file is written successfully.
+  bool SaveBaseline(const std::string& filepath,
+                    const std::string& filepath_document) const;
+
+  /// \brief Gets the results.
+  /// \return The results.
+  const std::list<BenchmarkResult>& results() const;
+
+ private:
+  /// \var results_
+  ///   The results of every benchmark that has been run.
+  std::list<BenchmarkResult> results_;
+
+  /// \var samples_
+  ///   The number of timed samples for each benchmark.
+  int samples_;
+};
+
+#endif  // OTLS_LINEANALYZER_BENCHMARKRUNNER_H_
@@ -0,0 +1,202 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_BLOWOUTENGINE_H_
+#define OTLS_LINEANALYZER_BLOWOUTENGINE_H_
+
+#include <string>
+#include <vector>
+
+#include "line_span.h"
+#include "plan_grid.h"
+#include "quantity.h"
+#include "tension_table.h"
+
+/// \par OVERVIEW
+///
+/// This struct is the swept envelope of a span under all wind cases.
+///
+/// \par STORAGE
+///
+/// The envelope is sampled at evenly spaced positions along the span chord.
+/// Wind can blow from either side, so the envelope is symmetric about the
+/// chord and only the swing distance is stored. Values are single precision
+/// to keep envelopes for long lines small.
+struct BlowoutEnvelope {
+  /// \var elevations_min
+  ///   The lowest cable elevation at each sample.
+  std::vector<float> elevations_min;
+
+  /// \var offsets
+  ///   The largest horizontal cable displacement from the chord at each
+  ///   sample.
+  std::vector<float> offsets;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a vertical cylinder that the blowout envelopes are tested
+/// against (i.e. a building, tree, or pole).
+struct BlowoutObstacle {
+  /// \var elevation
+  ///   The elevation of the top.
+  double elevation;
+
+  /// \var radius
+  ///   The plan radius.
+  double radius;
+
+  /// \var x
+  ///   The x coordinate of the center.
+  double x;
+
+  /// \var y
+  ///   The y coordinate of the center.
+  double y;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is an obstacle that is too close to a blowout envelope.
+struct BlowoutIntersection {
+  /// \var distance
+  ///   The horizontal distance from the obstacle to the envelope. This is
+  ///   negative if the obstacle is inside the envelope.
+  double distance;
+
+  /// \var index_obstacle
+  ///   The obstacle index.
+  int index_obstacle;
+
+  /// \var index_span
+  ///   The span index.
+  int index_span;
+};
+
+/// \par OVERVIEW
+///
+/// This class computes the blowout envelope of every span, which is the
+/// plan area that the cable can swing through under the wind cases.
+///
+/// \par SWING
+///
+/// Each span catenary swings in the plane of its resultant unit weight. At
+/// suspension hardware, the hardware also swings, by the angle of the
+/// transverse and vertical loads from both adjacent spans plus the hardware
+/// wind and weight. The swung hardware moves the cable end sideways and
+/// lifts it, and this is interpolated along the span.
+///
+/// \par VECTORIZATION
+///
+/// The samples of a span are computed as arrays, with one branch-free loop
+/// per step (sag, displacement, envelope update), so the compiler can
+/// vectorize across the samples.
+///
+/// \par INTERSECTION
+///
+/// The envelopes are registered in a uniform plan grid. An obstacle is only
+/// tested against the spans in the cells it touches, and each test converts
+/// the obstacle to span chord coordinates and reads the envelope at that
+/// position directly, so tests don't depend on the envelope size.
+class BlowoutEngine {
+ public:
+  /// \brief Constructor.
+  BlowoutEngine();
+
+  /// \brief Builds the envelopes.
+  /// \param[in] spans
+  ///   The spans.
+  /// \param[in] tensions
+  ///   The tension table, which must be built for the same line as the
+  ///   spans.
+  /// \param[in] spacing
+  ///   The sample spacing along the spans.
+  void Build(const std::vector<LineSpan>& spans, const TensionTable& tensions,
+             const double& spacing);
+
+  /// \brief Exports the envelope polygons to a csv file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] units
+  ///   The length units to export in.
+  /// \return If the file was written.
+  bool Export(const std::string& filepath,
+              const quantity::Unit<quantity::Length>& units) const;
+
+  /// \brief Exports intersections to a csv file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] obstacles
+  ///   The obstacles that were intersected.
+  /// \param[in] intersections
+  ///   The intersections.
+  /// \param[in] units
+  ///   The length units to export in.
+  /// \return If the file was written.
+  bool ExportIntersections(
+      const std::string& filepath,
+      const std::vector<BlowoutObstacle>& obstacles,
+      const std::vector<BlowoutIntersection>& intersections,
+      const quantity::Unit<quantity::Length>& units) const;
+
+  /// \brief Finds the obstacles that are too close to the envelopes.
+  /// \param[in] obstacles
+  ///   The obstacles.
+  /// \param[in] clearance
+  ///   The required clearance, both horizontally and vertically.
+  /// \param[out] intersections
+  ///   The intersections, sorted by obstacle and then by span.
+  void Intersect(const std::vector<BlowoutObstacle>& obstacles,
+                 const double& clearance,
+                 std::vector<BlowoutIntersection>& intersections) const;
+
+  /// \brief Gets the plan polygon of an envelope.
+  /// \param[in] index
+  ///   The span index.
+  /// \param[out] xs
+  ///   The x coordinates of the polygon vertices.
+  /// \param[out] ys
+  ///   The y coordinates of the polygon vertices.
+  /// The vertices run along the left side of the span and back along the
+  /// right side.
+  void Polygon(const int& index, std::vector<double>& xs,
+               std::vector<double>& ys) const;
+
+  /// \brief Gets the envelopes.
+  /// \return The envelopes, which are parallel to the spans.
+  const std::vector<BlowoutEnvelope>& envelopes() const;
+
+  /// \brief Gets the spans.
+  /// \return The spans.
+  const std::vector<LineSpan>& spans() const;
+
+ private:
+  /// \brief Gets the horizontal distance from an obstacle to an envelope.
+  /// \param[in] index
+  ///   The span index.
+  /// \param[in] obstacle
+  ///   The obstacle.
+  /// \param[in] clearance
+  ///   The required clearance.
+  /// \param[out] distance
+  ///   The horizontal distance, which is negative if the obstacle is inside
+  ///   the envelope.
+  /// \return If the obstacle is within the required clearance of the
+  ///   envelope, both horizontally and vertically.
+  bool Distance(const int& index, const BlowoutObstacle& obstacle,
+                const double& clearance, double& distance) const;
+
+  /// \var envelopes_
+  ///   The envelopes, which are parallel to the spans.
+  std::vector<BlowoutEnvelope> envelopes_;
+
+  /// \var grid_
+  ///   The grid that the spans are registered in.
+  PlanGrid grid_;
+
+  /// \var spans_
+  ///   The spans.
+  std::vector<LineSpan> spans_;
+};
+
+#endif  // OTLS_LINEANALYZER_BLOWOUTENGINE_H_
@@ -0,0 +1,127 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_CLEARANCEENGINE_H_
+#define OTLS_LINEANALYZER_CLEARANCEENGINE_H_
+
+#include <string>
+#include <vector>
+
+#include "alignment_path.h"
+#include "line_span.h"
+#include "quantity.h"
+#include "tension_table.h"
+#include "terrain_index.h"
+
+/// \par OVERVIEW
+///
+/// This struct is the minimum ground clearance of a span for a weathercase
+/// and cable condition.
+struct ClearanceResult {
+  /// \var clearance
+  ///   The minimum vertical clearance from the cable to the ground.
+  double clearance;
+
+  /// \var elevation
+  ///   The cable elevation where the minimum clearance occurs.
+  double elevation;
+
+  /// \var elevation_ground
+  ///   The ground elevation where the minimum clearance occurs.
+  double elevation_ground;
+
+  /// \var index_condition
+  ///   The cable condition index in the tension table.
+  int index_condition;
+
+  /// \var index_span
+  ///   The span index.
+  int index_span;
+
+  /// \var index_weathercase
+  ///   The weathercase index in the tension table.
+  int index_weathercase;
+
+  /// \var is_valid
+  ///   An indicator that tells if the clearance was found. This is false if
+  ///   the tension couldn't be solved, or if there is no ground under the
+  ///   span.
+  bool is_valid;
+
+  /// \var offset
+  ///   The offset where the minimum clearance occurs.
+  double offset;
+
+  /// \var station
+  ///   The station where the minimum clearance occurs.
+  double station;
+};
+
+/// \par OVERVIEW
+///
+/// This class checks the ground clearance of every span, for every
+/// weathercase and cable condition in a tension table.
+///
+/// \par SAMPLING
+///
+/// Each span catenary is sampled in 3D at a fixed spacing. Each sample is
+/// projected onto the alignment, and the clearance is measured vertically to
+/// the highest ground point within half the spacing of the sample. The wind
+/// can blow from either side, so a catenary that is swung by wind is sampled
+/// swung to both sides of the chord.
+///
+/// \par PARALLELISM
+///
+/// The spans are split across cores, and each span checks all of its cases.
+/// The results are preallocated with a slot for every span and case, so
+/// results are written without locks.
+class ClearanceEngine {
+ public:
+  /// \brief Checks the clearances.
+  /// \param[in] spans
+  ///   The spans.
+  /// \param[in] tensions
+  ///   The tension table, which must be built for the same line as the
+  ///   spans.
+  /// \param[in] path
+  ///   The alignment path.
+  /// \param[in] terrain
+  ///   The terrain index.
+  /// \param[in] spacing
+  ///   The sample spacing along the span.
+  /// \param[out] results
+  ///   The results, stored by span and then by weathercase and condition.
+  static void Check(const std::vector<LineSpan>& spans,
+                    const TensionTable& tensions,
+                    const AlignmentPath& path,
+                    const TerrainIndex& terrain,
+                    const double& spacing,
+                    std::vector<ClearanceResult>& results);
+
+  /// \brief Exports the results to a csv file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] spans
+  ///   The spans.
+  /// \param[in] tensions
+  ///   The tension table.
+  /// \param[in] results
+  ///   The results.
+  /// \param[in] units
+  ///   The length units to export in.
+  /// \return If the file was written.
+  static bool Export(const std::string& filepath,
+                     const std::vector<LineSpan>& spans,
+                     const TensionTable& tensions,
+                     const std::vector<ClearanceResult>& results,
+                     const quantity::Unit<quantity::Length>& units);
+
+  /// \brief Gets the minimum clearance.
+  /// \param[in] results
+  ///   The results.
+  /// \return The index of the result with the minimum clearance, or -1 if
+  ///   no results are valid.
+  static int Minimum(const std::vector<ClearanceResult>& results);
+};
+
+#endif  // OTLS_LINEANALYZER_CLEARANCEENGINE_H_
@@ -0,0 +1,193 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_COMMANDJOURNAL_H_
+#define OTLS_LINEANALYZER_COMMANDJOURNAL_H_
+
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "wx/ffile.h"
+#include "wx/xml/xml.h"
+
+/// \par OVERVIEW
+///
+/// This enum contains types of journal records. Each type describes a change
+/// that was committed to the document.
+enum class JournalRecordType {
+  kNull,
+  kCables,
+  kHardwares,
+  kLineActivate,
+  kLineDelete,
+  kLineInsert,
+  kLineModify,
+  kLineMove,
+  kLines,
+  kStructures,
+  kWeathercases
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a change that was committed to the document by a command.
+///
+/// Records describe the resulting document change, not the command, so an
+/// undo is recorded as the change that the undo made.
+struct JournalRecord {
+  /// \var filepaths
+  ///   The external file paths. This is used by the cable, hardware, and
+  ///   structure records.
+  std::list<std::string> filepaths;
+
+  /// \var index
+  ///   The line index. This is used by the activate, delete, insert, and
+  ///   move records.
+  int index;
+
+  /// \var index_to
+  ///   The line index to move to. This is only used by the move record.
+  int index_to;
+
+  /// \var type
+  ///   The record type.
+  JournalRecordType type;
+
+  /// \var xml
+  ///   The xml text, in the document unit system. This is used by the insert,
+  ///   modify, lines, and weathercase records.
+  std::string xml;
+};
+
+/// \par OVERVIEW
+///
+/// This class is an append-only journal of the changes that have been
+/// committed to a document since it was last saved. If the application exits
+/// without saving, the journal can be replayed onto the saved document file to
+/// recover the changes.
+///
+/// \par FILE FORMAT
+///
+/// The journal is stored next to the document file, with a '.journal'
+/// extension added. The file starts with a header that identifies the saved
+/// document file (size and modification time), and then contains a sequence
+/// of binary records. Each record is framed by its payload size and checksum,
+/// so a record that was only partially written when the application crashed
+/// is detected and ignored, along with anything after it.
+///
+/// \par DURABILITY
+///
+/// Each record is flushed to the operating system when it is appended, which
+/// survives an application crash. The file is not synced to the disk, as that
+/// would exceed the latency budget of a command on most storage.
+///
+/// \par COMPACTION
+///
+/// When the document is saved, the records that are included in the saved
+/// file are removed and the header is updated for the new file. Records that
+/// were appended while the save was in progress are kept.
+class CommandJournal {
+ public:
+  /// \brief Constructor.
+  CommandJournal();
+
+  /// \brief Destructor.
+  ~CommandJournal();
+
+  /// \brief Appends a record.
+  /// \param[in] record
+  ///   The record.
+  /// \return If the record was written successfully.
+  bool Append(const JournalRecord& record);
+
+  /// \brief Closes the journal file.
+  void Close();
+
+  /// \brief Compacts the journal after the document has been saved.
+  /// \param[in] filepath_doc
+  ///   The document file that was saved. This can differ from the file the
+  ///   journal was opened for (i.e. save as).
+  /// \param[in] offset
+  ///   The journal offset when the saved snapshot was taken. Records before
+  ///   this offset are included in the saved file and are removed.
+  /// \return If the journal was compacted successfully.
+  bool Compact(const std::string& filepath_doc, const uint64_t& offset);
+
+  /// \brief Closes and removes the journal file.
+  /// This is used when the recorded changes are no longer needed, or can no
+  /// longer be replayed correctly.
+  void Discard();
+
+  /// \brief Gets the journal file path for a document.
+  /// \param[in] filepath_doc
+  ///   The document file path.
+  /// \return The journal file path.
+  static std::string FilePath(const std::string& filepath_doc);
+
+  /// \brief Determines if the journal file is open.
+  /// \return If the journal file is open.
+  bool IsOpen() const;
+
+  /// \brief Opens the journal for a document.
+  /// \param[in] filepath_doc
+  ///   The document file path. The document file must exist.
+  /// \param[out] records
+  ///   The records from an existing journal that matches the document file.
+  ///   These have not been included in the document file yet.
+  /// \return 0 if no errors, -1 if file related errors, or 1 if an existing
+  ///   journal was discarded because it was stale or damaged.
+  /// Any existing records are kept, and new records are appended after them.
+  int Open(const std::string& filepath_doc, std::list<JournalRecord>& records);
+
+  /// \brief Parses xml text into a node.
+  /// \param[in] xml
+  ///   The xml text.
+  /// \return The xml node, which the caller owns. A nullptr is returned if
+  ///   the text is invalid.
+  static wxXmlNode* ParseXml(const std::string& xml);
+
+  /// \brief Removes the journal file for a document.
+  /// \param[in] filepath_doc
+  ///   The document file path.
+  static void Remove(const std::string& filepath_doc);
+
+  /// \brief Writes an xml node as text.
+  /// \param[in] node
+  ///   The xml node, including its children.
+  /// \return The xml text.
+  static std::string WriteXml(const wxXmlNode* node);
+
+  /// \brief Gets the end of the journal.
+  /// \return The end of the journal, which is where the next record will be
+  ///   appended.
+  uint64_t offset() const;
+
+ private:
+  /// \brief Writes a new journal file.
+  /// \param[in] filepath_doc
+  ///   The document file path.
+  /// \param[in] data
+  ///   The encoded records to write after the header.
+  /// \return If the file was written and opened for appending.
+  bool Create(const std::string& filepath_doc, const std::string& data);
+
+  /// \var file_
+  ///   The open journal file.
+  wxFFile file_;
+
+  /// \var filepath_doc_
+  ///   The document file that the journal is for.
+  std::string filepath_doc_;
+
+  /// \var offset_
+  ///   The end of the journal.
+  uint64_t offset_;
+
+  /// \var payload_
+  ///   The payload of the record being appended. This is kept between
+  ///   appends so its memory is reused.
+  std::string payload_;
+};
+
+#endif  // OTLS_LINEANALYZER_COMMANDJOURNAL_H_
@@ -0,0 +1,112 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_COREHOOKS_H_
+#define OTLS_LINEANALYZER_COREHOOKS_H_
+
+#include <string>
+
+#include "models/base/units.h"
+
+#include "document_container.h"
+
+/// \par OVERVIEW
+///
+/// This class provides the application services that the document core
+/// (document, xml handlers, file handler, and commands) needs, without the
+/// core having to reference the GUI application.
+///
+/// \par INJECTION
+///
+/// A single hooks object is active at a time. The GUI application installs a
+/// derived class that forwards to the status bar, busy cursor, message boxes,
+/// and the application config. Headless programs (batch runner, benchmarks)
+/// can use this base class directly, which keeps all status messages silent
+/// and holds the unit system as a simple member.
+///
+/// \par LOGGING
+///
+/// Error and verbose messages are still sent through the wxWidgets logging
+/// framework, so a headless program only needs to set an active log target.
+class CoreHooks {
+ public:
+  /// \brief Constructor.
+  CoreHooks();
+
+  /// \brief Destructor.
+  virtual ~CoreHooks();
+
+  /// \brief Gets the active hooks.
+  /// \return The active hooks. This will never be a nullptr, as a default
+  ///   headless hooks object is provided if none has been set.
+  static CoreHooks* Get();
+
+  /// \brief Sets the active hooks.
+  /// \param[in] hooks
+  ///   The hooks. The caller keeps ownership. A nullptr restores the default
+  ///   headless hooks.
+  static void Set(CoreHooks* hooks);
+
+  /// \brief Notifies that a long operation is starting.
+  virtual void BeginBusy();
+
+  /// \brief Notifies that a long operation has finished.
+  virtual void EndBusy();
+
+  /// \brief Removes the most recent status message.
+  virtual void PopStatus();
+
+  /// \brief Adds a status message.
+  /// \param[in] message
+  ///   The message.
+  virtual void PushStatus(const std::string& message);
+
+  /// \brief Shows a message that requires the attention of the user.
+  /// \param[in] message
+  ///   The message.
+  /// This should be treated as a notification only. Anything that needs to be
+  /// kept should also be logged.
+  virtual void ShowMessage(const std::string& message);
+
+  /// \brief Gets the file format for new documents.
+  /// \return The file format for new documents.
+  /// Documents that are loaded keep the format of their file.
+  virtual DocumentFormat format_document() const;
+
+  /// \brief Determines if documents journal their committed changes.
+  /// \return If documents journal their committed changes.
+  /// Headless programs don't journal, so processing a document never leaves
+  /// a journal file next to it.
+  virtual bool is_journaling() const;
+
+  /// \brief Sets the unit system.
+  /// \param[in] units
+  ///   The unit system.
+  void set_units(const units::UnitSystem& units);
+
+  /// \brief Gets the unit system.
+  /// \return The unit system.
+  /// This is the unit system that document files are saved in. Values in
+  /// the document are always stored in LineAnalyzerDoc::kUnitSystem.
+  virtual units::UnitSystem units() const;
+
+ protected:
+  /// \var units_
+  ///   The unit system.
+  units::UnitSystem units_;
+};
+
+/// \par OVERVIEW
+///
+/// This class notifies the active hooks of a busy state for the lifetime of
+/// the object.
+class BusyIndicator {
+ public:
+  /// \brief Constructor.
+  BusyIndicator();
+
+  /// \brief Destructor.
+  ~BusyIndicator();
+};
+
+#endif  // OTLS_LINEANALYZER_COREHOOKS_H_
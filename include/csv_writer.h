@@ -0,0 +1,70 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_CSVWRITER_H_
+#define OTLS_LINEANALYZER_CSVWRITER_H_
+
+#include <string>
+
+#include "wx/ffile.h"
+
+/// \par OVERVIEW
+///
+/// This class writes the csv files that the analysis engines export.
+///
+/// \par BUFFERING
+///
+/// Rows are formatted into a text buffer, and the buffer is written to the
+/// file in one call when it is flushed or the file is closed. Large exports
+/// can be flushed after each block of rows to bound the buffer size.
+///
+/// \par ERRORS
+///
+/// Open and write failures are logged with the file description and path,
+/// so callers only need to check the return values.
+class CsvWriter {
+ public:
+  /// \brief Constructor.
+  CsvWriter();
+
+  /// \brief Appends formatted text to the buffer.
+  /// \param[in] format
+  ///   The printf style format.
+  void Append(const char* format, ...);
+
+  /// \brief Flushes the buffer and closes the file.
+  /// \return If the file was written and closed.
+  bool Close();
+
+  /// \brief Writes the buffer to the file and clears it.
+  /// \return If the buffer was written.
+  bool Flush();
+
+  /// \brief Opens a file for writing.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] description
+  ///   The file description that is used in error messages (i.e.
+  ///   "Clearance").
+  /// \return If the file was opened.
+  bool Open(const std::string& filepath, const std::string& description);
+
+ private:
+  /// \var buffer_
+  ///   The text that hasn't been written yet.
+  std::string buffer_;
+
+  /// \var description_
+  ///   The file description.
+  std::string description_;
+
+  /// \var file_
+  ///   The file.
+  wxFFile file_;
+
+  /// \var filepath_
+  ///   The file path.
+  std::string filepath_;
+};
+
+#endif  // OTLS_LINEANALYZER_CSVWRITER_H_
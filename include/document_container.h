@@ -0,0 +1,142 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_DOCUMENTCONTAINER_H_
+#define OTLS_LINEANALYZER_DOCUMENTCONTAINER_H_
+
+#include <list>
+#include <map>
+#include <string>
+
+#include "wx/stream.h"
+#include "wx/xml/xml.h"
+#include "wx/zipstrm.h"
+
+/// \par OVERVIEW
+///
+/// This enum contains the document file formats.
+enum class DocumentFormat {
+  kXml,
+  kZip,
+  kZipBundled
+};
+
+/// \par OVERVIEW
+///
+/// This struct is an external file that is bundled into a document container.
+struct BundledFile {
+  /// \var data
+  ///   The file contents. If empty, the file is read from the file path.
+  std::string data;
+
+  /// \var filepath
+  ///   The absolute file path, which the file is read from.
+  std::string filepath;
+
+  /// \var name
+  ///   The file path that is stored in the document xml, which is usually
+  ///   relative to the document.
+  std::string name;
+};
+
+/// \par OVERVIEW
+///
+/// This class reads and writes the compressed document container.
+///
+/// \par FILE FORMAT
+///
+/// The container is a zip archive. The document xml is the first entry, so
+/// it is decompressed straight into the xml parser (see
+/// DocumentContainerReader) before the rest of the file is read. Bundled
+/// external files (cable, hardware, and structure files) follow, stored
+/// under a 'files/' prefix and the same path that the document xml
+/// references them by.
+///
+/// \par DETECTION
+///
+/// A container is detected by the zip signature at the start of the file, so
+/// a document file can be either format without changing the extension.
+///
+/// \par BUNDLED FILES
+///
+/// Bundled files are a copy of the external files when the document was
+/// saved. When a bundled document is loaded, the bundled copy is used instead
+/// of the file on disk, so the document opens with a single sequential read
+/// (i.e. from a network share) and still opens where the external files
+/// don't exist.
+class DocumentContainer {
+ public:
+  /// \brief Determines if a stream contains a document container.
+  /// \param[in] stream
+  ///   The input stream. The signature is put back, so the stream position
+  ///   is not changed.
+  /// \return If the stream contains a document container.
+  static bool IsContainer(wxInputStream& stream);
+
+  /// \brief Writes a document container.
+  /// \param[in] doc_xml
+  ///   The document xml.
+  /// \param[in] files
+  ///   The external files to bundle. This can be empty.
+  /// \param[out] stream
+  ///   The output stream.
+  /// \return If the container was written successfully.
+  static bool Write(const wxXmlDocument& doc_xml,
+                    const std::list<BundledFile>& files,
+                    wxOutputStream& stream);
+};
+
+/// \par OVERVIEW
+///
+/// This class reads a document container in a single sequential pass.
+///
+/// \par STREAMING
+///
+/// The document xml entry is handed to the caller as a stream, which is
+/// decompressed as the xml parser reads it, so the document text is never
+/// copied into a buffer. The bundled files are only read once the document
+/// xml has been parsed, and each is decompressed directly into its own
+/// string.
+class DocumentContainerReader {
+ public:
+  /// \brief Constructor.
+  /// \param[in] stream
+  ///   The input stream, which is not owned.
+  explicit DocumentContainerReader(wxInputStream& stream);
+
+  /// \brief Opens the document xml entry.
+  /// \return The document xml stream, which is valid until ReadFiles() is
+  ///   called. A nullptr is returned if the container can't be read or
+  ///   doesn't contain a document xml.
+  /// Any bundled files that precede the document xml are kept for
+  /// ReadFiles().
+  wxInputStream* OpenDocument();
+
+  /// \brief Reads the bundled files that follow the document xml.
+  /// \param[out] files
+  ///   The bundled files, keyed by the file path that the document xml
+  ///   references them by.
+  /// \return 0 if no errors, or -1 if file related errors.
+  int ReadFiles(std::map<std::string, std::string>& files);
+
+ private:
+  /// \brief Reads the current entry into a bundled file if it is one.
+  /// \param[in] entry
+  ///   The current entry.
+  /// \return If the entry was read.
+  bool ReadFile(const wxZipEntry& entry);
+
+  /// The reader can't be copied.
+  DocumentContainerReader(const DocumentContainerReader&) = delete;
+  DocumentContainerReader& operator=(const DocumentContainerReader&) = delete;
+
+  /// \var files_
+  ///   The bundled files that have been read.
+  std::map<std::string, std::string> files_;
+
+  /// \var zip_
+  ///   The zip stream.
+  wxZipInputStream zip_;
+};
+
+#endif  // OTLS_LINEANALYZER_DOCUMENTCONTAINER_H_
@@ -0,0 +1,135 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_ENCROACHMENTENGINE_H_
+#define OTLS_LINEANALYZER_ENCROACHMENTENGINE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "line_span.h"
+#include "obstacle_layer.h"
+#include "quantity.h"
+#include "tension_table.h"
+
+/// \par OVERVIEW
+///
+/// This struct is an obstacle point that is within the clearance radius of
+/// a span. Each point is reported once per span, for the case where the
+/// cable comes closest.
+struct EncroachmentViolation {
+  /// \var distance
+  ///   The distance from the point to the cable.
+  double distance;
+
+  /// \var index_condition
+  ///   The cable condition index in the tension table.
+  int index_condition;
+
+  /// \var index_point
+  ///   The point index in the obstacle layer.
+  uint32_t index_point;
+
+  /// \var index_span
+  ///   The span index.
+  int index_span;
+
+  /// \var index_weathercase
+  ///   The weathercase index in the tension table.
+  int index_weathercase;
+};
+
+/// \par OVERVIEW
+///
+/// This class finds the obstacle points that are within a clearance radius
+/// of the cable in every span, for every weathercase and cable condition.
+///
+/// \par SEARCH
+///
+/// Each span is handled as one batch. The cable curve of every case is
+/// sampled, and cases with wind are sampled swung to both sides, as the wind
+/// can blow from either side. The obstacle layer is queried once with the
+/// box that bounds all of the curves plus the clearance radius. The cable
+/// only moves sideways and vertically from its chord, so each candidate
+/// point is only measured against the curve segments that are within the
+/// clearance radius along the chord.
+///
+/// \par PARALLELISM
+///
+/// The spans are split across cores, and each span writes its violations to
+/// its own slot, so the spans are searched without locks.
+///
+/// \par EDITS
+///
+/// Every scan searches all of the spans. Rescanning only the spans that a
+/// TransmissionLineCommand edit changes is deferred: the document doesn't
+/// hold an obstacle layer, so the only caller is the batch, which scans each
+/// line once. A per-span cache would need an owner that outlives edits, such
+/// as the document, and would be cleared for the spans next to an edited
+/// structure.
+class EncroachmentEngine {
+ public:
+  /// \brief Exports violations to a csv file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] spans
+  ///   The spans.
+  /// \param[in] tensions
+  ///   The tension table.
+  /// \param[in] obstacles
+  ///   The obstacle layer.
+  /// \param[in] violations
+  ///   The violations.
+  /// \param[in] units
+  ///   The length units to export in.
+  /// \return If the file was written.
+  static bool Export(const std::string& filepath,
+                     const std::vector<LineSpan>& spans,
+                     const TensionTable& tensions,
+                     const ObstacleLayer& obstacles,
+                     const std::vector<EncroachmentViolation>& violations,
+                     const quantity::Unit<quantity::Length>& units);
+
+  /// \brief Scans the spans for violations.
+  /// \param[in] obstacles
+  ///   The obstacle layer.
+  /// \param[in] spans
+  ///   The spans.
+  /// \param[in] tensions
+  ///   The tension table, which must be built for the same line as the
+  ///   spans.
+  /// \param[in] clearance
+  ///   The clearance radius.
+  /// \param[in] spacing
+  ///   The sample spacing along the spans.
+  /// \param[out] violations
+  ///   The violations, ranked from the closest to the farthest.
+  static void Scan(const ObstacleLayer& obstacles,
+                   const std::vector<LineSpan>& spans,
+                   const TensionTable& tensions,
+                   const double& clearance,
+                   const double& spacing,
+                   std::vector<EncroachmentViolation>& violations);
+
+ private:
+  /// \brief Searches a span for violations.
+  /// \param[in] obstacles
+  ///   The obstacle layer.
+  /// \param[in] span
+  ///   The span.
+  /// \param[in] tensions
+  ///   The tension table.
+  /// \param[in] clearance
+  ///   The clearance radius.
+  /// \param[in] spacing
+  ///   The sample spacing along the span.
+  /// \param[out] violations
+  ///   The violations. The span index isn't set.
+  static void Search(const ObstacleLayer& obstacles, const LineSpan& span,
+                     const TensionTable& tensions, const double& clearance,
+                     const double& spacing,
+                     std::vector<EncroachmentViolation>& violations);
+};
+
+#endif  // OTLS_LINEANALYZER_ENCROACHMENTENGINE_H_
@@ -7,6 +7,7 @@
 #include "models/transmissionline/cable.h"
 #include "models/transmissionline/hardware.h"
 #include "models/transmissionline/structure.h"
+#include "wx/stream.h"
 
 #include "line_analyzer_config.h"
 
@@ -30,6 +31,24 @@ class FileHandler {
                        const units::UnitSystem& units,
                        Cable& cable);
 
+  /// \brief Loads a cable file from a stream.
+  /// \param[in] stream
+  ///   The input stream.
+  /// \param[in] filepath
+  ///   The filepath that the stream was read from. This is for logging
+  ///   purposes only.
+  /// \param[in] units
+  ///   The unit system to convert to.
+  /// \param[out] cable
+  ///   The cable that is populated.
+  /// \return 0 if no errors, -1 if file related errors, or 1 if parsing
+  ///   errors are encountered.
+  /// All errors are logged to the active application log target.
+  static int LoadCable(wxInputStream& stream,
+                       const std::string& filepath,
+                       const units::UnitSystem& units,
+                       Cable& cable);
+
   /// \brief Loads the config file.
   /// \param[in] filepath
   ///   The filepath.
@@ -55,6 +74,24 @@ class FileHandler {
                           const units::UnitSystem& units,
                           Hardware& hardware);
 
+  /// \brief Loads a hardware file from a stream.
+  /// \param[in] stream
+  ///   The input stream.
+  /// \param[in] filepath
+  ///   The filepath that the stream was read from. This is for logging
+  ///   purposes only.
+  /// \param[in] units
+  ///   The unit system to convert to.
+  /// \param[out] hardware
+  ///   The hardware that is populated.
+  /// \return 0 if no errors, -1 if file related errors, or 1 if parsing
+  ///   errors are encountered.
+  /// All errors are logged to the active application log target.
+  static int LoadHardware(wxInputStream& stream,
+                          const std::string& filepath,
+                          const units::UnitSystem& units,
+                          Hardware& hardware);
+
   /// \brief Loads a structure file.
   /// \param[in] filepath
   ///   The filepath.
@@ -69,6 +106,24 @@ class FileHandler {
                            const units::UnitSystem& units,
                            Structure& structure);
 
+  /// \brief Loads a structure file from a stream.
+  /// \param[in] stream
+  ///   The input stream.
+  /// \param[in] filepath
+  ///   The filepath that the stream was read from. This is for logging
+  ///   purposes only.
+  /// \param[in] units
+  ///   The unit system to convert to.
+  /// \param[out] structure
+  ///   The structure that is populated.
+  /// \return 0 if no errors, -1 if file related errors, or 1 if parsing
+  ///   errors are encountered.
+  /// All errors are logged to the active application log target.
+  static int LoadStructure(wxInputStream& stream,
+                           const std::string& filepath,
+                           const units::UnitSystem& units,
+                           Structure& structure);
+
   /// \brief Saves a cable file.
   /// \param[in] filepath
   ///   The filepath.
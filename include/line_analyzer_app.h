@@ -5,15 +5,79 @@
 #define OTLS_LINEANALYZER_LINEANALYZERAPP_H_
 
 #include <string>
+#include <thread>
 
 #include "wx/cmdline.h"
 #include "wx/docview.h"
+#include "wx/stopwatch.h"
 #include "wx/wx.h"
 
+#include "core_hooks.h"
 #include "line_analyzer_config.h"
 #include "line_analyzer_doc.h"
 #include "line_analyzer_frame.h"
 
+/// \par OVERVIEW
+///
+/// This class connects the document core to the GUI application. Status
+/// messages are sent to the status bar, busy notifications change the cursor,
+/// user messages are shown in a message box, and the unit system is read from
+/// the application config.
+///
+/// \par THREADING
+///
+/// The document core can be used from a worker thread (i.e. when loading the
+/// start document). Status and user messages from a worker thread are
+/// forwarded to the main thread, and busy notifications are ignored so the
+/// application stays responsive.
+class LineAnalyzerAppHooks : public CoreHooks {
+ public:
+  /// \brief Constructor.
+  /// \param[in] config
+  ///   The application configuration settings.
+  LineAnalyzerAppHooks(const LineAnalyzerConfig* config);
+
+  /// \brief Destructor.
+  virtual ~LineAnalyzerAppHooks();
+
+  /// \brief Begins a busy cursor.
+  virtual void BeginBusy();
+
+  /// \brief Ends a busy cursor.
+  virtual void EndBusy();
+
+  /// \brief Removes the most recent status bar message.
+  virtual void PopStatus();
+
+  /// \brief Adds a status bar message.
+  /// \param[in] message
+  ///   The message.
+  virtual void PushStatus(const std::string& message);
+
+  /// \brief Shows a message box.
+  /// \param[in] message
+  ///   The message.
+  virtual void ShowMessage(const std::string& message);
+
+  /// \brief Gets the file format for new documents from the application
+  ///   config.
+  /// \return The file format for new documents.
+  virtual DocumentFormat format_document() const;
+
+  /// \brief Determines if documents journal their committed changes.
+  /// \return True, so unsaved changes can be recovered after a crash.
+  virtual bool is_journaling() const;
+
+  /// \brief Gets the unit system from the application config.
+  /// \return The unit system.
+  virtual units::UnitSystem units() const;
+
+ private:
+  /// \var config_
+  ///   The application configuration settings.
+  const LineAnalyzerConfig* config_;
+};
+
 /// \par OVERVIEW
 ///
 /// This is the LineAnalyzer application class.
@@ -28,6 +92,20 @@
 /// The application stores configuration settings. This includes:
 ///   - AUI pane layout and frame size
 ///   - data file location
+///
+/// \par STARTUP
+///
+/// The main frame is shown before anything that isn't needed to draw it is
+/// loaded. Dialog resources are loaded the first time they are used, and the
+/// start document is loaded on a worker thread and then handed off to the
+/// document manager on the main thread. The time to first paint and the time
+/// until the application is interactive are logged as verbose messages.
+///
+/// \par RECOVERY
+///
+/// Documents journal their committed changes. If the start document has a
+/// journal from a session that didn't exit cleanly, it is replayed once the
+/// document is handed off to the document manager.
 class LineAnalyzerApp : public wxApp {
  public:
   /// \brief Constructor.
@@ -73,10 +151,24 @@ class LineAnalyzerApp : public wxApp {
   wxDocManager* manager_doc();
 
  private:
+  /// \brief Starts loading the start document on a worker thread.
+  void BeginLoadStartDocument();
+
+  /// \brief Opens the start document after it has been loaded.
+  /// \param[in] is_loaded
+  ///   An indicator that tells if the document loaded successfully.
+  /// This must be called on the main thread.
+  void EndLoadStartDocument(const bool& is_loaded);
+
   /// \var config_
   ///   The application configuration settings.
   LineAnalyzerConfig config_;
 
+  /// \var doc_start_
+  ///   The start document while it is being loaded on the worker thread. It
+  ///   is not managed by the document manager.
+  LineAnalyzerDoc* doc_start_;
+
   /// \var filepath_config_
   ///   The config file that is loaded on application startup. This is specified
   ///   as a command line option.
@@ -87,13 +179,32 @@ class LineAnalyzerApp : public wxApp {
   ///   a command line option.
   std::string filepath_start_;
 
+  /// \var filepath_trace_
+  ///   The file that trace spans are exported to when the application exits.
+  ///   This is specified as a command line option. If empty, spans are not
+  ///   recorded on startup.
+  std::string filepath_trace_;
+
   /// \var frame_
   ///   The main application frame.
   LineAnalyzerFrame* frame_;
 
+  /// \var hooks_
+  ///   The hooks that connect the document core to the application.
+  LineAnalyzerAppHooks hooks_;
+
   /// \var manager_doc_
   ///   The document manager.
   wxDocManager* manager_doc_;
+
+  /// \var thread_start_
+  ///   The worker thread that loads the start document.
+  std::thread thread_start_;
+
+  /// \var watch_startup_
+  ///   The stopwatch that times application startup. It starts when the
+  ///   application object is constructed.
+  wxStopWatch watch_startup_;
 };
 
 /// This is an array of command line options.
@@ -102,6 +213,9 @@ static const wxCmdLineEntryDesc cmd_line_desc [] = {
       wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP},
   {wxCMD_LINE_OPTION, nullptr, "config", "the application configuration file",
       wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "trace",
+      "records trace spans and exports them to this file on exit",
+      wxCMD_LINE_VAL_STRING},
   {wxCMD_LINE_PARAM, nullptr, nullptr, "file",
       wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL},
 
@@ -9,11 +9,27 @@
 #include "models/base/units.h"
 #include "wx/wx.h"
 
+#include "document_container.h"
+
 /// \par OVERVIEW
 ///
 /// This struct stores the application configuration settings.
 struct LineAnalyzerConfig {
  public:
+  /// \var autosave_budget
+  ///   The fraction of wall time that autosaves are allowed to use. Autosaves
+  ///   are delayed when they take longer than this.
+  double autosave_budget;
+
+  /// \var autosave_interval
+  ///   The time between autosaves of a modified document, in seconds. A value
+  ///   of zero disables autosave.
+  int autosave_interval;
+
+  /// \var format_document
+  ///   The file format for new documents.
+  DocumentFormat format_document;
+
   /// \var level_log
   ///   The log level of the application.
   wxLogLevelValues level_log;
@@ -4,15 +4,25 @@
 #ifndef OTLS_LINEANALYZER_LINEANALYZERDOC_H_
 #define OTLS_LINEANALYZER_LINEANALYZERDOC_H_
 
+#include <atomic>
+#include <functional>
 #include <list>
+#include <map>
+#include <string>
+#include <thread>
 
 #include "models/base/units.h"
 #include "models/transmissionline/transmission_line.h"
 #include "wx/docview.h"
 #include "wx/xml/xml.h"
 
+#include "command_journal.h"
+#include "document_container.h"
+#include "reference_index.h"
+
 /// This enum class contains types of update hints.
 enum class HintType {
+  kPreferencesEdit,
   kSharedDataEdit,
   kTransmissionLineEdit
 };
@@ -84,6 +94,70 @@ struct StructureFile {
   Structure structure;
 };
 
+/// \par OVERVIEW
+///
+/// This struct is a transmission line that was loaded from a document file,
+/// but hasn't been parsed yet.
+struct UnparsedLine {
+  /// \var line_number
+  ///   The line number in the document file that the xml text starts on.
+  int line_number;
+
+  /// \var units
+  ///   The unit system of the xml text.
+  units::UnitSystem units;
+
+  /// \var xml
+  ///   The byte range of the document file xml text that contains the
+  ///   transmission line.
+  std::string xml;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a copy of the document data that is needed to write a
+/// document file.
+///
+/// External files are only referenced by file path, so they aren't copied.
+/// The transmission lines still reference the shared data of the document
+/// they were copied from, so the document must not replace its shared data
+/// while the snapshot is being written.
+struct DocumentSnapshot {
+  /// \var filepath
+  ///   The document file path, which relative external file paths are based
+  ///   on.
+  std::string filepath;
+
+  /// \var filepaths_cables
+  ///   The cable file paths.
+  std::list<std::string> filepaths_cables;
+
+  /// \var filepaths_hardwares
+  ///   The hardware file paths.
+  std::list<std::string> filepaths_hardwares;
+
+  /// \var filepaths_structures
+  ///   The structure file paths.
+  std::list<std::string> filepaths_structures;
+
+  /// \var files_bundled
+  ///   The external files that were bundled in the loaded document file,
+  ///   keyed by absolute file path.
+  std::map<std::string, std::string> files_bundled;
+
+  /// \var format
+  ///   The file format.
+  DocumentFormat format;
+
+  /// \var lines
+  ///   The transmission lines.
+  std::list<TransmissionLine> lines;
+
+  /// \var weathercases
+  ///   The weathercases.
+  std::list<WeatherLoadCase> weathercases;
+};
+
 /// \par OVERVIEW
 ///
 /// This is a LineAnalyzer application document, which holds all of the
@@ -123,6 +197,63 @@ struct StructureFile {
 /// - structures   (ownership = external, id = filepath)
 /// - weathercases (ownership = document, id = name)
 ///
+/// \par UNITS
+///
+/// All values are stored in a single canonical unit system (kUnitSystem) and
+/// in the consistent unit style, regardless of the unit system that the
+/// application displays. Conversion only happens at the file boundaries. Each
+/// item is converted as it is parsed when loading, and a converted copy of
+/// each item is created as it is written when saving, so saving never
+/// modifies the document. Views are responsible for converting values to the
+/// display unit system.
+///
+/// \par SAVING
+///
+/// Saving never modifies the document. A snapshot of the document is taken
+/// and written instead. When saved through the docview framework, the
+/// snapshot is written on a worker thread to a temporary file, which then
+/// replaces the document file, so the user can keep editing while the file
+/// is written. Replacing the shared data waits for a save in progress to
+/// finish, because the snapshot lines reference it.
+///
+/// Other services (i.e. autosave) can write a snapshot to their own file in
+/// the background as well. Only one background save runs at a time.
+///
+/// \par LAZY PARSING
+///
+/// Only the active transmission line is parsed when a document is loaded, so
+/// the open time depends on the active line and not the whole file. The
+/// byte ranges of the other lines are cut out of the file text before it is
+/// parsed as xml, and a placeholder line is stored in their place. A line is
+/// parsed when it is activated, or when it is requested by
+/// ParseTransmissionLine(). Operations that need every line (lines(),
+/// saving, editing shared data, searching for references) parse all of the
+/// remaining lines first, so placeholders are never handed out.
+///
+/// Parsing a line only fills in the placeholder, so it can be done from const
+/// methods. If a line contains errors, the user is notified and the document
+/// is marked as modified, as the parsed line no longer matches the file.
+///
+/// \par CHANGE COUNT
+///
+/// Every change to the document data is counted, so services can tell how
+/// much has changed since they last acted on the document.
+///
+/// \par FILE FORMAT
+///
+/// The document file is either plain xml or a compressed container, which
+/// can also bundle the external files. The format is detected when loading,
+/// and the same format is used when saving. New documents use the format
+/// from the core hooks.
+///
+/// \par JOURNAL
+///
+/// When journaling is enabled by the core hooks, every change that a command
+/// commits is appended to a journal next to the document file. If the
+/// application exits without saving, the journal is replayed onto the saved
+/// file the next time it is opened. The journal is compacted when the
+/// document is saved, and removed when the document is closed.
+///
 /// \par COMMANDS AND UNDO/REDO
 ///
 /// This document provides a public interface that can be used by commands.
@@ -151,26 +282,15 @@ class LineAnalyzerDoc : public wxDocument {
   /// \brief Destructor.
   ~LineAnalyzerDoc();
 
-  /// \brief Converts the document between unit styles.
-  /// \param[in] system
-  ///   The unit system.
-  /// \param[in] style_from
-  ///   The unit style to convert from.
-  /// \param[in] style_to
-  ///   The unit style to convert to.
-  void ConvertUnitStyle(const units::UnitSystem& system,
-                        const units::UnitStyle& style_from,
-                        const units::UnitStyle& style_to);
-
-  /// \brief Converts the document between unit systems.
-  /// \param[in] system_from
-  ///   The unit system to convert from.
-  /// \param[in] system_to
-  ///   The unit system to convert to.
-  /// This function requires that the document is in a 'consistent' unit
-  /// style.
-  void ConvertUnitSystem(const units::UnitSystem& system_from,
-                         const units::UnitSystem& system_to);
+  /// \brief Appends a committed change to the journal.
+  /// \param[in] record
+  ///   The journal record.
+  /// This does nothing if the journal isn't open.
+  void AppendJournal(const JournalRecord& record);
+
+  /// \brief Creates a snapshot of the document for writing.
+  /// \return The snapshot.
+  DocumentSnapshot CreateSnapshot() const;
 
   /// \brief Creates the active transmission line from an xml node.
   /// \param[in] node
@@ -208,6 +328,22 @@ class LineAnalyzerDoc : public wxDocument {
   /// \return Success status.
   bool InsertTransmissionLine(const int& index, const TransmissionLine& line);
 
+  /// \brief Inserts a transmission line that is parsed when it is first
+  ///   needed.
+  /// \param[in] index
+  ///   The list index to insert before.
+  /// \param[in] line
+  ///   The unparsed transmission line.
+  /// \return Success status.
+  /// This is used when loading a document file.
+  bool InsertTransmissionLineUnparsed(const int& index,
+                                      const UnparsedLine& line);
+
+  /// \brief Determines if committed changes are being journaled.
+  /// \return If the journal is open.
+  /// Commands can check this before creating a journal record.
+  bool IsJournaling() const;
+
   /// \brief Determines if the cable file is referenced.
   /// \param[in] index
   ///   The list index.
@@ -232,6 +368,10 @@ class LineAnalyzerDoc : public wxDocument {
   /// \return If the weather case is referenced.
   bool IsReferencedWeatherCase(const int& index) const;
 
+  /// \brief Determines if a snapshot is being written in the background.
+  /// \return If a snapshot is being written in the background.
+  bool IsSaving() const;
+
   /// \brief Determines if the index is valid.
   /// \param[in] index
   ///   The list index.
@@ -272,6 +412,12 @@ class LineAnalyzerDoc : public wxDocument {
   /// \return Success status.
   bool MoveTransmissionLine(const int& index_from, const int& index_to);
 
+  /// \brief Closes the document.
+  /// \return If the document is closed successfully.
+  /// This is called by the wxWidgets framework after the user has saved or
+  /// discarded any changes, so the journal is removed.
+  virtual bool OnCloseDocument();
+
   /// \brief Initializes the document.
   /// \param[in] path
   ///   The document filepath.
@@ -283,12 +429,70 @@ class LineAnalyzerDoc : public wxDocument {
   /// initialization constructor.
   virtual bool OnCreate(const wxString& path, long flags);
 
+  /// \brief Opens a document file.
+  /// \param[in] file
+  ///   The file path.
+  /// \return If the document is opened successfully.
+  /// This is called by the wxWidgets framework. If journaling is enabled, the
+  /// journal is opened and any unsaved changes are recovered.
+  virtual bool OnOpenDocument(const wxString& file);
+
+  /// \brief Opens the journal for the document file.
+  /// \return If the journal is open.
+  /// Any changes in an existing journal are replayed onto the document, which
+  /// is then marked as modified.
+  bool OpenJournal();
+
+  /// \brief Parses a transmission line, if it hasn't been parsed yet.
+  /// \param[in] index
+  ///   The list index.
+  /// \return If the line is parsed without errors.
+  /// This should be called before a line other than the active line is
+  /// analyzed.
+  bool ParseTransmissionLine(const int& index) const;
+
+  /// \brief Parses all transmission lines that haven't been parsed yet.
+  /// \return If the lines are parsed without errors.
+  bool ParseTransmissionLines() const;
+
   /// \brief Saves the document.
   /// \param[out] stream
   ///   The output stream generated by wxWidgets.
   /// \return The output stream.
   wxOutputStream& SaveObject(wxOutputStream& stream);
 
+  /// \brief Saves a snapshot to a document file.
+  /// \param[in] snapshot
+  ///   The snapshot.
+  /// \param[in] units
+  ///   The unit system to write.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \return If the file is written successfully.
+  /// The snapshot is written to a temporary file next to the document file,
+  /// which is flushed to the storage device and then replaces the document
+  /// file in a single step. An existing document file is left untouched if
+  /// writing fails, or if the system crashes during the save. This can be
+  /// called from any thread.
+  static bool SaveSnapshot(const DocumentSnapshot& snapshot,
+                           const units::UnitSystem& units,
+                           const std::string& filepath);
+
+  /// \brief Saves a snapshot of the document to a file on a worker thread.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] on_finish
+  ///   The function that is called on the main thread with the save status
+  ///   once the file is written. It isn't called if the document is
+  ///   destroyed first.
+  /// \return If the save was started. A save isn't started if another
+  ///   background save is in progress.
+  /// The snapshot is taken before this returns, so the document can be
+  /// edited right away.
+  bool SaveSnapshotInBackground(
+      const std::string& filepath,
+      const std::function<void(const bool&)>& on_finish);
+
   /// \brief Saves the active transmission line to an xml node.
   /// \return An xml node with the active transmission line.
   wxXmlNode* SaveTransmissionLineToXml() const;
@@ -297,10 +501,50 @@ class LineAnalyzerDoc : public wxDocument {
   /// \return An xml node with all the transmission lines.
   wxXmlNode* SaveTransmissionLinesToXml() const;
 
+  /// \brief Exchanges all document data with another document.
+  /// \param[in,out] doc
+  ///   The other document.
+  /// This is used to hand off a document that was loaded in the background
+  /// to a document that is managed by the docview framework. The lists are
+  /// swapped without copying, so the references held by the transmission
+  /// lines remain valid. The command history and file information are not
+  /// exchanged.
+  void Swap(LineAnalyzerDoc& doc);
+
+  /// \brief Waits for a save in progress to finish.
+  void WaitForSave();
+
+  /// \brief Writes a snapshot to a stream.
+  /// \param[in] snapshot
+  ///   The snapshot.
+  /// \param[in] units
+  ///   The unit system to write.
+  /// \param[out] stream
+  ///   The output stream.
+  /// \return If the snapshot is written successfully.
+  /// This can be called from any thread.
+  static bool WriteSnapshot(const DocumentSnapshot& snapshot,
+                            const units::UnitSystem& units,
+                            wxOutputStream& stream);
+
   /// \brief Gets the cable files.
   /// \return The cable files.
   const std::list<CableFile>& cables() const;
 
+  /// \brief Gets the number of changes made to the document data.
+  /// \return The number of changes made to the document data.
+  int count_changes() const;
+
+  /// \brief Gets the number of transmission lines.
+  /// \return The number of transmission lines.
+  /// Unlike lines(), this doesn't parse the lines that haven't been parsed
+  /// yet.
+  int count_lines() const;
+
+  /// \brief Gets the file format.
+  /// \return The file format.
+  DocumentFormat format() const;
+
   /// \brief Gets the hardware files.
   /// \return The hardware files.
   const std::list<HardwareFile>& hardwares() const;
@@ -314,15 +558,36 @@ class LineAnalyzerDoc : public wxDocument {
   const TransmissionLine& line() const;
 
   /// \brief Gets the transmission lines.
-  /// \return The transmission lines.
+  /// \return The transmission lines. Any lines that haven't been parsed yet
+  ///   are parsed first.
   const std::list<TransmissionLine>& lines() const;
 
+  /// \brief Gets the transmission lines without parsing them.
+  /// \return The transmission lines. Lines that haven't been parsed yet are
+  ///   empty placeholders (see lines_unparsed()).
+  const std::list<TransmissionLine>& lines_stored() const;
+
+  /// \brief Gets the transmission lines that haven't been parsed yet.
+  /// \return The unparsed lines, keyed by their placeholder line.
+  const std::map<const TransmissionLine*, UnparsedLine>& lines_unparsed()
+      const;
+
+  /// \brief Gets the shared data index, which transmission line references
+  ///   are resolved with.
+  /// \return The shared data index.
+  const ReferenceIndex& references() const;
+
   /// \brief Sets the cable files.
   /// \param[in] cablefiles
   ///   The cable files.
   /// \return Success status.
   bool set_cables(const std::list<CableFile>& cablefiles);
 
+  /// \brief Sets the file format.
+  /// \param[in] format
+  ///   The file format, which is used the next time the document is saved.
+  void set_format(const DocumentFormat& format);
+
   /// \brief Sets the hardware files.
   /// \param[in] hardwarefiles
   ///   The hardware files.
@@ -355,7 +620,28 @@ class LineAnalyzerDoc : public wxDocument {
   /// \return The weathercases.
   const std::list<WeatherLoadCase>& weathercases() const;
 
+  /// \var kUnitSystem
+  ///   The unit system that all document values are stored in.
+  static const units::UnitSystem kUnitSystem;
+
+ protected:
+  /// \brief Saves the document to a file.
+  /// \param[in] file
+  ///   The file path.
+  /// \return If the save was started successfully.
+  /// This is called by the wxWidgets framework. A snapshot is taken and then
+  /// written on a worker thread. If writing fails, the document is marked as
+  /// modified again.
+  virtual bool DoSaveDocument(const wxString& file);
+
  private:
+  /// \brief Compacts the journal after a save has finished.
+  /// \param[in] filepath
+  ///   The file that was saved.
+  /// \param[in] offset
+  ///   The journal offset when the snapshot was taken.
+  void CompactJournal(const std::string& filepath, const uint64_t& offset);
+
   /// \brief Determines if the weathercase name is unique.
   /// \param[in] name
   ///   The name.
@@ -365,13 +651,44 @@ class LineAnalyzerDoc : public wxDocument {
   bool IsUniqueWeathercaseName(const std::string& name,
                                const int& index_ignore) const;
 
+  /// \brief Replays a journal record onto the document.
+  /// \param[in] record
+  ///   The journal record.
+  /// \return If the record was applied successfully.
+  bool ReplayJournalRecord(const JournalRecord& record);
+
+  /// \brief Parses an unparsed transmission line into its placeholder.
+  /// \param[in] iter
+  ///   The unparsed line.
+  /// \return If the line is parsed without errors.
+  bool ParseUnparsedLine(
+      std::map<const TransmissionLine*, UnparsedLine>::iterator iter) const;
+
   /// Updates active transmission line.
   void UpdateActiveLineReference();
 
+  /// \brief Rebuilds the shared data index.
+  /// This must be called whenever the shared data lists are replaced.
+  void UpdateReferenceIndex();
+
   /// \var cables_
   ///   The cable files.
   std::list<CableFile> cables_;
 
+  /// \var count_changes_
+  ///   The number of changes made to the document data.
+  int count_changes_;
+
+  /// \var files_bundled_
+  ///   The external files that were bundled in the loaded document file,
+  ///   keyed by absolute file path. These are bundled again when saving if
+  ///   the file no longer exists on disk.
+  std::map<std::string, std::string> files_bundled_;
+
+  /// \var format_
+  ///   The file format.
+  DocumentFormat format_;
+
   /// \var hardwares_
   ///   The hardware files.
   std::list<HardwareFile> hardwares_;
@@ -380,6 +697,14 @@ class LineAnalyzerDoc : public wxDocument {
   ///   The index of the active transmission line.
   int index_active_;
 
+  /// \var is_saving_
+  ///   An indicator that tells if a background save is writing a snapshot.
+  std::atomic<bool> is_saving_;
+
+  /// \var journal_
+  ///   The journal of changes since the document was last saved.
+  CommandJournal journal_;
+
   /// \var line_active_
   ///   A reference to the active transmission line.
   TransmissionLine* line_active_;
@@ -388,10 +713,24 @@ class LineAnalyzerDoc : public wxDocument {
   ///   The transmission lines.
   std::list<TransmissionLine> lines_;
 
+  /// \var lines_unparsed_
+  ///   The transmission lines that haven't been parsed yet, keyed by their
+  ///   placeholder line.
+  mutable std::map<const TransmissionLine*, UnparsedLine> lines_unparsed_;
+
+  /// \var references_
+  ///   The shared data index, which is kept up to date by the set_*
+  ///   functions.
+  ReferenceIndex references_;
+
   /// \var structures_
   ///   The structure files.
   std::list<StructureFile> structures_;
 
+  /// \var thread_save_
+  ///   The worker thread that writes a snapshot when saving.
+  std::thread thread_save_;
+
   /// \var weathercases_
   ///   The weathercases.
   std::list<WeatherLoadCase> weathercases_;
@@ -5,6 +5,8 @@
 #define OTLS_LINEANALYZER_LINEANALYZERDOCXMLHANDLER_H_
 
 #include <list>
+#include <map>
+#include <string>
 
 #include "appcommon/xml/xml_handler.h"
 #include "models/base/units.h"
@@ -26,19 +28,30 @@
 /// This class supports attributing the child XML nodes for various unit
 /// systems.
 ///
+/// \par LAZY PARSING
+///
+/// The inactive transmission lines are cut out of the document xml text by a
+/// LineExtractionStream as it is parsed, so only the first line is parsed
+/// into the document node. The other lines are handed to the
+/// document as unparsed xml text, and are parsed with
+/// ParseUnparsedTransmissionLine() when they are first needed.
+///
 /// \par EXTERNAL FILES
 ///
 /// The document owns data that is stored in external files. Only the file
-/// path of the data is stored in the xml node.
+/// path of the data is stored in the xml node. A copy of the files can be
+/// bundled alongside the xml node (see DocumentContainer).
 class LineAnalyzerDocXmlHandler : public XmlHandler {
  public:
   /// \brief Creates an XML node for a document.
-  /// \param[in] doc
-  ///   The document.
+  /// \param[in] snapshot
+  ///   The document snapshot.
   /// \param[in] units
-  ///   The unit system, which is used for attributing child XML nodes.
+  ///   The unit system to write. A copy of each item is converted from the
+  ///   document unit system as it is written, so the document is not
+  ///   modified.
   /// \return An XML node for the document.
-  static wxXmlNode* CreateNode(const LineAnalyzerDoc& doc,
+  static wxXmlNode* CreateNode(const DocumentSnapshot& snapshot,
                                const units::UnitSystem& units);
 
   /// \brief Parses an XML node and populates a document.
@@ -48,9 +61,13 @@ class LineAnalyzerDocXmlHandler : public XmlHandler {
   ///   The filepath that the xml node was loaded from. This is for logging
   ///   purposes only and can be left blank.
   /// \param[in] units
-  ///   The unit system, which is used by the filehandler to convert external
-  ///   files (ex: cable files) as they are loaded into the data. Data that is
-  ///   stored internally in the data file is NOT converted.
+  ///   The unit system of the xml node. Data that is stored in the node is
+  ///   converted to the document unit system as each item is parsed.
+  ///   External files (ex: cable files) are converted by the filehandler.
+  /// \param[in] files
+  ///   The external files that were bundled with the xml node, keyed by the
+  ///   file path in the xml node. Bundled files are loaded instead of the
+  ///   files on disk.
   /// \param[out] doc
   ///   The document that is populated.
   /// \return The status of the xml node parse. If any errors are encountered
@@ -61,9 +78,73 @@ class LineAnalyzerDocXmlHandler : public XmlHandler {
   static bool ParseNode(const wxXmlNode* root,
                         const std::string& filepath,
                         const units::UnitSystem& units,
+                        const std::map<std::string, std::string>& files,
                         LineAnalyzerDoc& doc);
 
+  /// \brief Parses a transmission line XML node.
+  /// \param[in] node
+  ///   The XML node for the transmission line.
+  /// \param[in] filepath
+  ///   The filepath that the xml node was loaded from. This is for logging
+  ///   purposes only and can be left blank.
+  /// \param[in] units
+  ///   The unit system of the xml node. The line is converted to the document
+  ///   unit system after it is parsed.
+  /// \param[in] doc
+  ///   The document, which the line references to shared data (cables,
+  ///   weathercases, etc.) are resolved against.
+  /// \param[out] line
+  ///   The transmission line that is populated.
+  /// \return The status of the xml node parse. If any errors are encountered
+  ///   false is returned.
+  static bool ParseNodeTransmissionLine(const wxXmlNode* node,
+                                        const std::string& filepath,
+                                        const units::UnitSystem& units,
+                                        const LineAnalyzerDoc& doc,
+                                        TransmissionLine& line);
+
+  /// \brief Parses a transmission line that was extracted from the document
+  ///   xml text.
+  /// \param[in] unparsed
+  ///   The unparsed line.
+  /// \param[in] filepath
+  ///   The filepath that the xml text was loaded from. This is for logging
+  ///   purposes only and can be left blank.
+  /// \param[in] doc
+  ///   The document, which the line references to shared data (cables,
+  ///   weathercases, etc.) are resolved against.
+  /// \param[out] line
+  ///   The transmission line that is populated.
+  /// \return The status of the parse. If the xml text is invalid or any
+  ///   errors are encountered false is returned.
+  static bool ParseUnparsedTransmissionLine(const UnparsedLine& unparsed,
+                                            const std::string& filepath,
+                                            const LineAnalyzerDoc& doc,
+                                            TransmissionLine& line);
+
+  /// \brief Gets the file path that an external file is stored as.
+  /// \param[in] filepath
+  ///   The absolute file path.
+  /// \param[in] dirname_doc
+  ///   The document directory.
+  /// \return The file path relative to the document directory, with unix
+  ///   style separators.
+  static std::string RelativeFilePath(const std::string& filepath,
+                                      const wxString& dirname_doc);
+
  private:
+  /// \brief Creates an XML node for a set of external files.
+  /// \param[in] title
+  ///   The node title.
+  /// \param[in] filepaths
+  ///   The absolute file paths.
+  /// \param[in] dirname_doc
+  ///   The document directory, which the file paths are made relative to.
+  /// \return An XML node with a child node for each file.
+  static wxXmlNode* CreateNodeFiles(const std::string& title,
+                                    const std::list<std::string>& filepaths,
+                                    const wxString& dirname_doc);
+
   /// \brief Parses a version 1 XML node and populates a document.
   /// \param[in] root
   ///   The XML root node for the document.
@@ -71,9 +152,13 @@ class LineAnalyzerDocXmlHandler : public XmlHandler {
   ///   The filepath that the xml node was loaded from. This is for logging
   ///   purposes only and can be left blank.
   /// \param[in] units
-  ///   The unit system, which is used by the filehandler to convert external
-  ///   files (ex: cable files) as they are loaded into the data. Data that is
-  ///   stored internally in the data file is NOT converted.
+  ///   The unit system of the xml node. Data that is stored in the node is
+  ///   converted to the document unit system as each item is parsed.
+  ///   External files (ex: cable files) are converted by the filehandler.
+  /// \param[in] files
+  ///   The external files that were bundled with the xml node, keyed by the
+  ///   file path in the xml node. Bundled files are loaded instead of the
+  ///   files on disk.
   /// \param[out] doc
   ///   The document that is populated.
   /// \return The status of the xml node parse. If any errors are encountered
@@ -84,6 +169,7 @@ class LineAnalyzerDocXmlHandler : public XmlHandler {
   static bool ParseNodeV1(const wxXmlNode* root,
                           const std::string& filepath,
                           const units::UnitSystem& units,
+                          const std::map<std::string, std::string>& files,
                           LineAnalyzerDoc& doc);
 };
 
@@ -9,6 +9,8 @@
 #include "wx/docview.h"
 #include "wx/dnd.h"
 
+#include "autosave_service.h"
+
 /// \par OVERVIEW
 ///
 /// This class is the drop target for an application document file.
@@ -44,6 +46,11 @@ class DocumentFileDropTarget : public wxFileDropTarget {
 /// \par OVERVIEW
 ///
 /// This is the top-level application frame.
+///
+/// \par AUTOSAVE
+///
+/// The frame owns the autosave service, and gives it the current document
+/// when the application is idle.
 class LineAnalyzerFrame : public wxDocParentFrame {
  public:
   /// \brief Constructor.
@@ -52,6 +59,11 @@ class LineAnalyzerFrame : public wxDocParentFrame {
   /// \brief Destructor.
   virtual ~LineAnalyzerFrame();
 
+  /// \brief Handles the idle event.
+  /// \param[in] event
+  ///   The event.
+  void OnIdle(wxIdleEvent& event);
+
   /// \brief Handles the file->preferences menu click event.
   /// \param[in] event
   ///   The event.
@@ -67,11 +79,30 @@ class LineAnalyzerFrame : public wxDocParentFrame {
   ///   The event.
   void OnMenuViewLog(wxCommandEvent& event);
 
+  /// \brief Handles the view->memory report menu click event.
+  /// \param[in] event
+  ///   The event.
+  void OnMenuViewMemory(wxCommandEvent& event);
+
+  /// \brief Handles the view->export trace menu click event.
+  /// \param[in] event
+  ///   The event.
+  void OnMenuViewTraceExport(wxCommandEvent& event);
+
+  /// \brief Handles the view->record trace menu click event.
+  /// \param[in] event
+  ///   The event.
+  void OnMenuViewTraceRecord(wxCommandEvent& event);
+
   /// \brief Gets the log pane.
   /// \return The log pane.
   LogPane* pane_log();
 
  private:
+  /// \var autosave_
+  ///   The autosave service.
+  AutosaveService autosave_;
+
   /// \var pane_log_
   ///   The log pane.
   LogPane* pane_log_;
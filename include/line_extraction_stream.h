@@ -0,0 +1,157 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_LINEEXTRACTIONSTREAM_H_
+#define OTLS_LINEANALYZER_LINEEXTRACTIONSTREAM_H_
+
+#include <string>
+#include <vector>
+
+#include "wx/stream.h"
+
+#include "line_analyzer_doc.h"
+
+/// \par OVERVIEW
+///
+/// This class is an input filter stream that cuts the inactive transmission
+/// lines out of document xml text as it is read, so only the active line is
+/// parsed as xml. The document text is never held in memory as a whole.
+///
+/// \par TOKENIZING
+///
+/// The text is split into markup and character data the same way an xml
+/// parser does, so tags inside comments, CDATA sections, processing
+/// instructions, and attribute values are not mistaken for elements. Open
+/// elements are tracked by name, and a transmission line is only cut if it
+/// is a child of the 'transmission_lines' element under the root. The first
+/// line is left in the text, as it is activated when loading.
+///
+/// \par VALIDATION
+///
+/// A cut line is held until its matching end tag is read. If an end tag
+/// doesn't match, or the text ends inside a line, the held text is put back
+/// and the rest of the text is passed through unchanged, so the parser sees
+/// the original text and reports the error. A cut line is replaced by its
+/// line breaks, so the parser still reports the file line numbers.
+///
+/// \par ENCODING
+///
+/// Lines are only cut from UTF-8 text, as the unparsed lines are parsed
+/// later without the xml declaration. Text in any other encoding, or with a
+/// document type declaration that the lines could depend on, is passed
+/// through unchanged and every line is parsed.
+class LineExtractionStream : public wxFilterInputStream {
+ public:
+  /// \brief Constructor.
+  /// \param[in] stream
+  ///   The document xml stream, which is not owned.
+  explicit LineExtractionStream(wxInputStream& stream);
+
+  /// \brief Gets the lines that were cut out of the text.
+  /// \return The lines that were cut out, in document order. The unit system
+  ///   isn't known until the document node is parsed, so it isn't set.
+  ///   This is complete once the stream has been read to the end.
+  std::vector<UnparsedLine>& lines();
+
+ protected:
+  /// \brief Reads filtered text.
+  /// \param[out] buffer
+  ///   The buffer to fill.
+  /// \param[in] size
+  ///   The buffer size.
+  /// \return The number of bytes read. This is only zero at the end of the
+  ///   text or if the source stream fails.
+  virtual size_t OnSysRead(void* buffer, size_t size);
+
+ private:
+  /// \brief Appends a chunk of the source stream to the input.
+  void Fill();
+
+  /// \brief Finds the end of the token at the input position.
+  /// \param[out] pos_end
+  ///   The position after the token.
+  /// \return If the token is complete in the input.
+  bool FindToken(size_t& pos_end) const;
+
+  /// \brief Checks the xml declaration and the start of the text for an
+  ///   encoding other than UTF-8.
+  /// \param[in] pos_end
+  ///   The position after the processing instruction.
+  void HandleDeclaration(const size_t& pos_end);
+
+  /// \brief Processes a start or end tag.
+  /// \param[in] pos_end
+  ///   The position after the tag.
+  void HandleTag(const size_t& pos_end);
+
+  /// \brief Stops cutting lines, and puts back a line that is being cut.
+  void PassThrough();
+
+  /// \brief Processes the complete tokens in the input.
+  void Process();
+
+  /// \brief Appends text to the output, or to the line that is being cut.
+  /// \param[in] pos_begin
+  ///   The input position to start at.
+  /// \param[in] pos_end
+  ///   The input position to stop at.
+  void Route(const size_t& pos_begin, const size_t& pos_end);
+
+  /// The stream can't be copied.
+  LineExtractionStream(const LineExtractionStream&) = delete;
+  LineExtractionStream& operator=(const LineExtractionStream&) = delete;
+
+  /// \var count_lines_
+  ///   The number of transmission lines that have been read.
+  int count_lines_;
+
+  /// \var input_
+  ///   The source text that hasn't been processed, starting at pos_input_.
+  std::string input_;
+
+  /// \var is_cutting_
+  ///   An indicator that tells if a line is being cut.
+  bool is_cutting_;
+
+  /// \var is_end_source_
+  ///   An indicator that tells if the source stream has been read to the end.
+  bool is_end_source_;
+
+  /// \var is_passing_
+  ///   An indicator that tells if the text is passed through unchanged.
+  bool is_passing_;
+
+  /// \var is_started_
+  ///   An indicator that tells if the first token has been read.
+  bool is_started_;
+
+  /// \var line_
+  ///   The line that is being cut.
+  UnparsedLine line_;
+
+  /// \var line_number_
+  ///   The file line number at the input position.
+  int line_number_;
+
+  /// \var lines_
+  ///   The lines that have been cut.
+  std::vector<UnparsedLine> lines_;
+
+  /// \var names_
+  ///   The names of the open elements.
+  std::vector<std::string> names_;
+
+  /// \var output_
+  ///   The filtered text that hasn't been read, starting at pos_output_.
+  std::string output_;
+
+  /// \var pos_input_
+  ///   The position of the next token in the input.
+  size_t pos_input_;
+
+  /// \var pos_output_
+  ///   The position of the next byte to read in the output.
+  size_t pos_output_;
+};
+
+#endif  // OTLS_LINEANALYZER_LINEEXTRACTIONSTREAM_H_
@@ -0,0 +1,160 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_LINESPAN_H_
+#define OTLS_LINEANALYZER_LINESPAN_H_
+
+#include <vector>
+
+#include "models/transmissionline/hardware.h"
+#include "models/transmissionline/transmission_line.h"
+#include "models/transmissionline/weather_load_case.h"
+
+#include "alignment_path.h"
+
+/// \par OVERVIEW
+///
+/// This struct is a span of a line cable between two structure attachments.
+/// The cable ends are in plan coordinates (see AlignmentPath), and are below
+/// the attachments when suspension hardware is used.
+struct LineSpan {
+  /// \var elevation_ahead
+  ///   The elevation of the ahead-station cable end.
+  double elevation_ahead;
+
+  /// \var elevation_back
+  ///   The elevation of the back-station cable end.
+  double elevation_back;
+
+  /// \var hardware_ahead
+  ///   The suspension hardware at the ahead-station attachment, or a nullptr
+  ///   if the cable is held rigidly.
+  const Hardware* hardware_ahead;
+
+  /// \var hardware_back
+  ///   The suspension hardware at the back-station attachment, or a nullptr
+  ///   if the cable is held rigidly.
+  const Hardware* hardware_back;
+
+  /// \var index_attachment_ahead
+  ///   The structure attachment index of the ahead-station attachment.
+  int index_attachment_ahead;
+
+  /// \var index_attachment_back
+  ///   The structure attachment index of the back-station attachment.
+  int index_attachment_back;
+
+  /// \var index_line_cable
+  ///   The line cable index.
+  int index_line_cable;
+
+  /// \var index_structure_ahead
+  ///   The line structure index of the ahead-station attachment.
+  int index_structure_ahead;
+
+  /// \var index_structure_back
+  ///   The line structure index of the back-station attachment.
+  int index_structure_back;
+
+  /// \var line_cable
+  ///   The line cable.
+  const LineCable* line_cable;
+
+  /// \var x_ahead
+  ///   The x coordinate of the ahead-station cable end.
+  double x_ahead;
+
+  /// \var x_back
+  ///   The x coordinate of the back-station cable end.
+  double x_back;
+
+  /// \var y_ahead
+  ///   The y coordinate of the ahead-station cable end.
+  double y_ahead;
+
+  /// \var y_back
+  ///   The y coordinate of the back-station cable end.
+  double y_back;
+};
+
+/// \par OVERVIEW
+///
+/// This class builds the spans of a transmission line from the line cable
+/// connections.
+///
+/// \par ATTACHMENTS
+///
+/// Each line structure is placed on the alignment at its station and offset.
+/// The structure attachment offsets are rotated by the line structure
+/// rotation (positive is counter-clockwise), with longitudinal offsets
+/// measured up-station and transverse offsets measured to the left. The
+/// attachment elevation is the alignment elevation, plus the structure
+/// height and height adjustment, minus the attachment vertical offset from
+/// the structure top. Suspension hardware hangs vertically below the
+/// attachment, so the cable end is lowered by the hardware length. Swing of
+/// the hardware is left to the analyses that load the span transversely.
+class LineSpanBuilder {
+ public:
+  /// \brief Gets the longitudinal axis of a line structure.
+  /// \param[in] line_structure
+  ///   The line structure.
+  /// \param[in] path
+  ///   The alignment path.
+  /// \param[out] x
+  ///   The x component of the unit axis.
+  /// \param[out] y
+  ///   The y component of the unit axis.
+  /// The transverse axis is the longitudinal axis rotated to the left.
+  static void AxisLongitudinal(const LineStructure& line_structure,
+                               const AlignmentPath& path, double& x,
+                               double& y);
+
+  /// \brief Builds the spans of a transmission line.
+  /// \param[in] line
+  ///   The transmission line.
+  /// \param[in] path
+  ///   The alignment path of the transmission line.
+  /// \param[out] spans
+  ///   The spans, sorted by line cable and then by station.
+  /// \return The number of connections that were skipped because the line
+  ///   structure or attachment couldn't be resolved.
+  static int Build(const TransmissionLine& line, const AlignmentPath& path,
+                   std::vector<LineSpan>& spans);
+
+  /// \brief Gets the location of a cable end at a structure attachment.
+  /// \param[in] line_structure
+  ///   The line structure.
+  /// \param[in] index_attachment
+  ///   The structure attachment index.
+  /// \param[in] path
+  ///   The alignment path.
+  /// \param[out] x
+  ///   The x coordinate.
+  /// \param[out] y
+  ///   The y coordinate.
+  /// \param[out] elevation
+  ///   The elevation.
+  /// \param[out] hardware
+  ///   The suspension hardware, or a nullptr if there is none.
+  /// \return If the attachment exists.
+  static bool PointAttachment(const LineStructure& line_structure,
+                              const int& index_attachment,
+                              const AlignmentPath& path, double& x,
+                              double& y, double& elevation,
+                              const Hardware*& hardware);
+
+  /// \brief Gets the unit weight of a cable for a weathercase.
+  /// \param[in] cable
+  ///   The cable.
+  /// \param[in] weathercase
+  ///   The weathercase.
+  /// \param[out] weight_transverse
+  ///   The transverse (wind) unit weight.
+  /// \param[out] weight_vertical
+  ///   The vertical (cable and ice) unit weight.
+  static void UnitWeight(const Cable& cable,
+                         const WeatherLoadCase& weathercase,
+                         double& weight_transverse, double& weight_vertical);
+};
+
+#endif  // OTLS_LINEANALYZER_LINESPAN_H_
@@ -0,0 +1,68 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_MAPPEDFILE_H_
+#define OTLS_LINEANALYZER_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <string>
+
+/// \par OVERVIEW
+///
+/// This class maps a file into memory for reading.
+///
+/// \par STREAMING
+///
+/// The file is paged in by the operating system as it is read, and pages that
+/// have been read can be dropped again under memory pressure. Files that are
+/// much larger than the available memory can be read sequentially without
+/// copying them into buffers.
+class MappedFile {
+ public:
+  /// \brief Constructor.
+  MappedFile();
+
+  /// \brief Destructor. The file is closed.
+  ~MappedFile();
+
+  /// \brief Closes the file.
+  void Close();
+
+  /// \brief Opens and maps a file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \return If the file was mapped. An empty file is opened with no data.
+  bool Open(const std::string& filepath);
+
+  /// \brief Gets the file contents.
+  /// \return The file contents, or a nullptr if the file is empty or not
+  ///   open.
+  const char* data() const;
+
+  /// \brief Gets the file size.
+  /// \return The file size, in bytes.
+  size_t size() const;
+
+ private:
+  /// The file can't be copied.
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// \var data_
+  ///   The mapped file contents.
+  const char* data_;
+
+  /// \var handle_file_
+  ///   The operating system file handle.
+  void* handle_file_;
+
+  /// \var handle_mapping_
+  ///   The operating system mapping handle. This is only used on Windows.
+  void* handle_mapping_;
+
+  /// \var size_
+  ///   The file size.
+  size_t size_;
+};
+
+#endif  // OTLS_LINEANALYZER_MAPPEDFILE_H_
@@ -0,0 +1,135 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_MEMORYREPORT_H_
+#define OTLS_LINEANALYZER_MEMORYREPORT_H_
+
+#include <string>
+
+#include "wx/xml/xml.h"
+
+#include "line_analyzer_doc.h"
+
+/// \par OVERVIEW
+///
+/// This struct contains the estimated memory usage of a document, in bytes,
+/// grouped by category.
+struct MemoryUsage {
+ public:
+  /// \brief Gets the total of all categories.
+  /// \return The total of all categories.
+  size_t Total() const;
+
+  /// \var cables
+  ///   The cable files.
+  size_t cables;
+
+  /// \var caches
+  ///   The caches that are held in addition to the document data. This
+  ///   includes the shared data index and the trace span buffers.
+  size_t caches;
+
+  /// \var hardwares
+  ///   The hardware files.
+  size_t hardwares;
+
+  /// \var history
+  ///   The commands in the undo/redo history, including the xml nodes that
+  ///   they hold.
+  size_t history;
+
+  /// \var lines
+  ///   The transmission lines, including the xml text of the lines that
+  ///   haven't been parsed yet.
+  size_t lines;
+
+  /// \var structures
+  ///   The structure files.
+  size_t structures;
+
+  /// \var weathercases
+  ///   The weathercases.
+  size_t weathercases;
+};
+
+/// \par OVERVIEW
+///
+/// This class estimates the memory that a document is using.
+///
+/// \par ESTIMATES
+///
+/// The estimates are computed by walking the document data and adding the
+/// object sizes, container node overhead, and heap allocated contents
+/// (strings, vectors, xml nodes) that can be reached. Allocator overhead and
+/// anything hidden inside the Models library classes is not counted, so the
+/// actual usage will be somewhat higher. The estimates are meant to compare
+/// categories and documents, not to match the process memory exactly.
+class MemoryReport {
+ public:
+  /// \brief Formats the memory usage as a multi-line report.
+  /// \param[in] usage
+  ///   The memory usage.
+  /// \return A report with one line per category.
+  static std::string Format(const MemoryUsage& usage);
+
+  /// \brief Measures the memory usage of a document.
+  /// \param[in] doc
+  ///   The document.
+  /// \return The memory usage.
+  /// The command history is only included if the document has a command
+  /// processor. Transmission lines that haven't been parsed yet are counted
+  /// by their xml text, so measuring doesn't parse them.
+  static MemoryUsage Measure(const LineAnalyzerDoc& doc);
+
+  /// \brief Gets the heap size of a string.
+  /// \param[in] str
+  ///   The string.
+  /// \return The heap size, in bytes. Strings whose characters are stored
+  ///   inside the string object (small string optimization) return zero.
+  static size_t SizeHeap(const std::string& str);
+
+  /// \brief Gets the size of an xml node and all of its children.
+  /// \param[in] node
+  ///   The xml node. This can be a nullptr.
+  /// \return The size, in bytes.
+  static size_t SizeXmlNode(const wxXmlNode* node);
+
+ private:
+  /// \brief Gets the size of a cable file.
+  /// \param[in] cablefile
+  ///   The cable file.
+  /// \return The size, in bytes.
+  static size_t SizeCableFile(const CableFile& cablefile);
+
+  /// \brief Gets the size of the command history.
+  /// \param[in] doc
+  ///   The document.
+  /// \return The size, in bytes.
+  static size_t SizeHistory(const LineAnalyzerDoc& doc);
+
+  /// \brief Gets the size of a hardware file.
+  /// \param[in] hardwarefile
+  ///   The hardware file.
+  /// \return The size, in bytes.
+  static size_t SizeHardwareFile(const HardwareFile& hardwarefile);
+
+  /// \brief Gets the size of a transmission line.
+  /// \param[in] line
+  ///   The transmission line.
+  /// \return The size, in bytes.
+  static size_t SizeLine(const TransmissionLine& line);
+
+  /// \brief Gets the size of a structure file.
+  /// \param[in] structurefile
+  ///   The structure file.
+  /// \return The size, in bytes.
+  static size_t SizeStructureFile(const StructureFile& structurefile);
+
+  /// \brief Gets the size of a weathercase.
+  /// \param[in] weathercase
+  ///   The weathercase.
+  /// \return The size, in bytes.
+  static size_t SizeWeathercase(const WeatherLoadCase& weathercase);
+};
+
+#endif  // OTLS_LINEANALYZER_MEMORYREPORT_H_
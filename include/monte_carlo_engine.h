@@ -0,0 +1,189 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_MONTECARLOENGINE_H_
+#define OTLS_LINEANALYZER_MONTECARLOENGINE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/transmission_line.h"
+#include "models/transmissionline/weather_load_case.h"
+
+/// \par OVERVIEW
+///
+/// This struct is the distribution of a sampled weathercase parameter,
+/// which is centered on the parameter value of the base weathercase.
+struct MonteCarloDistribution {
+  /// \par OVERVIEW
+  ///
+  /// This enum contains types of distributions.
+  enum class DistributionType {
+    kFixed,
+    kGumbel,
+    kNormal,
+    kUniform
+  };
+
+  /// \var spread
+  ///   The spread of the distribution, which is the standard deviation of a
+  ///   normal distribution, the half width of a uniform distribution, and
+  ///   the scale of a gumbel distribution. A gumbel distribution is shifted
+  ///   so its mean is the base value.
+  double spread;
+
+  /// \var type
+  ///   The distribution type.
+  DistributionType type;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a histogram of sampled values.
+///
+/// \par TAILS
+///
+/// The bins cover a fixed range, and samples outside of it are counted as
+/// overflow or underflow. The true extremes are tracked, so the tails are
+/// bounded by them instead of being folded into the edge bins.
+struct MonteCarloHistogram {
+  /// \var count_overflow
+  ///   The number of samples above the last bin.
+  uint64_t count_overflow;
+
+  /// \var count_underflow
+  ///   The number of samples below the first bin.
+  uint64_t count_underflow;
+
+  /// \var counts
+  ///   The number of samples in each bin.
+  std::vector<uint64_t> counts;
+
+  /// \var value_begin
+  ///   The lower bound of the first bin.
+  double value_begin;
+
+  /// \var value_max
+  ///   The largest sampled value.
+  double value_max;
+
+  /// \var value_min
+  ///   The smallest sampled value.
+  double value_min;
+
+  /// \var width_bin
+  ///   The width of each bin.
+  double width_bin;
+};
+
+/// \par OVERVIEW
+///
+/// This class samples the ice thickness, wind pressure, and temperature of a
+/// weathercase from distributions, and builds histograms of the resulting
+/// ruling span tension and sag of every line cable. The tension and sag are
+/// both solved at the stored ruling span of the line cable.
+///
+/// \par RANDOM NUMBERS
+///
+/// Random numbers are generated by hashing the seed with a counter that is
+/// derived from the sample index, so every sample has its own stream that
+/// doesn't depend on which thread evaluates it. Results are reproducible
+/// for a seed regardless of the number of cores.
+///
+/// \par HISTOGRAMS
+///
+/// A pilot block of samples sets the bin ranges. The remaining samples are
+/// split into blocks that are evaluated on all cores, and each thread
+/// accumulates into its own histograms, which are merged after the run, so
+/// no locks are taken.
+class MonteCarloEngine {
+ public:
+  /// \brief Constructor.
+  MonteCarloEngine();
+
+  /// \brief Exports the histograms to a csv file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] units
+  ///   The unit system to export in.
+  /// \return If the file was written.
+  bool Export(const std::string& filepath,
+              const units::UnitSystem& units) const;
+
+  /// \brief Samples the line.
+  /// \param[in] line
+  ///   The transmission line.
+  /// \param[in] weathercase
+  ///   The base weathercase.
+  /// \param[in] condition
+  ///   The cable condition.
+  /// \param[in] count_samples
+  ///   The number of samples.
+  /// \param[in] seed
+  ///   The random seed.
+  /// \return The number of solutions that failed.
+  uint64_t Run(const TransmissionLine& line,
+               const WeatherLoadCase& weathercase,
+               const CableConditionType& condition,
+               const int& count_samples, const uint64_t& seed);
+
+  /// \brief Gets the value that is exceeded with a probability.
+  /// \param[in] histogram
+  ///   The histogram.
+  /// \param[in] probability
+  ///   The exceedance probability.
+  /// \return The value, interpolated within its bin. Values in the overflow
+  ///   or underflow are interpolated between the bin range and the sampled
+  ///   extreme.
+  static double ValueExceeded(const MonteCarloHistogram& histogram,
+                              const double& probability);
+
+  /// \brief Gets the ruling span sag histogram of each line cable.
+  /// \return The sag histograms.
+  const std::vector<MonteCarloHistogram>& histograms_sag() const;
+
+  /// \brief Gets the horizontal tension histogram of each line cable.
+  /// \return The tension histograms.
+  const std::vector<MonteCarloHistogram>& histograms_tension() const;
+
+  /// \brief Sets the ice thickness distribution.
+  /// \param[in] distribution
+  ///   The distribution.
+  void set_distribution_ice(const MonteCarloDistribution& distribution);
+
+  /// \brief Sets the temperature distribution.
+  /// \param[in] distribution
+  ///   The distribution.
+  void set_distribution_temperature(
+      const MonteCarloDistribution& distribution);
+
+  /// \brief Sets the wind pressure distribution.
+  /// \param[in] distribution
+  ///   The distribution.
+  void set_distribution_wind(const MonteCarloDistribution& distribution);
+
+ private:
+  /// \var distribution_ice_
+  ///   The ice thickness distribution.
+  MonteCarloDistribution distribution_ice_;
+
+  /// \var distribution_temperature_
+  ///   The temperature distribution.
+  MonteCarloDistribution distribution_temperature_;
+
+  /// \var distribution_wind_
+  ///   The wind pressure distribution.
+  MonteCarloDistribution distribution_wind_;
+
+  /// \var histograms_sag_
+  ///   The ruling span sag histogram of each line cable.
+  std::vector<MonteCarloHistogram> histograms_sag_;
+
+  /// \var histograms_tension_
+  ///   The horizontal tension histogram of each line cable.
+  std::vector<MonteCarloHistogram> histograms_tension_;
+};
+
+#endif  // OTLS_LINEANALYZER_MONTECARLOENGINE_H_
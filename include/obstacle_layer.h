@@ -0,0 +1,120 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_OBSTACLELAYER_H_
+#define OTLS_LINEANALYZER_OBSTACLELAYER_H_
+
+#include <cstdint>
+#include <vector>
+
+/// \par OVERVIEW
+///
+/// This struct is a classified obstacle point (i.e. a vegetation or building
+/// return) in plan coordinates. The coordinates are single precision to
+/// halve the memory of large point clouds.
+struct ObstaclePoint {
+  /// \var classification
+  ///   The classification code from the survey (i.e. LAS classes, where 3-5
+  ///   are vegetation and 6 is building).
+  int classification;
+
+  /// \var x
+  ///   The x coordinate.
+  float x;
+
+  /// \var y
+  ///   The y coordinate.
+  float y;
+
+  /// \var z
+  ///   The elevation.
+  float z;
+};
+
+/// \par OVERVIEW
+///
+/// This class indexes obstacle points in a 3D KD-tree.
+///
+/// \par STORAGE
+///
+/// The tree is built by median splits on the longest axis of each node, and
+/// the points are reordered in place so every node covers a contiguous range
+/// of the point array. Nodes store their bounding box, so queries can skip
+/// nodes that are outside of the query box, and take whole nodes that are
+/// inside of it without testing their points.
+class ObstacleLayer {
+ public:
+  /// \brief Constructor.
+  ObstacleLayer();
+
+  /// \brief Builds the tree.
+  /// \param[in,out] points
+  ///   The points. These are moved into the layer, and the vector is left
+  ///   empty.
+  void Build(std::vector<ObstaclePoint>& points);
+
+  /// \brief Clears the layer.
+  void Clear();
+
+  /// \brief Finds the points inside a box.
+  /// \param[in] bounds_min
+  ///   The minimum corner of the box (x, y, z).
+  /// \param[in] bounds_max
+  ///   The maximum corner of the box (x, y, z).
+  /// \param[out] indexes
+  ///   The indexes of the points inside the box. These are appended.
+  void Query(const double bounds_min[3], const double bounds_max[3],
+             std::vector<uint32_t>& indexes) const;
+
+  /// \brief Gets the points.
+  /// \return The points, in tree order.
+  const std::vector<ObstaclePoint>& points() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct is a tree node.
+  struct Node {
+    /// \var begin
+    ///   The index of the first point.
+    uint32_t begin;
+
+    /// \var bounds_max
+    ///   The maximum corner of the bounding box.
+    float bounds_max[3];
+
+    /// \var bounds_min
+    ///   The minimum corner of the bounding box.
+    float bounds_min[3];
+
+    /// \var end
+    ///   The index after the last point.
+    uint32_t end;
+
+    /// \var index_left
+    ///   The index of the left child, or -1 if the node is a leaf.
+    int32_t index_left;
+
+    /// \var index_right
+    ///   The index of the right child, or -1 if the node is a leaf.
+    int32_t index_right;
+  };
+
+  /// \brief Builds a node and its children.
+  /// \param[in] begin
+  ///   The index of the first point.
+  /// \param[in] end
+  ///   The index after the last point.
+  /// \return The node index.
+  int32_t BuildNode(const uint32_t& begin, const uint32_t& end);
+
+  /// \var nodes_
+  ///   The nodes. The root is the first node.
+  std::vector<Node> nodes_;
+
+  /// \var points_
+  ///   The points, in tree order.
+  std::vector<ObstaclePoint> points_;
+};
+
+#endif  // OTLS_LINEANALYZER_OBSTACLELAYER_H_
@@ -0,0 +1,51 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_PARALLEL_H_
+#define OTLS_LINEANALYZER_PARALLEL_H_
+
+#include <functional>
+
+/// \par OVERVIEW
+///
+/// This class runs independent work items on all cores.
+///
+/// \par SCHEDULING
+///
+/// Work items are claimed one at a time from a shared atomic counter, so
+/// threads that get cheap items keep claiming more and the load balances
+/// itself. No locks are taken while items run.
+///
+/// \par THREADS
+///
+/// The worker threads are started on the first call and reused by every
+/// call after it, so short runs don't pay for creating threads. The calling
+/// thread works alongside them. Calls from inside a work item, and calls
+/// that arrive while another thread's run is in progress, don't start more
+/// threads: nested calls run on the calling thread, and other calls wait
+/// for the pool.
+///
+/// \par RESULTS
+///
+/// Work items should write results into a slot that belongs to the item, or
+/// into a per-thread accumulator that is selected by the thread index and
+/// merged after the run. This keeps result accumulation lock-free.
+class Parallel {
+ public:
+  /// \brief Gets the number of threads that work is split across.
+  /// \return The number of threads, which is at least one.
+  static int CountThreads();
+
+  /// \brief Runs a function for every work item.
+  /// \param[in] count
+  ///   The number of work items.
+  /// \param[in] function
+  ///   The function, which is called with the item index and the thread
+  ///   index. It is called from multiple threads at once.
+  /// This returns after every item has finished. Small counts and nested
+  /// calls are run on the calling thread.
+  static void For(const int& count,
+                  const std::function<void(const int&, const int&)>& function);
+};
+
+#endif  // OTLS_LINEANALYZER_PARALLEL_H_
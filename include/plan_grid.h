@@ -0,0 +1,81 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_PLANGRID_H_
+#define OTLS_LINEANALYZER_PLANGRID_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// \par OVERVIEW
+///
+/// This class is a uniform plan grid that indexes straight segments (i.e.
+/// alignment segments or span chords), so the segments near a plan point
+/// can be found with a single lookup.
+///
+/// \par STORAGE
+///
+/// Only the cells that segments are registered in are stored, keyed by
+/// packing the column and row into one integer. A segment is registered in
+/// the cells around points that are sampled along it every half cell.
+class PlanGrid {
+ public:
+  /// \brief Constructor.
+  PlanGrid();
+
+  /// \brief Registers a segment.
+  /// \param[in] x_start
+  ///   The x coordinate of the segment start.
+  /// \param[in] y_start
+  ///   The y coordinate of the segment start.
+  /// \param[in] x_end
+  ///   The x coordinate of the segment end.
+  /// \param[in] y_end
+  ///   The y coordinate of the segment end.
+  /// \param[in] count_cells
+  ///   The number of cells around each sample that the segment is
+  ///   registered in.
+  /// \param[in] index
+  ///   The segment index. Segments must be added in index order.
+  void Add(const double& x_start, const double& y_start,
+           const double& x_end, const double& y_end,
+           const int& count_cells, const int& index);
+
+  /// \brief Clears the grid.
+  /// \param[in] size_cell
+  ///   The cell size for the segments that are added next.
+  void Clear(const double& size_cell);
+
+  /// \brief Gets the segments that are registered in a cell.
+  /// \param[in] x
+  ///   The x coordinate of a point in the cell.
+  /// \param[in] y
+  ///   The y coordinate of a point in the cell.
+  /// \return The segment indexes, or a nullptr if no segments are registered
+  ///   in the cell.
+  const std::vector<int>* Find(const double& x, const double& y) const;
+
+  /// \brief Gets the cell size.
+  /// \return The cell size.
+  double size_cell() const;
+
+ private:
+  /// \brief Gets the key of the cell that contains a plan point.
+  /// \param[in] x
+  ///   The x coordinate.
+  /// \param[in] y
+  ///   The y coordinate.
+  /// \return The cell key.
+  int64_t Key(const double& x, const double& y) const;
+
+  /// \var cells_
+  ///   The segments that are registered in each cell, keyed by cell.
+  std::unordered_map<int64_t, std::vector<int>> cells_;
+
+  /// \var size_cell_
+  ///   The cell size.
+  double size_cell_;
+};
+
+#endif  // OTLS_LINEANALYZER_PLANGRID_H_
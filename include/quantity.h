@@ -0,0 +1,183 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_QUANTITY_H_
+#define OTLS_LINEANALYZER_QUANTITY_H_
+
+/// \par OVERVIEW
+///
+/// This namespace contains typed measurement units and quantities.
+///
+/// \par TYPE SAFETY
+///
+/// Each unit is tagged with a dimension type, so converting between units of
+/// different dimensions (ex: feet to pounds) will not compile. Pressure and
+/// stress share the same physical dimension, but are tagged separately
+/// because they are reported in different units.
+///
+/// \par COMPILE TIME CONVERSION
+///
+/// Units and conversion factors are constexpr, so a factor between two unit
+/// constants is folded into a single scale and offset by the compiler.
+///
+/// \par BASE UNITS
+///
+/// Every unit is defined by its relationship to the base unit of its
+/// dimension, which is the metric consistent unit that the document stores:
+///   base = value * scale + offset
+namespace quantity {
+
+/// \par OVERVIEW
+///
+/// This struct is the dimension tag for weight densities.
+struct Density {};
+
+/// \par OVERVIEW
+///
+/// This struct is the dimension tag for forces.
+struct Force {};
+
+/// \par OVERVIEW
+///
+/// This struct is the dimension tag for lengths.
+struct Length {};
+
+/// \par OVERVIEW
+///
+/// This struct is the dimension tag for pressures.
+struct Pressure {};
+
+/// \par OVERVIEW
+///
+/// This struct is the dimension tag for stresses.
+struct Stress {};
+
+/// \par OVERVIEW
+///
+/// This struct is the dimension tag for temperatures.
+struct Temperature {};
+
+/// \par OVERVIEW
+///
+/// This struct is a linear conversion:
+///   value_to = value_from * scale + offset
+struct Factor {
+  /// \var scale
+  ///   The scale.
+  double scale;
+
+  /// \var offset
+  ///   The offset, which is only non-zero for temperatures.
+  double offset;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a measurement unit of a dimension.
+template<typename Dimension>
+struct Unit {
+  /// \var scale
+  ///   The base units per unit.
+  double scale;
+
+  /// \var offset
+  ///   The base unit value at zero of this unit.
+  double offset;
+};
+
+/// \brief Gets the factor that converts between two units.
+/// \param[in] unit_from
+///   The unit to convert from.
+/// \param[in] unit_to
+///   The unit to convert to.
+/// \return The conversion factor.
+template<typename Dimension>
+constexpr Factor FactorBetween(const Unit<Dimension>& unit_from,
+                               const Unit<Dimension>& unit_to) {
+  return Factor{unit_from.scale / unit_to.scale,
+                (unit_from.offset - unit_to.offset) / unit_to.scale};
+}
+
+/// \brief Gets the factor that reverses a conversion.
+/// \param[in] factor
+///   The conversion factor.
+/// \return The reverse conversion factor.
+constexpr Factor Inverse(const Factor& factor) {
+  return Factor{1 / factor.scale, -factor.offset / factor.scale};
+}
+
+/// \par OVERVIEW
+///
+/// This class is a measured value of a dimension. The value is stored in the
+/// base unit.
+template<typename Dimension>
+class Quantity {
+ public:
+  /// \brief Constructor.
+  /// \param[in] value
+  ///   The value.
+  /// \param[in] unit
+  ///   The unit of the value.
+  constexpr Quantity(const double& value, const Unit<Dimension>& unit)
+      : value_(value * unit.scale + unit.offset) {}
+
+  /// \brief Gets the value in a unit.
+  /// \param[in] unit
+  ///   The unit.
+  /// \return The value.
+  constexpr double In(const Unit<Dimension>& unit) const {
+    return (value_ - unit.offset) / unit.scale;
+  }
+
+ private:
+  /// \var value_
+  ///   The value, in the base unit.
+  double value_;
+};
+
+/// The newtons in a pound-force.
+constexpr double kNewtonsPerPound = 4.4482216152605;
+
+/// The meters in a foot.
+constexpr double kMetersPerFoot = 0.3048;
+
+namespace density {
+constexpr Unit<Density> kNewtonsPerCubicMeter = {1, 0};
+constexpr Unit<Density> kPoundsPerCubicFoot = {
+    kNewtonsPerPound / (kMetersPerFoot * kMetersPerFoot * kMetersPerFoot), 0};
+}  // namespace density
+
+namespace force {
+constexpr Unit<Force> kNewtons = {1, 0};
+constexpr Unit<Force> kPounds = {kNewtonsPerPound, 0};
+}  // namespace force
+
+namespace length {
+constexpr Unit<Length> kCentimeters = {0.01, 0};
+constexpr Unit<Length> kFeet = {kMetersPerFoot, 0};
+constexpr Unit<Length> kInches = {kMetersPerFoot / 12, 0};
+constexpr Unit<Length> kMeters = {1, 0};
+constexpr Unit<Length> kMillimeters = {0.001, 0};
+}  // namespace length
+
+namespace pressure {
+constexpr Unit<Pressure> kPascals = {1, 0};
+constexpr Unit<Pressure> kPoundsPerSquareFoot = {
+    kNewtonsPerPound / (kMetersPerFoot * kMetersPerFoot), 0};
+}  // namespace pressure
+
+namespace stress {
+constexpr Unit<Stress> kMegapascals = {1e6, 0};
+constexpr Unit<Stress> kPascals = {1, 0};
+constexpr Unit<Stress> kPoundsPerSquareInch = {
+    kNewtonsPerPound / (kMetersPerFoot / 12 * kMetersPerFoot / 12), 0};
+}  // namespace stress
+
+namespace temperature {
+constexpr Unit<Temperature> kCelsius = {1, 0};
+constexpr Unit<Temperature> kFahrenheit = {5.0 / 9.0, -32 * 5.0 / 9.0};
+}  // namespace temperature
+
+}  // namespace quantity
+
+#endif  // OTLS_LINEANALYZER_QUANTITY_H_
@@ -0,0 +1,127 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_REFERENCEINDEX_H_
+#define OTLS_LINEANALYZER_REFERENCEINDEX_H_
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "models/transmissionline/cable.h"
+#include "models/transmissionline/hardware.h"
+#include "models/transmissionline/structure.h"
+#include "models/transmissionline/weather_load_case.h"
+#include "wx/xml/xml.h"
+
+/// \par OVERVIEW
+///
+/// This struct contains the shared data that a transmission line xml node
+/// can reference, in the form that the transmission line xml handler
+/// resolves names against.
+struct ReferenceLists {
+  /// \var cables
+  ///   The cables.
+  std::list<const Cable*> cables;
+
+  /// \var hardwares
+  ///   The hardwares.
+  std::list<const Hardware*> hardwares;
+
+  /// \var structures
+  ///   The structures.
+  std::list<const Structure*> structures;
+
+  /// \var weathercases
+  ///   The weathercases.
+  std::list<const WeatherLoadCase*> weathercases;
+};
+
+/// \par OVERVIEW
+///
+/// This class indexes the document shared data (cables, hardwares,
+/// structures, and weathercases) by name.
+///
+/// \par NAME RESOLUTION
+///
+/// Transmission line xml nodes reference shared data by name, and the xml
+/// handler resolves each name by searching the lists it is given. Instead of
+/// giving it every item in the document, the names in a node are looked up in
+/// this index first, so the lists only contain the items the node actually
+/// references. Resolving a line then no longer depends on how much shared
+/// data the document has.
+///
+/// \par DUPLICATE NAMES
+///
+/// If multiple items have the same name, the first item that is added is
+/// indexed. This matches a linear search of the document lists.
+class ReferenceIndex {
+ public:
+  /// \brief Adds a cable.
+  /// \param[in] cable
+  ///   The cable.
+  void AddCable(const Cable* cable);
+
+  /// \brief Adds a hardware.
+  /// \param[in] hardware
+  ///   The hardware.
+  void AddHardware(const Hardware* hardware);
+
+  /// \brief Adds a structure.
+  /// \param[in] structure
+  ///   The structure.
+  void AddStructure(const Structure* structure);
+
+  /// \brief Adds a weathercase.
+  /// \param[in] weathercase
+  ///   The weathercase.
+  void AddWeathercase(const WeatherLoadCase* weathercase);
+
+  /// \brief Clears the index.
+  void Clear();
+
+  /// \brief Gets the items that a transmission line xml node references.
+  /// \param[in] node
+  ///   The transmission line xml node.
+  /// \param[out] lists
+  ///   The referenced items. Names that aren't in the index are left out, so
+  ///   the xml handler reports them as unresolved.
+  void ListReferences(const wxXmlNode* node, ReferenceLists& lists) const;
+
+  /// \brief Gets the indexed cables.
+  /// \return The cables, keyed by name.
+  const std::unordered_map<std::string, const Cable*>& cables() const;
+
+  /// \brief Gets the indexed hardwares.
+  /// \return The hardwares, keyed by name.
+  const std::unordered_map<std::string, const Hardware*>& hardwares() const;
+
+  /// \brief Gets the indexed structures.
+  /// \return The structures, keyed by name.
+  const std::unordered_map<std::string, const Structure*>& structures()
+      const;
+
+  /// \brief Gets the indexed weathercases.
+  /// \return The weathercases, keyed by description.
+  const std::unordered_map<std::string, const WeatherLoadCase*>&
+      weathercases() const;
+
+ private:
+  /// \var cables_
+  ///   The cables, keyed by name.
+  std::unordered_map<std::string, const Cable*> cables_;
+
+  /// \var hardwares_
+  ///   The hardwares, keyed by name.
+  std::unordered_map<std::string, const Hardware*> hardwares_;
+
+  /// \var structures_
+  ///   The structures, keyed by name.
+  std::unordered_map<std::string, const Structure*> structures_;
+
+  /// \var weathercases_
+  ///   The weathercases, keyed by description.
+  std::unordered_map<std::string, const WeatherLoadCase*> weathercases_;
+};
+
+#endif  // OTLS_LINEANALYZER_REFERENCEINDEX_H_
@@ -0,0 +1,176 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_RULINGSPANCALCULATOR_H_
+#define OTLS_LINEANALYZER_RULINGSPANCALCULATOR_H_
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "models/transmissionline/transmission_line.h"
+
+#include "alignment_path.h"
+
+/// \par OVERVIEW
+///
+/// This struct is the ruling span of a line cable.
+struct RulingSpanResult {
+  /// \var count_spans
+  ///   The number of spans in the connection chain.
+  int count_spans;
+
+  /// \var is_deviating
+  ///   An indicator that tells if the stored ruling span differs from the
+  ///   calculated ruling span by more than the tolerance.
+  bool is_deviating;
+
+  /// \var spacing_calculated
+  ///   The ruling span that is calculated from the attachment spacings.
+  double spacing_calculated;
+
+  /// \var spacing_stored
+  ///   The horizontal ruling span that is stored in the line cable.
+  double spacing_stored;
+};
+
+/// \par OVERVIEW
+///
+/// This class calculates the ruling span of every line cable from the
+/// horizontal spacings of its connected attachments:
+///   ruling span = sqrt(sum(L^3) / sum(L))
+/// and flags the line cables whose stored ruling span deviates from it.
+///
+/// \par INCREMENTAL UPDATES
+///
+/// The attachment locations of every connection are cached. When a
+/// structure moves, only the connections to that structure are located
+/// again, and the ruling spans of the affected line cables are summed again
+/// from the cached locations. A copy of a calculated instance can be updated
+/// for a moved copy of a structure, which is how sweep variants get their
+/// ruling spans without changing the line.
+///
+/// \par ANALYSIS RULING SPAN
+///
+/// Every analysis solves tensions and sags at the stored ruling span, which
+/// the line cable constraint is defined at. The calculated ruling span only
+/// flags stored values that deviate, and scales the stored value when a
+/// sweep variant moves structures.
+///
+/// \par SOLVING
+///
+/// The full calculation locates the connections of every line cable in one
+/// parallel pass, with each line cable written into its own slot.
+class RulingSpanCalculator {
+ public:
+  /// \brief Constructor.
+  RulingSpanCalculator();
+
+  /// \brief Calculates the ruling spans of every line cable.
+  /// \param[in] line
+  ///   The transmission line.
+  /// \param[in] path
+  ///   The alignment path.
+  void Calculate(const TransmissionLine& line, const AlignmentPath& path);
+
+  /// \brief Gets the number of line cables with deviating ruling spans.
+  /// \return The number of line cables with deviating ruling spans.
+  int CountDeviating() const;
+
+  /// \brief Updates the line cables that connect to a structure after it
+  ///   moves.
+  /// \param[in] line
+  ///   The transmission line.
+  /// \param[in] path
+  ///   The alignment path.
+  /// \param[in] index_structure
+  ///   The line structure index.
+  /// \param[in] line_structure
+  ///   The line structure at its new location. This can be a copy that isn't
+  ///   in the line.
+  void UpdateStructure(const TransmissionLine& line, const AlignmentPath& path,
+                       const int& index_structure,
+                       const LineStructure& line_structure);
+
+  /// \brief Gets the ruling span results.
+  /// \return The results, in line cable order.
+  const std::vector<RulingSpanResult>& results() const;
+
+  /// \brief Sets the deviation tolerance.
+  /// \param[in] tolerance
+  ///   The tolerance, as a fraction of the calculated ruling span.
+  void set_tolerance(const double& tolerance);
+
+  /// \brief Gets the deviation tolerance.
+  /// \return The tolerance, as a fraction of the calculated ruling span.
+  double tolerance() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct is the cached location of a line cable connection.
+  struct ChainPoint {
+    /// \var index_attachment
+    ///   The structure attachment index.
+    int index_attachment;
+
+    /// \var index_structure
+    ///   The line structure index, or -1 if the structure isn't in the line.
+    int index_structure;
+
+    /// \var is_valid
+    ///   An indicator that tells if the attachment was located.
+    bool is_valid;
+
+    /// \var x
+    ///   The x coordinate.
+    double x;
+
+    /// \var y
+    ///   The y coordinate.
+    double y;
+  };
+
+  /// \brief Indexes the connections of every structure.
+  void Index();
+
+  /// \brief Locates the connections of a line cable.
+  /// \param[in] line_cable
+  ///   The line cable.
+  /// \param[in] indexes_structure
+  ///   The line structure indexes, by line structure.
+  /// \param[in] path
+  ///   The alignment path.
+  /// \param[out] chain
+  ///   The connection locations.
+  static void Locate(
+      const LineCable& line_cable,
+      const std::unordered_map<const LineStructure*, int>& indexes_structure,
+      const AlignmentPath& path, std::vector<ChainPoint>& chain);
+
+  /// \brief Sums the ruling span of a line cable from its chain.
+  /// \param[in] line_cable
+  ///   The line cable.
+  /// \param[in] index_line_cable
+  ///   The line cable index.
+  void Sum(const LineCable& line_cable, const int& index_line_cable);
+
+  /// \var chains_
+  ///   The connection locations of each line cable.
+  std::vector<std::vector<ChainPoint>> chains_;
+
+  /// \var connections_structure_
+  ///   The connections to each line structure, as line cable and connection
+  ///   indexes.
+  std::vector<std::vector<std::pair<int, int>>> connections_structure_;
+
+  /// \var results_
+  ///   The ruling span of each line cable.
+  std::vector<RulingSpanResult> results_;
+
+  /// \var tolerance_
+  ///   The deviation tolerance, as a fraction of the calculated ruling span.
+  double tolerance_;
+};
+
+#endif  // OTLS_LINEANALYZER_RULINGSPANCALCULATOR_H_
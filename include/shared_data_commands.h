@@ -25,12 +25,19 @@
 /// xml node because the document shared/external data types do not reference
 /// other data types, and no pointer references have to be re-established on an
 /// undo operation.
+///
+/// \par JOURNAL
+///
+/// After a do or an undo, the new shared data is appended to the document
+/// journal. An undo also appends the restored transmission lines.
 class SharedDataCommandBase : public wxCommand {
  public:
   /// \brief Constructor.
   /// \param[in] name
   ///   The command name, which should match one of the defined strings.
-  SharedDataCommandBase(const std::string& name);
+  /// \param[in] doc
+  ///   The document that the command modifies.
+  SharedDataCommandBase(const std::string& name, LineAnalyzerDoc* doc);
 
   /// \brief Destructor.
   virtual ~SharedDataCommandBase();
@@ -43,7 +50,16 @@ class SharedDataCommandBase : public wxCommand {
   /// \return True if the action has taken place, false otherwise.
   virtual bool Undo();
 
+  /// \brief Gets the transmission lines xml node.
+  /// \return The transmission lines xml node. This is a nullptr until the
+  ///   command has been done.
+  const wxXmlNode* node_lines() const;
+
  protected:
+  /// \brief Creates a journal record for the document shared data.
+  /// \return The journal record.
+  virtual JournalRecord CreateJournalRecord() const = 0;
+
   /// \brief Does the modify command.
   /// \return The success status.
   virtual bool DoModify() = 0;
@@ -71,7 +87,9 @@ class SharedDataCommandBase : public wxCommand {
 class CableFileCommand : public SharedDataCommandBase {
  public:
   /// \brief Constructor.
-  CableFileCommand();
+  /// \param[in] doc
+  ///   The document that the command modifies.
+  CableFileCommand(LineAnalyzerDoc* doc);
 
   /// \brief Destructor.
   virtual ~CableFileCommand();
@@ -83,9 +101,13 @@ class CableFileCommand : public SharedDataCommandBase {
 
   /// \brief Gets the cable files.
   /// \return The cable files.
-  const std::list<CableFile> cablefiles() const;
+  const std::list<CableFile>& cablefiles() const;
 
  private:
+  /// \brief Creates a journal record for the document shared data.
+  /// \return The journal record.
+  virtual JournalRecord CreateJournalRecord() const;
+
   /// \brief Does the modify command.
   /// \return The success status.
   /// This function will switch the stored data with the document data.
@@ -108,7 +130,9 @@ class CableFileCommand : public SharedDataCommandBase {
 class HardwareFileCommand : public SharedDataCommandBase {
  public:
   /// \brief Constructor.
-  HardwareFileCommand();
+  /// \param[in] doc
+  ///   The document that the command modifies.
+  HardwareFileCommand(LineAnalyzerDoc* doc);
 
   /// \brief Destructor.
   virtual ~HardwareFileCommand();
@@ -120,9 +144,13 @@ class HardwareFileCommand : public SharedDataCommandBase {
 
   /// \brief Gets the hardware files.
   /// \return The hardware files.
-  const std::list<HardwareFile> hardwarefiles() const;
+  const std::list<HardwareFile>& hardwarefiles() const;
 
  private:
+  /// \brief Creates a journal record for the document shared data.
+  /// \return The journal record.
+  virtual JournalRecord CreateJournalRecord() const;
+
   /// \brief Does the modify command.
   /// \return The success status.
   /// This function will switch the stored data with the document data.
@@ -145,7 +173,9 @@ class HardwareFileCommand : public SharedDataCommandBase {
 class StructureFileCommand : public SharedDataCommandBase {
  public:
   /// \brief Constructor.
-  StructureFileCommand();
+  /// \param[in] doc
+  ///   The document that the command modifies.
+  StructureFileCommand(LineAnalyzerDoc* doc);
 
   /// \brief Destructor.
   virtual ~StructureFileCommand();
@@ -157,9 +187,13 @@ class StructureFileCommand : public SharedDataCommandBase {
 
   /// \brief Gets the structure files.
   /// \return The structure files.
-  const std::list<StructureFile> structurefiles() const;
+  const std::list<StructureFile>& structurefiles() const;
 
  private:
+  /// \brief Creates a journal record for the document shared data.
+  /// \return The journal record.
+  virtual JournalRecord CreateJournalRecord() const;
+
   /// \brief Does the modify command.
   /// \return The success status.
   /// This function will switch the stored data with the document data.
@@ -183,7 +217,9 @@ class StructureFileCommand : public SharedDataCommandBase {
 class WeatherLoadCaseCommand : public SharedDataCommandBase {
  public:
   /// \brief Constructor.
-  WeatherLoadCaseCommand();
+  /// \param[in] doc
+  ///   The document that the command modifies.
+  WeatherLoadCaseCommand(LineAnalyzerDoc* doc);
 
   /// \brief Destructor.
   virtual ~WeatherLoadCaseCommand();
@@ -195,9 +231,13 @@ class WeatherLoadCaseCommand : public SharedDataCommandBase {
 
   /// \brief Gets the weather cases.
   /// \return The weather cases.
-  const std::list<WeatherLoadCase> weathercases() const;
+  const std::list<WeatherLoadCase>& weathercases() const;
 
  private:
+  /// \brief Creates a journal record for the document shared data.
+  /// \return The journal record.
+  virtual JournalRecord CreateJournalRecord() const;
+
   /// \brief Does the modify command.
   /// \return The success status.
   /// This function will switch the stored data with the document data.
@@ -0,0 +1,128 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_SPANCATENARY_H_
+#define OTLS_LINEANALYZER_SPANCATENARY_H_
+
+#include <vector>
+
+#include "line_span.h"
+
+/// \par OVERVIEW
+///
+/// This class is the loaded shape of a cable in a span.
+///
+/// \par SHAPE
+///
+/// The cable hangs as a catenary in the plane that contains the span chord
+/// and the resultant unit weight. The sag below the chord is solved in that
+/// plane with the resultant unit weight, and is then split into vertical and
+/// transverse components by the swing angle of the unit weight. Transverse
+/// displacement is measured to the left of the span when facing from the
+/// back attachment to the ahead attachment, so a negative transverse unit
+/// weight swings the cable to the right.
+///
+/// \par COST
+///
+/// The catenary constants are solved once when the span and loading are set,
+/// so sampling points along the span is cheap.
+class SpanCatenary {
+ public:
+  /// \brief Constructor.
+  SpanCatenary();
+
+  /// \brief Gets a point on the cable.
+  /// \param[in] fraction
+  ///   The position along the span, from 0 (back) to 1 (ahead).
+  /// \param[out] x
+  ///   The x coordinate.
+  /// \param[out] y
+  ///   The y coordinate.
+  /// \param[out] elevation
+  ///   The elevation.
+  void Point(const double& fraction, double& x, double& y,
+             double& elevation) const;
+
+  /// \brief Gets the sag below the chord in the loaded plane.
+  /// \param[in] fraction
+  ///   The position along the span, from 0 (back) to 1 (ahead).
+  /// \return The sag.
+  double Sag(const double& fraction) const;
+
+  /// \brief Gets the sag below the chord at evenly spaced samples.
+  /// \param[in] count_samples
+  ///   The number of samples, including both ends of the span.
+  /// \param[out] sags
+  ///   The sag at each sample.
+  /// This is a single loop without branches, so it can be vectorized.
+  void SagProfile(const int& count_samples, std::vector<double>& sags) const;
+
+  /// \brief Sets the span and loading.
+  /// \param[in] span
+  ///   The span.
+  /// \param[in] tension_horizontal
+  ///   The horizontal tension.
+  /// \param[in] weight_transverse
+  ///   The transverse unit weight.
+  /// \param[in] weight_vertical
+  ///   The vertical unit weight.
+  /// \return If the catenary is valid. The tension and resultant unit weight
+  ///   must be positive, and the span must have a plan length.
+  bool Set(const LineSpan& span, const double& tension_horizontal,
+           const double& weight_transverse, const double& weight_vertical);
+
+  /// \brief Gets the slope of the cable at the ahead attachment.
+  /// \return The slope (rise over run) in the loaded plane.
+  double SlopeAhead() const;
+
+  /// \brief Gets the slope of the cable at the back attachment.
+  /// \return The slope (rise over run) in the loaded plane.
+  double SlopeBack() const;
+
+  /// \brief Gets the plan length of the span.
+  /// \return The plan length of the span.
+  double length() const;
+
+  /// \brief Gets the position of the catenary low point.
+  /// \return The plan distance from the back attachment to the low point,
+  ///   which is outside of the span if the cable slopes the same way at
+  ///   both attachments.
+  double position_low() const;
+
+  /// \brief Gets the span.
+  /// \return The span.
+  const LineSpan& span() const;
+
+ private:
+  /// \var constant_
+  ///   The catenary constant, which is the horizontal tension divided by the
+  ///   resultant unit weight.
+  double constant_;
+
+  /// \var cosine_swing_
+  ///   The cosine of the swing angle of the unit weight from vertical.
+  double cosine_swing_;
+
+  /// \var height_
+  ///   The elevation difference from the back to the ahead attachment.
+  double height_;
+
+  /// \var length_
+  ///   The plan length of the span.
+  double length_;
+
+  /// \var position_low_
+  ///   The position of the catenary low point from the back attachment,
+  ///   which may be outside of the span.
+  double position_low_;
+
+  /// \var sine_swing_
+  ///   The sine of the swing angle of the unit weight from vertical.
+  double sine_swing_;
+
+  /// \var span_
+  ///   The span.
+  LineSpan span_;
+};
+
+#endif  // OTLS_LINEANALYZER_SPANCATENARY_H_
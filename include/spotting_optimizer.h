@@ -0,0 +1,230 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_SPOTTINGOPTIMIZER_H_
+#define OTLS_LINEANALYZER_SPOTTINGOPTIMIZER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "models/base/units.h"
+
+#include "alignment_path.h"
+#include "terrain_index.h"
+
+/// \par OVERVIEW
+///
+/// This struct is a cable loading that spans are checked for.
+struct SpottingCase {
+  /// \var tension_horizontal
+  ///   The horizontal tension.
+  double tension_horizontal;
+
+  /// \var weight_transverse
+  ///   The transverse unit weight.
+  double weight_transverse;
+
+  /// \var weight_vertical
+  ///   The vertical unit weight.
+  double weight_vertical;
+};
+
+/// \par OVERVIEW
+///
+/// This struct contains the criteria that spans must meet.
+struct SpottingCriteria {
+  /// \var cases
+  ///   The cable loadings. Clearance is checked for the loading with the
+  ///   most vertical sag, and support tension and structure weight spans are
+  ///   checked for all loadings.
+  std::vector<SpottingCase> cases;
+
+  /// \var clearance
+  ///   The minimum vertical clearance from the cable to the ground.
+  double clearance;
+
+  /// \var spacing_candidates
+  ///   The station spacing of the candidate structure locations.
+  double spacing_candidates;
+
+  /// \var spacing_samples
+  ///   The station spacing of the ground profile.
+  double spacing_samples;
+
+  /// \var tension_support_max
+  ///   The maximum cable tension at the attachments. If zero, support
+  ///   tension isn't checked.
+  double tension_support_max;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a structure type that can be spotted.
+struct SpottingStructure {
+  /// \var cost
+  ///   The cost of placing the structure.
+  double cost;
+
+  /// \var height_attachment
+  ///   The height of the cable attachment above the ground.
+  double height_attachment;
+
+  /// \var span_max
+  ///   The maximum wind span that the structure can support. Each span
+  ///   next to the structure is limited to this, which keeps the wind span
+  ///   within it.
+  double span_max;
+
+  /// \var weight_span_max
+  ///   The maximum weight span that the structure can support, or zero if it
+  ///   isn't checked. The weight span is the distance between the low points
+  ///   of the spans next to the structure, so each span keeps its low point
+  ///   within half of this from the structure for every loading. Uplift
+  ///   (a negative weight span) isn't checked.
+  double weight_span_max;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a structure that was spotted.
+struct SpottedStructure {
+  /// \var elevation_ground
+  ///   The ground elevation.
+  double elevation_ground;
+
+  /// \var index_structure
+  ///   The structure type index.
+  int index_structure;
+
+  /// \var station
+  ///   The station.
+  double station;
+};
+
+/// \par OVERVIEW
+///
+/// This class spots structures along an alignment, finding the placement
+/// with the least total structure cost where every span meets the
+/// clearance, tension, and structure wind and weight span criteria.
+///
+/// \par CANDIDATES
+///
+/// Structures can be placed at evenly spaced candidate stations, and must
+/// be placed at the fixed stations, which are the path ends and angle
+/// points. Spans can't cross a fixed station, so every span is a straight
+/// tangent, and the ground profile under it is the alignment profile.
+///
+/// \par OPTIMIZATION
+///
+/// The cost of the cheapest placement that ends with a structure type at a
+/// candidate only depends on the feasible spans that end there, so the
+/// candidates are solved in station order with dynamic programming.
+///
+/// \par PRUNING
+///
+/// The feasibility of the spans that start at each candidate is evaluated
+/// on all cores. Spans are extended one candidate at a time while the
+/// highest ground under the span is tracked, so most spans are accepted by
+/// a bound on the lowest cable point, or rejected at the highest ground,
+/// without sampling the whole span.
+class SpottingOptimizer {
+ public:
+  /// \brief Constructor.
+  SpottingOptimizer();
+
+  /// \brief Exports the spotted structures to a csv file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] units
+  ///   The unit system to export in.
+  /// \return If the file was written.
+  bool Export(const std::string& filepath,
+              const units::UnitSystem& units) const;
+
+  /// \brief Finds the cheapest placement.
+  /// \param[in] path
+  ///   The alignment path.
+  /// \param[in] terrain
+  ///   The terrain index.
+  /// \param[in] stations_fixed
+  ///   The stations that must have structures, in addition to the path
+  ///   ends.
+  /// \param[in] criteria
+  ///   The span criteria.
+  /// \param[in] structures
+  ///   The structure types.
+  /// \return 0 if a placement was found, or 1 if the terrain has no points
+  ///   or no placement meets the criteria.
+  int Optimize(const AlignmentPath& path, const TerrainIndex& terrain,
+               const std::vector<double>& stations_fixed,
+               const SpottingCriteria& criteria,
+               const std::vector<SpottingStructure>& structures);
+
+  /// \brief Gets the total structure cost.
+  /// \return The total structure cost.
+  double cost() const;
+
+  /// \brief Gets the number of spans that were checked.
+  /// \return The number of spans that were checked.
+  uint64_t count_checked() const;
+
+  /// \brief Gets the number of spans that were sampled.
+  /// \return The number of spans that couldn't be accepted or rejected
+  ///   without sampling.
+  uint64_t count_sampled() const;
+
+  /// \brief Gets the spotted structures.
+  /// \return The spotted structures, in station order.
+  const std::vector<SpottedStructure>& placements() const;
+
+ private:
+  /// \brief Gets the ground elevation at a station.
+  /// \param[in] station
+  ///   The station.
+  /// \return The ground elevation, which is interpolated between profile
+  ///   samples.
+  double Ground(const double& station) const;
+
+  /// \brief Builds the ground profile.
+  /// \param[in] path
+  ///   The alignment path.
+  /// \param[in] terrain
+  ///   The terrain index.
+  /// \return If the profile has any ground.
+  bool Profile(const AlignmentPath& path, const TerrainIndex& terrain);
+
+  /// \var cost_
+  ///   The total structure cost.
+  double cost_;
+
+  /// \var count_checked_
+  ///   The number of spans that were checked.
+  uint64_t count_checked_;
+
+  /// \var count_sampled_
+  ///   The number of spans that were sampled.
+  uint64_t count_sampled_;
+
+  /// \var elevations_ground_
+  ///   The ground elevation at each profile sample.
+  std::vector<double> elevations_ground_;
+
+  /// \var placements_
+  ///   The spotted structures.
+  std::vector<SpottedStructure> placements_;
+
+  /// \var spacing_samples_
+  ///   The station spacing of the ground profile.
+  double spacing_samples_;
+
+  /// \var station_start_
+  ///   The station of the first profile sample.
+  double station_start_;
+
+  /// \var structures_
+  ///   The structure types.
+  std::vector<SpottingStructure> structures_;
+};
+
+#endif  // OTLS_LINEANALYZER_SPOTTINGOPTIMIZER_H_
@@ -0,0 +1,132 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_STRUCTURELOADENGINE_H_
+#define OTLS_LINEANALYZER_STRUCTURELOADENGINE_H_
+
+#include <string>
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/transmission_line.h"
+
+#include "alignment_path.h"
+#include "line_span.h"
+#include "tension_table.h"
+
+/// \par OVERVIEW
+///
+/// This struct is the load that the cables and hardware apply to a
+/// structure attachment, in the structure axes.
+struct AttachmentLoad {
+  /// \var longitudinal
+  ///   The load along the structure longitudinal axis (up-station).
+  double longitudinal;
+
+  /// \var transverse
+  ///   The load along the structure transverse axis (to the left).
+  double transverse;
+
+  /// \var vertical
+  ///   The downward load.
+  double vertical;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a structure attachment that at least one span is
+/// connected to.
+struct LoadedAttachment {
+  /// \var index_attachment
+  ///   The structure attachment index.
+  int index_attachment;
+
+  /// \var index_structure
+  ///   The line structure index.
+  int index_structure;
+};
+
+/// \par OVERVIEW
+///
+/// This class calculates the attachment loads of every line structure for
+/// every weathercase and cable condition.
+///
+/// \par LOADS
+///
+/// Each span pulls on its end attachments with the horizontal tension along
+/// the span chord, and with the end reaction in the plane of the loaded
+/// cable, which is split into vertical and transverse loads by the swing
+/// angle. The contributions of every span that ends at an attachment are
+/// summed, so tangent structures get the difference of the ahead and back
+/// tensions, and dead-ends get the full tension. Suspension hardware adds
+/// its weight, and its wind load in the direction that the cable is blown.
+///
+/// \par SOLVING
+///
+/// The attachment and case grid is solved on all cores, and each grid cell
+/// is written into its own result slot.
+class StructureLoadEngine {
+ public:
+  /// \brief Constructor.
+  StructureLoadEngine();
+
+  /// \brief Calculates the attachment loads.
+  /// \param[in] line
+  ///   The transmission line.
+  /// \param[in] path
+  ///   The alignment path, which orients the structures.
+  /// \param[in] spans
+  ///   The spans of the line.
+  /// \param[in] tensions
+  ///   The tension table, which must be built for the same line as the
+  ///   spans.
+  void Calculate(const TransmissionLine& line, const AlignmentPath& path,
+                 const std::vector<LineSpan>& spans,
+                 const TensionTable& tensions);
+
+  /// \brief Exports the loads to a csv file per line structure.
+  /// \param[in] dirpath
+  ///   The directory to write the files into.
+  /// \param[in] units
+  ///   The unit system to export in.
+  /// \return The number of files that were written, or -1 if a file
+  ///   couldn't be written.
+  int Export(const std::string& dirpath,
+             const units::UnitSystem& units) const;
+
+  /// \brief Gets a load.
+  /// \param[in] index_attachment
+  ///   The loaded attachment index.
+  /// \param[in] index_weathercase
+  ///   The weathercase index.
+  /// \param[in] index_condition
+  ///   The condition index.
+  /// \return The load.
+  const AttachmentLoad& Load(const int& index_attachment,
+                             const int& index_weathercase,
+                             const int& index_condition) const;
+
+  /// \brief Gets the loaded attachments.
+  /// \return The loaded attachments, sorted by line structure and then by
+  ///   attachment.
+  const std::vector<LoadedAttachment>& attachments() const;
+
+ private:
+  /// \var attachments_
+  ///   The loaded attachments.
+  std::vector<LoadedAttachment> attachments_;
+
+  /// \var conditions_
+  ///   The cable conditions.
+  std::vector<CableConditionType> conditions_;
+
+  /// \var loads_
+  ///   The loads, stored by attachment, then weathercase, then condition.
+  std::vector<AttachmentLoad> loads_;
+
+  /// \var weathercases_
+  ///   The weathercases.
+  std::vector<const WeatherLoadCase*> weathercases_;
+};
+
+#endif  // OTLS_LINEANALYZER_STRUCTURELOADENGINE_H_
@@ -0,0 +1,234 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_SWEEPRUNNER_H_
+#define OTLS_LINEANALYZER_SWEEPRUNNER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/transmission_line.h"
+#include "models/transmissionline/weather_load_case.h"
+
+#include "alignment_path.h"
+#include "line_span.h"
+#include "ruling_span_calculator.h"
+
+/// \par OVERVIEW
+///
+/// This struct is a document field that is varied by a sweep, along with
+/// the values that it takes.
+struct SweepParameter {
+  /// \par OVERVIEW
+  ///
+  /// This enum contains types of sweep parameters.
+  enum class ParameterType {
+    kConstraintLimit,
+    kConstraintWeathercase,
+    kStation
+  };
+
+  /// \var index
+  ///   The line cable index for constraint parameters, or the line structure
+  ///   index for station parameters.
+  int index;
+
+  /// \var type
+  ///   The parameter type.
+  ParameterType type;
+
+  /// \var values
+  ///   The values, in the document units. Constraint weathercase values are
+  ///   weathercase indexes.
+  std::vector<double> values;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is the objective metrics of a sweep variant.
+struct SweepResult {
+  /// \var count_failed
+  ///   The number of sag-tension solutions that failed.
+  int count_failed;
+
+  /// \var sag_max
+  ///   The maximum midspan sag, for any span, weathercase, and condition.
+  double sag_max;
+
+  /// \var tension_max
+  ///   The maximum horizontal tension, for any line cable, weathercase, and
+  ///   condition.
+  double tension_max;
+};
+
+/// \par OVERVIEW
+///
+/// This class evaluates every combination of a set of parameter values,
+/// which are called variants, and tabulates the objective metrics of each.
+///
+/// \par OVERLAYS
+///
+/// A variant isn't a copy of the transmission line. It is an overlay that
+/// only copies the line cables and line structures that its parameters
+/// change, and reads everything else from the base line and spans. Spans
+/// that end at a moved structure are relocated as they are evaluated.
+///
+/// \par RULING SPANS
+///
+/// Moving a structure changes the ruling span of the line cables that
+/// connect to it, which changes their tensions. The ruling spans of a
+/// variant are updated incrementally from the base line ruling spans, for
+/// only the moved structures. The stored ruling span of each line cable is
+/// scaled by the change in its calculated ruling span, so a variant that
+/// doesn't move a structure is solved with the stored ruling span.
+///
+/// \par CACHE
+///
+/// Sag-tension solutions only depend on the line cable constraint and ruling
+/// span, so the solutions that every variant needs are collected first, and
+/// only the ones that aren't cached are solved. Solutions are keyed by the
+/// line cable and weathercase they were solved for, not by their indexes, so
+/// the cache can be kept between runs of different lines and weathercases.
+///
+/// \par SOLVING
+///
+/// The uncached solutions and the variants are each evaluated on all cores,
+/// and every result is written into its own slot.
+class SweepRunner {
+ public:
+  /// \brief Constructor.
+  SweepRunner();
+
+  /// \brief Clears the solution cache.
+  /// This must be called if a line cable or weathercase is modified in place
+  /// between runs.
+  void ClearCache();
+
+  /// \brief Gets the number of variants.
+  /// \return The number of variants, which is the product of the number of
+  ///   values of every parameter.
+  int CountVariants() const;
+
+  /// \brief Exports the results to a csv file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] weathercases
+  ///   The weathercases that the sweep was run with.
+  /// \param[in] units
+  ///   The unit system to export in.
+  /// \return If the file was written.
+  bool Export(const std::string& filepath,
+              const std::vector<const WeatherLoadCase*>& weathercases,
+              const units::UnitSystem& units) const;
+
+  /// \brief Runs the sweep.
+  /// \param[in] line
+  ///   The base transmission line.
+  /// \param[in] path
+  ///   The alignment path.
+  /// \param[in] rulings
+  ///   The ruling spans of the base line, calculated with the same path.
+  /// \param[in] spans
+  ///   The spans of the base line.
+  /// \param[in] weathercases
+  ///   The weathercases, which are evaluated and which constraint
+  ///   weathercase values index into.
+  /// \param[in] conditions
+  ///   The cable conditions.
+  /// \return The number of solutions that were solved, which excludes the
+  ///   cached solutions.
+  int Run(const TransmissionLine& line, const AlignmentPath& path,
+          const RulingSpanCalculator& rulings,
+          const std::vector<LineSpan>& spans,
+          const std::vector<const WeatherLoadCase*>& weathercases,
+          const std::vector<CableConditionType>& conditions);
+
+  /// \brief Gets a parameter value of a variant.
+  /// \param[in] index_variant
+  ///   The variant index.
+  /// \param[in] index_parameter
+  ///   The parameter index.
+  /// \return The parameter value.
+  double Value(const int& index_variant, const int& index_parameter) const;
+
+  /// \brief Gets the number of cached solutions.
+  /// \return The number of cached solutions.
+  int count_cached() const;
+
+  /// \brief Gets the parameters.
+  /// \return The parameters.
+  const std::vector<SweepParameter>& parameters() const;
+
+  /// \brief Gets the results.
+  /// \return The results, in variant order.
+  const std::vector<SweepResult>& results() const;
+
+  /// \brief Sets the parameters.
+  /// \param[in] parameters
+  ///   The parameters. The first parameter varies the fastest.
+  void set_parameters(const std::vector<SweepParameter>& parameters);
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct identifies a sag-tension solution.
+  struct SolutionKey {
+    /// \brief Compares keys.
+    bool operator<(const SolutionKey& other) const;
+
+    /// \var condition
+    ///   The cable condition.
+    CableConditionType condition;
+
+    /// \var limit
+    ///   The constraint limit.
+    double limit;
+
+    /// \var line_cable
+    ///   The base line cable.
+    const LineCable* line_cable;
+
+    /// \var spacing_ruling
+    ///   The horizontal ruling span.
+    double spacing_ruling;
+
+    /// \var weathercase
+    ///   The weathercase that is solved for.
+    const WeatherLoadCase* weathercase;
+
+    /// \var weathercase_constraint
+    ///   The constraint weathercase.
+    const WeatherLoadCase* weathercase_constraint;
+  };
+
+  /// \brief Applies the constraint parameters of a variant to a line cable.
+  /// \param[in] index_variant
+  ///   The variant index.
+  /// \param[in] index_line_cable
+  ///   The line cable index.
+  /// \param[in] weathercases
+  ///   The weathercases.
+  /// \param[in,out] constraint
+  ///   The constraint, which starts as the base constraint.
+  void ApplyConstraint(
+      const int& index_variant, const int& index_line_cable,
+      const std::vector<const WeatherLoadCase*>& weathercases,
+      CableConstraint& constraint) const;
+
+  /// \var cache_
+  ///   The horizontal tension of every solved solution, which is NaN if the
+  ///   solution failed.
+  std::map<SolutionKey, double> cache_;
+
+  /// \var parameters_
+  ///   The parameters.
+  std::vector<SweepParameter> parameters_;
+
+  /// \var results_
+  ///   The results.
+  std::vector<SweepResult> results_;
+};
+
+#endif  // OTLS_LINEANALYZER_SWEEPRUNNER_H_
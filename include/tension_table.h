@@ -0,0 +1,94 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_TENSIONTABLE_H_
+#define OTLS_LINEANALYZER_TENSIONTABLE_H_
+
+#include <vector>
+
+#include "models/sagtension/line_cable_reloader.h"
+#include "models/transmissionline/transmission_line.h"
+#include "models/transmissionline/weather_load_case.h"
+
+/// \par OVERVIEW
+///
+/// This class is a table of the horizontal tension of every line cable in a
+/// transmission line, for every weathercase and cable condition.
+///
+/// \par SOLVING
+///
+/// Each tension is a sag-tension solution of the line cable ruling span,
+/// which is applied to every span of the line cable. The solutions are
+/// independent, so they are solved on all cores with a reloader per work
+/// item, and each solution is written into its own table slot.
+///
+/// \par FAILURES
+///
+/// Solutions that fail validation are stored as NaN, so a single bad line
+/// cable doesn't prevent the rest of the line from being analyzed.
+class TensionTable {
+ public:
+  /// \brief Constructor.
+  TensionTable();
+
+  /// \brief Solves the table.
+  /// \param[in] line
+  ///   The transmission line.
+  /// \param[in] weathercases
+  ///   The weathercases.
+  /// \param[in] conditions
+  ///   The cable conditions.
+  /// \return The number of solutions that failed.
+  int Build(const TransmissionLine& line,
+            const std::vector<const WeatherLoadCase*>& weathercases,
+            const std::vector<CableConditionType>& conditions);
+
+  /// \brief Gets the name of a cable condition.
+  /// \param[in] condition
+  ///   The cable condition.
+  /// \return The name of the cable condition.
+  static const char* NameCondition(const CableConditionType& condition);
+
+  /// \brief Gets a horizontal tension.
+  /// \param[in] index_line_cable
+  ///   The line cable index.
+  /// \param[in] index_weathercase
+  ///   The weathercase index.
+  /// \param[in] index_condition
+  ///   The condition index.
+  /// \return The horizontal tension, or NaN if the solution failed.
+  double Tension(const int& index_line_cable, const int& index_weathercase,
+                 const int& index_condition) const;
+
+  /// \brief Gets the cable conditions.
+  /// \return The cable conditions.
+  const std::vector<CableConditionType>& conditions() const;
+
+  /// \brief Gets the number of line cables.
+  /// \return The number of line cables.
+  int count_line_cables() const;
+
+  /// \brief Gets the weathercases.
+  /// \return The weathercases.
+  const std::vector<const WeatherLoadCase*>& weathercases() const;
+
+ private:
+  /// \var conditions_
+  ///   The cable conditions.
+  std::vector<CableConditionType> conditions_;
+
+  /// \var count_line_cables_
+  ///   The number of line cables.
+  int count_line_cables_;
+
+  /// \var tensions_
+  ///   The horizontal tensions, stored by line cable, then weathercase, then
+  ///   condition.
+  std::vector<double> tensions_;
+
+  /// \var weathercases_
+  ///   The weathercases.
+  std::vector<const WeatherLoadCase*> weathercases_;
+};
+
+#endif  // OTLS_LINEANALYZER_TENSIONTABLE_H_
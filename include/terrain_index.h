@@ -0,0 +1,163 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_TERRAININDEX_H_
+#define OTLS_LINEANALYZER_TERRAININDEX_H_
+
+#include <cstdint>
+#include <vector>
+
+/// \par OVERVIEW
+///
+/// This struct is a ground point in alignment coordinates. The values are
+/// single precision to halve the memory of large point clouds, which keeps
+/// centimeter precision for lines that are tens of kilometers long.
+struct TerrainPoint {
+  /// \var elevation
+  ///   The elevation.
+  float elevation;
+
+  /// \var offset
+  ///   The offset from the alignment.
+  float offset;
+
+  /// \var station
+  ///   The station.
+  float station;
+};
+
+/// \par OVERVIEW
+///
+/// This class indexes ground points along an alignment in a station/offset
+/// grid.
+///
+/// \par STORAGE
+///
+/// The points are sorted by grid cell into a single array, and each cell
+/// stores where its points start. There is no per-cell allocation, so the
+/// index costs little more than the points themselves. Each cell also stores
+/// its highest point, so queries that cover whole cells don't visit their
+/// points.
+///
+/// \par QUERIES
+///
+/// Ground profiles take the highest point in each station interval, which is
+/// the controlling ground for vertical clearance. Nearest point queries
+/// search outward from a cell in rings, and stop when no unvisited ring can
+/// contain a closer point.
+class TerrainIndex {
+ public:
+  /// \brief Constructor.
+  TerrainIndex();
+
+  /// \brief Builds the index.
+  /// \param[in,out] points
+  ///   The points. These are moved into the index, and the vector is left
+  ///   empty.
+  /// \param[in] size_cell
+  ///   The grid cell size.
+  void Build(std::vector<TerrainPoint>& points, const double& size_cell);
+
+  /// \brief Clears the index.
+  void Clear();
+
+  /// \brief Finds the highest point in a station and offset range.
+  /// \param[in] station_min
+  ///   The minimum station.
+  /// \param[in] station_max
+  ///   The maximum station.
+  /// \param[in] offset_min
+  ///   The minimum offset.
+  /// \param[in] offset_max
+  ///   The maximum offset.
+  /// \param[out] point
+  ///   The highest point.
+  /// \return If any points are in the range.
+  bool Highest(const double& station_min, const double& station_max,
+               const double& offset_min, const double& offset_max,
+               TerrainPoint& point) const;
+
+  /// \brief Finds the nearest point in three dimensions.
+  /// \param[in] station
+  ///   The station.
+  /// \param[in] offset
+  ///   The offset.
+  /// \param[in] elevation
+  ///   The elevation.
+  /// \param[in] distance_max
+  ///   The maximum distance to search.
+  /// \param[out] point
+  ///   The nearest point.
+  /// \return If a point was found within the maximum distance.
+  bool Nearest(const double& station, const double& offset,
+               const double& elevation, const double& distance_max,
+               TerrainPoint& point) const;
+
+  /// \brief Gets the ground profile along the alignment.
+  /// \param[in] station_start
+  ///   The starting station.
+  /// \param[in] station_end
+  ///   The ending station.
+  /// \param[in] spacing
+  ///   The station interval of the profile.
+  /// \param[in] offset_max
+  ///   The maximum offset on either side of the alignment.
+  /// \return The highest point in each interval. Intervals without points
+  ///   are skipped.
+  std::vector<TerrainPoint> Profile(const double& station_start,
+                                    const double& station_end,
+                                    const double& spacing,
+                                    const double& offset_max) const;
+
+  /// \brief Gets the points.
+  /// \return The points, sorted by grid cell.
+  const std::vector<TerrainPoint>& points() const;
+
+ private:
+  /// \brief Gets the grid column of a station.
+  /// \param[in] station
+  ///   The station.
+  /// \return The column, which is clamped to the grid.
+  int Column(const double& station) const;
+
+  /// \brief Gets the grid row of an offset.
+  /// \param[in] offset
+  ///   The offset.
+  /// \return The row, which is clamped to the grid.
+  int Row(const double& offset) const;
+
+  /// \var cells_
+  ///   The index of the first point in each cell, with an extra entry for the
+  ///   end of the last cell. Cells are stored by column, then row.
+  std::vector<uint32_t> cells_;
+
+  /// \var count_columns_
+  ///   The number of grid columns (station direction).
+  int count_columns_;
+
+  /// \var count_rows_
+  ///   The number of grid rows (offset direction).
+  int count_rows_;
+
+  /// \var highest_
+  ///   The index of the highest point in each cell.
+  std::vector<uint32_t> highest_;
+
+  /// \var offset_min_
+  ///   The offset at the start of the first row.
+  double offset_min_;
+
+  /// \var points_
+  ///   The points, sorted by grid cell.
+  std::vector<TerrainPoint> points_;
+
+  /// \var size_cell_
+  ///   The grid cell size.
+  double size_cell_;
+
+  /// \var station_min_
+  ///   The station at the start of the first column.
+  double station_min_;
+};
+
+#endif  // OTLS_LINEANALYZER_TERRAININDEX_H_
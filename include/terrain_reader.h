@@ -0,0 +1,85 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_TERRAINREADER_H_
+#define OTLS_LINEANALYZER_TERRAINREADER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "alignment_path.h"
+#include "obstacle_layer.h"
+#include "quantity.h"
+#include "terrain_index.h"
+
+/// \par OVERVIEW
+///
+/// This class reads survey point files (ground or obstacle points), and keeps
+/// the points that are inside a corridor around an alignment.
+///
+/// \par FILE FORMATS
+///
+/// ASCII files have one point per line, with the x, y, and z coordinates
+/// separated by spaces, tabs, or commas. Obstacle files may have a fourth
+/// column with the point classification. Any other columns are ignored, as
+/// are lines that don't start with three numbers (headers and comments).
+///
+/// Binary files (*.bin) are packed little-endian 64-bit floating point
+/// values with no header. Terrain points are (x, y, z) triplets, and
+/// obstacle points are (x, y, z, classification) quadruplets.
+///
+/// The coordinates must be in the line coordinate system (see AlignmentPath).
+///
+/// \par STREAMING
+///
+/// The file is memory mapped and split into chunks that are parsed on all
+/// cores. Each point is projected onto the alignment as it is parsed, and
+/// only the points inside the corridor are kept, so memory use depends on
+/// the corridor and not the file size.
+class TerrainReader {
+ public:
+  /// \brief Reads a survey point file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] units
+  ///   The length units of the file. Points are converted to the document
+  ///   units.
+  /// \param[in] path
+  ///   The alignment path. The search distance of the path is the corridor
+  ///   half width.
+  /// \param[out] points
+  ///   The points that are inside the corridor.
+  /// \param[out] count_read
+  ///   The number of points that were read from the file.
+  /// \return 0 if no errors, -1 if file related errors, or 1 if the file has
+  ///   no points.
+  static int Read(const std::string& filepath,
+                  const quantity::Unit<quantity::Length>& units,
+                  const AlignmentPath& path,
+                  std::vector<TerrainPoint>& points,
+                  uint64_t& count_read);
+
+  /// \brief Reads an obstacle point file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] units
+  ///   The length units of the file. Points are converted to the document
+  ///   units.
+  /// \param[in] path
+  ///   The alignment path. The search distance of the path is the corridor
+  ///   half width.
+  /// \param[out] points
+  ///   The points that are inside the corridor, in plan coordinates.
+  /// \param[out] count_read
+  ///   The number of points that were read from the file.
+  /// \return 0 if no errors, -1 if file related errors, or 1 if the file has
+  ///   no points.
+  static int ReadObstacles(const std::string& filepath,
+                           const quantity::Unit<quantity::Length>& units,
+                           const AlignmentPath& path,
+                           std::vector<ObstaclePoint>& points,
+                           uint64_t& count_read);
+};
+
+#endif  // OTLS_LINEANALYZER_TERRAINREADER_H_
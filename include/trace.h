@@ -0,0 +1,126 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_TRACE_H_
+#define OTLS_LINEANALYZER_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// \par OVERVIEW
+///
+/// This class records timed spans of code execution, and exports them as a
+/// Chrome trace-event file that can be viewed in chrome://tracing or the
+/// Perfetto UI.
+///
+/// \par RECORDING
+///
+/// Spans are recorded into a fixed size ring buffer that belongs to the
+/// recording thread, so threads do not contend with each other. When a
+/// buffer is full the oldest spans are overwritten. When a thread exits its
+/// buffer is kept for exporting, and is reused by the next thread that
+/// records, so the memory is bounded by the number of live threads.
+///
+/// \par OVERHEAD
+///
+/// Recording is disabled by default. When disabled, a span only costs a
+/// relaxed atomic load, so spans can be left in hot paths.
+///
+/// \par EXPORTING
+///
+/// Recording should be stopped before exporting, so that spans are not
+/// being overwritten while the buffers are being read.
+class Tracer {
+ public:
+  /// \brief Clears all recorded spans.
+  static void Clear();
+
+  /// \brief Exports the recorded spans to a Chrome trace-event file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \return If the file is written successfully.
+  static bool Export(const std::string& filepath);
+
+  /// \brief Determines if spans are being recorded.
+  /// \return If spans are being recorded.
+  static bool IsEnabled() {
+    return is_enabled_.load(std::memory_order_relaxed);
+  }
+
+  /// \brief Records a completed span.
+  /// \param[in] name
+  ///   The span name. This must be a string literal, or otherwise outlive
+  ///   the recorded span.
+  /// \param[in] time_start
+  ///   The start time, in microseconds.
+  /// \param[in] time_end
+  ///   The end time, in microseconds.
+  static void Record(const char* name, const int64_t& time_start,
+                     const int64_t& time_end);
+
+  /// \brief Gets the memory that is allocated for the span buffers.
+  /// \return The size, in bytes.
+  static size_t SizeBuffers();
+
+  /// \brief Starts recording spans.
+  static void Start();
+
+  /// \brief Stops recording spans.
+  static void Stop();
+
+  /// \brief Gets the time since the trace clock started.
+  /// \return The time, in microseconds.
+  static int64_t TimeNow();
+
+ private:
+  /// \var is_enabled_
+  ///   An indicator that tells if spans are being recorded.
+  static std::atomic<bool> is_enabled_;
+};
+
+/// \par OVERVIEW
+///
+/// This class records a span for the lifetime of the object.
+///
+/// Use the TRACE_SCOPE macro instead of creating this class directly.
+class TraceScope {
+ public:
+  /// \brief Constructor.
+  /// \param[in] name
+  ///   The span name. This must be a string literal.
+  explicit TraceScope(const char* name) {
+    if (Tracer::IsEnabled() == true) {
+      name_ = name;
+      time_start_ = Tracer::TimeNow();
+    } else {
+      name_ = nullptr;
+    }
+  }
+
+  /// \brief Destructor.
+  ~TraceScope() {
+    if (name_ != nullptr) {
+      Tracer::Record(name_, time_start_, Tracer::TimeNow());
+    }
+  }
+
+ private:
+  /// \var name_
+  ///   The span name. This is a nullptr if recording was disabled when the
+  ///   span started.
+  const char* name_;
+
+  /// \var time_start_
+  ///   The start time, in microseconds.
+  int64_t time_start_;
+};
+
+#define OTLS_TRACE_CONCAT_INNER(a, b) a##b
+#define OTLS_TRACE_CONCAT(a, b) OTLS_TRACE_CONCAT_INNER(a, b)
+
+/// Records a span from this point until the end of the enclosing scope.
+#define TRACE_SCOPE(name) \
+    TraceScope OTLS_TRACE_CONCAT(trace_scope_, __LINE__)(name)
+
+#endif  // OTLS_LINEANALYZER_TRACE_H_
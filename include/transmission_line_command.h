@@ -30,6 +30,11 @@
 /// document on a 'do' method, while the other will be committed to the document
 /// on an 'undo' method. These nodes may not be needed for all command types,
 /// and will be kept as a nullptr if not used.
+///
+/// \par JOURNAL
+///
+/// Each change that is made to the document (by a do or an undo) is appended
+/// to the document journal.
 class TransmissionLineCommand : public wxCommand {
  public:
   /// \var kNameActivate
@@ -65,7 +70,9 @@ class TransmissionLineCommand : public wxCommand {
   /// \brief Constructor.
   /// \param[in] name
   ///   The command name, which should match one of the defined strings.
-  TransmissionLineCommand(const std::string& name);
+  /// \param[in] doc
+  ///   The document that the command modifies.
+  TransmissionLineCommand(const std::string& name, LineAnalyzerDoc* doc);
 
   /// \brief Destructor.
   virtual ~TransmissionLineCommand();
@@ -92,6 +99,10 @@ class TransmissionLineCommand : public wxCommand {
   /// \return The transmission line xml node.
   const wxXmlNode* node_transmission_line() const;
 
+  /// \brief Gets the transmission line xml node that is used for undo.
+  /// \return The transmission line xml node that is used for undo.
+  const wxXmlNode* node_undo() const;
+
   /// \brief Sets the index.
   /// \param[in] index
   ///   The index.
@@ -0,0 +1,101 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_UNITCONVERSIONPLAN_H_
+#define OTLS_LINEANALYZER_UNITCONVERSIONPLAN_H_
+
+#include <list>
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/weather_load_case.h"
+
+#include "quantity.h"
+
+/// \par OVERVIEW
+///
+/// This class converts many values between units in a single pass.
+///
+/// \par PLANNING
+///
+/// Values are added to the plan with their typed units, and are grouped by
+/// conversion factor. Adding values doesn't modify them, so a plan can be
+/// built while objects are still being parsed.
+///
+/// \par EXECUTION
+///
+/// Each group is converted with a tight loop that applies one scale and
+/// offset to every value in the group. There is no per-field dispatch on the
+/// unit system or unit style like the object converters have.
+///
+/// \par UNIT STYLE
+///
+/// Plans convert between unit systems. The values must be in the consistent
+/// unit style.
+class UnitConversionPlan {
+ public:
+  /// \brief Constructor.
+  UnitConversionPlan();
+
+  /// \brief Adds a value to convert.
+  /// \param[in] unit_from
+  ///   The unit to convert from.
+  /// \param[in] unit_to
+  ///   The unit to convert to.
+  /// \param[in,out] value
+  ///   The value, which must stay valid until the plan is executed.
+  template<typename Dimension>
+  void Add(const quantity::Unit<Dimension>& unit_from,
+           const quantity::Unit<Dimension>& unit_to,
+           double& value) {
+    Group(quantity::FactorBetween(unit_from, unit_to)).push_back(&value);
+  }
+
+  /// \brief Adds weathercases to convert between unit systems.
+  /// \param[in] system_from
+  ///   The unit system to convert from.
+  /// \param[in] system_to
+  ///   The unit system to convert to.
+  /// \param[in,out] weathercases
+  ///   The weathercases, which must stay valid until the plan is executed.
+  void AddWeathercases(const units::UnitSystem& system_from,
+                       const units::UnitSystem& system_to,
+                       std::list<WeatherLoadCase>& weathercases);
+
+  /// \brief Clears all values from the plan.
+  void Clear();
+
+  /// \brief Converts all values in the plan.
+  /// A plan should only be executed once, as values are converted in place.
+  void Execute() const;
+
+  /// \brief Gets the number of values in the plan.
+  /// \return The number of values in the plan.
+  size_t Size() const;
+
+ private:
+  /// \par OVERVIEW
+  ///
+  /// This struct is a set of values that share a conversion factor.
+  struct FactorGroup {
+    /// \var factor
+    ///   The conversion factor.
+    quantity::Factor factor;
+
+    /// \var values
+    ///   The values to convert.
+    std::vector<double*> values;
+  };
+
+  /// \brief Gets the values for a conversion factor.
+  /// \param[in] factor
+  ///   The conversion factor.
+  /// \return The values that use the factor. A group is created if needed.
+  std::vector<double*>& Group(const quantity::Factor& factor);
+
+  /// \var groups_
+  ///   The values, grouped by conversion factor.
+  std::vector<FactorGroup> groups_;
+};
+
+#endif  // OTLS_LINEANALYZER_UNITCONVERSIONPLAN_H_
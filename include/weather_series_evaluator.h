@@ -0,0 +1,61 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_WEATHERSERIESEVALUATOR_H_
+#define OTLS_LINEANALYZER_WEATHERSERIESEVALUATOR_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "models/base/units.h"
+#include "models/transmissionline/transmission_line.h"
+
+#include "weather_series_reader.h"
+
+/// \par OVERVIEW
+///
+/// This class evaluates the ruling span tension and sag of every line cable
+/// for every row of a weather time series, and exports them to a csv file.
+///
+/// \par BATCHING
+///
+/// Rows are read and evaluated a block at a time, and each block is written
+/// before the next is read, so memory use doesn't depend on the series
+/// length. Measured weather repeats often (i.e. calm hours at the same
+/// temperature), so the rows of a block are reduced to their unique weather
+/// states, which are solved in parallel and then scattered back to the rows.
+///
+/// \par OUTPUT
+///
+/// The file has a row per record, starting with the time stamp, and a
+/// tension and sag column for every line cable and condition. Solutions
+/// that fail are left blank. Sags are at the midspan of the stored line cable
+/// ruling span, which the tensions are solved with, in the plane of the
+/// loaded cable.
+class WeatherSeriesEvaluator {
+ public:
+  /// \brief Evaluates a weather series.
+  /// \param[in] line
+  ///   The transmission line.
+  /// \param[in] conditions
+  ///   The cable conditions.
+  /// \param[in,out] reader
+  ///   The open weather series reader, which is read to the end.
+  /// \param[in] filepath
+  ///   The csv file to write.
+  /// \param[in] units
+  ///   The unit system to export in.
+  /// \param[out] count_rows
+  ///   The number of rows that were evaluated.
+  /// \return 0 if no errors, -1 if file related errors, or 1 if the series
+  ///   has no rows.
+  static int Evaluate(const TransmissionLine& line,
+                      const std::vector<CableConditionType>& conditions,
+                      WeatherSeriesReader& reader,
+                      const std::string& filepath,
+                      const units::UnitSystem& units,
+                      uint64_t& count_rows);
+};
+
+#endif  // OTLS_LINEANALYZER_WEATHERSERIESEVALUATOR_H_
@@ -0,0 +1,114 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_WEATHERSERIESREADER_H_
+#define OTLS_LINEANALYZER_WEATHERSERIESREADER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "models/base/units.h"
+
+#include "mapped_file.h"
+#include "quantity.h"
+
+/// \par OVERVIEW
+///
+/// This struct is a measured weather record.
+struct WeatherSeriesRow {
+  /// \var pressure_wind
+  ///   The wind pressure.
+  double pressure_wind;
+
+  /// \var temperature
+  ///   The cable temperature.
+  double temperature;
+
+  /// \var thickness_ice
+  ///   The radial ice thickness.
+  double thickness_ice;
+
+  /// \var time
+  ///   The time stamp, as written in the file.
+  std::string time;
+};
+
+/// \par OVERVIEW
+///
+/// This class reads a weather time series from a csv file, a block of rows
+/// at a time.
+///
+/// \par FILE FORMAT
+///
+/// Each line is a record of four comma separated values:
+///   time, temperature, wind pressure, ice thickness
+/// The time stamp is kept as text. Lines that don't parse (i.e. headers) are
+/// skipped and counted.
+///
+/// \par UNITS
+///
+/// Imperial files are in degrees Fahrenheit, pounds per square foot, and
+/// inches. Metric files are in degrees Celsius, pascals, and centimeters.
+/// Rows are converted to the document units.
+///
+/// \par STREAMING
+///
+/// The file is memory mapped and read sequentially, so only the current
+/// block of rows is held in memory, regardless of the series length.
+class WeatherSeriesReader {
+ public:
+  /// \brief Constructor.
+  WeatherSeriesReader();
+
+  /// \brief Closes the file.
+  void Close();
+
+  /// \brief Opens a file.
+  /// \param[in] filepath
+  ///   The file path.
+  /// \param[in] units
+  ///   The unit system of the file.
+  /// \return If the file was opened.
+  bool Open(const std::string& filepath, const units::UnitSystem& units);
+
+  /// \brief Reads the next block of rows.
+  /// \param[in] count_max
+  ///   The most rows to read.
+  /// \param[out] rows
+  ///   The rows. The vector is resized to the number of rows read, and is
+  ///   meant to be reused between calls.
+  /// \return The number of rows read, which is zero at the end of the file.
+  int Read(const int& count_max, std::vector<WeatherSeriesRow>& rows);
+
+  /// \brief Gets the number of lines that were skipped.
+  /// \return The number of lines that were skipped.
+  uint64_t count_skipped() const;
+
+ private:
+  /// \var count_skipped_
+  ///   The number of lines that were skipped.
+  uint64_t count_skipped_;
+
+  /// \var factor_length_
+  ///   The conversion from the file ice thickness units.
+  quantity::Factor factor_length_;
+
+  /// \var factor_pressure_
+  ///   The conversion from the file wind pressure units.
+  quantity::Factor factor_pressure_;
+
+  /// \var factor_temperature_
+  ///   The conversion from the file temperature units.
+  quantity::Factor factor_temperature_;
+
+  /// \var file_
+  ///   The mapped file.
+  MappedFile file_;
+
+  /// \var position_
+  ///   The position of the next line in the file.
+  size_t position_;
+};
+
+#endif  // OTLS_LINEANALYZER_WEATHERSERIESREADER_H_
@@ -0,0 +1,33 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#ifndef OTLS_LINEANALYZER_XRCLOADER_H_
+#define OTLS_LINEANALYZER_XRCLOADER_H_
+
+/// \par OVERVIEW
+///
+/// This class loads the xrc resources that are compiled into the application,
+/// one resource file at a time, the first time each one is needed.
+///
+/// \par LAZY LOADING
+///
+/// Each xrc file is compiled by the wxWidgets resource compiler into its own
+/// init function. Loading a resource adds it to the virtual file system and
+/// parses the xml, and only the xml handlers for the controls in that
+/// resource are registered. This keeps resources that aren't needed to show
+/// the main frame (dialogs) off of the startup path.
+///
+/// \par THREADING
+///
+/// The wxWidgets xrc system is not thread-safe, so these functions must only
+/// be called from the main thread.
+class XrcLoader {
+ public:
+  /// \brief Loads the main frame menubar resource.
+  static void LoadMenuBar();
+
+  /// \brief Loads the preferences dialog resource.
+  static void LoadPreferencesDialog();
+};
+
+#endif  // OTLS_LINEANALYZER_XRCLOADER_H_
@@ -0,0 +1,192 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "alignment_path.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+/// The number of grid cells around a segment sample that the segment is
+/// registered in. The cell size is the search distance, so this covers the
+/// search distance plus the spacing between samples.
+const int kCountCellsSearch = 2;
+
+/// The ratio of degrees to radians.
+const double kRadiansPerDegree = 3.14159265358979323846 / 180;
+
+}  // namespace
+
+AlignmentPath::AlignmentPath() {
+  distance_search_ = 0;
+}
+
+bool AlignmentPath::Build(const std::list<AlignmentPoint>& points,
+                          const double& distance_search) {
+  segments_.clear();
+  grid_.Clear(std::max(distance_search, 1.0));
+
+  if (points.size() < 2) {
+    return false;
+  }
+
+  distance_search_ = distance_search;
+
+  // walks the alignment points, turning at each point
+  double angle = 0;
+  double x = 0;
+  double y = 0;
+  auto iter = points.cbegin();
+  for (auto iter_next = std::next(iter); iter_next != points.cend();
+       iter++, iter_next++) {
+    const AlignmentPoint& point = *iter;
+    const AlignmentPoint& point_next = *iter_next;
+
+    if (iter != points.cbegin()) {
+      angle += point.rotation * kRadiansPerDegree;
+    }
+
+    Segment segment;
+    segment.direction_x = std::cos(angle);
+    segment.direction_y = std::sin(angle);
+    segment.elevation_end = point_next.elevation;
+    segment.elevation_start = point.elevation;
+    segment.length = point_next.station - point.station;
+    segment.station = point.station;
+    segment.x = x;
+    segment.y = y;
+    segments_.push_back(segment);
+
+    x += segment.direction_x * segment.length;
+    y += segment.direction_y * segment.length;
+  }
+
+  // registers each segment in the grid cells around points sampled along it
+  for (int index = 0; index < (int)segments_.size(); index++) {
+    const Segment& segment = segments_[index];
+    grid_.Add(segment.x, segment.y,
+              segment.x + segment.direction_x * segment.length,
+              segment.y + segment.direction_y * segment.length,
+              kCountCellsSearch, index);
+  }
+
+  return true;
+}
+
+void AlignmentPath::Direction(const double& station,
+                              double& x, double& y) const {
+  if (segments_.empty() == true) {
+    x = 1;
+    y = 0;
+    return;
+  }
+
+  const Segment& segment = segments_[IndexSegment(station)];
+  x = segment.direction_x;
+  y = segment.direction_y;
+}
+
+double AlignmentPath::Elevation(const double& station) const {
+  if (segments_.empty() == true) {
+    return 0;
+  }
+
+  const Segment& segment = segments_[IndexSegment(station)];
+  if (segment.length <= 0) {
+    return segment.elevation_start;
+  }
+
+  double fraction = (station - segment.station) / segment.length;
+  fraction = std::min(std::max(fraction, 0.0), 1.0);
+  return segment.elevation_start
+         + fraction * (segment.elevation_end - segment.elevation_start);
+}
+
+void AlignmentPath::PointXy(const double& station, const double& offset,
+                            double& x, double& y) const {
+  if (segments_.empty() == true) {
+    x = 0;
+    y = offset;
+    return;
+  }
+
+  const Segment& segment = segments_[IndexSegment(station)];
+  const double distance = station - segment.station;
+  x = segment.x + distance * segment.direction_x
+      - offset * segment.direction_y;
+  y = segment.y + distance * segment.direction_y
+      + offset * segment.direction_x;
+}
+
+bool AlignmentPath::Project(const double& x, const double& y,
+                            double& station, double& offset) const {
+  const std::vector<int>* indexes = grid_.Find(x, y);
+  if (indexes == nullptr) {
+    return false;
+  }
+
+  // finds the nearest segment
+  double distance_best = distance_search_;
+  bool is_found = false;
+  for (auto it = indexes->cbegin(); it != indexes->cend(); it++) {
+    const int index = *it;
+    const Segment& segment = segments_[index];
+
+    const double dx = x - segment.x;
+    const double dy = y - segment.y;
+    const double along = dx * segment.direction_x + dy * segment.direction_y;
+
+    // points beyond the path ends aren't projected
+    if (((index == 0) && (along < 0))
+        || ((index == (int)segments_.size() - 1)
+            && (segment.length < along))) {
+      continue;
+    }
+
+    const double along_clamped = std::min(std::max(along, 0.0),
+                                          segment.length);
+    const double across = dy * segment.direction_x - dx * segment.direction_y;
+    const double distance = std::hypot(along - along_clamped, across);
+    if (distance <= distance_best) {
+      distance_best = distance;
+      station = segment.station + along_clamped;
+      offset = across < 0 ? -distance : distance;
+      is_found = true;
+    }
+  }
+
+  return is_found;
+}
+
+double AlignmentPath::station_end() const {
+  if (segments_.empty() == true) {
+    return 0;
+  }
+
+  const Segment& segment = segments_.back();
+  return segment.station + segment.length;
+}
+
+double AlignmentPath::station_start() const {
+  if (segments_.empty() == true) {
+    return 0;
+  }
+
+  return segments_.front().station;
+}
+
+int AlignmentPath::IndexSegment(const double& station) const {
+  // finds the last segment that starts at or before the station
+  auto iter = std::upper_bound(
+      segments_.cbegin(), segments_.cend(), station,
+      [](const double& value, const Segment& segment) {
+        return value < segment.station;
+      });
+  if (iter == segments_.cbegin()) {
+    return 0;
+  }
+
+  return (int)(std::distance(segments_.cbegin(), iter) - 1);
+}
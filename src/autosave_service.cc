@@ -0,0 +1,218 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "autosave_service.h"
+
+#include <algorithm>
+
+#include "wx/filename.h"
+#include "wx/stdpaths.h"
+
+#include "core_hooks.h"
+#include "trace.h"
+
+namespace {
+
+/// The number of changes that starts an autosave without waiting for the
+/// interval.
+const int kCountChanges = 20;
+
+}  // namespace
+
+BEGIN_EVENT_TABLE(AutosaveService, wxEvtHandler)
+  EVT_TIMER(wxID_ANY, AutosaveService::OnTimer)
+END_EVENT_TABLE()
+
+AutosaveService::AutosaveService(const LineAnalyzerConfig* config)
+    : timer_(this) {
+  config_ = config;
+  count_saved_ = 0;
+  doc_ = nullptr;
+  id_ = 0;
+  is_written_ = false;
+  time_allowed_ = 0;
+  time_changed_ = 0;
+  time_start_ = 0;
+}
+
+AutosaveService::~AutosaveService() {
+  timer_.Stop();
+
+  // the application is exiting, and any document was closed or saved by the
+  // user
+  RemoveFile();
+}
+
+std::string AutosaveService::FilePath(const LineAnalyzerDoc& doc) {
+  wxFileName path;
+  if (doc.GetFilename().empty() == false) {
+    path = doc.GetFilename();
+  } else {
+    path.AssignDir(wxStandardPaths::Get().GetTempDir());
+    path.SetName(doc.GetUserReadableName());
+  }
+
+  path.SetName(path.GetName() + ".autosave");
+  path.SetExt("lineanalyzer");
+
+  return path.GetFullPath().ToStdString();
+}
+
+void AutosaveService::OnIdle(LineAnalyzerDoc* doc) {
+  if (doc != doc_) {
+    Reset(doc);
+  }
+
+  if ((doc_ == nullptr) || (doc_->IsSaving() == true)
+      || (config_->autosave_interval <= 0)) {
+    return;
+  }
+
+  // the document was saved or reverted, so the recovery file isn't needed
+  if (doc_->IsModified() == false) {
+    RemoveFile();
+    count_saved_ = doc_->count_changes();
+    time_changed_ = 0;
+    return;
+  }
+
+  const int count_unsaved = doc_->count_changes() - count_saved_;
+  if (count_unsaved <= 0) {
+    return;
+  }
+
+  const wxLongLong time_now = wxGetLocalTimeMillis();
+  if (time_changed_ == 0) {
+    time_changed_ = time_now;
+  }
+
+  // determines when the autosave is due
+  // the budget can delay the autosave past the due time
+  wxLongLong time_due = time_now;
+  if (count_unsaved < kCountChanges) {
+    time_due = time_changed_ + (wxLongLong)config_->autosave_interval * 1000;
+  }
+  time_due = std::max(time_due, time_allowed_);
+
+  if (time_now < time_due) {
+    // idle events stop when the user stops, so the timer wakes them up
+    if (timer_.IsRunning() == false) {
+      timer_.StartOnce((time_due - time_now).ToLong());
+    }
+  } else {
+    BeginSave();
+  }
+}
+
+void AutosaveService::BeginSave() {
+  TRACE_SCOPE("AutosaveService::BeginSave");
+
+  timer_.Stop();
+
+  // removes the previous recovery file if the document was renamed
+  const std::string filepath = FilePath(*doc_);
+  if (filepath != filepath_) {
+    RemoveFile();
+    filepath_ = filepath;
+  }
+
+  time_start_ = wxGetLocalTimeMillis();
+
+  const int count_changes = doc_->count_changes();
+  const int id = id_;
+  const bool is_started = doc_->SaveSnapshotInBackground(
+      filepath_, [this, count_changes, id](const bool& status) {
+        EndSave(status, count_changes, id);
+      });
+  if (is_started == true) {
+    is_written_ = true;
+  }
+}
+
+void AutosaveService::EndSave(const bool& status, const int& count_changes,
+                              const int& id) {
+  // ignores saves for a previous document
+  if (id != id_) {
+    return;
+  }
+
+  // delays the next autosave so that saves stay within the budget
+  const wxLongLong time_now = wxGetLocalTimeMillis();
+  const double duration = (time_now - time_start_).ToDouble();
+  const double budget =
+      std::min(std::max(config_->autosave_budget, 0.01), 1.0);
+  time_allowed_ = time_start_ + wxLongLong((wxLongLong_t)(duration / budget));
+
+  if (config_->autosave_interval * 1000 < (time_allowed_ - time_now)) {
+    wxLogVerbose("Autosave took %.0f ms. Delaying the next autosave.",
+                 duration);
+  }
+
+  if (status == false) {
+    wxLogWarning("Autosave file (%s) could not be written.", filepath_);
+    return;
+  }
+
+  // changes made while the file was written start a new interval
+  count_saved_ = count_changes;
+  if (count_saved_ < doc_->count_changes()) {
+    time_changed_ = time_now;
+  } else {
+    time_changed_ = 0;
+  }
+}
+
+void AutosaveService::OnTimer(wxTimerEvent& event) {
+  wxWakeUpIdle();
+}
+
+void AutosaveService::RemoveFile() {
+  if (is_written_ == false) {
+    return;
+  }
+
+  if (wxFileName::FileExists(filepath_) == true) {
+    wxRemoveFile(filepath_);
+  }
+
+  is_written_ = false;
+}
+
+void AutosaveService::Reset(LineAnalyzerDoc* doc) {
+  timer_.Stop();
+
+  // the previous document was closed
+  RemoveFile();
+
+  doc_ = doc;
+  id_++;
+  filepath_ = "";
+  time_allowed_ = 0;
+  time_changed_ = 0;
+
+  if (doc_ == nullptr) {
+    count_saved_ = 0;
+    return;
+  }
+
+  count_saved_ = doc_->count_changes();
+
+  // warns if a recovery file was left by a crash
+  // the recovery file isn't removed until the user decides what to do with it
+  const std::string filepath = FilePath(*doc_);
+  if (wxFileName::FileExists(filepath) == false) {
+    return;
+  }
+
+  const bool is_untitled = doc_->GetFilename().empty();
+  if ((is_untitled == false)
+      && (wxFileName(filepath).GetModificationTime()
+          < wxFileName(doc_->GetFilename()).GetModificationTime())) {
+    return;
+  }
+
+  const wxString message = "An autosave file (" + filepath + ") was found. "
+                           "It may contain changes that weren't saved.";
+  wxLogWarning(message);
+  CoreHooks::Get()->ShowMessage(message.ToStdString());
+}
@@ -0,0 +1,434 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "benchmark_runner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "wx/datetime.h"
+#include "wx/ffile.h"
+#include "wx/log.h"
+#include "wx/stopwatch.h"
+#include "wx/thread.h"
+#include "wx/utils.h"
+
+namespace {
+
+/// The factor that scales the MAD to an estimate of the standard deviation
+/// for normally distributed samples.
+const double kFactorMad = 1.4826;
+
+/// The number of standard deviations a slowdown must exceed to not be
+/// treated as noise.
+const double kFactorNoise = 3.0;
+
+/// \brief Appends a quoted json string.
+/// \param[in] str
+///   The string.
+/// \param[out] out
+///   The string to append to.
+void AppendJsonString(const std::string& str, std::string& out) {
+  out += '"';
+  for (auto iter = str.cbegin(); iter != str.cend(); iter++) {
+    if ((*iter == '"') || (*iter == '\\')) {
+      out += '\\';
+    }
+    out += *iter;
+  }
+  out += '"';
+}
+
+/// \brief Gets a description of the compiler and build configuration.
+/// \return The description.
+std::string DescribeBuild() {
+  char buffer[128];
+#if defined(_MSC_VER)
+  std::snprintf(buffer, sizeof(buffer), "msvc %d", _MSC_VER);
+#elif defined(__VERSION__)
+  std::snprintf(buffer, sizeof(buffer), "%s", __VERSION__);
+#else
+  std::snprintf(buffer, sizeof(buffer), "unknown");
+#endif
+
+  std::string str = buffer;
+#ifdef NDEBUG
+  str += ", release";
+#else
+  str += ", debug";
+#endif
+
+  return str;
+}
+
+/// \brief Gets the median of sorted values.
+/// \param[in] values
+///   The sorted values.
+/// \return The median.
+double Median(const std::vector<double>& values) {
+  const size_t size = values.size();
+  if (size % 2 == 1) {
+    return values.at(size / 2);
+  } else {
+    return (values.at(size / 2 - 1) + values.at(size / 2)) / 2;
+  }
+}
+
+/// \par OVERVIEW
+///
+/// This class parses the flat JSON objects in a baseline file.
+///
+/// Only the subset of JSON that SaveBaseline() writes is supported: an array
+/// of objects whose values are strings or numbers. The machine and settings
+/// that follow the array are not read.
+class BaselineParser {
+ public:
+  /// \brief Constructor.
+  /// \param[in] str
+  ///   The JSON text.
+  explicit BaselineParser(const std::string& str) : str_(str), pos_(0) {}
+
+  /// \brief Parses the results.
+  /// \param[out] results
+  ///   The results that are populated.
+  /// \return If the text was parsed successfully.
+  bool Parse(std::list<BenchmarkResult>& results) {
+    // moves to the benchmark array
+    pos_ = str_.find("\"benchmarks\"");
+    if (pos_ == std::string::npos) {
+      return false;
+    }
+    pos_ = str_.find('[', pos_);
+    if (pos_ == std::string::npos) {
+      return false;
+    }
+    pos_++;
+
+    // parses objects until the end of the array
+    while (true) {
+      SkipWhitespace();
+      if (Peek() == ']') {
+        return true;
+      } else if (Peek() == ',') {
+        pos_++;
+        continue;
+      } else if (Peek() != '{') {
+        return false;
+      }
+
+      BenchmarkResult result;
+      result.mad = 0;
+      result.max = 0;
+      result.median = 0;
+      result.min = 0;
+      result.samples = 0;
+      if (ParseObject(result) == false) {
+        return false;
+      }
+      results.push_back(result);
+    }
+  }
+
+ private:
+  /// \brief Parses an object into a result.
+  /// \param[out] result
+  ///   The result.
+  /// \return If the object was parsed successfully.
+  bool ParseObject(BenchmarkResult& result) {
+    // skips the opening brace
+    pos_++;
+
+    while (true) {
+      SkipWhitespace();
+      if (Peek() == '}') {
+        pos_++;
+        return true;
+      } else if (Peek() == ',') {
+        pos_++;
+        continue;
+      }
+
+      std::string key;
+      if (ParseString(key) == false) {
+        return false;
+      }
+
+      SkipWhitespace();
+      if (Peek() != ':') {
+        return false;
+      }
+      pos_++;
+      SkipWhitespace();
+
+      if (key == "name") {
+        if (ParseString(result.name) == false) {
+          return false;
+        }
+        continue;
+      }
+
+      double value = 0;
+      if (ParseNumber(value) == false) {
+        return false;
+      }
+
+      if (key == "mad") {
+        result.mad = value;
+      } else if (key == "max") {
+        result.max = value;
+      } else if (key == "median") {
+        result.median = value;
+      } else if (key == "min") {
+        result.min = value;
+      } else if (key == "samples") {
+        result.samples = (int)value;
+      }
+    }
+  }
+
+  /// \brief Parses a number.
+  /// \param[out] value
+  ///   The number.
+  /// \return If a number was parsed.
+  bool ParseNumber(double& value) {
+    const char* begin = str_.c_str() + pos_;
+    char* end = nullptr;
+    value = std::strtod(begin, &end);
+    if (end == begin) {
+      return false;
+    }
+
+    pos_ += end - begin;
+    return true;
+  }
+
+  /// \brief Parses a string.
+  /// \param[out] value
+  ///   The string.
+  /// \return If a string was parsed.
+  bool ParseString(std::string& value) {
+    if (Peek() != '"') {
+      return false;
+    }
+
+    const size_t pos_end = str_.find('"', pos_ + 1);
+    if (pos_end == std::string::npos) {
+      return false;
+    }
+
+    value = str_.substr(pos_ + 1, pos_end - pos_ - 1);
+    pos_ = pos_end + 1;
+    return true;
+  }
+
+  /// \brief Gets the current character.
+  /// \return The current character, or a null character at the end of the
+  ///   text.
+  char Peek() const {
+    if (pos_ < str_.size()) {
+      return str_[pos_];
+    } else {
+      return '\0';
+    }
+  }
+
+  /// \brief Advances past any whitespace.
+  void SkipWhitespace() {
+    while ((pos_ < str_.size())
+           && ((str_[pos_] == ' ') || (str_[pos_] == '\n')
+               || (str_[pos_] == '\r') || (str_[pos_] == '\t'))) {
+      pos_++;
+    }
+  }
+
+  /// \var str_
+  ///   The JSON text.
+  const std::string& str_;
+
+  /// \var pos_
+  ///   The current position in the text.
+  size_t pos_;
+};
+
+}  // namespace
+
+BenchmarkRunner::BenchmarkRunner(const int& samples) {
+  samples_ = std::max(samples, 1);
+}
+
+int BenchmarkRunner::Compare(const std::list<BenchmarkResult>& baseline,
+                             const double& threshold) const {
+  int count_regressions = 0;
+
+  wxPrintf("\n%-28s %12s %12s %9s  %s\n", "benchmark", "base (ms)",
+           "new (ms)", "change", "status");
+
+  for (auto iter = results_.cbegin(); iter != results_.cend(); iter++) {
+    const BenchmarkResult& result = *iter;
+
+    // searches the baseline for a match
+    auto iter_base = std::find_if(
+        baseline.cbegin(), baseline.cend(),
+        [&result](const BenchmarkResult& base) {
+          return base.name == result.name;
+        });
+    if (iter_base == baseline.cend()) {
+      wxPrintf("%-28s %12s %12.3f %9s  %s\n", result.name, "-",
+               result.median, "-", "new");
+      continue;
+    }
+    const BenchmarkResult& base = *iter_base;
+
+    // determines the change and the noise floor of both runs
+    const double delta = result.median - base.median;
+    double change = 0;
+    if (0 < base.median) {
+      change = delta / base.median;
+    }
+    const double noise = kFactorNoise * kFactorMad * (base.mad + result.mad);
+
+    std::string status;
+    if ((threshold < change) && (noise < delta)) {
+      status = "SLOWER";
+      count_regressions++;
+    } else if ((change < -threshold) && (noise < -delta)) {
+      status = "faster";
+    } else {
+      status = "ok";
+    }
+
+    wxPrintf("%-28s %12.3f %12.3f %+8.1f%%  %s\n", result.name, base.median,
+             result.median, change * 100, status);
+  }
+
+  return count_regressions;
+}
+
+int BenchmarkRunner::LoadBaseline(const std::string& filepath,
+                                  std::list<BenchmarkResult>& results) {
+  results.clear();
+
+  wxFFile file(filepath, "r");
+  if (file.IsOpened() == false) {
+    wxLogError("Baseline file (%s) could not be opened.", filepath);
+    return -1;
+  }
+
+  wxString str;
+  if (file.ReadAll(&str) == false) {
+    wxLogError("Baseline file (%s) could not be read.", filepath);
+    return -1;
+  }
+
+  const std::string text = str.ToStdString();
+  BaselineParser parser(text);
+  if (parser.Parse(results) == false) {
+    wxLogError("Baseline file (%s) contains invalid JSON.", filepath);
+    return 1;
+  }
+
+  return 0;
+}
+
+void BenchmarkRunner::Run(const std::string& name,
+                          const std::function<void()>& func) {
+  // runs once untimed to warm caches
+  func();
+
+  std::vector<double> times;
+  times.reserve(samples_);
+  for (int i = 0; i < samples_; i++) {
+    wxStopWatch watch;
+    func();
+    times.push_back(watch.TimeInMicro().ToDouble() / 1000);
+  }
+
+  // calculates statistics
+  std::sort(times.begin(), times.end());
+
+  BenchmarkResult result;
+  result.name = name;
+  result.samples = samples_;
+  result.min = times.front();
+  result.max = times.back();
+  result.median = Median(times);
+
+  std::vector<double> deviations;
+  deviations.reserve(times.size());
+  for (auto iter = times.cbegin(); iter != times.cend(); iter++) {
+    deviations.push_back(std::fabs(*iter - result.median));
+  }
+  std::sort(deviations.begin(), deviations.end());
+  result.mad = Median(deviations);
+
+  results_.push_back(result);
+
+  wxPrintf("%-28s %8d %12.3f %12.3f %12.3f %12.3f\n", result.name,
+           result.samples, result.min, result.median, result.mad,
+           result.max);
+}
+
+bool BenchmarkRunner::SaveBaseline(
+    const std::string& filepath,
+    const std::string& filepath_document) const {
+  std::string str = "{\n  \"benchmarks\": [";
+
+  char buffer[512];
+  for (auto iter = results_.cbegin(); iter != results_.cend(); iter++) {
+    const BenchmarkResult& result = *iter;
+    if (iter != results_.cbegin()) {
+      str += ",";
+    }
+
+    std::snprintf(buffer, sizeof(buffer),
+                  "\n    {\"name\": \"%s\", \"samples\": %d, \"min\": %.6f, "
+                  "\"median\": %.6f, \"mad\": %.6f, \"max\": %.6f}",
+                  result.name.c_str(), result.samples, result.min,
+                  result.median, result.mad, result.max);
+    str += buffer;
+  }
+
+  str += "\n  ],";
+
+  // records where the timings came from, as they are only comparable on the
+  // same machine and build
+  str += "\n  \"machine\": {\"host\": ";
+  AppendJsonString(wxGetHostName().ToStdString(), str);
+  str += ", \"os\": ";
+  AppendJsonString(wxGetOsDescription().ToStdString(), str);
+  std::snprintf(buffer, sizeof(buffer), ", \"cpus\": %d, \"build\": ",
+                wxThread::GetCPUCount());
+  str += buffer;
+  AppendJsonString(DescribeBuild(), str);
+  str += "},";
+
+  str += "\n  \"settings\": {\"date\": ";
+  AppendJsonString(wxDateTime::Now().FormatISOCombined(' ').ToStdString(),
+                   str);
+  str += ", \"document\": ";
+  AppendJsonString(filepath_document, str);
+  std::snprintf(buffer, sizeof(buffer), ", \"samples\": %d}", samples_);
+  str += buffer;
+
+  str += "\n}\n";
+
+  wxFFile file(filepath, "w");
+  if (file.IsOpened() == false) {
+    wxLogError("Baseline file (%s) could not be opened.", filepath);
+    return false;
+  }
+
+  if (file.Write(str.c_str(), str.size()) != str.size()) {
+    wxLogError("Baseline file (%s) could not be written.", filepath);
+    return false;
+  }
+
+  return file.Close();
+}
+
+const std::list<BenchmarkResult>& BenchmarkRunner::results() const {
+  return results_;
+}
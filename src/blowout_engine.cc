@@ -0,0 +1,491 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "blowout_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "csv_writer.h"
+#include "parallel.h"
+#include "span_catenary.h"
+#include "trace.h"
+
+namespace {
+
+/// \par OVERVIEW
+///
+/// This struct is the load that a span applies to its ends for a case,
+/// split into transverse and vertical components.
+struct EndLoads {
+  /// \var transverse_ahead
+  ///   The transverse load at the ahead end.
+  double transverse_ahead;
+
+  /// \var transverse_back
+  ///   The transverse load at the back end.
+  double transverse_back;
+
+  /// \var vertical_ahead
+  ///   The vertical load at the ahead end.
+  double vertical_ahead;
+
+  /// \var vertical_back
+  ///   The vertical load at the back end.
+  double vertical_back;
+};
+
+/// \brief Gets the displacement of a cable end from hardware swing.
+/// \param[in] hardware
+///   The suspension hardware, or a nullptr if the end is held rigidly.
+/// \param[in] pressure_wind
+///   The wind pressure.
+/// \param[in] load_transverse
+///   The transverse load from the spans at the hardware.
+/// \param[in] load_vertical
+///   The vertical load from the spans at the hardware.
+/// \param[out] displacement
+///   The horizontal displacement in the wind direction.
+/// \param[out] lift
+///   The vertical rise.
+void SwingHardware(const Hardware* hardware, const double& pressure_wind,
+                   const double& load_transverse,
+                   const double& load_vertical,
+                   double& displacement, double& lift) {
+  displacement = 0;
+  lift = 0;
+  if (hardware == nullptr) {
+    return;
+  }
+
+  // the hardware wind and weight act at its midpoint
+  const double transverse = load_transverse
+                            + pressure_wind * hardware->area_cross_section / 2;
+  const double vertical = load_vertical + hardware->weight / 2;
+  const double angle = std::atan2(transverse, vertical);
+
+  displacement = hardware->length * std::sin(angle);
+  lift = hardware->length * (1 - std::cos(angle));
+}
+
+/// \brief Determines if two spans share a cable end.
+/// \param[in] span_back
+///   The back-station span.
+/// \param[in] span_ahead
+///   The ahead-station span.
+/// \return If the ahead end of the back span is the back end of the ahead
+///   span.
+bool IsContinuous(const LineSpan& span_back, const LineSpan& span_ahead) {
+  return (span_back.index_line_cable == span_ahead.index_line_cable)
+         && (span_back.index_structure_ahead
+             == span_ahead.index_structure_back)
+         && (span_back.index_attachment_ahead
+             == span_ahead.index_attachment_back);
+}
+
+}  // namespace
+
+BlowoutEngine::BlowoutEngine() {
+}
+
+void BlowoutEngine::Build(const std::vector<LineSpan>& spans,
+                          const TensionTable& tensions,
+                          const double& spacing) {
+  TRACE_SCOPE("BlowoutEngine::Build");
+
+  spans_ = spans;
+
+  const int count_spans = (int)spans_.size();
+  const int count_conditions = (int)tensions.conditions().size();
+  const int count_cases = (int)tensions.weathercases().size()
+                          * count_conditions;
+  envelopes_.assign(count_spans, BlowoutEnvelope());
+
+  // solves the end loads of every span and case first, so hardware swing
+  // can combine the loads from both spans at a structure
+  std::vector<EndLoads> loads(count_spans * count_cases);
+  Parallel::For(count_spans, [&](const int& index_span, const int& thread) {
+    const LineSpan& span = spans_[index_span];
+    const Cable* cable = span.line_cable->cable();
+
+    SpanCatenary catenary;
+    for (int index_case = 0; index_case < count_cases; index_case++) {
+      EndLoads& load = loads[index_span * count_cases + index_case];
+      load = EndLoads{0, 0, 0, 0};
+      if (cable == nullptr) {
+        continue;
+      }
+
+      const int index_weathercase = index_case / count_conditions;
+      double weight_transverse = 0;
+      double weight_vertical = 0;
+      LineSpanBuilder::UnitWeight(
+          *cable, *tensions.weathercases()[index_weathercase],
+          weight_transverse, weight_vertical);
+
+      const double tension = tensions.Tension(span.index_line_cable,
+                                              index_weathercase,
+                                              index_case % count_conditions);
+      if (catenary.Set(span, tension, weight_transverse, weight_vertical)
+          == false) {
+        continue;
+      }
+
+      // the loads act in the loaded plane and are split by the swing angle
+      const double weight = std::hypot(weight_transverse, weight_vertical);
+      const double load_back = -tension * catenary.SlopeBack();
+      const double load_ahead = tension * catenary.SlopeAhead();
+      load.transverse_ahead = load_ahead * weight_transverse / weight;
+      load.transverse_back = load_back * weight_transverse / weight;
+      load.vertical_ahead = load_ahead * weight_vertical / weight;
+      load.vertical_back = load_back * weight_vertical / weight;
+    }
+  });
+
+  // sweeps every case along each span
+  Parallel::For(count_spans, [&](const int& index_span, const int& thread) {
+    const LineSpan& span = spans_[index_span];
+    const Cable* cable = span.line_cable->cable();
+    BlowoutEnvelope& envelope = envelopes_[index_span];
+
+    const bool is_continuous_back = (0 < index_span)
+        && (IsContinuous(spans_[index_span - 1], span) == true);
+    const bool is_continuous_ahead = (index_span + 1 < count_spans)
+        && (IsContinuous(span, spans_[index_span + 1]) == true);
+
+    const double length = std::hypot(span.x_ahead - span.x_back,
+                                     span.y_ahead - span.y_back);
+    const int count_samples =
+        std::max((int)std::ceil(length / spacing), 1) + 1;
+    const double height = span.elevation_ahead - span.elevation_back;
+
+    std::vector<double> fractions(count_samples);
+    for (int i = 0; i < count_samples; i++) {
+      fractions[i] = (double)i / (count_samples - 1);
+    }
+
+    std::vector<double> offsets(count_samples, 0);
+    std::vector<double> elevations(count_samples,
+                                   std::numeric_limits<double>::infinity());
+    std::vector<double> sags;
+
+    SpanCatenary catenary;
+    for (int index_case = 0; index_case < count_cases; index_case++) {
+      if (cable == nullptr) {
+        break;
+      }
+
+      const int index_weathercase = index_case / count_conditions;
+      const WeatherLoadCase& weathercase =
+          *tensions.weathercases()[index_weathercase];
+      double weight_transverse = 0;
+      double weight_vertical = 0;
+      LineSpanBuilder::UnitWeight(*cable, weathercase, weight_transverse,
+                                  weight_vertical);
+
+      const double tension = tensions.Tension(span.index_line_cable,
+                                              index_weathercase,
+                                              index_case % count_conditions);
+      if (catenary.Set(span, tension, weight_transverse, weight_vertical)
+          == false) {
+        continue;
+      }
+
+      // swings the hardware at each end with the loads from both spans
+      const EndLoads& load = loads[index_span * count_cases + index_case];
+      double transverse_back = load.transverse_back;
+      double vertical_back = load.vertical_back;
+      if (is_continuous_back == true) {
+        const EndLoads& load_adjacent =
+            loads[(index_span - 1) * count_cases + index_case];
+        transverse_back += load_adjacent.transverse_ahead;
+        vertical_back += load_adjacent.vertical_ahead;
+      }
+
+      double transverse_ahead = load.transverse_ahead;
+      double vertical_ahead = load.vertical_ahead;
+      if (is_continuous_ahead == true) {
+        const EndLoads& load_adjacent =
+            loads[(index_span + 1) * count_cases + index_case];
+        transverse_ahead += load_adjacent.transverse_back;
+        vertical_ahead += load_adjacent.vertical_back;
+      }
+
+      double displacement_back = 0;
+      double lift_back = 0;
+      SwingHardware(span.hardware_back, weathercase.pressure_wind,
+                    transverse_back, vertical_back, displacement_back,
+                    lift_back);
+
+      double displacement_ahead = 0;
+      double lift_ahead = 0;
+      SwingHardware(span.hardware_ahead, weathercase.pressure_wind,
+                    transverse_ahead, vertical_ahead, displacement_ahead,
+                    lift_ahead);
+
+      // displaces every sample and updates the envelope
+      catenary.SagProfile(count_samples, sags);
+
+      const double weight = std::hypot(weight_transverse, weight_vertical);
+      const double sine_swing = weight_transverse / weight;
+      const double cosine_swing = weight_vertical / weight;
+      const double elevation_back = span.elevation_back + lift_back;
+      const double rise = height + lift_ahead - lift_back;
+      const double displacement_change = displacement_ahead
+                                         - displacement_back;
+      const double* data_fractions = fractions.data();
+      const double* data_sags = sags.data();
+      double* data_offsets = offsets.data();
+      double* data_elevations = elevations.data();
+      for (int i = 0; i < count_samples; i++) {
+        const double offset = displacement_back
+                              + data_fractions[i] * displacement_change
+                              + data_sags[i] * sine_swing;
+        const double elevation = elevation_back + data_fractions[i] * rise
+                                 - data_sags[i] * cosine_swing;
+        data_offsets[i] = std::max(data_offsets[i], offset);
+        data_elevations[i] = std::min(data_elevations[i], elevation);
+      }
+    }
+
+    // spans without a valid case keep the chord
+    envelope.offsets.resize(count_samples);
+    envelope.elevations_min.resize(count_samples);
+    for (int i = 0; i < count_samples; i++) {
+      double elevation = elevations[i];
+      if (std::isinf(elevation) == true) {
+        elevation = span.elevation_back + fractions[i] * height;
+      }
+      envelope.offsets[i] = (float)offsets[i];
+      envelope.elevations_min[i] = (float)elevation;
+    }
+  });
+
+  // sizes the grid to the spans
+  double length_total = 0;
+  for (auto iter = spans_.cbegin(); iter != spans_.cend(); iter++) {
+    length_total += std::hypot(iter->x_ahead - iter->x_back,
+                               iter->y_ahead - iter->y_back);
+  }
+  double size_cell = 1;
+  if (0 < count_spans) {
+    size_cell = std::max(length_total / count_spans / 4, 1.0);
+  }
+  grid_.Clear(size_cell);
+
+  // registers each span in the cells around points sampled along its chord
+  for (int index = 0; index < count_spans; index++) {
+    const LineSpan& span = spans_[index];
+    const BlowoutEnvelope& envelope = envelopes_[index];
+    const double offset_max = *std::max_element(envelope.offsets.cbegin(),
+                                                envelope.offsets.cend());
+    const int count_cells = (int)std::ceil(offset_max / size_cell) + 1;
+
+    const double length = std::hypot(span.x_ahead - span.x_back,
+                                     span.y_ahead - span.y_back);
+    if (length <= 0) {
+      continue;
+    }
+
+    grid_.Add(span.x_back, span.y_back, span.x_ahead, span.y_ahead,
+              count_cells, index);
+  }
+}
+
+bool BlowoutEngine::Export(
+    const std::string& filepath,
+    const quantity::Unit<quantity::Length>& units) const {
+  CsvWriter file;
+  if (file.Open(filepath, "Blowout") == false) {
+    return false;
+  }
+
+  const double scale =
+      quantity::FactorBetween(quantity::length::kMeters, units).scale;
+
+  file.Append("line_cable,structure_back,structure_ahead,vertex,x,y\n");
+  std::vector<double> xs;
+  std::vector<double> ys;
+  for (int index = 0; index < (int)spans_.size(); index++) {
+    const LineSpan& span = spans_[index];
+    Polygon(index, xs, ys);
+    for (int i = 0; i < (int)xs.size(); i++) {
+      file.Append("%d,%d,%d,%d,%.3f,%.3f\n", span.index_line_cable,
+                  span.index_structure_back, span.index_structure_ahead, i,
+                  xs[i] * scale, ys[i] * scale);
+    }
+  }
+
+  return file.Close();
+}
+
+bool BlowoutEngine::ExportIntersections(
+    const std::string& filepath,
+    const std::vector<BlowoutObstacle>& obstacles,
+    const std::vector<BlowoutIntersection>& intersections,
+    const quantity::Unit<quantity::Length>& units) const {
+  CsvWriter file;
+  if (file.Open(filepath, "Blowout intersection") == false) {
+    return false;
+  }
+
+  const double scale =
+      quantity::FactorBetween(quantity::length::kMeters, units).scale;
+
+  file.Append("line_cable,structure_back,structure_ahead,distance,x,y,"
+              "elevation\n");
+  for (auto iter = intersections.cbegin(); iter != intersections.cend();
+       iter++) {
+    const LineSpan& span = spans_[iter->index_span];
+    const BlowoutObstacle& obstacle = obstacles[iter->index_obstacle];
+    file.Append("%d,%d,%d,%.3f,%.3f,%.3f,%.3f\n", span.index_line_cable,
+                span.index_structure_back, span.index_structure_ahead,
+                iter->distance * scale, obstacle.x * scale,
+                obstacle.y * scale, obstacle.elevation * scale);
+  }
+
+  return file.Close();
+}
+
+void BlowoutEngine::Intersect(
+    const std::vector<BlowoutObstacle>& obstacles,
+    const double& clearance,
+    std::vector<BlowoutIntersection>& intersections) const {
+  TRACE_SCOPE("BlowoutEngine::Intersect");
+
+  intersections.clear();
+
+  // each thread keeps its own intersections, which are merged afterwards
+  std::vector<std::vector<BlowoutIntersection>> intersections_threads(
+      Parallel::CountThreads());
+  const int count_obstacles = (int)obstacles.size();
+  Parallel::For(count_obstacles, [&](const int& index, const int& thread) {
+    const BlowoutObstacle& obstacle = obstacles[index];
+
+    // gathers the spans in the cells that the obstacle touches
+    const double reach = obstacle.radius + clearance;
+    const double size_cell = grid_.size_cell();
+    const int count_cells = (int)std::ceil(reach / size_cell);
+    std::vector<int> indexes;
+    for (int dx = -count_cells; dx <= count_cells; dx++) {
+      for (int dy = -count_cells; dy <= count_cells; dy++) {
+        const std::vector<int>* cell = grid_.Find(
+            obstacle.x + dx * size_cell, obstacle.y + dy * size_cell);
+        if (cell != nullptr) {
+          indexes.insert(indexes.end(), cell->cbegin(), cell->cend());
+        }
+      }
+    }
+
+    std::sort(indexes.begin(), indexes.end());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()),
+                  indexes.end());
+
+    for (auto iter = indexes.cbegin(); iter != indexes.cend(); iter++) {
+      double distance = 0;
+      if (Distance(*iter, obstacle, clearance, distance) == true) {
+        intersections_threads[thread].push_back(
+            BlowoutIntersection{distance, index, *iter});
+      }
+    }
+  });
+
+  for (auto iter = intersections_threads.cbegin();
+       iter != intersections_threads.cend(); iter++) {
+    intersections.insert(intersections.end(), iter->cbegin(), iter->cend());
+  }
+
+  std::sort(intersections.begin(), intersections.end(),
+            [](const BlowoutIntersection& a, const BlowoutIntersection& b) {
+              if (a.index_obstacle != b.index_obstacle) {
+                return a.index_obstacle < b.index_obstacle;
+              }
+              return a.index_span < b.index_span;
+            });
+}
+
+void BlowoutEngine::Polygon(const int& index, std::vector<double>& xs,
+                            std::vector<double>& ys) const {
+  xs.clear();
+  ys.clear();
+
+  const LineSpan& span = spans_[index];
+  const BlowoutEnvelope& envelope = envelopes_[index];
+  const int count_samples = (int)envelope.offsets.size();
+  const double length = std::hypot(span.x_ahead - span.x_back,
+                                   span.y_ahead - span.y_back);
+  if ((count_samples < 2) || (length <= 0)) {
+    return;
+  }
+
+  const double normal_x = -(span.y_ahead - span.y_back) / length;
+  const double normal_y = (span.x_ahead - span.x_back) / length;
+
+  // runs up the left side and back down the right side
+  for (int side = 1; -1 <= side; side -= 2) {
+    for (int j = 0; j < count_samples; j++) {
+      const int i = side == 1 ? j : count_samples - 1 - j;
+      const double fraction = (double)i / (count_samples - 1);
+      const double offset = side * envelope.offsets[i];
+      xs.push_back(span.x_back + fraction * (span.x_ahead - span.x_back)
+                   + offset * normal_x);
+      ys.push_back(span.y_back + fraction * (span.y_ahead - span.y_back)
+                   + offset * normal_y);
+    }
+  }
+}
+
+const std::vector<BlowoutEnvelope>& BlowoutEngine::envelopes() const {
+  return envelopes_;
+}
+
+const std::vector<LineSpan>& BlowoutEngine::spans() const {
+  return spans_;
+}
+
+bool BlowoutEngine::Distance(const int& index,
+                             const BlowoutObstacle& obstacle,
+                             const double& clearance,
+                             double& distance) const {
+  const LineSpan& span = spans_[index];
+  const BlowoutEnvelope& envelope = envelopes_[index];
+  const int count_samples = (int)envelope.offsets.size();
+  const double length = std::hypot(span.x_ahead - span.x_back,
+                                   span.y_ahead - span.y_back);
+  if ((count_samples < 2) || (length <= 0)) {
+    return false;
+  }
+
+  // converts the obstacle to chord coordinates
+  const double direction_x = (span.x_ahead - span.x_back) / length;
+  const double direction_y = (span.y_ahead - span.y_back) / length;
+  const double dx = obstacle.x - span.x_back;
+  const double dy = obstacle.y - span.y_back;
+  const double along = dx * direction_x + dy * direction_y;
+  const double across = std::abs(dy * direction_x - dx * direction_y);
+
+  // reads the envelope at the nearest samples
+  const double along_clamped = std::min(std::max(along, 0.0), length);
+  const int index_sample = std::min(
+      (int)(along_clamped / length * (count_samples - 1)), count_samples - 2);
+  const double offset = std::max(envelope.offsets[index_sample],
+                                 envelope.offsets[index_sample + 1]);
+  const double elevation = std::min(envelope.elevations_min[index_sample],
+                                    envelope.elevations_min[index_sample + 1]);
+
+  const double gap_along = std::abs(along - along_clamped);
+  if ((gap_along == 0) && (across <= offset)) {
+    distance = across - offset - obstacle.radius;
+  } else {
+    distance = std::hypot(gap_along, std::max(across - offset, 0.0))
+               - obstacle.radius;
+  }
+
+  if (clearance <= distance) {
+    return false;
+  }
+
+  // the cable may pass over the obstacle
+  return elevation - clearance < obstacle.elevation;
+}
@@ -0,0 +1,215 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "clearance_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "csv_writer.h"
+#include "parallel.h"
+#include "span_catenary.h"
+#include "trace.h"
+
+namespace {
+
+/// The smallest swing sine that displaces the cable transversely. Cases
+/// below this reuse the ground that is sampled under the still cable.
+const double kSineSwingStill = 1e-6;
+
+/// \brief Gets the ground under a sample.
+/// \param[in] x
+///   The x coordinate.
+/// \param[in] y
+///   The y coordinate.
+/// \param[in] radius
+///   The search radius.
+/// \param[in] path
+///   The alignment path.
+/// \param[in] terrain
+///   The terrain index.
+/// \param[out] point
+///   The highest ground point near the sample.
+/// \return If ground was found.
+bool Ground(const double& x, const double& y, const double& radius,
+            const AlignmentPath& path, const TerrainIndex& terrain,
+            TerrainPoint& point) {
+  double station = 0;
+  double offset = 0;
+  if (path.Project(x, y, station, offset) == false) {
+    return false;
+  }
+
+  return terrain.Highest(station - radius, station + radius,
+                         offset - radius, offset + radius, point);
+}
+
+}  // namespace
+
+void ClearanceEngine::Check(const std::vector<LineSpan>& spans,
+                            const TensionTable& tensions,
+                            const AlignmentPath& path,
+                            const TerrainIndex& terrain,
+                            const double& spacing,
+                            std::vector<ClearanceResult>& results) {
+  TRACE_SCOPE("ClearanceEngine::Check");
+
+  const int count_weathercases = (int)tensions.weathercases().size();
+  const int count_conditions = (int)tensions.conditions().size();
+  const int count_cases = count_weathercases * count_conditions;
+  const double radius = spacing / 2;
+
+  const int count_spans = (int)spans.size();
+  results.resize(count_spans * count_cases);
+
+  Parallel::For(count_spans, [&](const int& index_span, const int& thread) {
+    const LineSpan& span = spans[index_span];
+    const Cable* cable = span.line_cable->cable();
+
+    SpanCatenary catenary;
+    const double length = std::hypot(span.x_ahead - span.x_back,
+                                     span.y_ahead - span.y_back);
+    const int count_samples =
+        std::max((int)std::ceil(length / spacing), 1) + 1;
+
+    // the ground under the still cable is shared by all cases without wind
+    std::vector<TerrainPoint> grounds_still;
+    std::vector<bool> is_grounds_still;
+
+    for (int index_case = 0; index_case < count_cases; index_case++) {
+      ClearanceResult& result = results[index_span * count_cases
+                                        + index_case];
+      result.index_condition = index_case % count_conditions;
+      result.index_span = index_span;
+      result.index_weathercase = index_case / count_conditions;
+      result.is_valid = false;
+
+      if (cable == nullptr) {
+        continue;
+      }
+
+      const WeatherLoadCase& weathercase =
+          *tensions.weathercases()[result.index_weathercase];
+      double weight_transverse = 0;
+      double weight_vertical = 0;
+      LineSpanBuilder::UnitWeight(*cable, weathercase, weight_transverse,
+                                  weight_vertical);
+
+      const double tension = tensions.Tension(span.index_line_cable,
+                                              result.index_weathercase,
+                                              result.index_condition);
+
+      const bool is_still = std::abs(weight_transverse)
+                            <= kSineSwingStill * weight_vertical;
+      if ((is_still == true) && (grounds_still.empty() == true)) {
+        grounds_still.resize(count_samples);
+        is_grounds_still.resize(count_samples);
+        for (int i = 0; i < count_samples; i++) {
+          const double fraction = (double)i / (count_samples - 1);
+          const double x = span.x_back + fraction
+                           * (span.x_ahead - span.x_back);
+          const double y = span.y_back + fraction
+                           * (span.y_ahead - span.y_back);
+          is_grounds_still[i] = Ground(x, y, radius, path, terrain,
+                                       grounds_still[i]);
+        }
+      }
+
+      // samples the catenary
+      // the wind can blow from either side, so a swung cable is sampled
+      // over the ground on both sides of the chord
+      const int count_sides = is_still == true ? 1 : 2;
+      for (int side = 0; side < count_sides; side++) {
+        const double weight_side =
+            side == 0 ? weight_transverse : -weight_transverse;
+        if (catenary.Set(span, tension, weight_side, weight_vertical)
+            == false) {
+          continue;
+        }
+
+        for (int i = 0; i < count_samples; i++) {
+          const double fraction = (double)i / (count_samples - 1);
+          double x = 0;
+          double y = 0;
+          double elevation = 0;
+          catenary.Point(fraction, x, y, elevation);
+
+          TerrainPoint ground;
+          if (is_still == true) {
+            if (is_grounds_still[i] == false) {
+              continue;
+            }
+            ground = grounds_still[i];
+          } else if (Ground(x, y, radius, path, terrain, ground) == false) {
+            continue;
+          }
+
+          const double clearance = elevation - ground.elevation;
+          if ((result.is_valid == false)
+              || (clearance < result.clearance)) {
+            result.clearance = clearance;
+            result.elevation = elevation;
+            result.elevation_ground = ground.elevation;
+            result.is_valid = true;
+            result.offset = ground.offset;
+            result.station = ground.station;
+          }
+        }
+      }
+    }
+  });
+}
+
+bool ClearanceEngine::Export(const std::string& filepath,
+                             const std::vector<LineSpan>& spans,
+                             const TensionTable& tensions,
+                             const std::vector<ClearanceResult>& results,
+                             const quantity::Unit<quantity::Length>& units) {
+  CsvWriter file;
+  if (file.Open(filepath, "Clearance") == false) {
+    return false;
+  }
+
+  const double scale =
+      quantity::FactorBetween(quantity::length::kMeters, units).scale;
+
+  file.Append("line_cable,structure_back,structure_ahead,weathercase,"
+              "condition,clearance,station,offset,elevation,"
+              "elevation_ground\n");
+  for (auto iter = results.cbegin(); iter != results.cend(); iter++) {
+    const ClearanceResult& result = *iter;
+    if (result.is_valid == false) {
+      continue;
+    }
+
+    const LineSpan& span = spans[result.index_span];
+    const WeatherLoadCase& weathercase =
+        *tensions.weathercases()[result.index_weathercase];
+    const CableConditionType& condition =
+        tensions.conditions()[result.index_condition];
+    file.Append("%d,%d,%d,\"%s\",%s,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+                span.index_line_cable, span.index_structure_back,
+                span.index_structure_ahead, weathercase.description.c_str(),
+                TensionTable::NameCondition(condition),
+                result.clearance * scale, result.station * scale,
+                result.offset * scale, result.elevation * scale,
+                result.elevation_ground * scale);
+  }
+
+  return file.Close();
+}
+
+int ClearanceEngine::Minimum(const std::vector<ClearanceResult>& results) {
+  int index_minimum = -1;
+  double clearance_minimum = std::numeric_limits<double>::infinity();
+  for (int i = 0; i < (int)results.size(); i++) {
+    const ClearanceResult& result = results[i];
+    if ((result.is_valid == true) && (result.clearance < clearance_minimum)) {
+      clearance_minimum = result.clearance;
+      index_minimum = i;
+    }
+  }
+
+  return index_minimum;
+}
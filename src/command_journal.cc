@@ -0,0 +1,486 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "command_journal.h"
+
+#include "wx/filename.h"
+#include "wx/log.h"
+#include "wx/mstream.h"
+
+#include "trace.h"
+
+namespace {
+
+/// The identifier at the start of every journal file, which includes the
+/// format version.
+const char kMagic[4] = {'L', 'A', 'J', '1'};
+
+/// The size of the journal header (identifier, document size, document
+/// modification time).
+const uint64_t kSizeHeader = 4 + 8 + 8;
+
+/// The size of the frame before each record payload (size, checksum).
+const uint64_t kSizeFrame = 4 + 4;
+
+/// \brief Calculates a checksum.
+/// \param[in] data
+///   The data.
+/// \param[in] size
+///   The data size.
+/// \return The 32-bit FNV-1a hash of the data.
+uint32_t Checksum(const char* data, const size_t& size) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= (uint8_t)data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/// \brief Appends a little-endian unsigned integer.
+/// \param[in] value
+///   The value.
+/// \param[in] size
+///   The number of bytes to append.
+/// \param[out] data
+///   The data to append to.
+void PutInteger(const uint64_t& value, const int& size, std::string& data) {
+  for (int i = 0; i < size; i++) {
+    data += (char)((value >> (8 * i)) & 0xFF);
+  }
+}
+
+/// \brief Appends a length-prefixed string.
+/// \param[in] str
+///   The string.
+/// \param[out] data
+///   The data to append to.
+void PutString(const std::string& str, std::string& data) {
+  PutInteger(str.size(), 4, data);
+  data += str;
+}
+
+/// \par OVERVIEW
+///
+/// This class reads values from encoded data, and checks that every value is
+/// within the data.
+class Decoder {
+ public:
+  /// \brief Constructor.
+  /// \param[in] data
+  ///   The data.
+  /// \param[in] size
+  ///   The data size.
+  Decoder(const char* data, const uint64_t& size)
+      : data_(data), pos_(0), size_(size) {}
+
+  /// \brief Reads a little-endian unsigned integer.
+  /// \param[in] size
+  ///   The number of bytes to read.
+  /// \param[out] value
+  ///   The value.
+  /// \return If the value was within the data.
+  bool GetInteger(const int& size, uint64_t& value) {
+    if (size_ - pos_ < (uint64_t)size) {
+      return false;
+    }
+
+    value = 0;
+    for (int i = 0; i < size; i++) {
+      value |= (uint64_t)(uint8_t)data_[pos_ + i] << (8 * i);
+    }
+    pos_ += size;
+    return true;
+  }
+
+  /// \brief Reads a length-prefixed string.
+  /// \param[out] str
+  ///   The string.
+  /// \return If the string was within the data.
+  bool GetString(std::string& str) {
+    uint64_t length = 0;
+    if ((GetInteger(4, length) == false) || (size_ - pos_ < length)) {
+      return false;
+    }
+
+    str.assign(data_ + pos_, (size_t)length);
+    pos_ += length;
+    return true;
+  }
+
+  /// \brief Gets the position.
+  /// \return The number of bytes that have been read.
+  uint64_t pos() const {
+    return pos_;
+  }
+
+ private:
+  /// \var data_
+  ///   The data.
+  const char* data_;
+
+  /// \var pos_
+  ///   The read position.
+  uint64_t pos_;
+
+  /// \var size_
+  ///   The data size.
+  uint64_t size_;
+};
+
+/// \brief Encodes a record payload.
+/// \param[in] record
+///   The record.
+/// \param[out] data
+///   The payload. This is cleared first, but keeps its capacity.
+void EncodePayload(const JournalRecord& record, std::string& data) {
+  data.clear();
+  data.reserve(16 + record.xml.size());
+
+  PutInteger((uint64_t)record.type, 1, data);
+  PutInteger((uint32_t)record.index, 4, data);
+  PutInteger((uint32_t)record.index_to, 4, data);
+  PutString(record.xml, data);
+  PutInteger(record.filepaths.size(), 4, data);
+  for (auto iter = record.filepaths.cbegin(); iter != record.filepaths.cend();
+       iter++) {
+    PutString(*iter, data);
+  }
+}
+
+/// \brief Decodes a record payload.
+/// \param[in] data
+///   The payload.
+/// \param[in] size
+///   The payload size.
+/// \param[out] record
+///   The record.
+/// \return If the payload is valid.
+bool DecodePayload(const char* data, const uint64_t& size,
+                   JournalRecord& record) {
+  Decoder decoder(data, size);
+
+  uint64_t type = 0;
+  uint64_t index = 0;
+  uint64_t index_to = 0;
+  uint64_t count = 0;
+  if ((decoder.GetInteger(1, type) == false)
+      || (decoder.GetInteger(4, index) == false)
+      || (decoder.GetInteger(4, index_to) == false)
+      || (decoder.GetString(record.xml) == false)
+      || (decoder.GetInteger(4, count) == false)) {
+    return false;
+  }
+
+  if ((type == (uint64_t)JournalRecordType::kNull)
+      || ((uint64_t)JournalRecordType::kWeathercases < type)) {
+    return false;
+  }
+
+  record.type = (JournalRecordType)type;
+  record.index = (int)(int32_t)(uint32_t)index;
+  record.index_to = (int)(int32_t)(uint32_t)index_to;
+
+  record.filepaths.clear();
+  for (uint64_t i = 0; i < count; i++) {
+    std::string filepath;
+    if (decoder.GetString(filepath) == false) {
+      return false;
+    }
+    record.filepaths.push_back(filepath);
+  }
+
+  return decoder.pos() == size;
+}
+
+/// \brief Encodes the journal header for a document file.
+/// \param[in] filepath_doc
+///   The document file path.
+/// \param[out] data
+///   The header.
+/// \return If the document file information could be read.
+bool EncodeHeader(const std::string& filepath_doc, std::string& data) {
+  wxFileName filename(filepath_doc);
+  const wxULongLong size = filename.GetSize();
+  const wxDateTime time = filename.GetModificationTime();
+  if ((size == wxInvalidSize) || (time.IsValid() == false)) {
+    return false;
+  }
+
+  data.assign(kMagic, sizeof(kMagic));
+  PutInteger(size.GetValue(), 8, data);
+  PutInteger((uint64_t)time.GetValue().GetValue(), 8, data);
+  return true;
+}
+
+/// \brief Reads an entire file.
+/// \param[in] filepath
+///   The file path.
+/// \param[out] data
+///   The file contents.
+/// \return If the file was read.
+bool ReadFile(const std::string& filepath, std::string& data) {
+  wxFFile file(filepath, "rb");
+  if (file.IsOpened() == false) {
+    return false;
+  }
+
+  const wxFileOffset length = file.Length();
+  if (length < 0) {
+    return false;
+  }
+
+  data.resize((size_t)length);
+  if (length == 0) {
+    return true;
+  }
+
+  return file.Read(&data[0], (size_t)length) == (size_t)length;
+}
+
+}  // namespace
+
+CommandJournal::CommandJournal() {
+  offset_ = 0;
+}
+
+CommandJournal::~CommandJournal() {
+  Close();
+}
+
+bool CommandJournal::Append(const JournalRecord& record) {
+  TRACE_SCOPE("CommandJournal::Append");
+
+  if (IsOpen() == false) {
+    return false;
+  }
+
+  // frames the payload so partial writes can be detected
+  // the payload buffer is reused, so appending doesn't allocate once it has
+  // grown to the size of the largest record
+  EncodePayload(record, payload_);
+
+  std::string frame;
+  PutInteger(payload_.size(), 4, frame);
+  PutInteger(Checksum(payload_.c_str(), payload_.size()), 4, frame);
+
+  // flushes so the record survives an application crash
+  if ((file_.Write(frame.c_str(), frame.size()) != frame.size())
+      || (file_.Write(payload_.c_str(), payload_.size()) != payload_.size())
+      || (file_.Flush() == false)) {
+    wxLogError("Journal file (%s) could not be written.",
+               FilePath(filepath_doc_));
+    return false;
+  }
+
+  offset_ += frame.size() + payload_.size();
+  return true;
+}
+
+void CommandJournal::Close() {
+  if (file_.IsOpened() == true) {
+    file_.Close();
+  }
+
+  offset_ = 0;
+}
+
+bool CommandJournal::Compact(const std::string& filepath_doc,
+                             const uint64_t& offset) {
+  TRACE_SCOPE("CommandJournal::Compact");
+
+  if (IsOpen() == false) {
+    return false;
+  }
+
+  // reads the records that were appended after the offset
+  std::string data;
+  if (offset < offset_) {
+    std::string data_all;
+    if ((file_.Flush() == false)
+        || (ReadFile(FilePath(filepath_doc_), data_all) == false)
+        || (data_all.size() < offset_)) {
+      wxLogError("Journal file (%s) could not be read.",
+                 FilePath(filepath_doc_));
+      return false;
+    }
+
+    data = data_all.substr((size_t)offset, (size_t)(offset_ - offset));
+  }
+
+  // removes the journal of the previous document file if it was renamed
+  const std::string filepath_doc_old = filepath_doc_;
+  Close();
+  if (filepath_doc_old != filepath_doc) {
+    Remove(filepath_doc_old);
+  }
+
+  return Create(filepath_doc, data);
+}
+
+void CommandJournal::Discard() {
+  if (IsOpen() == false) {
+    return;
+  }
+
+  Close();
+  Remove(filepath_doc_);
+}
+
+std::string CommandJournal::FilePath(const std::string& filepath_doc) {
+  return filepath_doc + ".journal";
+}
+
+bool CommandJournal::IsOpen() const {
+  return file_.IsOpened();
+}
+
+int CommandJournal::Open(const std::string& filepath_doc,
+                         std::list<JournalRecord>& records) {
+  TRACE_SCOPE("CommandJournal::Open");
+
+  Close();
+  records.clear();
+
+  std::string header;
+  if (EncodeHeader(filepath_doc, header) == false) {
+    wxLogError("Document file (%s) could not be read for journaling.",
+               filepath_doc);
+    return -1;
+  }
+
+  int status = 0;
+
+  // reads the existing journal, if any
+  std::string data;
+  std::string data_valid;
+  if (ReadFile(FilePath(filepath_doc), data) == true) {
+    if ((data.size() < kSizeHeader)
+        || (data.compare(0, (size_t)kSizeHeader, header) != 0)) {
+      // the journal doesn't belong to the saved document file
+      wxLogWarning("Journal file (%s) does not match the document file and "
+                   "was discarded.", FilePath(filepath_doc));
+      status = 1;
+    } else {
+      // decodes records until the end of the file, or a damaged record
+      uint64_t pos = kSizeHeader;
+      while (pos < data.size()) {
+        Decoder decoder(data.c_str() + pos, data.size() - pos);
+        uint64_t size = 0;
+        uint64_t checksum = 0;
+        if ((decoder.GetInteger(4, size) == false)
+            || (decoder.GetInteger(4, checksum) == false)
+            || (data.size() - pos - kSizeFrame < size)) {
+          break;
+        }
+
+        const char* payload = data.c_str() + pos + kSizeFrame;
+        JournalRecord record;
+        if ((Checksum(payload, (size_t)size) != (uint32_t)checksum)
+            || (DecodePayload(payload, size, record) == false)) {
+          break;
+        }
+
+        records.push_back(record);
+        pos += kSizeFrame + size;
+      }
+
+      if (pos < data.size()) {
+        wxLogWarning("Journal file (%s) ends with a damaged record, which was "
+                     "discarded.", FilePath(filepath_doc));
+        status = 1;
+      }
+
+      data_valid = data.substr((size_t)kSizeHeader,
+                               (size_t)(pos - kSizeHeader));
+    }
+  }
+
+  // rewrites the journal with only the valid records
+  if (Create(filepath_doc, data_valid) == false) {
+    records.clear();
+    return -1;
+  }
+
+  return status;
+}
+
+wxXmlNode* CommandJournal::ParseXml(const std::string& xml) {
+  wxMemoryInputStream stream(xml.c_str(), xml.size());
+
+  wxXmlDocument doc_xml;
+  if (doc_xml.Load(stream) == false) {
+    return nullptr;
+  }
+
+  return doc_xml.DetachRoot();
+}
+
+void CommandJournal::Remove(const std::string& filepath_doc) {
+  const std::string filepath = FilePath(filepath_doc);
+  if (wxFileName::FileExists(filepath) == true) {
+    wxRemoveFile(filepath);
+  }
+}
+
+std::string CommandJournal::WriteXml(const wxXmlNode* node) {
+  // the document takes ownership of the root, so a copy is used
+  wxXmlDocument doc_xml;
+  doc_xml.SetRoot(new wxXmlNode(*node));
+
+  wxMemoryOutputStream stream;
+  doc_xml.Save(stream, wxXML_NO_INDENTATION);
+
+  std::string xml(stream.GetSize(), '\0');
+  if (xml.empty() == false) {
+    stream.CopyTo(&xml[0], xml.size());
+  }
+
+  return xml;
+}
+
+uint64_t CommandJournal::offset() const {
+  return offset_;
+}
+
+bool CommandJournal::Create(const std::string& filepath_doc,
+                            const std::string& data) {
+  std::string header;
+  if (EncodeHeader(filepath_doc, header) == false) {
+    wxLogError("Document file (%s) could not be read for journaling.",
+               filepath_doc);
+    return false;
+  }
+
+  // writes a temporary file, which then replaces the journal so an existing
+  // journal is never left partially written
+  const std::string filepath = FilePath(filepath_doc);
+  const std::string filepath_temp = filepath + ".tmp";
+  {
+    wxFFile file(filepath_temp, "wb");
+    if ((file.IsOpened() == false)
+        || (file.Write(header.c_str(), header.size()) != header.size())
+        || (file.Write(data.c_str(), data.size()) != data.size())
+        || (file.Close() == false)) {
+      wxLogError("Journal file (%s) could not be written.", filepath_temp);
+      wxRemoveFile(filepath_temp);
+      return false;
+    }
+  }
+
+  if (wxRenameFile(filepath_temp, filepath, true) == false) {
+    wxLogError("Journal file (%s) could not be written.", filepath);
+    wxRemoveFile(filepath_temp);
+    return false;
+  }
+
+  // opens for appending
+  if (file_.Open(filepath, "ab") == false) {
+    wxLogError("Journal file (%s) could not be opened.", filepath);
+    return false;
+  }
+
+  filepath_doc_ = filepath_doc;
+  offset_ = header.size() + data.size();
+  return true;
+}
@@ -0,0 +1,72 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "core_hooks.h"
+
+namespace {
+
+/// The default hooks, which are used when no hooks have been set.
+CoreHooks hooks_default;
+
+/// The active hooks.
+CoreHooks* hooks_active = &hooks_default;
+
+}  // namespace
+
+CoreHooks::CoreHooks() {
+  units_ = units::UnitSystem::kImperial;
+}
+
+CoreHooks::~CoreHooks() {
+}
+
+CoreHooks* CoreHooks::Get() {
+  return hooks_active;
+}
+
+void CoreHooks::Set(CoreHooks* hooks) {
+  if (hooks == nullptr) {
+    hooks_active = &hooks_default;
+  } else {
+    hooks_active = hooks;
+  }
+}
+
+void CoreHooks::BeginBusy() {
+}
+
+void CoreHooks::EndBusy() {
+}
+
+void CoreHooks::PopStatus() {
+}
+
+void CoreHooks::PushStatus(const std::string& message) {
+}
+
+void CoreHooks::ShowMessage(const std::string& message) {
+}
+
+DocumentFormat CoreHooks::format_document() const {
+  return DocumentFormat::kXml;
+}
+
+bool CoreHooks::is_journaling() const {
+  return false;
+}
+
+void CoreHooks::set_units(const units::UnitSystem& units) {
+  units_ = units;
+}
+
+units::UnitSystem CoreHooks::units() const {
+  return units_;
+}
+
+BusyIndicator::BusyIndicator() {
+  CoreHooks::Get()->BeginBusy();
+}
+
+BusyIndicator::~BusyIndicator() {
+  CoreHooks::Get()->EndBusy();
+}
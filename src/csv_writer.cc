@@ -0,0 +1,77 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "csv_writer.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+#include "wx/log.h"
+
+CsvWriter::CsvWriter() {
+}
+
+void CsvWriter::Append(const char* format, ...) {
+  char buffer[512];
+
+  va_list args;
+  va_start(args, format);
+  const int size = std::vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (size < 0) {
+    return;
+  }
+
+  if (size < (int)sizeof(buffer)) {
+    buffer_.append(buffer, size);
+    return;
+  }
+
+  // formats again directly into the text for long rows
+  const size_t size_buffer = buffer_.size();
+  buffer_.resize(size_buffer + size + 1);
+  va_start(args, format);
+  std::vsnprintf(&buffer_[size_buffer], size + 1, format, args);
+  va_end(args);
+  buffer_.resize(size_buffer + size);
+}
+
+bool CsvWriter::Close() {
+  if (Flush() == false) {
+    return false;
+  }
+
+  if (file_.Close() == false) {
+    wxLogError("%s file (%s) could not be closed.", description_,
+               filepath_);
+    return false;
+  }
+
+  return true;
+}
+
+bool CsvWriter::Flush() {
+  if (file_.Write(buffer_.c_str(), buffer_.size()) != buffer_.size()) {
+    wxLogError("%s file (%s) could not be written.", description_,
+               filepath_);
+    return false;
+  }
+
+  buffer_.clear();
+  return true;
+}
+
+bool CsvWriter::Open(const std::string& filepath,
+                     const std::string& description) {
+  buffer_.clear();
+  description_ = description;
+  filepath_ = filepath;
+
+  if (file_.Open(filepath, "w") == false) {
+    wxLogError("%s file (%s) could not be opened.", description_,
+               filepath_);
+    return false;
+  }
+
+  return true;
+}
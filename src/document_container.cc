@@ -0,0 +1,164 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "document_container.h"
+
+#include <cstring>
+#include <memory>
+
+#include "wx/log.h"
+#include "wx/wfstream.h"
+
+#include "trace.h"
+
+namespace {
+
+/// The entry name of the document xml.
+const char* kNameDocument = "document.xml";
+
+/// The entry name prefix of the bundled files.
+const char* kPrefixFiles = "files/";
+
+/// The zip local file header signature.
+const char kSignature[4] = {'P', 'K', 3, 4};
+
+}  // namespace
+
+bool DocumentContainer::IsContainer(wxInputStream& stream) {
+  char buffer[4];
+  stream.Read(buffer, sizeof(buffer));
+  const size_t size = stream.LastRead();
+
+  // puts the signature back so the stream can be read from the start
+  if (0 < size) {
+    stream.Ungetch(buffer, size);
+  }
+
+  return (size == sizeof(buffer))
+      && (std::memcmp(buffer, kSignature, sizeof(buffer)) == 0);
+}
+
+bool DocumentContainer::Write(const wxXmlDocument& doc_xml,
+                              const std::list<BundledFile>& files,
+                              wxOutputStream& stream) {
+  TRACE_SCOPE("DocumentContainer::Write");
+
+  wxZipOutputStream zip(stream);
+
+  // writes the document first so it can be parsed while the rest is read
+  if ((zip.PutNextEntry(kNameDocument) == false)
+      || (doc_xml.Save(zip) == false)) {
+    return false;
+  }
+
+  // copies the bundled files
+  for (auto iter = files.cbegin(); iter != files.cend(); iter++) {
+    const BundledFile& file = *iter;
+
+    if (zip.PutNextEntry(kPrefixFiles + file.name) == false) {
+      return false;
+    }
+
+    if (file.data.empty() == false) {
+      zip.Write(file.data.data(), file.data.size());
+    } else {
+      wxFileInputStream stream_file(file.filepath);
+      if (stream_file.IsOk() == false) {
+        wxLogError("File (%s) could not be bundled.", file.filepath);
+        return false;
+      }
+
+      zip.Write(stream_file);
+    }
+
+    if (zip.IsOk() == false) {
+      return false;
+    }
+  }
+
+  return zip.Close();
+}
+
+DocumentContainerReader::DocumentContainerReader(wxInputStream& stream)
+    : zip_(stream) {
+}
+
+wxInputStream* DocumentContainerReader::OpenDocument() {
+  TRACE_SCOPE("DocumentContainerReader::OpenDocument");
+
+  // reads the entries in order, so the file is read sequentially
+  // the writer puts the document xml first, so normally nothing is skipped
+  bool status = true;
+  std::unique_ptr<wxZipEntry> entry(zip_.GetNextEntry());
+  while (entry != nullptr) {
+    if (entry->GetName(wxPATH_UNIX) == kNameDocument) {
+      return &zip_;
+    }
+
+    if (ReadFile(*entry) == false) {
+      status = false;
+      break;
+    }
+
+    entry.reset(zip_.GetNextEntry());
+  }
+
+  if ((status == false) || (zip_.GetLastError() != wxSTREAM_EOF)) {
+    wxLogError("Document container could not be read.");
+  } else {
+    wxLogError("Document container is missing the document xml.");
+  }
+
+  return nullptr;
+}
+
+int DocumentContainerReader::ReadFiles(
+    std::map<std::string, std::string>& files) {
+  TRACE_SCOPE("DocumentContainerReader::ReadFiles");
+
+  bool status = true;
+  std::unique_ptr<wxZipEntry> entry(zip_.GetNextEntry());
+  while (entry != nullptr) {
+    if (ReadFile(*entry) == false) {
+      status = false;
+      break;
+    }
+
+    entry.reset(zip_.GetNextEntry());
+  }
+
+  files.clear();
+  files.swap(files_);
+
+  if ((status == false) || (zip_.GetLastError() != wxSTREAM_EOF)) {
+    wxLogError("Document container could not be read.");
+    return -1;
+  }
+
+  return 0;
+}
+
+bool DocumentContainerReader::ReadFile(const wxZipEntry& entry) {
+  const std::string name = entry.GetName(wxPATH_UNIX).ToStdString();
+  if (name.compare(0, std::strlen(kPrefixFiles), kPrefixFiles) != 0) {
+    return true;
+  }
+
+  // the size is known unless the container was written to an unseekable
+  // stream, in which case the entry is read in chunks
+  std::string& data = files_[name.substr(std::strlen(kPrefixFiles))];
+  const wxFileOffset size = entry.GetSize();
+  if (0 < size) {
+    data.resize((size_t)size);
+    zip_.Read(&data[0], data.size());
+    return zip_.LastRead() == data.size();
+  }
+
+  char buffer[65536];
+  data.clear();
+  while (zip_.Read(buffer, sizeof(buffer)).LastRead() != 0) {
+    data.append(buffer, zip_.LastRead());
+  }
+
+  return zip_.GetLastError() == wxSTREAM_EOF;
+}
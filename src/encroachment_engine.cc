@@ -0,0 +1,272 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "encroachment_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "csv_writer.h"
+#include "parallel.h"
+#include "span_catenary.h"
+#include "trace.h"
+
+namespace {
+
+/// \brief Gets the squared distance from a point to a segment.
+/// \param[in] point
+///   The point (x, y, z).
+/// \param[in] start
+///   The segment start (x, y, z).
+/// \param[in] end
+///   The segment end (x, y, z).
+/// \return The squared distance.
+double DistanceSquared(const double point[3], const double start[3],
+                       const double end[3]) {
+  double segment[3];
+  double relative[3];
+  double dot = 0;
+  double length_squared = 0;
+  for (int k = 0; k < 3; k++) {
+    segment[k] = end[k] - start[k];
+    relative[k] = point[k] - start[k];
+    dot += segment[k] * relative[k];
+    length_squared += segment[k] * segment[k];
+  }
+
+  double fraction = 0;
+  if (0 < length_squared) {
+    fraction = std::min(std::max(dot / length_squared, 0.0), 1.0);
+  }
+
+  double distance_squared = 0;
+  for (int k = 0; k < 3; k++) {
+    const double delta = relative[k] - fraction * segment[k];
+    distance_squared += delta * delta;
+  }
+  return distance_squared;
+}
+
+}  // namespace
+
+bool EncroachmentEngine::Export(
+    const std::string& filepath,
+    const std::vector<LineSpan>& spans,
+    const TensionTable& tensions,
+    const ObstacleLayer& obstacles,
+    const std::vector<EncroachmentViolation>& violations,
+    const quantity::Unit<quantity::Length>& units) {
+  CsvWriter file;
+  if (file.Open(filepath, "Encroachment") == false) {
+    return false;
+  }
+
+  const double scale =
+      quantity::FactorBetween(quantity::length::kMeters, units).scale;
+
+  file.Append("line_cable,structure_back,structure_ahead,weathercase,"
+              "condition,distance,classification,x,y,elevation\n");
+  for (auto iter = violations.cbegin(); iter != violations.cend(); iter++) {
+    const EncroachmentViolation& violation = *iter;
+    const LineSpan& span = spans[violation.index_span];
+    const WeatherLoadCase& weathercase =
+        *tensions.weathercases()[violation.index_weathercase];
+    const CableConditionType& condition =
+        tensions.conditions()[violation.index_condition];
+    const ObstaclePoint& point = obstacles.points()[violation.index_point];
+    file.Append("%d,%d,%d,\"%s\",%s,%.3f,%d,%.3f,%.3f,%.3f\n",
+                span.index_line_cable, span.index_structure_back,
+                span.index_structure_ahead, weathercase.description.c_str(),
+                TensionTable::NameCondition(condition),
+                violation.distance * scale, point.classification,
+                point.x * scale, point.y * scale, point.z * scale);
+  }
+
+  return file.Close();
+}
+
+void EncroachmentEngine::Scan(const ObstacleLayer& obstacles,
+                              const std::vector<LineSpan>& spans,
+                              const TensionTable& tensions,
+                              const double& clearance,
+                              const double& spacing,
+                              std::vector<EncroachmentViolation>& violations) {
+  TRACE_SCOPE("EncroachmentEngine::Scan");
+
+  const int count_spans = (int)spans.size();
+  std::vector<std::vector<EncroachmentViolation>> violations_spans(
+      count_spans);
+  Parallel::For(count_spans, [&](const int& index, const int& thread) {
+    Search(obstacles, spans[index], tensions, clearance, spacing,
+           violations_spans[index]);
+  });
+
+  violations.clear();
+  for (int i = 0; i < count_spans; i++) {
+    const std::vector<EncroachmentViolation>& violations_span =
+        violations_spans[i];
+    for (auto iter = violations_span.cbegin();
+         iter != violations_span.cend(); iter++) {
+      violations.push_back(*iter);
+      violations.back().index_span = i;
+    }
+  }
+
+  std::sort(violations.begin(), violations.end(),
+            [](const EncroachmentViolation& a,
+               const EncroachmentViolation& b) {
+    if (a.distance != b.distance) {
+      return a.distance < b.distance;
+    } else if (a.index_span != b.index_span) {
+      return a.index_span < b.index_span;
+    } else {
+      return a.index_point < b.index_point;
+    }
+  });
+}
+
+void EncroachmentEngine::Search(
+    const ObstacleLayer& obstacles,
+    const LineSpan& span,
+    const TensionTable& tensions,
+    const double& clearance,
+    const double& spacing,
+    std::vector<EncroachmentViolation>& violations) {
+  violations.clear();
+
+  const Cable* cable = span.line_cable->cable();
+  if (cable == nullptr) {
+    return;
+  }
+
+  const double length = std::hypot(span.x_ahead - span.x_back,
+                                   span.y_ahead - span.y_back);
+  if (length <= 0) {
+    return;
+  }
+
+  const int count_weathercases = (int)tensions.weathercases().size();
+  const int count_conditions = (int)tensions.conditions().size();
+  const int count_cases = count_weathercases * count_conditions;
+  const int count_samples =
+      std::max((int)std::ceil(length / spacing), 1) + 1;
+
+  // samples the curve of every case swung to each side, and bounds all of
+  // them
+  // the wind can blow from either side, so a case with wind is also sampled
+  // with the transverse weight reversed
+  const int count_curves = count_cases * 2;
+  std::vector<double> samples(count_curves * count_samples * 3);
+  std::vector<bool> is_valid(count_curves, false);
+  double bounds_min[3];
+  double bounds_max[3];
+  for (int k = 0; k < 3; k++) {
+    bounds_min[k] = std::numeric_limits<double>::infinity();
+    bounds_max[k] = -std::numeric_limits<double>::infinity();
+  }
+
+  SpanCatenary catenary;
+  for (int w = 0; w < count_weathercases; w++) {
+    double weight_transverse = 0;
+    double weight_vertical = 0;
+    LineSpanBuilder::UnitWeight(*cable, *tensions.weathercases()[w],
+                                weight_transverse, weight_vertical);
+
+    for (int c = 0; c < count_conditions; c++) {
+      const int index_case = w * count_conditions + c;
+      const double tension = tensions.Tension(span.index_line_cable, w, c);
+      for (int side = 0; side < 2; side++) {
+        if ((side == 1) && (weight_transverse == 0)) {
+          continue;
+        }
+
+        const double weight_side =
+            side == 0 ? weight_transverse : -weight_transverse;
+        if (catenary.Set(span, tension, weight_side, weight_vertical)
+            == false) {
+          continue;
+        }
+
+        const int index_curve = index_case * 2 + side;
+        is_valid[index_curve] = true;
+        double* sample = &samples[index_curve * count_samples * 3];
+        for (int i = 0; i < count_samples; i++) {
+          const double fraction = (double)i / (count_samples - 1);
+          catenary.Point(fraction, sample[0], sample[1], sample[2]);
+          for (int k = 0; k < 3; k++) {
+            bounds_min[k] = std::min(bounds_min[k], sample[k]);
+            bounds_max[k] = std::max(bounds_max[k], sample[k]);
+          }
+          sample += 3;
+        }
+      }
+    }
+  }
+
+  if (std::find(is_valid.cbegin(), is_valid.cend(), true)
+      == is_valid.cend()) {
+    return;
+  }
+
+  for (int k = 0; k < 3; k++) {
+    bounds_min[k] -= clearance;
+    bounds_max[k] += clearance;
+  }
+
+  std::vector<uint32_t> indexes;
+  obstacles.Query(bounds_min, bounds_max, indexes);
+
+  // the cable is only displaced normal to the chord, so each sample stays at
+  // the same chord position for every case
+  const double direction_x = (span.x_ahead - span.x_back) / length;
+  const double direction_y = (span.y_ahead - span.y_back) / length;
+  const double spacing_samples = length / (count_samples - 1);
+  const double clearance_squared = clearance * clearance;
+
+  for (auto iter = indexes.cbegin(); iter != indexes.cend(); iter++) {
+    const ObstaclePoint& obstacle = obstacles.points()[*iter];
+    const double point[3] = {obstacle.x, obstacle.y, obstacle.z};
+
+    const double along = (point[0] - span.x_back) * direction_x
+                         + (point[1] - span.y_back) * direction_y;
+    const int index_begin = std::max(
+        (int)std::floor((along - clearance) / spacing_samples), 0);
+    const int index_end = std::min(
+        (int)std::ceil((along + clearance) / spacing_samples),
+        count_samples - 1);
+    if (index_end <= index_begin) {
+      continue;
+    }
+
+    double distance_squared = std::numeric_limits<double>::infinity();
+    int index_case_closest = -1;
+    for (int index_curve = 0; index_curve < count_curves; index_curve++) {
+      if (is_valid[index_curve] == false) {
+        continue;
+      }
+
+      const double* sample = &samples[index_curve * count_samples * 3];
+      for (int i = index_begin; i < index_end; i++) {
+        const double d = DistanceSquared(point, sample + i * 3,
+                                         sample + (i + 1) * 3);
+        if (d < distance_squared) {
+          distance_squared = d;
+          index_case_closest = index_curve / 2;
+        }
+      }
+    }
+
+    if ((index_case_closest == -1) || (clearance_squared < distance_squared)) {
+      continue;
+    }
+
+    EncroachmentViolation violation;
+    violation.distance = std::sqrt(distance_squared);
+    violation.index_condition = index_case_closest % count_conditions;
+    violation.index_point = *iter;
+    violation.index_span = -1;
+    violation.index_weathercase = index_case_closest / count_conditions;
+    violations.push_back(violation);
+  }
+}
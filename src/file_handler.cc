@@ -6,34 +6,46 @@
 #include "appcommon/units/cable_unit_converter.h"
 #include "appcommon/units/hardware_unit_converter.h"
 #include "appcommon/units/structure_unit_converter.h"
-#include "appcommon/widgets/status_bar_log.h"
 #include "appcommon/xml/cable_xml_handler.h"
 #include "appcommon/xml/hardware_xml_handler.h"
 #include "appcommon/xml/structure_xml_handler.h"
 #include "wx/dir.h"
 #include "wx/filename.h"
+#include "wx/wfstream.h"
 #include "wx/xml/xml.h"
 
-#include "line_analyzer_app.h"
+#include "core_hooks.h"
 #include "line_analyzer_config_xml_handler.h"
+#include "trace.h"
 
 int FileHandler::LoadCable(const std::string& filepath,
                            const units::UnitSystem& units,
                            Cable& cable) {
-  std::string message = "Loading cable file: " + filepath;
-  wxLogVerbose(message.c_str());
-  status_bar_log::PushText(message, 0);
-
   // checks if the file exists
   if (wxFileName::Exists(filepath) == false) {
-    message = "Cable file (" + filepath + ") does not exist. Aborting.";
+    const std::string message = "Cable file (" + filepath
+                                + ") does not exist. Aborting.";
     wxLogError(message.c_str());
     return -1;
   }
 
+  wxFileInputStream stream(filepath);
+  return LoadCable(stream, filepath, units, cable);
+}
+
+int FileHandler::LoadCable(wxInputStream& stream,
+                           const std::string& filepath,
+                           const units::UnitSystem& units,
+                           Cable& cable) {
+  TRACE_SCOPE("FileHandler::LoadCable");
+
+  std::string message = "Loading cable file: " + filepath;
+  wxLogVerbose(message.c_str());
+  CoreHooks::Get()->PushStatus(message);
+
   // uses an xml document to load cable file
   wxXmlDocument doc;
-  if (doc.Load(filepath) == false) {
+  if (doc.Load(stream) == false) {
     message = filepath + "  --  "
               "Cable file contains an invalid xml structure. Aborting.";
     wxLogError(message.c_str());
@@ -80,10 +92,9 @@ int FileHandler::LoadCable(const std::string& filepath,
       units::UnitStyle::kConsistent,
       cable);
 
-  // converts unit systems if the file doesn't match applicaton config
-  units::UnitSystem units_config = wxGetApp().config()->units;
-  if (units_file != units_config) {
-    CableUnitConverter::ConvertUnitSystem(units_file, units_config, cable);
+  // converts unit systems if the file doesn't match the requested units
+  if (units_file != units) {
+    CableUnitConverter::ConvertUnitSystem(units_file, units, cable);
   }
 
   // adds any missing polynomial coefficients
@@ -117,7 +128,7 @@ int FileHandler::LoadCable(const std::string& filepath,
   }
 
   // resets statusbar
-  status_bar_log::PopText(0);
+  CoreHooks::Get()->PopStatus();
 
   // selects return based on parsing status
   if (status_node == true) {
@@ -129,9 +140,11 @@ int FileHandler::LoadCable(const std::string& filepath,
 
 int FileHandler::LoadConfig(const std::string& filepath,
                             LineAnalyzerConfig& config) {
+  TRACE_SCOPE("FileHandler::LoadConfig");
+
   std::string message = "Loading config file: " + filepath;
   wxLogVerbose(message.c_str());
-  status_bar_log::PushText(message, 0);
+  CoreHooks::Get()->PushStatus(message);
 
   // checks if the file exists
   if (wxFileName::Exists(filepath) == false) {
@@ -166,7 +179,7 @@ int FileHandler::LoadConfig(const std::string& filepath,
       root, filepath, config);
 
   // resets statusbar
-  status_bar_log::PopText(0);
+  CoreHooks::Get()->PopStatus();
 
   // selects return based on parsing status
   if (status_node == true) {
@@ -179,20 +192,31 @@ int FileHandler::LoadConfig(const std::string& filepath,
 int FileHandler::LoadHardware(const std::string& filepath,
                               const units::UnitSystem& units,
                               Hardware& hardware) {
-  std::string message = "Loading hardware file: " + filepath;
-  wxLogVerbose(message.c_str());
-  status_bar_log::PushText(message, 0);
-
   // checks if the file exists
   if (wxFileName::Exists(filepath) == false) {
-    message = "Hardware file (" + filepath + ") does not exist. Aborting.";
+    const std::string message = "Hardware file (" + filepath
+                                + ") does not exist. Aborting.";
     wxLogError(message.c_str());
     return -1;
   }
 
+  wxFileInputStream stream(filepath);
+  return LoadHardware(stream, filepath, units, hardware);
+}
+
+int FileHandler::LoadHardware(wxInputStream& stream,
+                              const std::string& filepath,
+                              const units::UnitSystem& units,
+                              Hardware& hardware) {
+  TRACE_SCOPE("FileHandler::LoadHardware");
+
+  std::string message = "Loading hardware file: " + filepath;
+  wxLogVerbose(message.c_str());
+  CoreHooks::Get()->PushStatus(message);
+
   // uses an xml document to load hardware file
   wxXmlDocument doc;
-  if (doc.Load(filepath) == false) {
+  if (doc.Load(stream) == false) {
     message = filepath + "  --  "
               "Hardware file contains an invalid xml structure. Aborting.";
     wxLogError(message.c_str());
@@ -240,15 +264,13 @@ int FileHandler::LoadHardware(const std::string& filepath,
       units::UnitStyle::kConsistent,
       hardware);
 
-  // converts unit systems if the file doesn't match applicaton config
-  units::UnitSystem units_config = wxGetApp().config()->units;
-  if (units_file != units_config) {
-    HardwareUnitConverter::ConvertUnitSystem(units_file, units_config,
-                                             hardware);
+  // converts unit systems if the file doesn't match the requested units
+  if (units_file != units) {
+    HardwareUnitConverter::ConvertUnitSystem(units_file, units, hardware);
   }
 
   // resets statusbar
-  status_bar_log::PopText(0);
+  CoreHooks::Get()->PopStatus();
 
   // selects return based on parsing status
   if (status_node == true) {
@@ -261,20 +283,31 @@ int FileHandler::LoadHardware(const std::string& filepath,
 int FileHandler::LoadStructure(const std::string& filepath,
                                const units::UnitSystem& units,
                                Structure& structure) {
-  std::string message = "Loading structure file: " + filepath;
-  wxLogVerbose(message.c_str());
-  status_bar_log::PushText(message, 0);
-
   // checks if the file exists
   if (wxFileName::Exists(filepath) == false) {
-    message = "Structure file (" + filepath + ") does not exist. Aborting.";
+    const std::string message = "Structure file (" + filepath
+                                + ") does not exist. Aborting.";
     wxLogError(message.c_str());
     return -1;
   }
 
+  wxFileInputStream stream(filepath);
+  return LoadStructure(stream, filepath, units, structure);
+}
+
+int FileHandler::LoadStructure(wxInputStream& stream,
+                               const std::string& filepath,
+                               const units::UnitSystem& units,
+                               Structure& structure) {
+  TRACE_SCOPE("FileHandler::LoadStructure");
+
+  std::string message = "Loading structure file: " + filepath;
+  wxLogVerbose(message.c_str());
+  CoreHooks::Get()->PushStatus(message);
+
   // uses an xml document to load structure file
   wxXmlDocument doc;
-  if (doc.Load(filepath) == false) {
+  if (doc.Load(stream) == false) {
     message = filepath + "  --  "
               "Structure file contains an invalid xml structure. Aborting.";
     wxLogError(message.c_str());
@@ -322,15 +355,13 @@ int FileHandler::LoadStructure(const std::string& filepath,
       units::UnitStyle::kConsistent,
       structure);
 
-  // converts unit systems if the file doesn't match applicaton config
-  units::UnitSystem units_config = wxGetApp().config()->units;
-  if (units_file != units_config) {
-    StructureUnitConverter::ConvertUnitSystem(units_file, units_config,
-                                              structure);
+  // converts unit systems if the file doesn't match the requested units
+  if (units_file != units) {
+    StructureUnitConverter::ConvertUnitSystem(units_file, units, structure);
   }
 
   // resets statusbar
-  status_bar_log::PopText(0);
+  CoreHooks::Get()->PopStatus();
 
   // selects return based on parsing status
   if (status_node == true) {
@@ -345,7 +376,7 @@ void FileHandler::SaveCable(const std::string& filepath, const Cable& cable,
   // logs
   std::string message = "Saving cable file: " + filepath;
   wxLogVerbose(message.c_str());
-  status_bar_log::PushText(message, 0);
+  CoreHooks::Get()->PushStatus(message);
 
   // creates a copy of the cable and converts to different unit style
   Cable cable_converted = cable;
@@ -370,7 +401,7 @@ void FileHandler::SaveCable(const std::string& filepath, const Cable& cable,
   doc.Save(filepath, 2);
 
   // resets statusbar
-  status_bar_log::PopText(0);
+  CoreHooks::Get()->PopStatus();
 }
 
 void FileHandler::SaveConfig(const std::string& filepath,
@@ -378,7 +409,7 @@ void FileHandler::SaveConfig(const std::string& filepath,
   // logs
   std::string message = "Saving config file: " + filepath;
   wxLogVerbose(message.c_str());
-  status_bar_log::PushText(message, 0);
+  CoreHooks::Get()->PushStatus(message);
 
   // generates an xml node
   wxXmlNode* root = LineAnalyzerConfigXmlHandler::CreateNode(config);
@@ -389,7 +420,7 @@ void FileHandler::SaveConfig(const std::string& filepath,
   doc.Save(filepath, 2);
 
   // resets statusbar
-  status_bar_log::PopText(0);
+  CoreHooks::Get()->PopStatus();
 }
 
 void FileHandler::SaveHardware(const std::string& filepath,
@@ -398,7 +429,7 @@ void FileHandler::SaveHardware(const std::string& filepath,
   // logs
   std::string message = "Saving hardware file: " + filepath;
   wxLogVerbose(message.c_str());
-  status_bar_log::PushText(message, 0);
+  CoreHooks::Get()->PushStatus(message);
 
   // creates a copy of the structure and converts to different unit style
   Hardware hardware_converted = hardware;
@@ -424,7 +455,7 @@ void FileHandler::SaveHardware(const std::string& filepath,
   doc.Save(filepath, 2);
 
   // resets statusbar
-  status_bar_log::PopText(0);
+  CoreHooks::Get()->PopStatus();
 }
 
 void FileHandler::SaveStructure(const std::string& filepath,
@@ -433,7 +464,7 @@ void FileHandler::SaveStructure(const std::string& filepath,
   // logs
   std::string message = "Saving structure file: " + filepath;
   wxLogVerbose(message.c_str());
-  status_bar_log::PushText(message, 0);
+  CoreHooks::Get()->PushStatus(message);
 
   // creates a copy of the structure and converts to different unit style
   Structure structure_converted = structure;
@@ -459,5 +490,5 @@ void FileHandler::SaveStructure(const std::string& filepath,
   doc.Save(filepath, 2);
 
   // resets statusbar
-  status_bar_log::PopText(0);
+  CoreHooks::Get()->PopStatus();
 }
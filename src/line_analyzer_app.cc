@@ -6,21 +6,89 @@
 #include "appcommon/widgets/status_bar_log.h"
 #include "wx/filename.h"
 #include "wx/stdpaths.h"
-#include "wx/xrc/xmlres.h"
+#include "wx/wfstream.h"
 
 #include "file_handler.h"
 #include "line_analyzer_doc.h"
 #include "line_analyzer_view.h"
+#include "trace.h"
 
-/// This function handles loading all of the xrc files that are processed by
-/// the wxWidgets resource compiler. It is declared in an external file so
-/// this file doesn't have to be recompiled every time the resources are
-/// updated.
-extern void InitXmlResource();
+LineAnalyzerAppHooks::LineAnalyzerAppHooks(const LineAnalyzerConfig* config) {
+  config_ = config;
+}
+
+LineAnalyzerAppHooks::~LineAnalyzerAppHooks() {
+}
+
+void LineAnalyzerAppHooks::BeginBusy() {
+  // worker threads don't block the user interface
+  if (wxThread::IsMain() == false) {
+    return;
+  }
+
+  wxBeginBusyCursor();
+}
+
+void LineAnalyzerAppHooks::EndBusy() {
+  if (wxThread::IsMain() == false) {
+    return;
+  }
+
+  wxEndBusyCursor();
+}
+
+void LineAnalyzerAppHooks::PopStatus() {
+  // forwards to the main thread if needed
+  if (wxThread::IsMain() == false) {
+    wxTheApp->CallAfter([]() {
+      status_bar_log::PopText(0);
+    });
+    return;
+  }
+
+  status_bar_log::PopText(0);
+}
+
+void LineAnalyzerAppHooks::PushStatus(const std::string& message) {
+  // forwards to the main thread if needed
+  if (wxThread::IsMain() == false) {
+    wxTheApp->CallAfter([message]() {
+      status_bar_log::PushText(message, 0);
+    });
+    return;
+  }
+
+  status_bar_log::PushText(message, 0);
+}
+
+void LineAnalyzerAppHooks::ShowMessage(const std::string& message) {
+  // forwards to the main thread if needed
+  if (wxThread::IsMain() == false) {
+    wxTheApp->CallAfter([message]() {
+      wxMessageBox(message);
+    });
+    return;
+  }
+
+  wxMessageBox(message);
+}
+
+DocumentFormat LineAnalyzerAppHooks::format_document() const {
+  return config_->format_document;
+}
+
+bool LineAnalyzerAppHooks::is_journaling() const {
+  return true;
+}
+
+units::UnitSystem LineAnalyzerAppHooks::units() const {
+  return config_->units;
+}
 
 IMPLEMENT_APP(LineAnalyzerApp)
 
-LineAnalyzerApp::LineAnalyzerApp() {
+LineAnalyzerApp::LineAnalyzerApp() : hooks_(&config_) {
+  doc_start_ = nullptr;
   frame_ = nullptr;
   manager_doc_ = nullptr;
 }
@@ -28,6 +96,73 @@ LineAnalyzerApp::LineAnalyzerApp() {
 LineAnalyzerApp::~LineAnalyzerApp() {
 }
 
+void LineAnalyzerApp::BeginLoadStartDocument() {
+  // creates a document that isn't managed by the document manager
+  // it will be handed off once it is loaded
+  doc_start_ = new LineAnalyzerDoc();
+  doc_start_->SetFilename(filepath_start_, false);
+
+  status_bar_log::SetText("Opening document in background: "
+                          + filepath_start_, 0);
+
+  thread_start_ = std::thread([this]() {
+    bool is_loaded = false;
+
+    wxFileInputStream stream(filepath_start_);
+    if (stream.IsOk() == false) {
+      wxLogError("Document file (%s) could not be opened.", filepath_start_);
+    } else {
+      doc_start_->LoadObject(stream);
+
+      // the stream is at the end of file if it was read completely
+      const wxStreamError error = stream.GetLastError();
+      is_loaded = (error == wxSTREAM_NO_ERROR) || (error == wxSTREAM_EOF);
+    }
+
+    CallAfter([this, is_loaded]() {
+      EndLoadStartDocument(is_loaded);
+    });
+  });
+}
+
+void LineAnalyzerApp::EndLoadStartDocument(const bool& is_loaded) {
+  thread_start_.join();
+
+  // errors have already been logged if the document didn't load
+  if (is_loaded == true) {
+    if (manager_doc_->GetCurrentDocument() != nullptr) {
+      // the user opened a document while this one was loading
+      wxLogVerbose("Start document (%s) was discarded because another "
+                   "document is open.", filepath_start_);
+    } else {
+      // creates an empty managed document, and hands off the loaded data
+      wxDocument* document = manager_doc_->CreateDocument(
+          filepath_start_, wxDOC_NEW | wxDOC_SILENT);
+      LineAnalyzerDoc* doc = dynamic_cast<LineAnalyzerDoc*>(document);
+      if (doc != nullptr) {
+        doc->Swap(*doc_start_);
+        doc->SetFilename(filepath_start_, true);
+        doc->SetTitle(wxFileNameFromPath(filepath_start_));
+        doc->SetDocumentSaved(true);
+        doc->Modify(false);
+        manager_doc_->AddFileToHistory(filepath_start_);
+        doc->UpdateAllViews();
+
+        // recovers any changes that weren't saved in the last session
+        doc->OpenJournal();
+
+        wxLogVerbose("Startup time to open document: %ld ms",
+                     watch_startup_.Time());
+      }
+    }
+  }
+
+  delete doc_start_;
+  doc_start_ = nullptr;
+
+  status_bar_log::SetText("Ready", 0);
+}
+
 LineAnalyzerDoc* LineAnalyzerApp::GetDocument() const {
   return dynamic_cast<LineAnalyzerDoc*>(manager_doc_->GetCurrentDocument());
 }
@@ -69,6 +204,18 @@ bool LineAnalyzerApp::OnCmdLineParsed(wxCmdLineParser& parser) {
     filepath_config_ = path.GetFullPath();
   }
 
+  // starts recording trace spans so application startup is included
+  wxString filepath_trace;
+  if (parser.Found("trace", &filepath_trace)) {
+    wxFileName path(filepath_trace);
+    if (path.IsAbsolute() == false) {
+      path.MakeAbsolute(wxEmptyString, wxPATH_NATIVE);
+    }
+
+    filepath_trace_ = path.GetFullPath();
+    Tracer::Start();
+  }
+
   // captures the start file which will be loaded when doc manager is created
   if (parser.GetParamCount() == 1) {
     filepath_start_ = parser.GetParam(0);
@@ -88,9 +235,24 @@ int LineAnalyzerApp::OnExit() {
   }
   FileHandler::SaveConfig(filepath_config_, config_);
 
+  // waits for the start document if it is still loading
+  if (thread_start_.joinable() == true) {
+    thread_start_.join();
+  }
+
   // cleans up allocated resources
+  delete doc_start_;
   delete manager_doc_;
 
+  // exports trace spans if requested on the command line
+  if (filepath_trace_.empty() == false) {
+    Tracer::Stop();
+    Tracer::Export(filepath_trace_);
+  }
+
+  // restores the default document core hooks
+  CoreHooks::Set(nullptr);
+
   // continues exit process
   return wxApp::OnExit();
 }
@@ -115,11 +277,8 @@ bool LineAnalyzerApp::OnInit() {
                            "LineAnalyzerView", CLASSINFO(LineAnalyzerDoc),
                            CLASSINFO(LineAnalyzerView));
 
-  // loads all xml resource files into virtual file system
-  wxXmlResource::Get()->InitAllHandlers();
-  InitXmlResource();
-
   // creates main application frame
+  // only the menubar xrc resource is loaded, dialogs are loaded on first use
   frame_ = new LineAnalyzerFrame(manager_doc_);
   SetTopWindow(frame_);
 
@@ -128,11 +287,17 @@ bool LineAnalyzerApp::OnInit() {
   wxLog::SetActiveTarget(log);
 
   // manually initializes application config defaults
+  config_.autosave_budget = 0.05;
+  config_.autosave_interval = 120;
+  config_.format_document = DocumentFormat::kXml;
   config_.level_log = wxLOG_Message;
   config_.perspective = "";
   config_.size_frame = wxSize(0, 0);
   config_.units = units::UnitSystem::kImperial;
 
+  // connects the document core to the application
+  CoreHooks::Set(&hooks_);
+
   // loads config settings from file
   // any settings defined in the file will override the app defaults
   // filehandler handles all logging
@@ -146,11 +311,6 @@ bool LineAnalyzerApp::OnInit() {
     wxLog::SetVerbose(true);
   }
 
-  // loads a document if defined in command line
-  if (filepath_start_ != wxEmptyString) {
-    manager_doc_->CreateDocument(filepath_start_);
-  }
-
   // sets application frame based on config setting and shows
   if (config_.size_frame.GetHeight() < 100
       || config_.size_frame.GetWidth() < 100) {
@@ -161,8 +321,22 @@ bool LineAnalyzerApp::OnInit() {
   frame_->Centre(wxBOTH);
   frame_->Show(true);
 
-  // updates status bar
-  status_bar_log::SetText("Ready", 0);
+  // paints the frame immediately instead of waiting for the event loop
+  frame_->Update();
+  wxLogVerbose("Startup time to first paint: %ld ms", watch_startup_.Time());
+
+  // loads a document if defined in command line
+  if (filepath_start_ != wxEmptyString) {
+    BeginLoadStartDocument();
+  } else {
+    status_bar_log::SetText("Ready", 0);
+  }
+
+  // logs once the event loop is running and processing user input
+  CallAfter([this]() {
+    wxLogVerbose("Startup time to interactive: %ld ms",
+                 watch_startup_.Time());
+  });
 
   return true;
 }
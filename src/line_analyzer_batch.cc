@@ -0,0 +1,1695 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+// This is the entry point for the headless batch runner. It links the same
+// document core as the GUI application, but runs without a wxApp, frame, or
+// document manager.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "wx/arrstr.h"
+#include "wx/cmdline.h"
+#include "wx/filename.h"
+#include "wx/init.h"
+#include "wx/log.h"
+
+#include "alignment_path.h"
+#include "blowout_engine.h"
+#include "clearance_engine.h"
+#include "core_hooks.h"
+#include "encroachment_engine.h"
+#include "line_analyzer_doc.h"
+#include "line_span.h"
+#include "memory_report.h"
+#include "monte_carlo_engine.h"
+#include "obstacle_layer.h"
+#include "ruling_span_calculator.h"
+#include "spotting_optimizer.h"
+#include "structure_load_engine.h"
+#include "sweep_runner.h"
+#include "terrain_index.h"
+#include "terrain_reader.h"
+#include "tension_table.h"
+#include "trace.h"
+#include "weather_series_evaluator.h"
+#include "weather_series_reader.h"
+
+namespace {
+
+/// The sample spacing along spans for blowout envelopes, in meters.
+const double kSpacingBlowout = 1;
+
+/// The sample spacing along spans for encroachment searches, in meters.
+const double kSpacingEncroachment = 1;
+
+/// The exceedance probability that is logged for Monte Carlo runs.
+const double kProbabilityExceedance = 0.01;
+
+/// The ground profile spacing for spotting, in meters.
+const double kSpacingSpotting = 1;
+
+/// The maximum number of sweep variants.
+const int kCountSweepVariantsMax = 100000;
+
+/// This is an array of command line options.
+const wxCmdLineEntryDesc cmd_line_desc_batch [] = {
+  {wxCMD_LINE_SWITCH, nullptr, "help", "shows this help message",
+      wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP},
+  {wxCMD_LINE_OPTION, nullptr, "blowout",
+      "computes blowout envelopes of the active line and exports the polygons "
+      "to this csv file",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "blowout-intersections",
+      "finds obstacle points within --obstacle-clearance of the blowout "
+      "envelopes and exports them to this csv file (requires --blowout and "
+      "--obstacles)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "clearance",
+      "checks ground clearance along the active line and exports it to this "
+      "csv file (requires --terrain)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "corridor",
+      "the full corridor width that terrain points are kept in, in terrain "
+      "file units (default 200)",
+      wxCMD_LINE_VAL_DOUBLE},
+  {wxCMD_LINE_OPTION, nullptr, "encroachment",
+      "finds obstacle points that encroach on the active line and exports "
+      "them to this csv file (requires --obstacles)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "format",
+      "the file format to re-save documents in (Xml/Zip/ZipBundled)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "units",
+      "the unit system to load documents into (Imperial/Metric)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_SWITCH, nullptr, "memory",
+      "logs the estimated memory usage of each document",
+      wxCMD_LINE_VAL_NONE},
+  {wxCMD_LINE_OPTION, nullptr, "montecarlo",
+      "samples a weathercase of the active line and exports the tension and "
+      "sag histograms to this csv file (requires --montecarlo-case)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "montecarlo-case",
+      "the description of the weathercase that samples are centered on",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "montecarlo-ice",
+      "the ice thickness distribution, as type:spread in --units units "
+      "(fixed/gumbel/normal/uniform, default fixed)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "montecarlo-samples",
+      "the number of Monte Carlo samples (default 1000000)",
+      wxCMD_LINE_VAL_NUMBER},
+  {wxCMD_LINE_OPTION, nullptr, "montecarlo-seed",
+      "the Monte Carlo random seed (default 1)",
+      wxCMD_LINE_VAL_NUMBER},
+  {wxCMD_LINE_OPTION, nullptr, "montecarlo-temperature",
+      "the temperature distribution, as type:spread in --units units "
+      "(fixed/gumbel/normal/uniform, default fixed)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "montecarlo-wind",
+      "the wind pressure distribution, as type:spread in --units units "
+      "(fixed/gumbel/normal/uniform, default fixed)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "obstacle-clearance",
+      "the clearance radius around the cables for encroachments and blowout "
+      "intersections, in terrain file units (default 10)",
+      wxCMD_LINE_VAL_DOUBLE},
+  {wxCMD_LINE_OPTION, nullptr, "obstacles",
+      "the classified obstacle point file (*.xyz/*.txt/*.csv/*.bin) to index "
+      "along the active line",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "output",
+      "the directory to re-save the processed documents into",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_SWITCH, nullptr, "ruling-span",
+      "calculates the ruling span of every line cable in the active line and "
+      "warns if the stored ruling span deviates from it",
+      wxCMD_LINE_VAL_NONE},
+  {wxCMD_LINE_OPTION, nullptr, "series",
+      "the weather time series csv file (time, temperature, wind, ice) to "
+      "evaluate the active line for, in --units units (requires "
+      "--series-output)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "series-output",
+      "the csv file to export the tension and sag of every series row to",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "spotting",
+      "spots structures along the active line alignment for the least cost "
+      "and exports them to this csv file (requires --terrain and "
+      "--spotting-structures)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "spotting-clearance",
+      "the minimum ground clearance for spotting, in terrain file units "
+      "(default 10)",
+      wxCMD_LINE_VAL_DOUBLE},
+  {wxCMD_LINE_OPTION, nullptr, "spotting-spacing",
+      "the spacing of candidate structure stations, in terrain file units "
+      "(default 10)",
+      wxCMD_LINE_VAL_DOUBLE},
+  {wxCMD_LINE_OPTION, nullptr, "spotting-structures",
+      "the ';' separated structure types, as cost:height:span[:weight], "
+      "with the attachment height, maximum wind span, and maximum weight "
+      "span in terrain file units (weight span default unchecked, uplift "
+      "isn't checked)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "spotting-tension",
+      "the maximum support tension for spotting, in --units units (default "
+      "unchecked)",
+      wxCMD_LINE_VAL_DOUBLE},
+  {wxCMD_LINE_OPTION, nullptr, "structure-loads",
+      "calculates the attachment loads of the active line and exports a csv "
+      "file per structure into this directory",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "sweep",
+      "evaluates every combination of the sweep parameters on the active "
+      "line and exports the metrics to this csv file (requires "
+      "--sweep-parameters)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "sweep-parameters",
+      "the ';' separated sweep parameters, as limit:cable:begin:end:step, "
+      "station:structure:begin:end:step, or weathercase:cable:name|name, in "
+      "--units units",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "terrain",
+      "the survey point file (*.xyz/*.txt/*.csv/*.bin) to index along the "
+      "active line",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "terrain-units",
+      "the length units of the terrain file and exported results (Imperial "
+      "= feet, Metric = meters)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_OPTION, nullptr, "trace",
+      "records trace spans and exports them to this file",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_SWITCH, nullptr, "verbose", "enables verbose logging",
+      wxCMD_LINE_VAL_NONE},
+  {wxCMD_LINE_PARAM, nullptr, nullptr, "file",
+      wxCMD_LINE_VAL_STRING,
+      wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE},
+
+  {wxCMD_LINE_NONE}
+};
+
+/// \par OVERVIEW
+///
+/// This struct contains the options that are applied to every document.
+struct BatchOptions {
+  /// \var blowout_filepath
+  ///   The csv file to export blowout envelopes to. If empty, blowout isn't
+  ///   computed.
+  std::string blowout_filepath;
+
+  /// \var blowout_intersections_filepath
+  ///   The csv file to export blowout intersections to. If empty, the
+  ///   envelopes aren't intersected with the obstacles.
+  std::string blowout_intersections_filepath;
+
+  /// \var clearance_filepath
+  ///   The csv file to export ground clearances to. If empty, clearances
+  ///   aren't checked.
+  std::string clearance_filepath;
+
+  /// \var dir_output
+  ///   The directory to save the documents into. If empty, the documents are
+  ///   not saved.
+  std::string dir_output;
+
+  /// \var encroachment_filepath
+  ///   The csv file to export encroachments to. If empty, encroachments
+  ///   aren't searched.
+  std::string encroachment_filepath;
+
+  /// \var format
+  ///   The file format to save the documents in. If a nullptr, the documents
+  ///   are saved in the format they were loaded from.
+  const DocumentFormat* format;
+
+  /// \var is_checking_ruling_spans
+  ///   An indicator that tells if the ruling spans are checked.
+  bool is_checking_ruling_spans;
+
+  /// \var is_reporting_memory
+  ///   An indicator that tells if the memory usage is logged.
+  bool is_reporting_memory;
+
+  /// \var montecarlo_case
+  ///   The description of the weathercase that Monte Carlo samples are
+  ///   centered on.
+  std::string montecarlo_case;
+
+  /// \var montecarlo_count_samples
+  ///   The number of Monte Carlo samples.
+  long montecarlo_count_samples;
+
+  /// \var montecarlo_filepath
+  ///   The csv file to export Monte Carlo histograms to. If empty, the line
+  ///   isn't sampled.
+  std::string montecarlo_filepath;
+
+  /// \var montecarlo_ice
+  ///   The ice thickness distribution, in the document units.
+  MonteCarloDistribution montecarlo_ice;
+
+  /// \var montecarlo_seed
+  ///   The Monte Carlo random seed.
+  long montecarlo_seed;
+
+  /// \var montecarlo_temperature
+  ///   The temperature distribution, in the document units.
+  MonteCarloDistribution montecarlo_temperature;
+
+  /// \var montecarlo_wind
+  ///   The wind pressure distribution, in the document units.
+  MonteCarloDistribution montecarlo_wind;
+
+  /// \var obstacle_clearance
+  ///   The clearance radius around the cables, in the survey point file
+  ///   units.
+  double obstacle_clearance;
+
+  /// \var obstacles_filepath
+  ///   The obstacle point file. If empty, obstacles aren't processed.
+  std::string obstacles_filepath;
+
+  /// \var series_filepath
+  ///   The weather time series file. If empty, the series isn't evaluated.
+  std::string series_filepath;
+
+  /// \var series_output_filepath
+  ///   The csv file to export the weather time series results to.
+  std::string series_output_filepath;
+
+  /// \var spotting_clearance
+  ///   The minimum ground clearance for spotting, in the survey point file
+  ///   units.
+  double spotting_clearance;
+
+  /// \var spotting_filepath
+  ///   The csv file to export spotted structures to. If empty, structures
+  ///   aren't spotted.
+  std::string spotting_filepath;
+
+  /// \var spotting_spacing
+  ///   The candidate station spacing, in the survey point file units.
+  double spotting_spacing;
+
+  /// \var spotting_structures
+  ///   The structure types to spot, in the survey point file units.
+  std::vector<SpottingStructure> spotting_structures;
+
+  /// \var spotting_tension
+  ///   The maximum support tension, in the document units. If zero, the
+  ///   support tension isn't checked.
+  double spotting_tension;
+
+  /// \var structure_loads_dirpath
+  ///   The directory to export structure loads into. If empty, structure
+  ///   loads aren't calculated.
+  std::string structure_loads_dirpath;
+
+  /// \var sweep_filepath
+  ///   The csv file to export sweep results to. If empty, the sweep isn't
+  ///   run.
+  std::string sweep_filepath;
+
+  /// \var sweep_parameters
+  ///   The sweep parameters, which are parsed for each document.
+  std::string sweep_parameters;
+
+  /// \var terrain_filepath
+  ///   The survey point file. If empty, terrain isn't processed.
+  std::string terrain_filepath;
+
+  /// \var terrain_units
+  ///   The length units of the survey point file and the exported results.
+  quantity::Unit<quantity::Length> terrain_units;
+
+  /// \var terrain_width
+  ///   The full corridor width, in the survey point file units.
+  double terrain_width;
+};
+
+/// \par OVERVIEW
+///
+/// This struct contains the analysis data of the active line, which is
+/// shared by the line analyses.
+struct LineContext {
+  /// \var obstacles
+  ///   The obstacle layer.
+  ObstacleLayer obstacles;
+
+  /// \var path
+  ///   The alignment path.
+  AlignmentPath path;
+
+  /// \var rulings
+  ///   The ruling span of every line cable.
+  RulingSpanCalculator rulings;
+
+  /// \var size_cell
+  ///   The terrain grid cell size.
+  double size_cell;
+
+  /// \var spans
+  ///   The spans.
+  std::vector<LineSpan> spans;
+
+  /// \var tensions
+  ///   The tensions for every weathercase and condition.
+  TensionTable tensions;
+
+  /// \var terrain
+  ///   The terrain index.
+  TerrainIndex terrain;
+
+  /// \var width
+  ///   The full corridor width.
+  double width;
+};
+
+/// \brief Combines two statuses into the worst status.
+/// \param[in] status
+///   The status so far.
+/// \param[in] status_other
+///   The status to combine.
+/// \return -1 if either status is -1, 1 if either status is 1, or 0.
+int CombineStatus(const int& status, const int& status_other) {
+  if ((status == -1) || (status_other == -1)) {
+    return -1;
+  } else if ((status == 1) || (status_other == 1)) {
+    return 1;
+  } else {
+    return 0;
+  }
+}
+
+/// \brief Parses a Monte Carlo distribution.
+/// \param[in] str
+///   The distribution string, as type:spread.
+/// \param[in] scale
+///   The scale that converts the spread to the document units.
+/// \param[out] distribution
+///   The distribution.
+/// \return If the distribution was parsed.
+bool ParseDistribution(const wxString& str, const double& scale,
+                       MonteCarloDistribution& distribution) {
+  typedef MonteCarloDistribution::DistributionType DistributionType;
+
+  const wxString str_type = str.BeforeFirst(':').Lower();
+  if (str_type == "fixed") {
+    distribution.type = DistributionType::kFixed;
+  } else if (str_type == "gumbel") {
+    distribution.type = DistributionType::kGumbel;
+  } else if (str_type == "normal") {
+    distribution.type = DistributionType::kNormal;
+  } else if (str_type == "uniform") {
+    distribution.type = DistributionType::kUniform;
+  } else {
+    return false;
+  }
+
+  distribution.spread = 0;
+  if ((distribution.type != DistributionType::kFixed)
+      && ((str.AfterFirst(':').ToDouble(&distribution.spread) == false)
+          || (distribution.spread < 0))) {
+    return false;
+  }
+
+  distribution.spread *= scale;
+  return true;
+}
+
+/// \brief Parses a spotting structure type.
+/// \param[in] str
+///   The structure string, as cost:height:span, optionally followed by
+///   :weight.
+/// \param[out] structure
+///   The structure type.
+/// \return If the structure type was parsed.
+bool ParseSpottingStructure(const wxString& str,
+                            SpottingStructure& structure) {
+  const wxString str_height = str.AfterFirst(':').BeforeFirst(':');
+  const wxString str_spans = str.AfterFirst(':').AfterFirst(':');
+  if ((str.BeforeFirst(':').ToDouble(&structure.cost) == false)
+      || (str_height.ToDouble(&structure.height_attachment) == false)
+      || (str_spans.BeforeFirst(':').ToDouble(&structure.span_max)
+          == false)) {
+    return false;
+  }
+
+  structure.weight_span_max = 0;
+  if ((str_spans.Find(':') != wxNOT_FOUND)
+      && (str_spans.AfterFirst(':').ToDouble(&structure.weight_span_max)
+          == false)) {
+    return false;
+  }
+
+  return (0 <= structure.cost) && (0 < structure.height_attachment)
+         && (0 < structure.span_max) && (0 <= structure.weight_span_max);
+}
+
+/// \brief Parses a sweep parameter.
+/// \param[in] str
+///   The parameter string, as type:index:values.
+/// \param[in] doc
+///   The document, which constraint weathercases are found in.
+/// \param[out] parameter
+///   The parameter.
+/// \return If the parameter was parsed.
+/// Limits and stations are converted from the --units units to the document
+/// units.
+bool ParseSweepParameter(const wxString& str, const LineAnalyzerDoc& doc,
+                         SweepParameter& parameter) {
+  typedef SweepParameter::ParameterType ParameterType;
+
+  long index = 0;
+  if (str.AfterFirst(':').BeforeFirst(':').ToLong(&index) == false) {
+    return false;
+  }
+  parameter.index = (int)index;
+  parameter.values.clear();
+
+  const wxString str_type = str.BeforeFirst(':').Lower();
+  const wxString str_values = str.AfterFirst(':').AfterFirst(':');
+  if (str_type == "weathercase") {
+    parameter.type = ParameterType::kConstraintWeathercase;
+
+    // finds the weathercase index of every description
+    wxArrayString descriptions = wxSplit(str_values, '|');
+    for (auto iter = descriptions.begin(); iter != descriptions.end();
+         iter++) {
+      int index_weathercase = 0;
+      auto it = doc.weathercases().cbegin();
+      while ((it != doc.weathercases().cend())
+             && (it->description != iter->ToStdString())) {
+        index_weathercase++;
+        it++;
+      }
+
+      if (it == doc.weathercases().cend()) {
+        return false;
+      }
+      parameter.values.push_back(index_weathercase);
+    }
+
+    return parameter.values.empty() == false;
+  }
+
+  double scale = 1;
+  if (str_type == "limit") {
+    parameter.type = ParameterType::kConstraintLimit;
+    if (CoreHooks::Get()->units() == units::UnitSystem::kImperial) {
+      scale = quantity::FactorBetween(quantity::force::kPounds,
+                                      quantity::force::kNewtons).scale;
+    }
+  } else if (str_type == "station") {
+    parameter.type = ParameterType::kStation;
+    if (CoreHooks::Get()->units() == units::UnitSystem::kImperial) {
+      scale = quantity::FactorBetween(quantity::length::kFeet,
+                                      quantity::length::kMeters).scale;
+    }
+  } else {
+    return false;
+  }
+
+  // generates the range, which includes the end value
+  double begin = 0;
+  double end = 0;
+  double step = 0;
+  if ((str_values.BeforeFirst(':').ToDouble(&begin) == false)
+      || (str_values.AfterFirst(':').BeforeFirst(':').ToDouble(&end)
+          == false)
+      || (str_values.AfterLast(':').ToDouble(&step) == false)
+      || (step <= 0) || (end < begin)) {
+    return false;
+  }
+
+  const int count_values = (int)std::floor((end - begin) / step + 1e-9) + 1;
+  for (int i = 0; i < count_values; i++) {
+    parameter.values.push_back((begin + i * step) * scale);
+  }
+
+  return true;
+}
+
+/// \brief Computes the blowout envelopes of the active line, and intersects
+///   them with the obstacles if requested.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \param[in] context
+///   The line context.
+/// \return 0 if no errors, or -1 if file related errors.
+int ProcessBlowout(const wxString& name, const BatchOptions& options,
+                   const LineContext& context) {
+  TRACE_SCOPE("ProcessBlowout");
+
+  BlowoutEngine engine;
+  engine.Build(context.spans, context.tensions, kSpacingBlowout);
+
+  // logs the widest swing in the export units
+  double offset_max = 0;
+  for (auto iter = engine.envelopes().cbegin();
+       iter != engine.envelopes().cend(); iter++) {
+    for (auto it = iter->offsets.cbegin(); it != iter->offsets.cend();
+         it++) {
+      offset_max = std::max(offset_max, (double)*it);
+    }
+  }
+
+  const double scale = quantity::FactorBetween(
+      quantity::length::kMeters, options.terrain_units).scale;
+  wxLogMessage("%s: blowout envelopes for %d span(s), maximum swing %.2f",
+               name, (int)engine.envelopes().size(), offset_max * scale);
+
+  if (engine.Export(options.blowout_filepath, options.terrain_units)
+      == false) {
+    return -1;
+  }
+
+  if (options.blowout_intersections_filepath.empty() == true) {
+    return 0;
+  }
+
+  // intersects the envelopes with the obstacle points
+  // the document is in metric units, so the clearance is converted to meters
+  std::vector<BlowoutObstacle> obstacles;
+  obstacles.reserve(context.obstacles.points().size());
+  for (auto iter = context.obstacles.points().cbegin();
+       iter != context.obstacles.points().cend(); iter++) {
+    obstacles.push_back(BlowoutObstacle{iter->z, 0, iter->x, iter->y});
+  }
+
+  const double clearance = options.obstacle_clearance / scale;
+  std::vector<BlowoutIntersection> intersections;
+  engine.Intersect(obstacles, clearance, intersections);
+
+  if (intersections.empty() == false) {
+    auto iter_closest = std::min_element(
+        intersections.cbegin(), intersections.cend(),
+        [](const BlowoutIntersection& a, const BlowoutIntersection& b) {
+      return a.distance < b.distance;
+    });
+    const LineSpan& span = context.spans[iter_closest->index_span];
+    wxLogMessage("%s: %d blowout intersection(s), closest %.2f at span "
+                 "%d-%d",
+                 name, (int)intersections.size(),
+                 iter_closest->distance * scale, span.index_structure_back,
+                 span.index_structure_ahead);
+  } else {
+    wxLogMessage("%s: no blowout intersections.", name);
+  }
+
+  if (engine.ExportIntersections(options.blowout_intersections_filepath,
+                                 obstacles, intersections,
+                                 options.terrain_units) == false) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/// \brief Checks the ground clearance of the active line.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \param[in] context
+///   The line context.
+/// \return 0 if no errors, or -1 if file related errors.
+int ProcessClearance(const wxString& name, const BatchOptions& options,
+                     const LineContext& context) {
+  TRACE_SCOPE("ProcessClearance");
+
+  // the sample windows tile the span, so the cell size doesn't skip ground
+  std::vector<ClearanceResult> results;
+  ClearanceEngine::Check(context.spans, context.tensions, context.path,
+                         context.terrain, context.size_cell, results);
+
+  // logs the controlling clearance in the export units
+  const int index_minimum = ClearanceEngine::Minimum(results);
+  if (index_minimum != -1) {
+    const ClearanceResult& result = results[index_minimum];
+    const LineSpan& span = context.spans[result.index_span];
+    const double scale = quantity::FactorBetween(
+        quantity::length::kMeters, options.terrain_units).scale;
+    wxLogMessage("%s: minimum clearance %.2f at station %.1f, span %d-%d, "
+                 "weathercase '%s'",
+                 name, result.clearance * scale, result.station * scale,
+                 span.index_structure_back, span.index_structure_ahead,
+                 context.tensions.weathercases()[result.index_weathercase]
+                     ->description);
+  } else {
+    wxLogMessage("%s: no spans are over the terrain.", name);
+  }
+
+  if (ClearanceEngine::Export(options.clearance_filepath, context.spans,
+                              context.tensions, results,
+                              options.terrain_units) == false) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/// \brief Searches the obstacle encroachments of the active line.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \param[in] context
+///   The line context.
+/// \return 0 if no errors, or -1 if file related errors.
+int ProcessEncroachment(const wxString& name, const BatchOptions& options,
+                        const LineContext& context) {
+  TRACE_SCOPE("ProcessEncroachment");
+
+  // the document is in metric units, so the clearance is converted to meters
+  const double clearance = options.obstacle_clearance
+      * quantity::FactorBetween(options.terrain_units,
+                                quantity::length::kMeters).scale;
+
+  std::vector<EncroachmentViolation> violations;
+  EncroachmentEngine::Scan(context.obstacles, context.spans,
+                           context.tensions, clearance, kSpacingEncroachment,
+                           violations);
+
+  // logs the closest encroachment in the export units
+  if (violations.empty() == false) {
+    const EncroachmentViolation& violation = violations.front();
+    const LineSpan& span = context.spans[violation.index_span];
+    const double scale = quantity::FactorBetween(
+        quantity::length::kMeters, options.terrain_units).scale;
+    wxLogMessage("%s: %d encroachment(s), closest %.2f at span %d-%d, "
+                 "weathercase %s",
+                 name, (int)violations.size(), violation.distance * scale,
+                 span.index_structure_back, span.index_structure_ahead,
+                 context.tensions.weathercases()
+                     [violation.index_weathercase]->description);
+  } else {
+    wxLogMessage("%s: no encroachments.", name);
+  }
+
+  if (EncroachmentEngine::Export(options.encroachment_filepath,
+                                 context.spans, context.tensions,
+                                 context.obstacles, violations,
+                                 options.terrain_units) == false) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/// \brief Samples the weather of the active line.
+/// \param[in] doc
+///   The document.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \param[in] context
+///   The line context.
+/// \return 0 if no errors, -1 if file related errors, or 1 if the
+///   weathercase can't be found.
+int ProcessMonteCarlo(const LineAnalyzerDoc& doc, const wxString& name,
+                      const BatchOptions& options,
+                      const LineContext& context) {
+  TRACE_SCOPE("ProcessMonteCarlo");
+
+  const WeatherLoadCase* weathercase = nullptr;
+  for (auto iter = doc.weathercases().cbegin();
+       iter != doc.weathercases().cend(); iter++) {
+    if (iter->description == options.montecarlo_case) {
+      weathercase = &(*iter);
+      break;
+    }
+  }
+
+  if (weathercase == nullptr) {
+    wxLogError("%s: Monte Carlo weathercase (%s) could not be found.", name,
+               options.montecarlo_case);
+    return 1;
+  }
+
+  MonteCarloEngine engine;
+  engine.set_distribution_ice(options.montecarlo_ice);
+  engine.set_distribution_temperature(options.montecarlo_temperature);
+  engine.set_distribution_wind(options.montecarlo_wind);
+  const uint64_t count_failed = engine.Run(
+      doc.line(), *weathercase, CableConditionType::kInitial,
+      (int)options.montecarlo_count_samples,
+      (uint64_t)options.montecarlo_seed);
+  if (count_failed != 0) {
+    wxLogWarning("%s: %llu Monte Carlo solution(s) failed.", name,
+                 (unsigned long long)count_failed);
+  }
+
+  // logs the values that are rarely exceeded, in the export units
+  const units::UnitSystem units = CoreHooks::Get()->units();
+  double scale_force = 1;
+  double scale_length = 1;
+  if (units == units::UnitSystem::kImperial) {
+    scale_force = quantity::FactorBetween(quantity::force::kNewtons,
+                                          quantity::force::kPounds).scale;
+    scale_length = quantity::FactorBetween(quantity::length::kMeters,
+                                           quantity::length::kFeet).scale;
+  }
+
+  for (int i = 0; i < (int)engine.histograms_tension().size(); i++) {
+    const MonteCarloHistogram& histogram_tension =
+        engine.histograms_tension()[i];
+    const MonteCarloHistogram& histogram_sag = engine.histograms_sag()[i];
+    const uint64_t count_outside = histogram_tension.count_overflow
+        + histogram_tension.count_underflow + histogram_sag.count_overflow
+        + histogram_sag.count_underflow;
+    if (count_outside != 0) {
+      wxLogMessage("%s: line cable %d, %llu value(s) fell outside of the "
+                   "histogram bins and are exported as tails.",
+                   name, i, (unsigned long long)count_outside);
+    }
+
+    wxLogMessage("%s: line cable %d, %.0f%% exceedance tension %.1f, "
+                 "sag %.2f",
+                 name, i, kProbabilityExceedance * 100,
+                 MonteCarloEngine::ValueExceeded(
+                     histogram_tension, kProbabilityExceedance)
+                     * scale_force,
+                 MonteCarloEngine::ValueExceeded(
+                     histogram_sag, kProbabilityExceedance)
+                     * scale_length);
+  }
+
+  if (engine.Export(options.montecarlo_filepath, units) == false) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/// \brief Indexes the obstacles along the active line.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \param[in,out] context
+///   The line context, which the obstacle layer is built into.
+/// \return 0 if no errors, -1 if file related errors, or 1 if the obstacle
+///   file has no points.
+int ProcessObstacles(const wxString& name, const BatchOptions& options,
+                     LineContext& context) {
+  TRACE_SCOPE("ProcessObstacles");
+
+  std::vector<ObstaclePoint> points;
+  uint64_t count_read = 0;
+  const int status = TerrainReader::ReadObstacles(options.obstacles_filepath,
+                                                  options.terrain_units,
+                                                  context.path, points,
+                                                  count_read);
+  if (status != 0) {
+    return status;
+  }
+
+  const size_t count_kept = points.size();
+  context.obstacles.Build(points);
+
+  wxLogMessage("%s: obstacles %llu point(s) read, %llu point(s) in corridor",
+               name, (unsigned long long)count_read,
+               (unsigned long long)count_kept);
+
+  return 0;
+}
+
+/// \brief Checks the ruling spans of the active line.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] context
+///   The line context, with the ruling spans calculated.
+/// \return 0, as deviating ruling spans are only warnings.
+int ProcessRulingSpans(const wxString& name, const LineContext& context) {
+  TRACE_SCOPE("ProcessRulingSpans");
+
+  const RulingSpanCalculator& calculator = context.rulings;
+
+  // the document is in metric units, so spans are converted for logging
+  double scale = 1;
+  wxString str_units = "m";
+  if (CoreHooks::Get()->units() == units::UnitSystem::kImperial) {
+    scale = quantity::FactorBetween(quantity::length::kMeters,
+                                    quantity::length::kFeet).scale;
+    str_units = "ft";
+  }
+
+  const std::vector<RulingSpanResult>& results = calculator.results();
+  for (int i = 0; i < (int)results.size(); i++) {
+    const RulingSpanResult& result = results[i];
+    if (result.count_spans == 0) {
+      continue;
+    }
+
+    wxLogVerbose("%s: line cable %d ruling span calculated=%.1f %s "
+                 "stored=%.1f %s over %d span(s)",
+                 name, i, result.spacing_calculated * scale, str_units,
+                 result.spacing_stored * scale, str_units,
+                 result.count_spans);
+
+    if (result.is_deviating == true) {
+      wxLogWarning("%s: line cable %d stored ruling span (%.1f %s) deviates "
+                   "from the calculated ruling span (%.1f %s).",
+                   name, i, result.spacing_stored * scale, str_units,
+                   result.spacing_calculated * scale, str_units);
+    }
+  }
+
+  wxLogMessage("%s: %d of %d line cable ruling span(s) deviate by more than "
+               "%.0f%%",
+               name, calculator.CountDeviating(), (int)results.size(),
+               calculator.tolerance() * 100);
+
+  return 0;
+}
+
+/// \brief Evaluates a weather time series for the active line.
+/// \param[in] line
+///   The active line.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \param[in] context
+///   The line context.
+/// \return 0 if no errors, -1 if file related errors, or 1 if the series
+///   has no rows.
+int ProcessSeries(const TransmissionLine& line, const wxString& name,
+                  const BatchOptions& options, const LineContext& context) {
+  TRACE_SCOPE("ProcessSeries");
+
+  const units::UnitSystem units = CoreHooks::Get()->units();
+
+  WeatherSeriesReader reader;
+  if (reader.Open(options.series_filepath, units) == false) {
+    return -1;
+  }
+
+  uint64_t count_rows = 0;
+  const int status = WeatherSeriesEvaluator::Evaluate(
+      line, context.tensions.conditions(), reader,
+      options.series_output_filepath, units, count_rows);
+  if (status != 0) {
+    return status;
+  }
+
+  wxLogMessage("%s: weather series %llu row(s) evaluated, %llu line(s) "
+               "skipped",
+               name, (unsigned long long)count_rows,
+               (unsigned long long)reader.count_skipped());
+
+  return 0;
+}
+
+/// \brief Spots structures along the active line alignment.
+/// \param[in] line
+///   The active line.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \param[in] context
+///   The line context.
+/// \return 0 if no errors, -1 if file related errors, or 1 if no placement
+///   meets the criteria.
+int ProcessSpotting(const TransmissionLine& line, const wxString& name,
+                    const BatchOptions& options, const LineContext& context) {
+  TRACE_SCOPE("ProcessSpotting");
+
+  // spots for the first line cable with a cable, loaded by every solved
+  // weathercase and condition
+  int index_line_cable = 0;
+  auto iter_line_cable = line.line_cables()->cbegin();
+  while ((iter_line_cable != line.line_cables()->cend())
+         && (iter_line_cable->cable() == nullptr)) {
+    index_line_cable++;
+    iter_line_cable++;
+  }
+
+  if (iter_line_cable == line.line_cables()->cend()) {
+    wxLogError("%s: spotting requires a line cable with a cable.", name);
+    return 1;
+  }
+
+  SpottingCriteria criteria;
+  const int count_weathercases =
+      (int)context.tensions.weathercases().size();
+  const int count_conditions = (int)context.tensions.conditions().size();
+  for (int w = 0; w < count_weathercases; w++) {
+    for (int c = 0; c < count_conditions; c++) {
+      SpottingCase spotting_case;
+      spotting_case.tension_horizontal =
+          context.tensions.Tension(index_line_cable, w, c);
+      if (std::isnan(spotting_case.tension_horizontal) == true) {
+        continue;
+      }
+
+      LineSpanBuilder::UnitWeight(*iter_line_cable->cable(),
+                                  *context.tensions.weathercases()[w],
+                                  spotting_case.weight_transverse,
+                                  spotting_case.weight_vertical);
+      criteria.cases.push_back(spotting_case);
+    }
+  }
+
+  // the document is in metric units, so lengths are converted to meters
+  const double scale = quantity::FactorBetween(
+      options.terrain_units, quantity::length::kMeters).scale;
+  criteria.clearance = options.spotting_clearance * scale;
+  criteria.spacing_candidates = options.spotting_spacing * scale;
+  criteria.spacing_samples = kSpacingSpotting;
+  criteria.tension_support_max = options.spotting_tension;
+
+  std::vector<SpottingStructure> structures = options.spotting_structures;
+  for (auto iter = structures.begin(); iter != structures.end(); iter++) {
+    iter->height_attachment *= scale;
+    iter->span_max *= scale;
+    iter->weight_span_max *= scale;
+  }
+
+  // angle points must have structures
+  std::vector<double> stations_fixed;
+  for (auto iter = line.alignment()->points()->cbegin();
+       iter != line.alignment()->points()->cend(); iter++) {
+    if (iter->rotation != 0) {
+      stations_fixed.push_back(iter->station);
+    }
+  }
+
+  SpottingOptimizer optimizer;
+  if (optimizer.Optimize(context.path, context.terrain, stations_fixed,
+                         criteria, structures) != 0) {
+    wxLogError("%s: no structure placement meets the spotting criteria.",
+               name);
+    return 1;
+  }
+
+  wxLogMessage("%s: %d structure(s) spotted with a cost of %.2f, %llu "
+               "span(s) checked, %llu sampled",
+               name, (int)optimizer.placements().size(), optimizer.cost(),
+               (unsigned long long)optimizer.count_checked(),
+               (unsigned long long)optimizer.count_sampled());
+
+  if (optimizer.Export(options.spotting_filepath,
+                       CoreHooks::Get()->units()) == false) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/// \brief Calculates the structure attachment loads of the active line.
+/// \param[in] line
+///   The active line.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \param[in] context
+///   The line context.
+/// \return 0 if no errors, or -1 if file related errors.
+int ProcessStructureLoads(const TransmissionLine& line, const wxString& name,
+                          const BatchOptions& options,
+                          const LineContext& context) {
+  TRACE_SCOPE("ProcessStructureLoads");
+
+  StructureLoadEngine engine;
+  engine.Calculate(line, context.path, context.spans, context.tensions);
+
+  if ((wxFileName::DirExists(options.structure_loads_dirpath) == false)
+      && (wxFileName::Mkdir(options.structure_loads_dirpath,
+                            wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL) == false)) {
+    wxLogError("Structure load directory (%s) could not be created.",
+               options.structure_loads_dirpath);
+    return -1;
+  }
+
+  const int count_files = engine.Export(options.structure_loads_dirpath,
+                                        CoreHooks::Get()->units());
+  if (count_files == -1) {
+    return -1;
+  }
+
+  wxLogMessage("%s: loads for %d attachment(s) exported for %d "
+               "structure(s)",
+               name, (int)engine.attachments().size(), count_files);
+
+  return 0;
+}
+
+/// \brief Runs a parametric sweep on the active line.
+/// \param[in] doc
+///   The document.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \param[in] context
+///   The line context.
+/// \return 0 if no errors, -1 if file related errors, or 1 if the
+///   parameters can't be used.
+int ProcessSweep(const LineAnalyzerDoc& doc, const wxString& name,
+                 const BatchOptions& options, const LineContext& context) {
+  TRACE_SCOPE("ProcessSweep");
+
+  std::vector<SweepParameter> parameters;
+  wxArrayString strs = wxSplit(options.sweep_parameters, ';');
+  for (auto iter = strs.begin(); iter != strs.end(); iter++) {
+    SweepParameter parameter;
+    if (ParseSweepParameter(*iter, doc, parameter) == false) {
+      wxLogError("%s: sweep parameter (%s) is invalid.", name, *iter);
+      return 1;
+    }
+    parameters.push_back(parameter);
+  }
+
+  SweepRunner runner;
+  runner.set_parameters(parameters);
+  const int count_variants = runner.CountVariants();
+  if (kCountSweepVariantsMax < count_variants) {
+    wxLogError("%s: sweep has %d variants, which exceeds the maximum of %d.",
+               name, count_variants, kCountSweepVariantsMax);
+    return 1;
+  }
+
+  std::vector<const WeatherLoadCase*> weathercases;
+  for (auto iter = doc.weathercases().cbegin();
+       iter != doc.weathercases().cend(); iter++) {
+    weathercases.push_back(&(*iter));
+  }
+
+  const int count_solved = runner.Run(
+      doc.line(), context.path, context.rulings, context.spans, weathercases,
+      context.tensions.conditions());
+  if (count_solved == -1) {
+    return 1;
+  }
+
+  wxLogMessage("%s: %d sweep variant(s) evaluated with %d of %d "
+               "solution(s) solved",
+               name, count_variants, count_solved, runner.count_cached());
+
+  if (runner.Export(options.sweep_filepath, weathercases,
+                    CoreHooks::Get()->units()) == false) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/// \brief Indexes the terrain along the active line.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \param[in,out] context
+///   The line context, which the terrain index is built into.
+/// \return 0 if no errors, -1 if file related errors, or 1 if the terrain
+///   has no points.
+int ProcessTerrain(const wxString& name, const BatchOptions& options,
+                   LineContext& context) {
+  TRACE_SCOPE("ProcessTerrain");
+
+  // reads and indexes the terrain
+  std::vector<TerrainPoint> points;
+  uint64_t count_read = 0;
+  const int status = TerrainReader::Read(options.terrain_filepath,
+                                         options.terrain_units, context.path,
+                                         points, count_read);
+  if (status != 0) {
+    return status;
+  }
+
+  const size_t count_kept = points.size();
+  context.size_cell = std::max(context.width / 8, 1.0);
+  context.terrain.Build(points, context.size_cell);
+
+  wxLogMessage("%s: terrain %llu point(s) read, %llu point(s) in corridor",
+               name, (unsigned long long)count_read,
+               (unsigned long long)count_kept);
+
+  // logs a coarse ground profile along the alignment
+  const AlignmentPath& path = context.path;
+  const std::vector<TerrainPoint> profile = context.terrain.Profile(
+      path.station_start(), path.station_end(),
+      std::max((path.station_end() - path.station_start()) / 10, 1.0),
+      context.width / 2);
+  for (auto iter = profile.cbegin(); iter != profile.cend(); iter++) {
+    wxLogVerbose("%s: terrain station=%.1f offset=%.1f elevation=%.2f",
+                 name, iter->station, iter->offset, iter->elevation);
+  }
+
+  return 0;
+}
+
+/// \brief Runs the requested analyses on the active line of a document.
+/// \param[in] doc
+///   The document.
+/// \param[in] name
+///   The document name, which prefixes the log messages.
+/// \param[in] options
+///   The batch options.
+/// \return 0 if no errors, -1 if file related errors, or 1 if the line or
+///   terrain can't be used.
+int ProcessLine(const LineAnalyzerDoc& doc, const wxString& name,
+                const BatchOptions& options) {
+  TRACE_SCOPE("ProcessLine");
+
+  if (doc.index_active() == -1) {
+    wxLogError("%s: line analyses require an active line.", name);
+    return 1;
+  }
+
+  const TransmissionLine& line = doc.line();
+
+  // builds the alignment path
+  // the document is in metric units, so the corridor is converted to meters
+  LineContext context;
+  context.size_cell = 1;
+  context.width = options.terrain_width
+      * quantity::FactorBetween(options.terrain_units,
+                                quantity::length::kMeters).scale;
+  if (context.path.Build(*line.alignment()->points(), context.width / 2)
+      == false) {
+    wxLogError("%s: the active line alignment needs at least two points.",
+               name);
+    return 1;
+  }
+
+  // the ruling spans are shared by the ruling span check and the sweep
+  context.rulings.Calculate(line, context.path);
+
+  if (options.terrain_filepath.empty() == false) {
+    const int status = ProcessTerrain(name, options, context);
+    if (status != 0) {
+      return status;
+    }
+  }
+
+  if (options.obstacles_filepath.empty() == false) {
+    const int status = ProcessObstacles(name, options, context);
+    if (status != 0) {
+      return status;
+    }
+  }
+
+  if (options.is_checking_ruling_spans == true) {
+    ProcessRulingSpans(name, context);
+  }
+
+  // the remaining analyses need the spans and tensions
+  if ((options.blowout_filepath.empty() == true)
+      && (options.clearance_filepath.empty() == true)
+      && (options.encroachment_filepath.empty() == true)
+      && (options.montecarlo_filepath.empty() == true)
+      && (options.series_filepath.empty() == true)
+      && (options.spotting_filepath.empty() == true)
+      && (options.structure_loads_dirpath.empty() == true)
+      && (options.sweep_filepath.empty() == true)) {
+    return 0;
+  }
+
+  const int count_skipped =
+      LineSpanBuilder::Build(line, context.path, context.spans);
+  if (count_skipped != 0) {
+    wxLogWarning("%s: %d line cable connection(s) couldn't be resolved.",
+                 name, count_skipped);
+  }
+
+  // solves every weathercase and condition
+  std::vector<const WeatherLoadCase*> weathercases;
+  for (auto iter = doc.weathercases().cbegin();
+       iter != doc.weathercases().cend(); iter++) {
+    weathercases.push_back(&(*iter));
+  }
+
+  const std::vector<CableConditionType> conditions = {
+      CableConditionType::kInitial, CableConditionType::kCreep,
+      CableConditionType::kLoad};
+
+  const int count_failed =
+      context.tensions.Build(line, weathercases, conditions);
+  if (count_failed != 0) {
+    wxLogWarning("%s: %d sag-tension solution(s) failed.", name,
+                 count_failed);
+  }
+
+  int status = 0;
+  if (options.clearance_filepath.empty() == false) {
+    status = CombineStatus(status, ProcessClearance(name, options, context));
+  }
+
+  if (options.blowout_filepath.empty() == false) {
+    status = CombineStatus(status, ProcessBlowout(name, options, context));
+  }
+
+  if (options.encroachment_filepath.empty() == false) {
+    status = CombineStatus(status,
+                           ProcessEncroachment(name, options, context));
+  }
+
+  if (options.montecarlo_filepath.empty() == false) {
+    status = CombineStatus(status,
+                           ProcessMonteCarlo(doc, name, options, context));
+  }
+
+  if (options.series_filepath.empty() == false) {
+    status = CombineStatus(status, ProcessSeries(line, name, options, context));
+  }
+
+  if (options.spotting_filepath.empty() == false) {
+    status = CombineStatus(status,
+                           ProcessSpotting(line, name, options, context));
+  }
+
+  if (options.structure_loads_dirpath.empty() == false) {
+    status = CombineStatus(status,
+                           ProcessStructureLoads(line, name, options, context));
+  }
+
+  if (options.sweep_filepath.empty() == false) {
+    status = CombineStatus(status, ProcessSweep(doc, name, options, context));
+  }
+
+  return status;
+}
+
+/// \brief Processes a single document.
+/// \param[in] filepath
+///   The document filepath.
+/// \param[in] options
+///   The batch options.
+/// \return 0 if no errors, -1 if file related errors, or 1 if parsing errors
+///   are encountered.
+int ProcessDocument(const std::string& filepath,
+                    const BatchOptions& options) {
+  // converts filepath to absolute so external file references resolve
+  wxFileName path(filepath);
+  if (path.IsAbsolute() == false) {
+    path.MakeAbsolute(wxEmptyString, wxPATH_NATIVE);
+  }
+
+  if (path.FileExists() == false) {
+    wxLogError("Document file (%s) does not exist.", path.GetFullPath());
+    return -1;
+  }
+
+  // loads the document
+  // the filename must be set before loading so relative external file paths
+  // can be resolved
+  LineAnalyzerDoc doc;
+  doc.SetFilename(path.GetFullPath(), false);
+  if (doc.OnOpenDocument(path.GetFullPath()) == false) {
+    return 1;
+  }
+
+  // logs a summary of the document contents
+  wxLogMessage("%s: %d cable(s), %d hardware, %d structure(s), "
+               "%d weathercase(s), %d line(s)",
+               path.GetFullName(),
+               (int)doc.cables().size(), (int)doc.hardwares().size(),
+               (int)doc.structures().size(), (int)doc.weathercases().size(),
+               doc.count_lines());
+
+  // logs memory usage if requested
+  if (options.is_reporting_memory == true) {
+    const MemoryUsage usage = MemoryReport::Measure(doc);
+    wxLogMessage("%s: memory usage\n%s", path.GetFullName(),
+                 MemoryReport::Format(usage));
+  }
+
+  // analyzes the active line if requested
+  if ((options.blowout_filepath.empty() == false)
+      || (options.clearance_filepath.empty() == false)
+      || (options.encroachment_filepath.empty() == false)
+      || (options.is_checking_ruling_spans == true)
+      || (options.montecarlo_filepath.empty() == false)
+      || (options.obstacles_filepath.empty() == false)
+      || (options.series_filepath.empty() == false)
+      || (options.spotting_filepath.empty() == false)
+      || (options.structure_loads_dirpath.empty() == false)
+      || (options.sweep_filepath.empty() == false)
+      || (options.terrain_filepath.empty() == false)) {
+    const int status = ProcessLine(doc, path.GetFullName(), options);
+    if (status != 0) {
+      return status;
+    }
+  }
+
+  // saves the document if requested
+  // the snapshot is saved directly so the exit status reflects the write,
+  // instead of the asynchronous framework save
+  if (options.dir_output.empty() == false) {
+    wxFileName path_output(options.dir_output, path.GetFullName());
+    DocumentSnapshot snapshot = doc.CreateSnapshot();
+    snapshot.filepath = path_output.GetFullPath().ToStdString();
+    if (options.format != nullptr) {
+      snapshot.format = *options.format;
+    }
+    const bool status = LineAnalyzerDoc::SaveSnapshot(
+        snapshot, CoreHooks::Get()->units(), snapshot.filepath);
+    if (status == false) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // initializes the wxWidgets library without a GUI
+  wxInitializer initializer(argc, argv);
+  if (initializer.IsOk() == false) {
+    return -1;
+  }
+
+  // sends all logging to the console
+  wxLog* log = new wxLogStderr();
+  delete wxLog::SetActiveTarget(log);
+
+  // parses the command line
+  wxCmdLineParser parser(cmd_line_desc_batch, argc, argv);
+  parser.SetSwitchChars("--");
+  if (parser.Parse() != 0) {
+    return -1;
+  }
+
+  if (parser.Found("verbose") == true) {
+    wxLog::SetLogLevel(wxLOG_Info);
+    wxLog::SetVerbose(true);
+  }
+
+  // sets the unit system of the default hooks
+  wxString str_units;
+  if (parser.Found("units", &str_units) == true) {
+    if (str_units == "Imperial") {
+      CoreHooks::Get()->set_units(units::UnitSystem::kImperial);
+    } else if (str_units == "Metric") {
+      CoreHooks::Get()->set_units(units::UnitSystem::kMetric);
+    } else {
+      wxLogError("Invalid unit system. Aborting.");
+      return -1;
+    }
+  }
+
+  BatchOptions options;
+
+  wxString dir_output;
+  parser.Found("output", &dir_output);
+  options.dir_output = dir_output.ToStdString();
+
+  // gets the file format to convert documents to
+  DocumentFormat format = DocumentFormat::kXml;
+  options.format = nullptr;
+  wxString str_format;
+  if (parser.Found("format", &str_format) == true) {
+    if (str_format == "Xml") {
+      format = DocumentFormat::kXml;
+    } else if (str_format == "Zip") {
+      format = DocumentFormat::kZip;
+    } else if (str_format == "ZipBundled") {
+      format = DocumentFormat::kZipBundled;
+    } else {
+      wxLogError("Invalid file format. Aborting.");
+      return -1;
+    }
+    options.format = &format;
+  }
+
+  options.is_reporting_memory = parser.Found("memory");
+  options.is_checking_ruling_spans = parser.Found("ruling-span");
+
+  wxString filepath_blowout;
+  parser.Found("blowout", &filepath_blowout);
+  options.blowout_filepath = filepath_blowout.ToStdString();
+
+  wxString filepath_blowout_intersections;
+  parser.Found("blowout-intersections", &filepath_blowout_intersections);
+  options.blowout_intersections_filepath =
+      filepath_blowout_intersections.ToStdString();
+
+  wxString filepath_clearance;
+  parser.Found("clearance", &filepath_clearance);
+  options.clearance_filepath = filepath_clearance.ToStdString();
+
+  wxString filepath_encroachment;
+  parser.Found("encroachment", &filepath_encroachment);
+  options.encroachment_filepath = filepath_encroachment.ToStdString();
+
+  wxString filepath_obstacles;
+  parser.Found("obstacles", &filepath_obstacles);
+  options.obstacles_filepath = filepath_obstacles.ToStdString();
+
+  wxString filepath_series;
+  parser.Found("series", &filepath_series);
+  options.series_filepath = filepath_series.ToStdString();
+
+  wxString filepath_series_output;
+  parser.Found("series-output", &filepath_series_output);
+  options.series_output_filepath = filepath_series_output.ToStdString();
+
+  if ((options.series_filepath.empty() == false)
+      && (options.series_output_filepath.empty() == true)) {
+    wxLogError("Weather series require an output file. Aborting.");
+    return -1;
+  }
+
+  wxString dirpath_structure_loads;
+  parser.Found("structure-loads", &dirpath_structure_loads);
+  options.structure_loads_dirpath = dirpath_structure_loads.ToStdString();
+
+  wxString filepath_sweep;
+  parser.Found("sweep", &filepath_sweep);
+  options.sweep_filepath = filepath_sweep.ToStdString();
+
+  wxString str_sweep_parameters;
+  parser.Found("sweep-parameters", &str_sweep_parameters);
+  options.sweep_parameters = str_sweep_parameters.ToStdString();
+
+  if ((options.sweep_filepath.empty() == false)
+      && (options.sweep_parameters.empty() == true)) {
+    wxLogError("Sweeps require parameters. Aborting.");
+    return -1;
+  }
+
+  // gets the Monte Carlo options
+  // distribution spreads are in the --units units, like the weather series
+  wxString filepath_montecarlo;
+  parser.Found("montecarlo", &filepath_montecarlo);
+  options.montecarlo_filepath = filepath_montecarlo.ToStdString();
+
+  wxString str_montecarlo_case;
+  parser.Found("montecarlo-case", &str_montecarlo_case);
+  options.montecarlo_case = str_montecarlo_case.ToStdString();
+
+  if ((options.montecarlo_filepath.empty() == false)
+      && (options.montecarlo_case.empty() == true)) {
+    wxLogError("Monte Carlo runs require a weathercase. Aborting.");
+    return -1;
+  }
+
+  options.montecarlo_count_samples = 1000000;
+  if ((parser.Found("montecarlo-samples",
+                    &options.montecarlo_count_samples) == true)
+      && ((options.montecarlo_count_samples <= 0)
+          || (1000000000 < options.montecarlo_count_samples))) {
+    wxLogError("Invalid Monte Carlo sample count. Aborting.");
+    return -1;
+  }
+
+  options.montecarlo_seed = 1;
+  parser.Found("montecarlo-seed", &options.montecarlo_seed);
+
+  double scale_ice = quantity::FactorBetween(
+      quantity::length::kCentimeters, quantity::length::kMeters).scale;
+  double scale_temperature = 1;
+  double scale_wind = 1;
+  if (CoreHooks::Get()->units() == units::UnitSystem::kImperial) {
+    scale_ice = quantity::FactorBetween(quantity::length::kInches,
+                                        quantity::length::kMeters).scale;
+    scale_temperature = quantity::FactorBetween(
+        quantity::temperature::kFahrenheit,
+        quantity::temperature::kCelsius).scale;
+    scale_wind = quantity::FactorBetween(
+        quantity::pressure::kPoundsPerSquareFoot,
+        quantity::pressure::kPascals).scale;
+  }
+
+  const wxString names_distribution[] = {
+      "montecarlo-ice", "montecarlo-temperature", "montecarlo-wind"};
+  const double scales_distribution[] = {
+      scale_ice, scale_temperature, scale_wind};
+  MonteCarloDistribution* distributions[] = {
+      &options.montecarlo_ice, &options.montecarlo_temperature,
+      &options.montecarlo_wind};
+  for (int i = 0; i < 3; i++) {
+    ParseDistribution("fixed", 1, *distributions[i]);
+
+    wxString str_distribution;
+    if ((parser.Found(names_distribution[i], &str_distribution) == true)
+        && (ParseDistribution(str_distribution, scales_distribution[i],
+                              *distributions[i]) == false)) {
+      wxLogError("Invalid %s distribution. Aborting.",
+                 names_distribution[i]);
+      return -1;
+    }
+  }
+
+  // gets the terrain file and corridor
+  // terrain units default to the length units of the unit system
+  wxString filepath_terrain;
+  parser.Found("terrain", &filepath_terrain);
+  options.terrain_filepath = filepath_terrain.ToStdString();
+
+  if (CoreHooks::Get()->units() == units::UnitSystem::kImperial) {
+    options.terrain_units = quantity::length::kFeet;
+  } else {
+    options.terrain_units = quantity::length::kMeters;
+  }
+
+  wxString str_terrain_units;
+  if (parser.Found("terrain-units", &str_terrain_units) == true) {
+    if (str_terrain_units == "Imperial") {
+      options.terrain_units = quantity::length::kFeet;
+    } else if (str_terrain_units == "Metric") {
+      options.terrain_units = quantity::length::kMeters;
+    } else {
+      wxLogError("Invalid terrain units. Aborting.");
+      return -1;
+    }
+  }
+
+  if ((options.clearance_filepath.empty() == false)
+      && (options.terrain_filepath.empty() == true)) {
+    wxLogError("Clearance checks require a terrain file. Aborting.");
+    return -1;
+  }
+
+  if ((options.blowout_intersections_filepath.empty() == false)
+      && ((options.blowout_filepath.empty() == true)
+          || (options.obstacles_filepath.empty() == true))) {
+    wxLogError("Blowout intersections require a blowout file and an "
+               "obstacle file. Aborting.");
+    return -1;
+  }
+
+  if ((options.encroachment_filepath.empty() == false)
+      && (options.obstacles_filepath.empty() == true)) {
+    wxLogError("Encroachment searches require an obstacle file. Aborting.");
+    return -1;
+  }
+
+  // gets the spotting options
+  wxString filepath_spotting;
+  parser.Found("spotting", &filepath_spotting);
+  options.spotting_filepath = filepath_spotting.ToStdString();
+
+  if ((options.spotting_filepath.empty() == false)
+      && (options.terrain_filepath.empty() == true)) {
+    wxLogError("Spotting requires a terrain file. Aborting.");
+    return -1;
+  }
+
+  wxString str_spotting_structures;
+  if (parser.Found("spotting-structures", &str_spotting_structures)
+      == true) {
+    wxArrayString strs_spotting_structures =
+        wxSplit(str_spotting_structures, ';');
+    for (auto iter = strs_spotting_structures.begin();
+         iter != strs_spotting_structures.end(); iter++) {
+      SpottingStructure structure;
+      if (ParseSpottingStructure(*iter, structure) == false) {
+        wxLogError("Invalid spotting structure (%s). Aborting.", *iter);
+        return -1;
+      }
+      options.spotting_structures.push_back(structure);
+    }
+  }
+
+  if ((options.spotting_filepath.empty() == false)
+      && (options.spotting_structures.empty() == true)) {
+    wxLogError("Spotting requires structure types. Aborting.");
+    return -1;
+  }
+
+  options.spotting_clearance = 10;
+  if ((parser.Found("spotting-clearance", &options.spotting_clearance)
+       == true) && (options.spotting_clearance <= 0)) {
+    wxLogError("Invalid spotting clearance. Aborting.");
+    return -1;
+  }
+
+  options.spotting_spacing = 10;
+  if ((parser.Found("spotting-spacing", &options.spotting_spacing) == true)
+      && (options.spotting_spacing <= 0)) {
+    wxLogError("Invalid spotting spacing. Aborting.");
+    return -1;
+  }
+
+  options.spotting_tension = 0;
+  if (parser.Found("spotting-tension", &options.spotting_tension) == true) {
+    if (options.spotting_tension <= 0) {
+      wxLogError("Invalid spotting tension. Aborting.");
+      return -1;
+    }
+
+    if (CoreHooks::Get()->units() == units::UnitSystem::kImperial) {
+      options.spotting_tension *= quantity::FactorBetween(
+          quantity::force::kPounds, quantity::force::kNewtons).scale;
+    }
+  }
+
+  options.obstacle_clearance = 10;
+  if ((parser.Found("obstacle-clearance", &options.obstacle_clearance)
+       == true) && (options.obstacle_clearance <= 0)) {
+    wxLogError("Invalid obstacle clearance. Aborting.");
+    return -1;
+  }
+
+  options.terrain_width = 200;
+  if ((parser.Found("corridor", &options.terrain_width) == true)
+      && (options.terrain_width <= 0)) {
+    wxLogError("Invalid corridor width. Aborting.");
+    return -1;
+  }
+
+  wxString filepath_trace;
+  if (parser.Found("trace", &filepath_trace) == true) {
+    Tracer::Start();
+  }
+
+  // processes every document
+  // the return status is the worst status that is encountered
+  int status = 0;
+  for (size_t i = 0; i < parser.GetParamCount(); i++) {
+    const int status_doc = ProcessDocument(parser.GetParam(i).ToStdString(),
+                                           options);
+    if (status_doc == -1) {
+      status = -1;
+    } else if ((status_doc == 1) && (status == 0)) {
+      status = 1;
+    }
+  }
+
+  // exports trace spans
+  if (filepath_trace.empty() == false) {
+    Tracer::Stop();
+    if (Tracer::Export(filepath_trace.ToStdString()) == false) {
+      status = -1;
+    }
+  }
+
+  return status;
+}
@@ -0,0 +1,542 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+// This is the entry point for the console benchmark. It links the same
+// document core as the GUI application and times the document operations
+// without a wxApp or document manager.
+//
+// The results can be saved as a baseline, or compared against a baseline to
+// gate performance regressions. The exit code is 0 if no benchmarks have
+// regressed, 1 if any have regressed, or -1 if errors were encountered.
+
+#include <cmath>
+#include <iterator>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "appcommon/units/weather_load_case_unit_converter.h"
+#include "wx/cmdline.h"
+#include "wx/filename.h"
+#include "wx/init.h"
+#include "wx/log.h"
+#include "wx/mstream.h"
+#include "wx/wfstream.h"
+
+#include "alignment_path.h"
+#include "benchmark_runner.h"
+#include "clearance_engine.h"
+#include "command_journal.h"
+#include "core_hooks.h"
+#include "line_analyzer_doc.h"
+#include "line_analyzer_doc_xml_handler.h"
+#include "line_span.h"
+#include "monte_carlo_engine.h"
+#include "ruling_span_calculator.h"
+#include "spotting_optimizer.h"
+#include "sweep_runner.h"
+#include "tension_table.h"
+#include "terrain_index.h"
+#include "unit_conversion_plan.h"
+
+namespace {
+
+/// This is an array of command line options.
+const wxCmdLineEntryDesc cmd_line_desc_bench [] = {
+  {wxCMD_LINE_SWITCH, nullptr, "help", "shows this help message",
+      wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP},
+  {wxCMD_LINE_OPTION, nullptr, "baseline",
+      "the baseline file (default: test/benchmarks/baseline.json)",
+      wxCMD_LINE_VAL_STRING},
+  {wxCMD_LINE_SWITCH, nullptr, "compare",
+      "compares the results against the baseline file",
+      wxCMD_LINE_VAL_NONE},
+  {wxCMD_LINE_OPTION, nullptr, "samples",
+      "the number of timed samples for each benchmark (default: 15)",
+      wxCMD_LINE_VAL_NUMBER},
+  {wxCMD_LINE_SWITCH, nullptr, "save",
+      "saves the results as the baseline file",
+      wxCMD_LINE_VAL_NONE},
+  {wxCMD_LINE_OPTION, nullptr, "threshold",
+      "the allowable slowdown in percent before failing (default: 10)",
+      wxCMD_LINE_VAL_DOUBLE},
+  {wxCMD_LINE_PARAM, nullptr, nullptr, "file",
+      wxCMD_LINE_VAL_STRING},
+
+  {wxCMD_LINE_NONE}
+};
+
+/// The number of Monte Carlo samples that the Monte Carlo benchmark uses.
+const int kCountSamplesMonteCarlo = 2000;
+
+/// The number of weathercases that the conversion benchmarks use.
+const int kCountWeathercases = 20000;
+
+/// The length of the synthetic alignment, which is 20 miles in meters.
+const double kLengthAlignment = 32187;
+
+/// The station of the synthetic alignment angle point.
+const double kStationAngle = 16000;
+
+/// \brief Builds the synthetic alignment.
+/// \return The alignment points. The alignment is straight except for one
+///   angle point.
+std::list<AlignmentPoint> BuildAlignment() {
+  std::list<AlignmentPoint> points;
+
+  AlignmentPoint point;
+  point.elevation = 100;
+  point.rotation = 0;
+  point.station = 0;
+  points.push_back(point);
+
+  point.rotation = 0.3;
+  point.station = kStationAngle;
+  points.push_back(point);
+
+  point.rotation = 0;
+  point.station = kLengthAlignment;
+  points.push_back(point);
+
+  return points;
+}
+
+/// \brief Builds synthetic terrain along an alignment.
+/// \param[in] station_start
+///   The start station.
+/// \param[in] station_end
+///   The end station.
+/// \return The terrain points, on a 1 m station by 2 m offset grid. The
+///   ground rolls with two overlapping waves, and has a short ridge every
+///   5000 m.
+std::vector<TerrainPoint> BuildTerrain(const double& station_start,
+                                       const double& station_end) {
+  std::vector<TerrainPoint> points;
+  for (int station = (int)station_start; station <= (int)station_end;
+       station++) {
+    float elevation = 100 + 30 * std::sin(station / 700.0)
+                      + 15 * std::sin(station / 173.0);
+    if (station % 5000 < 40) {
+      elevation += 25;
+    }
+
+    for (int offset = -20; offset <= 20; offset += 2) {
+      points.push_back(
+          TerrainPoint{elevation, (float)offset, (float)station});
+    }
+  }
+
+  return points;
+}
+
+/// \brief Builds a large set of weathercases from a document.
+/// \param[in] doc
+///   The document.
+/// \return The weathercases. The document weathercases are repeated, or a
+///   default weathercase is used if the document has none.
+std::list<WeatherLoadCase> BuildWeathercases(const LineAnalyzerDoc& doc) {
+  std::list<WeatherLoadCase> weathercases;
+
+  std::list<WeatherLoadCase> templates = doc.weathercases();
+  if (templates.empty() == true) {
+    WeatherLoadCase weathercase;
+    weathercase.density_ice = 8980;
+    weathercase.pressure_wind = 190;
+    weathercase.temperature_cable = -20;
+    weathercase.thickness_ice = 0.0127;
+    templates.push_back(weathercase);
+  }
+
+  auto iter = templates.cbegin();
+  for (int i = 0; i < kCountWeathercases; i++) {
+    weathercases.push_back(*iter);
+    iter++;
+    if (iter == templates.cend()) {
+      iter = templates.cbegin();
+    }
+  }
+
+  return weathercases;
+}
+
+/// \brief Determines if a conversion plan matches the object converter.
+/// \param[in] weathercases
+///   The weathercases, in metric consistent units.
+/// \return If all converted values match within a relative tolerance.
+bool IsMatchingConversionPlan(
+    const std::list<WeatherLoadCase>& weathercases) {
+  // converts with the object converter
+  std::list<WeatherLoadCase> converted_object = weathercases;
+  for (auto iter = converted_object.begin(); iter != converted_object.end();
+       iter++) {
+    WeatherLoadCaseUnitConverter::ConvertUnitSystem(
+        units::UnitSystem::kMetric, units::UnitSystem::kImperial, *iter);
+  }
+
+  // converts with a plan
+  std::list<WeatherLoadCase> converted_plan = weathercases;
+  UnitConversionPlan plan;
+  plan.AddWeathercases(units::UnitSystem::kMetric,
+                       units::UnitSystem::kImperial, converted_plan);
+  plan.Execute();
+
+  // compares
+  const double kTolerance = 1e-6;
+  auto IsMatching = [kTolerance](const double& a, const double& b) {
+    return std::fabs(a - b) <= kTolerance * std::fmax(1, std::fabs(a));
+  };
+
+  auto iter_plan = converted_plan.cbegin();
+  for (auto iter = converted_object.cbegin(); iter != converted_object.cend();
+       iter++, iter_plan++) {
+    const WeatherLoadCase& a = *iter;
+    const WeatherLoadCase& b = *iter_plan;
+    if ((IsMatching(a.density_ice, b.density_ice) == false)
+        || (IsMatching(a.pressure_wind, b.pressure_wind) == false)
+        || (IsMatching(a.temperature_cable, b.temperature_cable) == false)
+        || (IsMatching(a.thickness_ice, b.thickness_ice) == false)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/// \brief Loads a document from file.
+/// \param[in] filepath
+///   The absolute document filepath.
+/// \param[out] doc
+///   The document to populate.
+/// \return If the document loaded without stream errors.
+bool LoadDocument(const std::string& filepath, LineAnalyzerDoc& doc) {
+  doc.SetFilename(filepath, false);
+
+  wxFileInputStream stream(filepath);
+  if (stream.IsOk() == false) {
+    return false;
+  }
+
+  doc.LoadObject(stream);
+  return stream.IsOk() || (stream.GetLastError() == wxSTREAM_EOF);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // initializes the wxWidgets library without a GUI
+  wxInitializer initializer(argc, argv);
+  if (initializer.IsOk() == false) {
+    return -1;
+  }
+
+  // only errors are sent to the console so timing output stays readable
+  delete wxLog::SetActiveTarget(new wxLogStderr());
+  wxLog::SetLogLevel(wxLOG_Error);
+
+  // parses the command line
+  wxCmdLineParser parser(cmd_line_desc_bench, argc, argv);
+  parser.SetSwitchChars("--");
+  if (parser.Parse() != 0) {
+    return -1;
+  }
+
+  long samples = 15;
+  parser.Found("samples", &samples);
+
+  wxString filepath_baseline = "test/benchmarks/baseline.json";
+  parser.Found("baseline", &filepath_baseline);
+
+  double threshold = 10;
+  parser.Found("threshold", &threshold);
+
+  const bool is_comparing = parser.Found("compare");
+  const bool is_saving = parser.Found("save");
+
+  wxFileName path(parser.GetParam(0));
+  path.MakeAbsolute(wxEmptyString, wxPATH_NATIVE);
+  const std::string filepath = path.GetFullPath().ToStdString();
+
+  // loads a reference document that the save and conversion benchmarks use
+  LineAnalyzerDoc doc;
+  if (LoadDocument(filepath, doc) == false) {
+    wxLogError("Could not load document (%s). Aborting.", filepath);
+    return -1;
+  }
+
+  // checks that the typed conversion plan agrees with the object converters
+  std::list<WeatherLoadCase> weathercases = BuildWeathercases(doc);
+  if (IsMatchingConversionPlan(weathercases) == false) {
+    wxLogError("Unit conversion plan doesn't match the weathercase "
+               "converter. Aborting.");
+    return -1;
+  }
+
+  BenchmarkRunner runner(samples);
+
+  wxPrintf("%-28s %8s %12s %12s %12s %12s\n", "benchmark", "samples",
+           "min (ms)", "median (ms)", "mad (ms)", "max (ms)");
+
+  // only the active line is parsed when loading, so the second benchmark
+  // shows the cost of parsing the rest
+  runner.Run("document_load", [&filepath]() {
+    LineAnalyzerDoc doc_load;
+    LoadDocument(filepath, doc_load);
+  });
+
+  runner.Run("document_load_all_lines", [&filepath]() {
+    LineAnalyzerDoc doc_load;
+    LoadDocument(filepath, doc_load);
+    doc_load.ParseTransmissionLines();
+  });
+
+  runner.Run("document_save", [&doc]() {
+    wxMemoryOutputStream stream;
+    doc.SaveObject(stream);
+  });
+
+  runner.Run("document_save_zip", [&doc]() {
+    DocumentSnapshot snapshot = doc.CreateSnapshot();
+    snapshot.format = DocumentFormat::kZip;
+
+    wxMemoryOutputStream stream;
+    LineAnalyzerDoc::WriteSnapshot(snapshot, units::UnitSystem::kImperial,
+                                   stream);
+  });
+
+  runner.Run("document_node_imperial", [&doc]() {
+    const wxXmlNode* node = LineAnalyzerDocXmlHandler::CreateNode(
+        doc.CreateSnapshot(), units::UnitSystem::kImperial);
+    delete node;
+  });
+
+  // both conversion benchmarks convert to imperial and back, so the values
+  // are the same for every sample
+  runner.Run("weathercases_converter", [&weathercases]() {
+    for (auto iter = weathercases.begin(); iter != weathercases.end();
+         iter++) {
+      WeatherLoadCaseUnitConverter::ConvertUnitSystem(
+          units::UnitSystem::kMetric, units::UnitSystem::kImperial, *iter);
+    }
+    for (auto iter = weathercases.begin(); iter != weathercases.end();
+         iter++) {
+      WeatherLoadCaseUnitConverter::ConvertUnitSystem(
+          units::UnitSystem::kImperial, units::UnitSystem::kMetric, *iter);
+    }
+  });
+
+  runner.Run("weathercases_plan", [&weathercases]() {
+    UnitConversionPlan plan;
+    plan.AddWeathercases(units::UnitSystem::kMetric,
+                         units::UnitSystem::kImperial, weathercases);
+    plan.Execute();
+
+    plan.Clear();
+    plan.AddWeathercases(units::UnitSystem::kImperial,
+                         units::UnitSystem::kMetric, weathercases);
+    plan.Execute();
+  });
+
+  runner.Run("lines_xml_roundtrip", [&doc]() {
+    const wxXmlNode* node = doc.SaveTransmissionLinesToXml();
+    std::list<TransmissionLine> lines;
+    doc.CreateTransmissionLinesFromXml(node, lines);
+    delete node;
+  });
+
+  // appends line changes to a journal for a temporary document file
+  // each append must stay well below a millisecond so commands aren't slowed
+  const wxString filepath_temp = wxFileName::CreateTempFileName("lineanalyzer");
+  CommandJournal journal;
+  std::list<JournalRecord> records;
+  if (journal.Open(filepath_temp.ToStdString(), records) == -1) {
+    wxLogError("Could not open journal. Aborting.");
+    return -1;
+  }
+
+  const wxXmlNode* node_line = doc.SaveTransmissionLineToXml();
+  runner.Run("journal_append", [&journal, node_line]() {
+    JournalRecord record;
+    record.type = JournalRecordType::kLineModify;
+    record.index = -1;
+    record.index_to = -1;
+    record.xml = CommandJournal::WriteXml(node_line);
+    journal.Append(record);
+  });
+  delete node_line;
+
+  journal.Discard();
+  wxRemoveFile(filepath_temp);
+
+  // builds the synthetic alignment and terrain that the terrain and
+  // spotting benchmarks use, so they don't depend on the reference document
+  AlignmentPath path_synthetic;
+  path_synthetic.Build(BuildAlignment(), 50);
+
+  const std::vector<TerrainPoint> points_synthetic =
+      BuildTerrain(0, kLengthAlignment);
+  TerrainIndex terrain_synthetic;
+
+  // the index takes the points, so each sample copies them first
+  // the last index that is built is used for spotting
+  runner.Run("terrain_index", [&]() {
+    std::vector<TerrainPoint> points = points_synthetic;
+    terrain_synthetic.Build(points, 10);
+  });
+
+  // the line analyses run on the active line of the reference document,
+  // with synthetic terrain along its alignment
+  const TransmissionLine* line = nullptr;
+  AlignmentPath path;
+  if (doc.index_active() != -1) {
+    line = &doc.line();
+    if (path.Build(*line->alignment()->points(), 15) == false) {
+      line = nullptr;
+    }
+  }
+
+  if ((line != nullptr) && (doc.weathercases().empty() == false)) {
+    std::vector<TerrainPoint> points =
+        BuildTerrain(path.station_start(), path.station_end());
+    TerrainIndex terrain;
+    terrain.Build(points, 3.75);
+
+    RulingSpanCalculator rulings;
+    rulings.Calculate(*line, path);
+
+    std::vector<LineSpan> spans;
+    LineSpanBuilder::Build(*line, path, spans);
+
+    std::vector<const WeatherLoadCase*> weathercases_line;
+    for (auto iter = doc.weathercases().cbegin();
+         iter != doc.weathercases().cend(); iter++) {
+      weathercases_line.push_back(&(*iter));
+    }
+
+    const std::vector<CableConditionType> conditions = {
+        CableConditionType::kInitial, CableConditionType::kCreep,
+        CableConditionType::kLoad};
+    TensionTable tensions;
+    tensions.Build(*line, weathercases_line, conditions);
+
+    // moves the second structure ahead and back on a copy of the ruling
+    // spans, which only locates the connections to that structure again
+    runner.Run("ruling_span_update", [&]() {
+      if (line->line_structures()->size() < 2) {
+        return;
+      }
+
+      RulingSpanCalculator rulings_moved = rulings;
+      LineStructure line_structure =
+          *std::next(line->line_structures()->cbegin());
+      const double station = line_structure.station();
+      for (int i = -10; i <= 10; i++) {
+        line_structure.set_station(station + i);
+        rulings_moved.UpdateStructure(*line, path, 1, line_structure);
+      }
+    });
+
+    runner.Run("clearance", [&]() {
+      std::vector<ClearanceResult> results;
+      ClearanceEngine::Check(spans, tensions, path, terrain, 3.75, results);
+    });
+
+    // varies the ice, temperature, and wind of the first weathercase
+    // the seed is fixed, so every sample solves the same weathercases
+    runner.Run("monte_carlo", [&]() {
+      MonteCarloEngine engine;
+      engine.set_distribution_ice(MonteCarloDistribution{
+          0.005, MonteCarloDistribution::DistributionType::kGumbel});
+      engine.set_distribution_temperature(MonteCarloDistribution{
+          10, MonteCarloDistribution::DistributionType::kNormal});
+      engine.set_distribution_wind(MonteCarloDistribution{
+          100, MonteCarloDistribution::DistributionType::kNormal});
+      engine.Run(*line, doc.weathercases().front(),
+                 CableConditionType::kInitial, kCountSamplesMonteCarlo, 1);
+    });
+
+    // moves the second structure and varies the first line cable limit
+    // each sample uses a new runner, so no solutions are cached
+    std::vector<SweepParameter> parameters;
+    if ((2 < line->line_structures()->size())
+        && (line->line_cables()->empty() == false)) {
+      const double station = std::next(
+          line->line_structures()->cbegin())->station();
+      parameters.push_back(SweepParameter{
+          1, SweepParameter::ParameterType::kStation,
+          {station - 20, station - 10, station, station + 10,
+           station + 20}});
+
+      const double limit = line->line_cables()->front().constraint().limit;
+      parameters.push_back(SweepParameter{
+          0, SweepParameter::ParameterType::kConstraintLimit,
+          {limit * 0.9, limit, limit * 1.1}});
+    }
+
+    runner.Run("sweep", [&]() {
+      SweepRunner sweep;
+      sweep.set_parameters(parameters);
+      sweep.Run(*line, path, rulings, spans, weathercases_line, conditions);
+    });
+  } else {
+    wxLogError("Document has no active line with an alignment and "
+               "weathercases. Skipping the line analysis benchmarks.");
+  }
+
+  // spots structures along the whole synthetic alignment with three
+  // structure types, which checks about a million spans
+  SpottingCriteria criteria;
+  criteria.cases = {{20000, 0, 15}, {30000, 10, 25}, {25000, 0, 12}};
+  criteria.clearance = 8;
+  criteria.spacing_candidates = 10;
+  criteria.spacing_samples = 1;
+  criteria.tension_support_max = 40000;
+
+  const std::vector<SpottingStructure> structures = {
+      {1.0, 20, 300, 350}, {1.3, 27, 400, 500}, {1.8, 35, 450, 0}};
+  const std::vector<double> stations_fixed = {kStationAngle};
+  runner.Run("spotting", [&]() {
+    SpottingOptimizer optimizer;
+    optimizer.Optimize(path_synthetic, terrain_synthetic, stations_fixed,
+                       criteria, structures);
+  });
+
+  // saves the results as the new baseline
+  if (is_saving == true) {
+    wxFileName path_baseline(filepath_baseline);
+    if (wxFileName::DirExists(path_baseline.GetPath()) == false) {
+      wxFileName::Mkdir(path_baseline.GetPath(), wxS_DIR_DEFAULT,
+                        wxPATH_MKDIR_FULL);
+    }
+
+    if (runner.SaveBaseline(filepath_baseline.ToStdString(),
+                            parser.GetParam(0).ToStdString()) == false) {
+      return -1;
+    }
+    wxPrintf("\nBaseline saved: %s\n", filepath_baseline);
+  }
+
+  // compares the results against the baseline
+  if (is_comparing == true) {
+    // baselines are machine specific, so none is committed with the source
+    if (wxFileName::FileExists(filepath_baseline) == false) {
+      wxLogError("Baseline file (%s) doesn't exist. Save a baseline on this "
+                 "machine with --save before comparing.", filepath_baseline);
+      return -1;
+    }
+
+    std::list<BenchmarkResult> baseline;
+    if (BenchmarkRunner::LoadBaseline(filepath_baseline.ToStdString(),
+                                      baseline) != 0) {
+      return -1;
+    }
+
+    const int count = runner.Compare(baseline, threshold / 100);
+    if (count != 0) {
+      wxPrintf("\n%d benchmark(s) regressed by more than %.1f%%.\n", count,
+               threshold);
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -5,8 +5,6 @@
 
 #include "wx/filename.h"
 
-#include "line_analyzer_app.h"
-
 LineAnalyzerConfigXmlHandler::LineAnalyzerConfigXmlHandler() {
 }
 
@@ -27,6 +25,30 @@ wxXmlNode* LineAnalyzerConfigXmlHandler::CreateNode(
 
   // adds child nodes for struct parameters
 
+  // creates autosave budget node
+  title = "autosave_budget";
+  content = std::to_string(config.autosave_budget);
+  node_element = CreateElementNodeWithContent(title, content);
+  node_root->AddChild(node_element);
+
+  // creates autosave interval node
+  title = "autosave_interval";
+  content = std::to_string(config.autosave_interval);
+  node_element = CreateElementNodeWithContent(title, content);
+  node_root->AddChild(node_element);
+
+  // creates document format node
+  title = "format_document";
+  if (config.format_document == DocumentFormat::kXml) {
+    content = "Xml";
+  } else if (config.format_document == DocumentFormat::kZip) {
+    content = "Zip";
+  } else if (config.format_document == DocumentFormat::kZipBundled) {
+    content = "ZipBundled";
+  }
+  node_element = CreateElementNodeWithContent(title, content);
+  node_root->AddChild(node_element);
+
   // creates log level node
   title = "level_log";
   if (config.level_log == wxLOG_Message) {
@@ -116,7 +138,39 @@ bool LineAnalyzerConfigXmlHandler::ParseNodeV1(const wxXmlNode* root,
     const wxString title = node->GetName();
     const wxString content = ParseElementNodeWithContent(node);
 
-    if (title == "level_log") {
+    if (title == "autosave_budget") {
+      double value = 0;
+      if ((content.ToDouble(&value) == true)
+          && (0 < value) && (value <= 1)) {
+        config.autosave_budget = value;
+      } else {
+        message = FileAndLineNumber(filepath, node)
+                  + "Autosave budget isn't valid. Keeping default setting.";
+        wxLogWarning(message);
+      }
+    } else if (title == "autosave_interval") {
+      long value = 0;
+      if ((content.ToLong(&value) == true) && (0 <= value)) {
+        config.autosave_interval = (int)value;
+      } else {
+        message = FileAndLineNumber(filepath, node)
+                  + "Autosave interval isn't valid. Keeping default setting.";
+        wxLogWarning(message);
+      }
+    } else if (title == "format_document") {
+      if (content == "Xml") {
+        config.format_document = DocumentFormat::kXml;
+      } else if (content == "Zip") {
+        config.format_document = DocumentFormat::kZip;
+      } else if (content == "ZipBundled") {
+        config.format_document = DocumentFormat::kZipBundled;
+      } else {
+        message = FileAndLineNumber(filepath, node)
+                  + "Document format isn't recognized. Keeping default "
+                    "setting.";
+        wxLogWarning(message);
+      }
+    } else if (title == "level_log") {
       if (content == "Normal") {
         config.level_log = wxLOG_Message;
       } else if (content == "Verbose") {
@@ -3,118 +3,144 @@
 
 #include "line_analyzer_doc.h"
 
-#include "appcommon/units/cable_unit_converter.h"
-#include "appcommon/units/hardware_unit_converter.h"
-#include "appcommon/units/structure_unit_converter.h"
-#include "appcommon/units/transmission_line_unit_converter.h"
-#include "appcommon/units/weather_load_case_unit_converter.h"
-#include "appcommon/widgets/status_bar_log.h"
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
 #include "appcommon/xml/transmission_line_xml_handler.h"
-#include "wx/cmdproc.h"
+#include "appcommon/xml/weather_load_case_xml_handler.h"
+#include "wx/filename.h"
+#include "wx/wfstream.h"
 #include "wx/wx.h"
 
+#include "core_hooks.h"
 #include "file_handler.h"
-#include "line_analyzer_app.h"
 #include "line_analyzer_doc_xml_handler.h"
+#include "line_extraction_stream.h"
+#include "trace.h"
+
+namespace {
+
+/// \brief Flushes a file to the storage device.
+/// \param[in] file
+///   The open file.
+/// \return If the file is flushed.
+/// Closing a file only hands its data to the operating system, which can
+/// write it after the file is renamed. A crash in between could leave an
+/// empty document file in place of the old one.
+bool FlushFile(const wxFile& file) {
+#ifdef _WIN32
+  const HANDLE handle = (HANDLE)_get_osfhandle(file.fd());
+  return (handle != INVALID_HANDLE_VALUE)
+      && (FlushFileBuffers(handle) != FALSE);
+#else
+  return fsync(file.fd()) == 0;
+#endif
+}
+
+/// \brief Replaces a file with another file in a single step.
+/// \param[in] filepath_from
+///   The file that replaces the other file.
+/// \param[in] filepath_to
+///   The file that is replaced. It doesn't need to exist.
+/// \return If the file is replaced.
+/// Readers see either the old file or the new file, never neither.
+bool ReplaceFileAtomic(const wxString& filepath_from,
+                       const wxString& filepath_to) {
+#ifdef _WIN32
+  return MoveFileExW(filepath_from.wc_str(), filepath_to.wc_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)
+      != FALSE;
+#else
+  if (std::rename(filepath_from.fn_str(), filepath_to.fn_str()) != 0) {
+    return false;
+  }
+
+  // flushes the directory so the rename is stored
+  // file systems that can't flush directories are not an error
+  wxString directory = wxFileName(filepath_to).GetPath();
+  if (directory.IsEmpty() == true) {
+    directory = ".";
+  }
+
+  const int fd = open(directory.fn_str(), O_RDONLY);
+  if (fd != -1) {
+    fsync(fd);
+    close(fd);
+  }
+
+  return true;
+#endif
+}
+
+}  // namespace
 
 IMPLEMENT_DYNAMIC_CLASS(LineAnalyzerDoc, wxDocument)
 
+const units::UnitSystem LineAnalyzerDoc::kUnitSystem =
+    units::UnitSystem::kMetric;
+
 LineAnalyzerDoc::LineAnalyzerDoc() {
   lines_.push_back(TransmissionLine());
   index_active_ = 0;
   line_active_ = &(*lines_.begin());
+
+  count_changes_ = 0;
+  format_ = CoreHooks::Get()->format_document();
+  is_saving_ = false;
 }
 
 LineAnalyzerDoc::~LineAnalyzerDoc() {
+  WaitForSave();
 }
 
-void LineAnalyzerDoc::ConvertUnitStyle(const units::UnitSystem& system,
-                                       const units::UnitStyle& style_from,
-                                       const units::UnitStyle& style_to) {
-  if (style_from == style_to) {
+void LineAnalyzerDoc::AppendJournal(const JournalRecord& record) {
+  if (journal_.IsOpen() == false) {
     return;
   }
 
-  // converts cable files
-  for (auto it = cables_.begin(); it != cables_.end(); it++) {
-    CableFile& cablefile = *it;
-    Cable& cable = cablefile.cable;
-    CableUnitConverter::ConvertUnitStyle(system, style_from,
-                                         style_to, cable);
-  }
-
-  // converts hardware files
-  for (auto it = hardwares_.begin(); it != hardwares_.end(); it++) {
-    HardwareFile& hardwarefile = *it;
-    Hardware& hardware = hardwarefile.hardware;
-    HardwareUnitConverter::ConvertUnitStyle(system, style_from,
-                                            style_to, hardware);
-  }
-
-  // converts structure files
-  for (auto it = structures_.begin(); it != structures_.end(); it++) {
-    StructureFile& structurefile = *it;
-    Structure& structure = structurefile.structure;
-    StructureUnitConverter::ConvertUnitStyle(system, style_from,
-                                             style_to, structure);
+  // a journal with a missing record can't be replayed correctly, so it is
+  // discarded and journaling stops until the next save
+  if (journal_.Append(record) == false) {
+    journal_.Discard();
   }
+}
 
-  // converts weathercases
-  for (auto it = weathercases_.begin(); it != weathercases_.end(); it++) {
-    WeatherLoadCase& weathercase = *it;
-    WeatherLoadCaseUnitConverter::ConvertUnitStyle(system, style_from,
-                                                   style_to, weathercase);
-  }
+DocumentSnapshot LineAnalyzerDoc::CreateSnapshot() const {
+  TRACE_SCOPE("LineAnalyzerDoc::CreateSnapshot");
 
-  // converts lines
-  for (auto it = lines_.begin(); it != lines_.end(); it++) {
-    TransmissionLine& line = *it;
-    TransmissionLineUnitConverter::ConvertUnitStyle(system, style_from,
-                                                    style_to, line);
-  }
-}
+  // the snapshot needs every line
+  ParseTransmissionLines();
 
-void LineAnalyzerDoc::ConvertUnitSystem(const units::UnitSystem& system_from,
-                                        const units::UnitSystem& system_to) {
-  if (system_from == system_to) {
-    return;
-  }
+  DocumentSnapshot snapshot;
+  snapshot.filepath = GetFilename();
 
-  // converts cable files
-  for (auto it = cables_.begin(); it != cables_.end(); it++) {
-    CableFile& cablefile = *it;
-    Cable& cable = cablefile.cable;
-    CableUnitConverter::ConvertUnitSystem(system_from, system_to, cable);
+  for (auto iter = cables_.cbegin(); iter != cables_.cend(); iter++) {
+    snapshot.filepaths_cables.push_back((*iter).filepath);
   }
 
-  // converts hardware files
-  for (auto it = hardwares_.begin(); it != hardwares_.end(); it++) {
-    HardwareFile& hardwarefile = *it;
-    Hardware& hardware = hardwarefile.hardware;
-    HardwareUnitConverter::ConvertUnitSystem(system_from, system_to, hardware);
+  for (auto iter = hardwares_.cbegin(); iter != hardwares_.cend(); iter++) {
+    snapshot.filepaths_hardwares.push_back((*iter).filepath);
   }
 
-  // converts structure files
-  for (auto it = structures_.begin(); it != structures_.end(); it++) {
-    StructureFile& structurefile = *it;
-    Structure& structure = structurefile.structure;
-    StructureUnitConverter::ConvertUnitSystem(system_from, system_to,
-                                              structure);
+  for (auto iter = structures_.cbegin(); iter != structures_.cend(); iter++) {
+    snapshot.filepaths_structures.push_back((*iter).filepath);
   }
 
-  // converts weathercases
-  for (auto it = weathercases_.begin(); it != weathercases_.end(); it++) {
-    WeatherLoadCase& weathercase = *it;
-    WeatherLoadCaseUnitConverter::ConvertUnitSystem(system_from, system_to,
-                                                    weathercase);
-  }
+  snapshot.files_bundled = files_bundled_;
+  snapshot.format = format_;
+  snapshot.lines = lines_;
+  snapshot.weathercases = weathercases_;
 
-  // converts lines
-  for (auto it = lines_.begin(); it != lines_.end(); it++) {
-    TransmissionLine& line = *it;
-    TransmissionLineUnitConverter::ConvertUnitSystem(system_from, system_to,
-                                                     line);
-  }
+  return snapshot;
 }
 
 bool LineAnalyzerDoc::CreateTransmissionLineFromXml(
@@ -123,41 +149,14 @@ bool LineAnalyzerDoc::CreateTransmissionLineFromXml(
   // clears line
   line = TransmissionLine();
 
-  // creates a list of structure const pointers for parsing
-  std::list<const Structure*> structures;
-  for (auto iter = structures_.cbegin(); iter != structures_.cend(); iter++) {
-    const StructureFile& structurefile = *iter;
-    const Structure* structure = &structurefile.structure;
-    structures.push_back(structure);
-  }
-
-  // creates a list of hardware const pointers for parsing
-  std::list<const Hardware*> hardwares;
-  for (auto iter = hardwares_.cbegin(); iter != hardwares_.cend(); iter++) {
-    const HardwareFile& hardwarefile = *iter;
-    const Hardware* hardware = &hardwarefile.hardware;
-    hardwares.push_back(hardware);
-  }
-
-  // creates a list of cable const pointers for parsing
-  std::list<const Cable*> cables;
-  for (auto iter = cables_.cbegin(); iter != cables_.cend(); iter++) {
-    const CableFile& cablefile = *iter;
-    const Cable* cable = &cablefile.cable;
-    cables.push_back(cable);
-  }
-
-  // creates a list of weathercase const pointers for parsing
-  std::list<const WeatherLoadCase*> weathercases;
-  for (auto iter = weathercases_.cbegin(); iter != weathercases_.cend();
-       iter++) {
-    const WeatherLoadCase* weathercase = &(*iter);
-    weathercases.push_back(weathercase);
-  }
+  // resolves the referenced names with the index, so the xml handler only
+  // searches the items that the line references
+  ReferenceLists references;
+  references_.ListReferences(node, references);
 
   const bool status_node = TransmissionLineXmlHandler::ParseNode(
-      node, "", &structures, &hardwares, &cables, &weathercases,
-      line);
+      node, "", &references.structures, &references.hardwares,
+      &references.cables, &references.weathercases, line);
   if (status_node == false) {
     wxString message =
         TransmissionLineXmlHandler::FileAndLineNumber("", node)
@@ -174,47 +173,20 @@ bool LineAnalyzerDoc::CreateTransmissionLinesFromXml(
   // deletes all transmission lines
   lines.clear();
 
-  // creates a list of structure const pointers for parsing
-  std::list<const Structure*> structures;
-  for (auto iter = structures_.cbegin(); iter != structures_.cend(); iter++) {
-    const StructureFile& structurefile = *iter;
-    const Structure* structure = &structurefile.structure;
-    structures.push_back(structure);
-  }
-
-  // creates a list of hardware const pointers for parsing
-  std::list<const Hardware*> hardwares;
-  for (auto iter = hardwares_.cbegin(); iter != hardwares_.cend(); iter++) {
-    const HardwareFile& hardwarefile = *iter;
-    const Hardware* hardware = &hardwarefile.hardware;
-    hardwares.push_back(hardware);
-  }
-
-  // creates a list of cable const pointers for parsing
-  std::list<const Cable*> cables;
-  for (auto iter = cables_.cbegin(); iter != cables_.cend(); iter++) {
-    const CableFile& cablefile = *iter;
-    const Cable* cable = &cablefile.cable;
-    cables.push_back(cable);
-  }
-
-  // creates a list of weathercase const pointers for parsing
-  std::list<const WeatherLoadCase*> weathercases;
-  for (auto iter = weathercases_.cbegin(); iter != weathercases_.cend();
-       iter++) {
-    const WeatherLoadCase* weathercase = &(*iter);
-    weathercases.push_back(weathercase);
-  }
-
   // parses all sub-nodes
   bool status = true;
+  ReferenceLists references;
   wxXmlNode* sub_node = node->GetChildren();
   while (sub_node != nullptr) {
+    // resolves the referenced names with the index, so the xml handler only
+    // searches the items that the line references
+    references_.ListReferences(sub_node, references);
+
     // creates a transmission line and parses
     TransmissionLine line;
     const bool status_node = TransmissionLineXmlHandler::ParseNode(
-        sub_node, "", &structures, &hardwares, &cables, &weathercases,
-        line);
+        sub_node, "", &references.structures, &references.hardwares,
+        &references.cables, &references.weathercases, line);
     if (status_node == false) {
       status = false;
     }
@@ -236,6 +208,30 @@ bool LineAnalyzerDoc::CreateTransmissionLinesFromXml(
   return status;
 }
 
+bool LineAnalyzerDoc::DoSaveDocument(const wxString& file) {
+  TRACE_SCOPE("LineAnalyzerDoc::DoSaveDocument");
+
+  // only one save can be in progress
+  WaitForSave();
+
+  // journal records after this offset aren't included in the snapshot
+  const uint64_t offset = journal_.offset();
+  const std::string filepath = file.ToStdString();
+
+  // the framework marks the document as saved when this returns, so a failed
+  // write marks it as modified again
+  SaveSnapshotInBackground(filepath, [this, filepath, offset](
+      const bool& status) {
+    if (status == false) {
+      Modify(true);
+    } else {
+      CompactJournal(filepath, offset);
+    }
+  });
+
+  return true;
+}
+
 bool LineAnalyzerDoc::DeleteTransmissionLine(const int& index) {
   // checks index
   if (IsValidIndex(index, lines_.size(), false) == false) {
@@ -244,6 +240,7 @@ bool LineAnalyzerDoc::DeleteTransmissionLine(const int& index) {
 
   // gets iterator with edit capability and deletes
   auto iter = std::next(lines_.begin(), index);
+  lines_unparsed_.erase(&(*iter));
   lines_.erase(iter);
 
   // changes active transmission line to index before deleted one
@@ -258,6 +255,7 @@ bool LineAnalyzerDoc::DeleteTransmissionLine(const int& index) {
   UpdateActiveLineReference();
 
   // marks as modified
+  count_changes_++;
   Modify(true);
 
   return true;
@@ -275,11 +273,36 @@ bool LineAnalyzerDoc::InsertTransmissionLine(const int& index,
   lines_.insert(iter, line);
 
   // marks as modified
+  count_changes_++;
+  Modify(true);
+
+  return true;
+}
+
+bool LineAnalyzerDoc::InsertTransmissionLineUnparsed(
+    const int& index,
+    const UnparsedLine& line) {
+  // checks index
+  if (IsValidIndex(index, lines_.size(), true) == false) {
+    return false;
+  }
+
+  // inserts a placeholder line, which the xml is parsed into later
+  auto iter = std::next(lines_.begin(), index);
+  iter = lines_.insert(iter, TransmissionLine());
+  lines_unparsed_[&(*iter)] = line;
+
+  // marks as modified
+  count_changes_++;
   Modify(true);
 
   return true;
 }
 
+bool LineAnalyzerDoc::IsJournaling() const {
+  return journal_.IsOpen();
+}
+
 bool LineAnalyzerDoc::IsReferencedCableFile(const int& index) const {
   // checks index
   if (IsValidIndex(index, cables_.size(), false) == false) {
@@ -291,6 +314,9 @@ bool LineAnalyzerDoc::IsReferencedCableFile(const int& index) const {
   const CableFile& cablefile = *iter_cable;
   const Cable* cable = &cablefile.cable;
 
+  // the unparsed lines may reference the item
+  ParseTransmissionLines();
+
   // searches transmission lines
   for (auto iter_lines = lines_.cbegin(); iter_lines != lines_.cend();
       iter_lines++) {
@@ -322,6 +348,9 @@ bool LineAnalyzerDoc::IsReferencedHardwareFile(const int& index) const {
   const HardwareFile& hardwarefile = *iter_hardware;
   const Hardware* hardware = &hardwarefile.hardware;
 
+  // the unparsed lines may reference the item
+  ParseTransmissionLines();
+
   // searches transmission lines
   for (auto iter_lines = lines_.cbegin(); iter_lines != lines_.cend();
       iter_lines++) {
@@ -359,6 +388,9 @@ bool LineAnalyzerDoc::IsReferencedStructureFile(const int& index) const {
   const StructureFile& structurefile = *iter_structure;
   const Structure* structure = &structurefile.structure;
 
+  // the unparsed lines may reference the item
+  ParseTransmissionLines();
+
   // searches transmission lines
   for (auto iter_lines = lines_.cbegin(); iter_lines != lines_.cend();
       iter_lines++) {
@@ -389,6 +421,9 @@ bool LineAnalyzerDoc::IsReferencedWeatherCase(const int& index) const {
   auto iter_weather = std::next(weathercases_.cbegin(), index);
   const WeatherLoadCase* weathercase = &(*iter_weather);
 
+  // the unparsed lines may reference the item
+  ParseTransmissionLines();
+
   // searches transmission lines
   for (auto iter_lines = lines_.cbegin(); iter_lines != lines_.cend();
       iter_lines++) {
@@ -420,6 +455,10 @@ bool LineAnalyzerDoc::IsReferencedWeatherCase(const int& index) const {
   return false;
 }
 
+bool LineAnalyzerDoc::IsSaving() const {
+  return is_saving_;
+}
+
 bool LineAnalyzerDoc::IsValidIndex(const int& index,
                                    const int& size,
                                    const bool& is_included_end) const {
@@ -433,25 +472,65 @@ bool LineAnalyzerDoc::IsValidIndex(const int& index,
 }
 
 wxInputStream& LineAnalyzerDoc::LoadObject(wxInputStream& stream) {
-  wxBusyCursor cursor;
+  TRACE_SCOPE("LineAnalyzerDoc::LoadObject");
+
+  // the shared data is replaced, so a save in progress must finish first
+  WaitForSave();
+
+  BusyIndicator busy;
+  CoreHooks* hooks = CoreHooks::Get();
 
   std::string message;
 
   message = "Loading document file: " + this->GetFilename();
   wxLogVerbose(message.c_str());
-  status_bar_log::PushText(message, 0);
+  hooks->PushStatus(message);
 
-  // attempts to load an xml document from the input stream
+  // parses the xml text from the input stream
+  // the inactive lines are cut out of the text as it is read, so only the
+  // active line is parsed as xml
   wxXmlDocument doc_xml;
-  if (doc_xml.Load(stream) == false) {
+  std::vector<UnparsedLine> lines_unparsed;
+  std::map<std::string, std::string> files;
+  bool status_load = false;
+  if (DocumentContainer::IsContainer(stream) == true) {
+    // the document xml entry is decompressed as it is parsed, and the
+    // bundled files that follow it are read afterwards
+    DocumentContainerReader reader(stream);
+    wxInputStream* stream_document = reader.OpenDocument();
+    if (stream_document != nullptr) {
+      LineExtractionStream stream_xml(*stream_document);
+      status_load = (doc_xml.Load(stream_xml) == true)
+                    && (stream_xml.GetLastError() != wxSTREAM_READ_ERROR);
+      lines_unparsed.swap(stream_xml.lines());
+    }
+
+    if (status_load == true) {
+      status_load = reader.ReadFiles(files) == 0;
+    }
+
+    if (files.empty() == true) {
+      format_ = DocumentFormat::kZip;
+    } else {
+      format_ = DocumentFormat::kZipBundled;
+    }
+  } else {
+    LineExtractionStream stream_xml(stream);
+    status_load = (doc_xml.Load(stream_xml) == true)
+                  && (stream_xml.GetLastError() != wxSTREAM_READ_ERROR);
+    lines_unparsed.swap(stream_xml.lines());
+    format_ = DocumentFormat::kXml;
+  }
+
+  if (status_load == false) {
     // notifies user of error
     message = GetFilename() + "  --  "
               "Document file contains an invalid xml structure. The document "
               "will close.";
     wxLogError(message.c_str());
-    wxMessageBox(message);
+    hooks->ShowMessage(message);
 
-    status_bar_log::PopText(0);
+    hooks->PopStatus();
 
     // sets stream to invalid state and returns
     stream.Reset(wxSTREAM_READ_ERROR);
@@ -466,9 +545,9 @@ wxInputStream& LineAnalyzerDoc::LoadObject(wxInputStream& stream) {
               "Document file contains an invalid xml root. The document "
               "will close.";
     wxLogError(message.c_str());
-    wxMessageBox(message);
+    hooks->ShowMessage(message);
 
-    status_bar_log::PopText(0);
+    hooks->PopStatus();
 
     // sets stream to invalide state and returns
     stream.Reset(wxSTREAM_READ_ERROR);
@@ -489,9 +568,9 @@ wxInputStream& LineAnalyzerDoc::LoadObject(wxInputStream& stream) {
                 "Document file contains an invalid units attribute. The "
                 "document will close.";
       wxLogError(message.c_str());
-      wxMessageBox(message);
+      hooks->ShowMessage(message);
 
-      status_bar_log::PopText(0);
+      hooks->PopStatus();
 
       // sets stream to invalide state and returns
       stream.Reset(wxSTREAM_READ_ERROR);
@@ -503,9 +582,9 @@ wxInputStream& LineAnalyzerDoc::LoadObject(wxInputStream& stream) {
               "Document file is missing units attribute. The document will "
               "close.";
     wxLogError(message.c_str());
-    wxMessageBox(message);
+    hooks->ShowMessage(message);
 
-    status_bar_log::PopText(0);
+    hooks->PopStatus();
 
     // sets stream to invalide state and returns
     stream.Reset(wxSTREAM_READ_ERROR);
@@ -514,28 +593,42 @@ wxInputStream& LineAnalyzerDoc::LoadObject(wxInputStream& stream) {
 
   // clears active line in document
   lines_.clear();
+  lines_unparsed_.clear();
 
   // parses the XML node and loads into the document
+  // each item is converted to the document units as it is parsed
   std::string filename = this->GetFilename();
 
   const bool status_node = LineAnalyzerDocXmlHandler::ParseNode(
-      root, filename, wxGetApp().config()->units, *this);
+      root, filename, units_file, files, *this);
+
+  // appends the inactive lines, which are parsed when they are first needed
+  for (auto iter = lines_unparsed.begin(); iter != lines_unparsed.end();
+       iter++) {
+    UnparsedLine& line = *iter;
+    line.units = units_file;
+    InsertTransmissionLineUnparsed(lines_.size(), line);
+  }
+
+  // keeps the bundled files so they can be bundled again if the files on
+  // disk are missing
+  wxFileName filename_doc(filename);
+  filename_doc.MakeAbsolute(wxEmptyString, wxPATH_NATIVE);
+
+  files_bundled_.clear();
+  for (auto iter = files.begin(); iter != files.end(); iter++) {
+    wxFileName filename_file(iter->first, wxPATH_UNIX);
+    if (filename_file.IsAbsolute() == false) {
+      filename_file.MakeAbsolute(filename_doc.GetPath(), wxPATH_NATIVE);
+    }
+    files_bundled_[filename_file.GetFullPath().ToStdString()].swap(
+        iter->second);
+  }
   if (status_node == false) {
     // notifies user of error
     message = GetFilename() + "  --  "
               "Document file contains parsing error(s). Check logs.";
-    wxMessageBox(message);
-  }
-
-  // converts units to consistent style
-  ConvertUnitStyle(units_file,
-                   units::UnitStyle::kDifferent,
-                   units::UnitStyle::kConsistent);
-
-  // converts unit systems if the file doesn't match applicaton config
-  units::UnitSystem units_config = wxGetApp().config()->units;
-  if (units_file != units_config) {
-    ConvertUnitSystem(units_file, units_config);
+    hooks->ShowMessage(message);
   }
 
   // ensures that at least one transmission line exists
@@ -551,13 +644,14 @@ wxInputStream& LineAnalyzerDoc::LoadObject(wxInputStream& stream) {
   // that mark it as modified
   Modify(false);
 
-  status_bar_log::PopText(0);
+  hooks->PopStatus();
 
   return stream;
 }
 
 bool LineAnalyzerDoc::ModifyTransmissionLine(const TransmissionLine& line) {
   *line_active_ = line;
+  count_changes_++;
 
   return true;
 }
@@ -565,6 +659,8 @@ bool LineAnalyzerDoc::ModifyTransmissionLine(const TransmissionLine& line) {
 bool LineAnalyzerDoc::ModifyTransmissionLines(
     const std::list<TransmissionLine>& lines) {
   // commits new lines to document
+  // the list nodes are reused, so the unparsed lines are cleared first
+  lines_unparsed_.clear();
   lines_ = lines;
 
   // checks that at least one line exists
@@ -578,6 +674,8 @@ bool LineAnalyzerDoc::ModifyTransmissionLines(
     index_active_ = 0;
   }
 
+  count_changes_++;
+
   return true;
 }
 
@@ -600,72 +698,214 @@ bool LineAnalyzerDoc::MoveTransmissionLine(const int& index_from,
   lines_.splice(iter_to, lines_, iter_from);
 
   // marks as modified
+  count_changes_++;
   Modify(true);
 
   return true;
 }
 
+bool LineAnalyzerDoc::OnCloseDocument() {
+  // the journal may still be compacted by a save in progress
+  WaitForSave();
+
+  if (wxDocument::OnCloseDocument() == false) {
+    return false;
+  }
+
+  // any changes have been saved or discarded by the user
+  journal_.Discard();
+
+  return true;
+}
+
 bool LineAnalyzerDoc::OnCreate(const wxString& path, long flags) {
   // calls base class function
   return wxDocument::OnCreate(path, flags);
 }
 
-wxOutputStream& LineAnalyzerDoc::SaveObject(wxOutputStream& stream) {
-  wxBusyCursor cursor;
+bool LineAnalyzerDoc::OnOpenDocument(const wxString& file) {
+  // an open journal is from before a revert, and would restore the changes
+  // the user discarded
+  journal_.Discard();
 
-  // logs
-  std::string message = "Saving document file: " + GetFilename();
-  wxLogVerbose(message.c_str());
-  status_bar_log::PushText(message, 0);
+  if (wxDocument::OnOpenDocument(file) == false) {
+    return false;
+  }
 
-  // gets the unit system from app config
-  units::UnitSystem units = wxGetApp().config()->units;
+  if (CoreHooks::Get()->is_journaling() == true) {
+    OpenJournal();
+  }
 
-  // converts to a different unit style for saving
-  ConvertUnitStyle(units, units::UnitStyle::kConsistent,
-                   units::UnitStyle::kDifferent);
+  return true;
+}
 
-  // generates an xml node
-  wxXmlNode* root = LineAnalyzerDocXmlHandler::CreateNode(*this, units);
+bool LineAnalyzerDoc::OpenJournal() {
+  TRACE_SCOPE("LineAnalyzerDoc::OpenJournal");
 
-  // adds unit attribute to xml node
-  // this attribute should be added at this step vs the xml handler because
-  // the attribute describes all values in the file, and is consistent
-  // with how the FileHandler functions work
-  if (units == units::UnitSystem::kImperial) {
-    root->AddAttribute("units", "Imperial");
-  } else if (units == units::UnitSystem::kMetric) {
-    root->AddAttribute("units", "Metric");
+  const std::string filepath = GetFilename();
+  if (filepath.empty() == true) {
+    return false;
   }
 
-  // creates an XML document and savaes to stream
-  wxXmlDocument doc_xml;
-  doc_xml.SetRoot(root);
-  doc_xml.Save(stream);
+  // opens the journal and gets any changes that weren't saved
+  std::list<JournalRecord> records;
+  if (journal_.Open(filepath, records) == -1) {
+    return false;
+  }
+
+  if (records.empty() == true) {
+    return true;
+  }
+
+  // replays the changes onto the saved document
+  int count_failed = 0;
+  for (auto iter = records.cbegin(); iter != records.cend(); iter++) {
+    if (ReplayJournalRecord(*iter) == false) {
+      count_failed++;
+    }
+  }
+
+  Modify(true);
+  UpdateAllViews();
+
+  // notifies the user
+  std::string message = GetFilename() + "  --  Recovered "
+                        + std::to_string(records.size())
+                        + " unsaved change(s) from the journal.";
+  if (count_failed != 0) {
+    message += " " + std::to_string(count_failed)
+               + " change(s) could not be applied. Check logs.";
+  }
+  wxLogMessage(message.c_str());
+  CoreHooks::Get()->ShowMessage(message);
+
+  return true;
+}
+
+bool LineAnalyzerDoc::ParseTransmissionLine(const int& index) const {
+  // checks index
+  if (IsValidIndex(index, lines_.size(), false) == false) {
+    return false;
+  }
+
+  const TransmissionLine* line = &(*std::next(lines_.cbegin(), index));
+  auto iter = lines_unparsed_.find(line);
+  if (iter == lines_unparsed_.end()) {
+    return true;
+  }
+
+  return ParseUnparsedLine(iter);
+}
+
+bool LineAnalyzerDoc::ParseTransmissionLines() const {
+  bool status = true;
+  while (lines_unparsed_.empty() == false) {
+    if (ParseUnparsedLine(lines_unparsed_.begin()) == false) {
+      status = false;
+    }
+  }
+
+  return status;
+}
 
-  // converts back to a consistent unit style
-  ConvertUnitStyle(units, units::UnitStyle::kDifferent,
-                   units::UnitStyle::kConsistent);
+wxOutputStream& LineAnalyzerDoc::SaveObject(wxOutputStream& stream) {
+  TRACE_SCOPE("LineAnalyzerDoc::SaveObject");
 
-  // clears commands in the processor
-  wxCommandProcessor* processor = GetCommandProcessor();
-  processor->ClearCommands();
+  BusyIndicator busy;
+  CoreHooks* hooks = CoreHooks::Get();
 
-  status_bar_log::PopText(0);
+  // writes a snapshot using the unit system from app config
+  // the document and the command history are not modified
+  const bool status = WriteSnapshot(CreateSnapshot(), hooks->units(), stream);
+  if (status == false) {
+    stream.Reset(wxSTREAM_WRITE_ERROR);
+  }
 
   return stream;
 }
 
-wxXmlNode* LineAnalyzerDoc::SaveTransmissionLineToXml() const {
-  units::UnitSystem units = wxGetApp().config()->units;
+bool LineAnalyzerDoc::SaveSnapshot(const DocumentSnapshot& snapshot,
+                                   const units::UnitSystem& units,
+                                   const std::string& filepath) {
+  TRACE_SCOPE("LineAnalyzerDoc::SaveSnapshot");
+
+  // writes to a temporary file so the document file is never left partially
+  // written
+  const wxString filepath_temp = filepath + ".tmp";
+
+  wxFileOutputStream stream(filepath_temp);
+  if (stream.IsOk() == false) {
+    wxLogError("Document file (%s) could not be opened.", filepath_temp);
+    return false;
+  }
+
+  bool status = WriteSnapshot(snapshot, units, stream);
+  if ((status == true) && (FlushFile(*stream.GetFile()) == false)) {
+    status = false;
+  }
+  if (stream.Close() == false) {
+    status = false;
+  }
+
+  // replaces the document file
+  if (status == true) {
+    status = ReplaceFileAtomic(filepath_temp, filepath);
+  }
+
+  if (status == false) {
+    wxLogError("Document file (%s) could not be saved.", filepath);
+    wxRemoveFile(filepath_temp);
+  }
+
+  return status;
+}
 
-  return TransmissionLineXmlHandler::CreateNode(*line_active_, "", units);;
+bool LineAnalyzerDoc::SaveSnapshotInBackground(
+    const std::string& filepath,
+    const std::function<void(const bool&)>& on_finish) {
+  TRACE_SCOPE("LineAnalyzerDoc::SaveSnapshotInBackground");
+
+  if (IsSaving() == true) {
+    return false;
+  }
+
+  // joins the previous save, which has already finished
+  WaitForSave();
+
+  // takes the snapshot on the main thread
+  // the snapshot is shared so the worker thread can own a reference
+  std::shared_ptr<DocumentSnapshot> snapshot =
+      std::make_shared<DocumentSnapshot>(CreateSnapshot());
+  snapshot->filepath = filepath;
+
+  const units::UnitSystem units = CoreHooks::Get()->units();
+
+  // writes the snapshot on a worker thread, and reports back on the main
+  // thread
+  is_saving_ = true;
+  thread_save_ = std::thread([this, snapshot, units, on_finish]() {
+    const bool status = SaveSnapshot(*snapshot, units, snapshot->filepath);
+    is_saving_ = false;
+
+    CallAfter([on_finish, status]() {
+      on_finish(status);
+    });
+  });
+
+  return true;
+}
+
+wxXmlNode* LineAnalyzerDoc::SaveTransmissionLineToXml() const {
+  // the node is only used within the document, so values aren't converted
+  return TransmissionLineXmlHandler::CreateNode(*line_active_, "",
+                                                kUnitSystem);
 }
 
 wxXmlNode* LineAnalyzerDoc::SaveTransmissionLinesToXml() const {
-  units::UnitSystem units = wxGetApp().config()->units;
+  ParseTransmissionLines();
 
   // creates a node for the root
+  // the node is only used within the document, so values aren't converted
   wxXmlNode* node_root = new wxXmlNode(wxXML_ELEMENT_NODE,
                                        "transmission_lines");
 
@@ -673,17 +913,138 @@ wxXmlNode* LineAnalyzerDoc::SaveTransmissionLinesToXml() const {
   for (auto iter = lines_.cbegin(); iter != lines_.cend(); iter++) {
     const TransmissionLine& line = *iter;
     wxXmlNode* sub_node =
-        TransmissionLineXmlHandler::CreateNode(line, "", units);
+        TransmissionLineXmlHandler::CreateNode(line, "", kUnitSystem);
     node_root->AddChild(sub_node);
   }
 
   return node_root;
 }
 
+void LineAnalyzerDoc::Swap(LineAnalyzerDoc& doc) {
+  // the shared data is exchanged, so saves in progress must finish first
+  WaitForSave();
+  doc.WaitForSave();
+
+  // swaps lists
+  // list nodes are relinked, so pointers to the list items are still valid
+  cables_.swap(doc.cables_);
+  hardwares_.swap(doc.hardwares_);
+  structures_.swap(doc.structures_);
+  weathercases_.swap(doc.weathercases_);
+  lines_.swap(doc.lines_);
+
+  // swaps the active line
+  std::swap(index_active_, doc.index_active_);
+  std::swap(line_active_, doc.line_active_);
+
+  // swaps the reference indexes
+  // the indexed items were relinked with the lists
+  std::swap(references_, doc.references_);
+
+  // swaps the unparsed lines
+  // the keys are still valid because the list nodes were relinked
+  lines_unparsed_.swap(doc.lines_unparsed_);
+
+  // swaps the file format
+  files_bundled_.swap(doc.files_bundled_);
+  std::swap(format_, doc.format_);
+}
+
+void LineAnalyzerDoc::WaitForSave() {
+  if (thread_save_.joinable() == true) {
+    thread_save_.join();
+  }
+}
+
+bool LineAnalyzerDoc::WriteSnapshot(const DocumentSnapshot& snapshot,
+                                    const units::UnitSystem& units,
+                                    wxOutputStream& stream) {
+  TRACE_SCOPE("LineAnalyzerDoc::WriteSnapshot");
+
+  CoreHooks* hooks = CoreHooks::Get();
+
+  // logs
+  std::string message = "Saving document file: " + snapshot.filepath;
+  wxLogVerbose(message.c_str());
+  hooks->PushStatus(message);
+
+  // generates an xml node
+  // each item is converted from the document units as it is written
+  wxXmlNode* root = LineAnalyzerDocXmlHandler::CreateNode(snapshot, units);
+
+  // adds unit attribute to xml node
+  // this attribute should be added at this step vs the xml handler because
+  // the attribute describes all values in the file, and is consistent
+  // with how the FileHandler functions work
+  if (units == units::UnitSystem::kImperial) {
+    root->AddAttribute("units", "Imperial");
+  } else if (units == units::UnitSystem::kMetric) {
+    root->AddAttribute("units", "Metric");
+  }
+
+  // creates an XML document and saves to stream
+  wxXmlDocument doc_xml;
+  doc_xml.SetRoot(root);
+
+  bool status = false;
+  if (snapshot.format == DocumentFormat::kXml) {
+    status = doc_xml.Save(stream);
+  } else {
+    // gets the external files to bundle
+    std::list<BundledFile> files;
+    if (snapshot.format == DocumentFormat::kZipBundled) {
+      wxFileName filename_doc(snapshot.filepath);
+      filename_doc.MakeAbsolute(wxEmptyString, wxPATH_NATIVE);
+
+      std::list<std::string> filepaths;
+      filepaths.insert(filepaths.end(), snapshot.filepaths_structures.cbegin(),
+                       snapshot.filepaths_structures.cend());
+      filepaths.insert(filepaths.end(), snapshot.filepaths_hardwares.cbegin(),
+                       snapshot.filepaths_hardwares.cend());
+      filepaths.insert(filepaths.end(), snapshot.filepaths_cables.cbegin(),
+                       snapshot.filepaths_cables.cend());
+
+      for (auto iter = filepaths.cbegin(); iter != filepaths.cend(); iter++) {
+        BundledFile file;
+        file.filepath = *iter;
+        file.name = LineAnalyzerDocXmlHandler::RelativeFilePath(
+            *iter, filename_doc.GetPath());
+
+        // uses the previously bundled copy if the file is missing
+        auto iter_bundled = snapshot.files_bundled.find(*iter);
+        if ((wxFileName::FileExists(*iter) == false)
+            && (iter_bundled != snapshot.files_bundled.cend())) {
+          file.data = iter_bundled->second;
+        }
+
+        files.push_back(file);
+      }
+    }
+
+    status = DocumentContainer::Write(doc_xml, files, stream);
+  }
+
+  hooks->PopStatus();
+
+  return status;
+}
+
 const std::list<CableFile>& LineAnalyzerDoc::cables() const {
   return cables_;
 }
 
+int LineAnalyzerDoc::count_changes() const {
+  return count_changes_;
+}
+
+int LineAnalyzerDoc::count_lines() const {
+  return (int)lines_.size();
+}
+
+DocumentFormat LineAnalyzerDoc::format() const {
+  return format_;
+}
+
 const std::list<HardwareFile>& LineAnalyzerDoc::hardwares() const {
   return hardwares_;
 }
@@ -697,10 +1058,26 @@ const TransmissionLine& LineAnalyzerDoc::line() const {
 }
 
 const std::list<TransmissionLine>& LineAnalyzerDoc::lines() const {
+  // placeholders aren't handed out
+  ParseTransmissionLines();
+  return lines_;
+}
+
+const std::list<TransmissionLine>& LineAnalyzerDoc::lines_stored() const {
   return lines_;
 }
 
+const std::map<const TransmissionLine*, UnparsedLine>&
+    LineAnalyzerDoc::lines_unparsed() const {
+  return lines_unparsed_;
+}
+
 bool LineAnalyzerDoc::set_cables(const std::list<CableFile>& cablefiles) {
+  TRACE_SCOPE("LineAnalyzerDoc::set_cables");
+
+  // the shared data is replaced, so a save in progress must finish first
+  WaitForSave();
+
   // saves xml node for transmission lines and clears lines
   const wxXmlNode* node = SaveTransmissionLinesToXml();
   lines_.clear();
@@ -708,22 +1085,37 @@ bool LineAnalyzerDoc::set_cables(const std::list<CableFile>& cablefiles) {
   // temporarily caches and then replaces existing cables
   std::list<CableFile> cables_cache = cables_;
   cables_ = cablefiles;
+  UpdateReferenceIndex();
 
   // reloads transmission lines from xml node
   bool status = CreateTransmissionLinesFromXml(node, lines_);
   if (status == false) {
     // loading lines failed, so resets to starting condition
     cables_ = cables_cache;
+    UpdateReferenceIndex();
 
     lines_.clear();
     CreateTransmissionLinesFromXml(node, lines_);
   }
 
+  delete node;
+
+  count_changes_++;
+
   return status;
 }
 
+void LineAnalyzerDoc::set_format(const DocumentFormat& format) {
+  format_ = format;
+}
+
 bool LineAnalyzerDoc::set_hardwares(
     const std::list<HardwareFile>& hardwarefiles) {
+  TRACE_SCOPE("LineAnalyzerDoc::set_hardwares");
+
+  // the shared data is replaced, so a save in progress must finish first
+  WaitForSave();
+
   // saves xml node for transmission lines and clears lines
   const wxXmlNode* node = SaveTransmissionLinesToXml();
   lines_.clear();
@@ -731,21 +1123,29 @@ bool LineAnalyzerDoc::set_hardwares(
   // temporarily caches and then replaces existing hardware
   std::list<HardwareFile> hardwares_cache = hardwares_;
   hardwares_ = hardwarefiles;
+  UpdateReferenceIndex();
 
   // reloads transmission lines from xml node
   bool status = CreateTransmissionLinesFromXml(node, lines_);
   if (status == false) {
     // loading lines failed, so resets to starting condition
     hardwares_ = hardwares_cache;
+    UpdateReferenceIndex();
 
     lines_.clear();
     CreateTransmissionLinesFromXml(node, lines_);
   }
 
+  delete node;
+
+  count_changes_++;
+
   return status;
 }
 
 bool LineAnalyzerDoc::set_index_active(const int& index) {
+  TRACE_SCOPE("LineAnalyzerDoc::set_index_active");
+
   if (IsValidIndex(index, lines_.size(), false) == true) {
     index_active_ = index;
     UpdateActiveLineReference();
@@ -757,6 +1157,11 @@ bool LineAnalyzerDoc::set_index_active(const int& index) {
 
 bool LineAnalyzerDoc::set_structures(
     const std::list<StructureFile>& structurefiles) {
+  TRACE_SCOPE("LineAnalyzerDoc::set_structures");
+
+  // the shared data is replaced, so a save in progress must finish first
+  WaitForSave();
+
   // saves xml node for transmission lines and clears lines
   const wxXmlNode* node = SaveTransmissionLinesToXml();
   lines_.clear();
@@ -764,22 +1169,33 @@ bool LineAnalyzerDoc::set_structures(
   // temporarily caches and then replaces existing structures
   std::list<StructureFile> structures_cache = structures_;
   structures_ = structurefiles;
+  UpdateReferenceIndex();
 
   // reloads transmission lines from xml node
   bool status = CreateTransmissionLinesFromXml(node, lines_);
   if (status == false) {
     // loading lines failed, so resets to starting condition
     structures_ = structures_cache;
+    UpdateReferenceIndex();
 
     lines_.clear();
     CreateTransmissionLinesFromXml(node, lines_);
   }
 
+  delete node;
+
+  count_changes_++;
+
   return status;
 }
 
 bool LineAnalyzerDoc::set_weathercases(
     const std::list<WeatherLoadCase>& weathercases) {
+  TRACE_SCOPE("LineAnalyzerDoc::set_weathercases");
+
+  // the shared data is replaced, so a save in progress must finish first
+  WaitForSave();
+
   // saves xml node for transmission lines and clears lines
   const wxXmlNode* node = SaveTransmissionLinesToXml();
   lines_.clear();
@@ -787,20 +1203,30 @@ bool LineAnalyzerDoc::set_weathercases(
   // temporarily caches and then replaces existing weathercases
   std::list<WeatherLoadCase> weathercases_cache = weathercases_;
   weathercases_ = weathercases;
+  UpdateReferenceIndex();
 
   // reloads transmission lines from xml node
   bool status = CreateTransmissionLinesFromXml(node, lines_);
   if (status == false) {
     // loading lines failed, so resets to starting condition
     weathercases_ = weathercases_cache;
+    UpdateReferenceIndex();
 
     lines_.clear();
     CreateTransmissionLinesFromXml(node, lines_);
   }
 
+  delete node;
+
+  count_changes_++;
+
   return status;
 }
 
+const ReferenceIndex& LineAnalyzerDoc::references() const {
+  return references_;
+}
+
 const std::list<StructureFile>& LineAnalyzerDoc::structures() const {
   return structures_;
 }
@@ -809,11 +1235,24 @@ const std::list<WeatherLoadCase>& LineAnalyzerDoc::weathercases() const {
   return weathercases_;
 }
 
+void LineAnalyzerDoc::CompactJournal(const std::string& filepath,
+                                     const uint64_t& offset) {
+  if (journal_.IsOpen() == true) {
+    if (journal_.Compact(filepath, offset) == false) {
+      journal_.Discard();
+    }
+  } else if (CoreHooks::Get()->is_journaling() == true) {
+    // starts journaling once a new document has a file to replay onto
+    std::list<JournalRecord> records;
+    journal_.Open(filepath, records);
+  }
+}
+
 bool LineAnalyzerDoc::IsUniqueWeathercaseName(const std::string& name,
                                               const int& index_ignore) const {
   int index = 0;
   for (auto iter = weathercases_.cbegin(); iter != weathercases_.cend();
-       iter++) {
+       iter++, index++) {
     const WeatherLoadCase& weathercase = *iter;
 
     if (index == index_ignore) {
@@ -829,6 +1268,168 @@ bool LineAnalyzerDoc::IsUniqueWeathercaseName(const std::string& name,
   return true;
 }
 
+bool LineAnalyzerDoc::ParseUnparsedLine(
+    std::map<const TransmissionLine*, UnparsedLine>::iterator iter) const {
+  TRACE_SCOPE("LineAnalyzerDoc::ParseUnparsedLine");
+
+  TransmissionLine line;
+  const bool status =
+      LineAnalyzerDocXmlHandler::ParseUnparsedTransmissionLine(
+          iter->second, GetFilename().ToStdString(), *this, line);
+
+  // fills in the placeholder
+  // the placeholder isn't part of the document contents yet, so it can be
+  // modified from a const method
+  *const_cast<TransmissionLine*>(iter->first) = line;
+  lines_unparsed_.erase(iter);
+
+  if (status == false) {
+    // notifies user of error
+    std::string message;
+    message = GetFilename() + "  --  "
+              "Transmission line contains parsing error(s). Check logs.";
+    CoreHooks::Get()->ShowMessage(message);
+
+    // the parsed line no longer matches the file, so the document is marked
+    // as modified to have it saved
+    const_cast<LineAnalyzerDoc*>(this)->Modify(true);
+  }
+
+  return status;
+}
+
+bool LineAnalyzerDoc::ReplayJournalRecord(const JournalRecord& record) {
+  bool status = true;
+
+  if ((record.type == JournalRecordType::kCables)
+      || (record.type == JournalRecordType::kHardwares)
+      || (record.type == JournalRecordType::kStructures)) {
+    // loads the external files
+    // filehandler functions handle all logging
+    std::list<CableFile> cables;
+    std::list<HardwareFile> hardwares;
+    std::list<StructureFile> structures;
+    for (auto iter = record.filepaths.cbegin();
+         iter != record.filepaths.cend(); iter++) {
+      const std::string& filepath = *iter;
+      int status_file = 0;
+      if (record.type == JournalRecordType::kCables) {
+        CableFile cablefile;
+        cablefile.filepath = filepath;
+        status_file = FileHandler::LoadCable(filepath, kUnitSystem,
+                                             cablefile.cable);
+        cables.push_back(cablefile);
+      } else if (record.type == JournalRecordType::kHardwares) {
+        HardwareFile hardwarefile;
+        hardwarefile.filepath = filepath;
+        status_file = FileHandler::LoadHardware(filepath, kUnitSystem,
+                                                hardwarefile.hardware);
+        hardwares.push_back(hardwarefile);
+      } else {
+        StructureFile structurefile;
+        structurefile.filepath = filepath;
+        status_file = FileHandler::LoadStructure(filepath, kUnitSystem,
+                                                 structurefile.structure);
+        structures.push_back(structurefile);
+      }
+
+      if (status_file == -1) {
+        return false;
+      }
+    }
+
+    if (record.type == JournalRecordType::kCables) {
+      status = set_cables(cables);
+    } else if (record.type == JournalRecordType::kHardwares) {
+      status = set_hardwares(hardwares);
+    } else {
+      status = set_structures(structures);
+    }
+  } else if (record.type == JournalRecordType::kLineActivate) {
+    status = set_index_active(record.index);
+  } else if (record.type == JournalRecordType::kLineDelete) {
+    status = DeleteTransmissionLine(record.index);
+  } else if (record.type == JournalRecordType::kLineMove) {
+    status = MoveTransmissionLine(record.index, record.index_to);
+  } else {
+    // the remaining records contain xml
+    const wxXmlNode* node = CommandJournal::ParseXml(record.xml);
+    if (node == nullptr) {
+      wxLogError("Journal record contains invalid xml. Skipping.");
+      return false;
+    }
+
+    if (record.type == JournalRecordType::kLineInsert) {
+      TransmissionLine line;
+      status = CreateTransmissionLineFromXml(node, line);
+      if (status == true) {
+        status = InsertTransmissionLine(record.index, line);
+      }
+    } else if (record.type == JournalRecordType::kLineModify) {
+      TransmissionLine line;
+      status = CreateTransmissionLineFromXml(node, line);
+      if (status == true) {
+        status = ModifyTransmissionLine(line);
+      }
+    } else if (record.type == JournalRecordType::kLines) {
+      std::list<TransmissionLine> lines;
+      status = CreateTransmissionLinesFromXml(node, lines);
+      ModifyTransmissionLines(lines);
+      UpdateActiveLineReference();
+    } else if (record.type == JournalRecordType::kWeathercases) {
+      // the values were written in the document units, so aren't converted
+      std::list<WeatherLoadCase> weathercases;
+      const wxXmlNode* sub_node = node->GetChildren();
+      while (sub_node != nullptr) {
+        WeatherLoadCase weathercase;
+        if (WeatherLoadCaseXmlHandler::ParseNode(sub_node, "",
+                                                 weathercase) == false) {
+          status = false;
+        }
+        weathercases.push_back(weathercase);
+        sub_node = sub_node->GetNext();
+      }
+
+      if (set_weathercases(weathercases) == false) {
+        status = false;
+      }
+    } else {
+      status = false;
+    }
+
+    delete node;
+  }
+
+  if (status == false) {
+    wxLogError("Journal record could not be fully applied.");
+  }
+
+  return status;
+}
+
 void LineAnalyzerDoc::UpdateActiveLineReference() {
+  // the active line is editable, so it must be parsed
+  ParseTransmissionLine(index_active_);
   line_active_ = &(*std::next(lines_.begin(), index_active_));
 }
+
+void LineAnalyzerDoc::UpdateReferenceIndex() {
+  references_.Clear();
+
+  for (auto iter = cables_.cbegin(); iter != cables_.cend(); iter++) {
+    references_.AddCable(&(*iter).cable);
+  }
+
+  for (auto iter = hardwares_.cbegin(); iter != hardwares_.cend(); iter++) {
+    references_.AddHardware(&(*iter).hardware);
+  }
+
+  for (auto iter = structures_.cbegin(); iter != structures_.cend(); iter++) {
+    references_.AddStructure(&(*iter).structure);
+  }
+
+  for (auto iter = weathercases_.cbegin(); iter != weathercases_.cend();
+       iter++) {
+    references_.AddWeathercase(&(*iter));
+  }
+}
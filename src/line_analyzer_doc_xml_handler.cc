@@ -3,14 +3,51 @@
 
 #include "line_analyzer_doc_xml_handler.h"
 
+#include "appcommon/units/transmission_line_unit_converter.h"
+#include "appcommon/units/weather_load_case_unit_converter.h"
 #include "appcommon/xml/transmission_line_xml_handler.h"
 #include "appcommon/xml/weather_load_case_xml_handler.h"
 #include "wx/filename.h"
+#include "wx/mstream.h"
 
 #include "file_handler.h"
+#include "trace.h"
+#include "unit_conversion_plan.h"
+
+namespace {
+
+/// \brief Converts an item from the document units to a file unit system.
+/// \param[in] units
+///   The file unit system.
+/// \param[in,out] item
+///   The item, which is converted to the different unit style.
+template<typename Converter, typename T>
+void ConvertFromDocumentUnits(const units::UnitSystem& units, T& item) {
+  if (units != LineAnalyzerDoc::kUnitSystem) {
+    Converter::ConvertUnitSystem(LineAnalyzerDoc::kUnitSystem, units, item);
+  }
+  Converter::ConvertUnitStyle(units, units::UnitStyle::kConsistent,
+                              units::UnitStyle::kDifferent, item);
+}
+
+/// \brief Converts an item from a file unit system to the document units.
+/// \param[in] units
+///   The file unit system.
+/// \param[in,out] item
+///   The item, which is converted to the consistent unit style.
+template<typename Converter, typename T>
+void ConvertToDocumentUnits(const units::UnitSystem& units, T& item) {
+  Converter::ConvertUnitStyle(units, units::UnitStyle::kDifferent,
+                              units::UnitStyle::kConsistent, item);
+  if (units != LineAnalyzerDoc::kUnitSystem) {
+    Converter::ConvertUnitSystem(units, LineAnalyzerDoc::kUnitSystem, item);
+  }
+}
+
+}  // namespace
 
 wxXmlNode* LineAnalyzerDocXmlHandler::CreateNode(
-    const LineAnalyzerDoc& doc,
+    const DocumentSnapshot& snapshot,
     const units::UnitSystem& units) {
   // initializes variables used to create XML node
   wxXmlNode* node_root = nullptr;
@@ -18,7 +55,7 @@ wxXmlNode* LineAnalyzerDocXmlHandler::CreateNode(
   std::string title;
 
   // gets document directory
-  wxFileName filename_doc(doc.GetFilename());
+  wxFileName filename_doc(snapshot.filepath);
   filename_doc.MakeAbsolute(wxEmptyString, wxPATH_NATIVE);
   wxString dirname_doc = filename_doc.GetPath();
 
@@ -26,73 +63,34 @@ wxXmlNode* LineAnalyzerDocXmlHandler::CreateNode(
   node_root = new wxXmlNode(wxXML_ELEMENT_NODE, "line_analyzer_doc");
   node_root->AddAttribute("version", "1");
 
-  // creates structure files node and adds to root node
-  title = "structures";
-  node_element = new wxXmlNode(wxXML_ELEMENT_NODE, title);
-
-  for (auto iter = doc.structures().cbegin(); iter != doc.structures().cend();
-       iter++) {
-    const StructureFile& structurefile = *iter;
-
-    // converts absolute path to a relative unix-style path
-    wxFileName filename(structurefile.filepath);
-    filename.MakeRelativeTo(dirname_doc);
-    std::string filepath_relative = filename.GetFullPath(wxPATH_UNIX);
+  // creates external file nodes and adds to root node
+  node_root->AddChild(CreateNodeFiles("structures",
+                                      snapshot.filepaths_structures,
+                                      dirname_doc));
+  node_root->AddChild(CreateNodeFiles("hardwares",
+                                      snapshot.filepaths_hardwares,
+                                      dirname_doc));
+  node_root->AddChild(CreateNodeFiles("cables", snapshot.filepaths_cables,
+                                      dirname_doc));
 
-    wxXmlNode* sub_node = CreateElementNodeWithContent("file",
-                                                       filepath_relative);
-    node_element->AddChild(sub_node);
-  }
-
-  node_root->AddChild(node_element);
-
-  // creates hardware files node and adds to root node
-  title = "hardwares";
+  // creates weathercase node and adds to root node
+  title = "weather_load_cases";
   node_element = new wxXmlNode(wxXML_ELEMENT_NODE, title);
 
-  for (auto iter = doc.hardwares().cbegin(); iter != doc.hardwares().cend();
-       iter++) {
-    const HardwareFile& hardwarefile = *iter;
-
-    // converts absolute path to a relative unix-style path
-    wxFileName filename(hardwarefile.filepath);
-    filename.MakeRelativeTo(dirname_doc);
-    std::string filepath_relative = filename.GetFullPath(wxPATH_UNIX);
-
-    wxXmlNode* sub_node = CreateElementNodeWithContent("file",
-                                                       filepath_relative);
-    node_element->AddChild(sub_node);
-  }
-
-  node_root->AddChild(node_element);
-
-  // creates cable files node and adds to root node
-  title = "cables";
-  node_element = new wxXmlNode(wxXML_ELEMENT_NODE, title);
+  // converts copies so the snapshot isn't modified
+  // the unit system is converted for all weathercases in a single plan
+  std::list<WeatherLoadCase> weathercases = snapshot.weathercases;
+  UnitConversionPlan plan;
+  plan.AddWeathercases(LineAnalyzerDoc::kUnitSystem, units, weathercases);
+  plan.Execute();
 
-  for (auto iter = doc.cables().cbegin(); iter != doc.cables().cend();
+  for (auto iter = weathercases.begin(); iter != weathercases.end();
        iter++) {
-    const CableFile& cablefile = *iter;
-
-    // converts absolute path to a relative unix-style path
-    wxFileName filename(cablefile.filepath);
-    filename.MakeRelativeTo(dirname_doc);
-    std::string filepath_relative = filename.GetFullPath(wxPATH_UNIX);
+    WeatherLoadCase& weathercase = *iter;
+    WeatherLoadCaseUnitConverter::ConvertUnitStyle(
+        units, units::UnitStyle::kConsistent, units::UnitStyle::kDifferent,
+        weathercase);
 
-    wxXmlNode* sub_node = CreateElementNodeWithContent("file",
-                                                       filepath_relative);
-    node_element->AddChild(sub_node);
-  }
-
-  node_root->AddChild(node_element);
-
-  // creates weathercase node and adds to root node
-  title = "weather_load_cases";
-  node_element = new wxXmlNode(wxXML_ELEMENT_NODE, title);
-
-  for (auto iter = doc.weathercases().cbegin();
-       iter != doc.weathercases().cend(); iter++) {
-    const WeatherLoadCase& weathercase = *iter;
     wxXmlNode* sub_node =
         WeatherLoadCaseXmlHandler::CreateNode(weathercase, "", units);
     node_element->AddChild(sub_node);
@@ -104,8 +102,12 @@ wxXmlNode* LineAnalyzerDocXmlHandler::CreateNode(
   title = "transmission_lines";
   node_element = new wxXmlNode(wxXML_ELEMENT_NODE, title);
 
-  for (auto iter = doc.lines().cbegin(); iter != doc.lines().cend(); iter++) {
-    const TransmissionLine& line = *iter;
+  for (auto iter = snapshot.lines.cbegin(); iter != snapshot.lines.cend();
+       iter++) {
+    // converts a copy so the snapshot isn't modified
+    TransmissionLine line = *iter;
+    ConvertFromDocumentUnits<TransmissionLineUnitConverter>(units, line);
+
     wxXmlNode* sub_node =
         TransmissionLineXmlHandler::CreateNode(line, "", units);
     node_element->AddChild(sub_node);
@@ -117,10 +119,26 @@ wxXmlNode* LineAnalyzerDocXmlHandler::CreateNode(
   return node_root;
 }
 
+wxXmlNode* LineAnalyzerDocXmlHandler::CreateNodeFiles(
+    const std::string& title,
+    const std::list<std::string>& filepaths,
+    const wxString& dirname_doc) {
+  wxXmlNode* node = new wxXmlNode(wxXML_ELEMENT_NODE, title);
+
+  for (auto iter = filepaths.cbegin(); iter != filepaths.cend(); iter++) {
+    wxXmlNode* sub_node = CreateElementNodeWithContent(
+        "file", RelativeFilePath(*iter, dirname_doc));
+    node->AddChild(sub_node);
+  }
+
+  return node;
+}
+
 bool LineAnalyzerDocXmlHandler::ParseNode(
     const wxXmlNode* root,
     const std::string& filepath,
     const units::UnitSystem& units,
+    const std::map<std::string, std::string>& files,
     LineAnalyzerDoc& doc) {
   wxString message;
 
@@ -143,7 +161,7 @@ bool LineAnalyzerDocXmlHandler::ParseNode(
 
   // sends to proper parsing function
   if (version == "1") {
-    return ParseNodeV1(root, filepath, units, doc);
+    return ParseNodeV1(root, filepath, units, files, doc);
   } else {
     message = FileAndLineNumber(filepath, root) +
               " Invalid version number. Aborting node parse.";
@@ -152,11 +170,75 @@ bool LineAnalyzerDocXmlHandler::ParseNode(
   }
 }
 
+bool LineAnalyzerDocXmlHandler::ParseNodeTransmissionLine(
+    const wxXmlNode* node,
+    const std::string& filepath,
+    const units::UnitSystem& units,
+    const LineAnalyzerDoc& doc,
+    TransmissionLine& line) {
+  TRACE_SCOPE("LineAnalyzerDocXmlHandler::ParseNodeTransmissionLine");
+
+  // resolves the referenced names with the document index, so the xml
+  // handler only searches the items that the line references
+  ReferenceLists references;
+  doc.references().ListReferences(node, references);
+
+  // parses the transmission line
+  const bool status = TransmissionLineXmlHandler::ParseNode(
+      node, filepath, &references.structures, &references.hardwares,
+      &references.cables, &references.weathercases, line);
+  if (status == false) {
+    wxString message = FileAndLineNumber(filepath, node)
+                       + "Transmission line contains parsing error(s).";
+    wxLogError(message);
+  }
+
+  // converts to document units
+  ConvertToDocumentUnits<TransmissionLineUnitConverter>(units, line);
+
+  return status;
+}
+
+bool LineAnalyzerDocXmlHandler::ParseUnparsedTransmissionLine(
+    const UnparsedLine& unparsed,
+    const std::string& filepath,
+    const LineAnalyzerDoc& doc,
+    TransmissionLine& line) {
+  TRACE_SCOPE("LineAnalyzerDocXmlHandler::ParseUnparsedTransmissionLine");
+
+  // pads the text so the node line numbers match the document file
+  std::string xml(unparsed.line_number - 1, '\n');
+  xml += unparsed.xml;
+
+  wxMemoryInputStream stream(xml.data(), xml.size());
+  wxXmlDocument doc_xml;
+  if (doc_xml.Load(stream) == false) {
+    wxLogError("%s: Transmission line at line %d contains an invalid xml "
+               "structure.", filepath, unparsed.line_number);
+    return false;
+  }
+
+  return ParseNodeTransmissionLine(doc_xml.GetRoot(), filepath,
+                                   unparsed.units, doc, line);
+}
+
+std::string LineAnalyzerDocXmlHandler::RelativeFilePath(
+    const std::string& filepath,
+    const wxString& dirname_doc) {
+  // converts absolute path to a relative unix-style path
+  wxFileName filename(filepath);
+  filename.MakeRelativeTo(dirname_doc);
+  return filename.GetFullPath(wxPATH_UNIX).ToStdString();
+}
+
 bool LineAnalyzerDocXmlHandler::ParseNodeV1(
     const wxXmlNode* root,
     const std::string& filepath,
     const units::UnitSystem& units,
+    const std::map<std::string, std::string>& files,
     LineAnalyzerDoc& doc) {
+  TRACE_SCOPE("LineAnalyzerDocXmlHandler::ParseNodeV1");
+
   bool status = true;
   wxString message;
 
@@ -185,14 +267,26 @@ bool LineAnalyzerDocXmlHandler::ParseNodeV1(
           filename.MakeAbsolute(dirname_doc, wxPATH_NATIVE);
         }
 
-        // loads structure file
+        // loads structure file, using the bundled copy if there is one
         // filehandler function handles all logging
         StructureFile structurefile;
         structurefile.filepath = filename.GetFullPath();
-        const int status_node = FileHandler::LoadStructure(
-            structurefile.filepath,
-            units,
-            structurefile.structure);
+        int status_node = 0;
+        auto iter_file = files.find(filepath_node.ToStdString());
+        if (iter_file != files.cend()) {
+          const std::string& data = iter_file->second;
+          wxMemoryInputStream stream(data.data(), data.size());
+          status_node = FileHandler::LoadStructure(
+              stream,
+              structurefile.filepath,
+              LineAnalyzerDoc::kUnitSystem,
+              structurefile.structure);
+        } else {
+          status_node = FileHandler::LoadStructure(
+              structurefile.filepath,
+              LineAnalyzerDoc::kUnitSystem,
+              structurefile.structure);
+        }
 
         // adds to document if no file errors were encountered
         if ((status_node == 0) || (status_node == 1)) {
@@ -224,14 +318,26 @@ bool LineAnalyzerDocXmlHandler::ParseNodeV1(
           filename.MakeAbsolute(dirname_doc, wxPATH_NATIVE);
         }
 
-        // loads hardware file
+        // loads hardware file, using the bundled copy if there is one
         // filehandler function handles all logging
         HardwareFile hardwarefile;
         hardwarefile.filepath = filename.GetFullPath();
-        const int status_node = FileHandler::LoadHardware(
-            hardwarefile.filepath,
-            units,
-            hardwarefile.hardware);
+        int status_node = 0;
+        auto iter_file = files.find(filepath_node.ToStdString());
+        if (iter_file != files.cend()) {
+          const std::string& data = iter_file->second;
+          wxMemoryInputStream stream(data.data(), data.size());
+          status_node = FileHandler::LoadHardware(
+              stream,
+              hardwarefile.filepath,
+              LineAnalyzerDoc::kUnitSystem,
+              hardwarefile.hardware);
+        } else {
+          status_node = FileHandler::LoadHardware(
+              hardwarefile.filepath,
+              LineAnalyzerDoc::kUnitSystem,
+              hardwarefile.hardware);
+        }
 
         // adds to document if no file errors were encountered
         if ((status_node == 0) || (status_node == 1)) {
@@ -263,13 +369,26 @@ bool LineAnalyzerDocXmlHandler::ParseNodeV1(
           filename.MakeAbsolute(dirname_doc, wxPATH_NATIVE);
         }
 
-        // loads cable file
+        // loads cable file, using the bundled copy if there is one
         // filehandler function handles all logging
         CableFile cablefile;
         cablefile.filepath = filename.GetFullPath();
-        const int status_node = FileHandler::LoadCable(cablefile.filepath,
-                                                       units,
-                                                       cablefile.cable);
+        int status_node = 0;
+        auto iter_file = files.find(filepath_node.ToStdString());
+        if (iter_file != files.cend()) {
+          const std::string& data = iter_file->second;
+          wxMemoryInputStream stream(data.data(), data.size());
+          status_node = FileHandler::LoadCable(
+              stream,
+              cablefile.filepath,
+              LineAnalyzerDoc::kUnitSystem,
+              cablefile.cable);
+        } else {
+          status_node = FileHandler::LoadCable(
+              cablefile.filepath,
+              LineAnalyzerDoc::kUnitSystem,
+              cablefile.cable);
+        }
 
         // adds to document if no file errors were encountered
         if ((status_node == 0) || (status_node == 1)) {
@@ -302,6 +421,12 @@ bool LineAnalyzerDocXmlHandler::ParseNodeV1(
           status = false;
         }
 
+        // converts to a consistent unit style
+        // the unit system is converted once all weathercases are parsed
+        WeatherLoadCaseUnitConverter::ConvertUnitStyle(
+            units, units::UnitStyle::kDifferent, units::UnitStyle::kConsistent,
+            weathercase);
+
         // adds to document if no file errors were encountered
         if ((status_node == 0) || (status_node == 1)) {
           weathercases.push_back(weathercase);
@@ -316,67 +441,28 @@ bool LineAnalyzerDocXmlHandler::ParseNodeV1(
         sub_node = sub_node->GetNext();
       }
 
-      // adds to document
+      // converts to document units and adds to document
+      UnitConversionPlan plan;
+      plan.AddWeathercases(units, LineAnalyzerDoc::kUnitSystem, weathercases);
+      plan.Execute();
+
       doc.set_weathercases(weathercases);
     } else if (title == "transmission_lines") {
-      // gets node for weather load case
+      // gets node for transmission line
       wxXmlNode* sub_node = node->GetChildren();
 
-      // creates a list of structure const pointers for parsing
-      std::list<const Structure*> structures;
-      for (auto iter = doc.structures().cbegin();
-           iter != doc.structures().cend(); iter++) {
-        const StructureFile& structurefile = *iter;
-        const Structure* structure = &structurefile.structure;
-        structures.push_back(structure);
-      }
-
-      // creates a list of hardware const pointers for parsing
-      std::list<const Hardware*> hardwares;
-      for (auto iter = doc.hardwares().cbegin();
-           iter != doc.hardwares().cend(); iter++) {
-        const HardwareFile& hardwarefile = *iter;
-        const Hardware* hardware = &hardwarefile.hardware;
-        hardwares.push_back(hardware);
-      }
-
-      // creates a list of cable const pointers for parsing
-      std::list<const Cable*> cables;
-      for (auto iter = doc.cables().cbegin();
-           iter != doc.cables().cend(); iter++) {
-        const CableFile& cablefile = *iter;
-        const Cable* cable = &cablefile.cable;
-        cables.push_back(cable);
-      }
-
-      // creates a list of weathercase const pointers for parsing
-      std::list<const WeatherLoadCase*> weathercases;
-      for (auto iter = doc.weathercases().cbegin();
-           iter != doc.weathercases().cend(); iter++) {
-        const WeatherLoadCase* weathercase = &(*iter);
-        weathercases.push_back(weathercase);
-      }
-
+      // when loading, the inactive lines have already been cut out of the
+      // xml (see LineExtractionStream)
       int index = 0;
       while (sub_node != nullptr) {
-        // creates a transmission line and parses
         TransmissionLine line;
-        const bool status_node = TransmissionLineXmlHandler::ParseNode(
-            sub_node, filepath, &structures, &hardwares, &cables, &weathercases,
-            line);
+        const bool status_node = ParseNodeTransmissionLine(
+            sub_node, filepath, units, doc, line);
         if (status_node == false) {
           status = false;
         }
 
-        // adds to document if no file errors were encountered
-        if ((status_node == 0) || (status_node == 1)) {
-          doc.InsertTransmissionLine(index, line);
-        } else {
-          message = FileAndLineNumber(filepath, sub_node)
-                    + "Invalid transmission line. Skipping.";
-          wxLogError(message);
-          status = false;
-        }
+        doc.InsertTransmissionLine(index, line);
 
         index++;
         sub_node = sub_node->GetNext();
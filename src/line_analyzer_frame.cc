@@ -6,12 +6,16 @@
 #include "appcommon/units/cable_unit_converter.h"
 #include "appcommon/units/weather_load_case_unit_converter.h"
 #include "wx/aboutdlg.h"
+#include "wx/filedlg.h"
 #include "wx/xrc/xmlres.h"
 
 #include "file_handler.h"
 #include "line_analyzer_app.h"
+#include "memory_report.h"
 #include "preferences_dialog.h"
+#include "trace.h"
 #include "xpm/icon.xpm"
+#include "xrc_loader.h"
 
 DocumentFileDropTarget::DocumentFileDropTarget(wxWindow* parent) {
   parent_ = parent;
@@ -48,14 +52,20 @@ bool DocumentFileDropTarget::OnDropFiles(wxCoord x, wxCoord y,
 }
 
 BEGIN_EVENT_TABLE(LineAnalyzerFrame, wxDocParentFrame)
+  EVT_IDLE(LineAnalyzerFrame::OnIdle)
   EVT_MENU(XRCID("menuitem_file_preferences"), LineAnalyzerFrame::OnMenuFilePreferences)
   EVT_MENU(XRCID("menuitem_help_about"), LineAnalyzerFrame::OnMenuHelpAbout)
   EVT_MENU(XRCID("menuitem_view_log"), LineAnalyzerFrame::OnMenuViewLog)
+  EVT_MENU(XRCID("menuitem_view_memory"), LineAnalyzerFrame::OnMenuViewMemory)
+  EVT_MENU(XRCID("menuitem_view_trace_export"), LineAnalyzerFrame::OnMenuViewTraceExport)
+  EVT_MENU(XRCID("menuitem_view_trace_record"), LineAnalyzerFrame::OnMenuViewTraceRecord)
 END_EVENT_TABLE()
 
 LineAnalyzerFrame::LineAnalyzerFrame(wxDocManager* manager)
-    : wxDocParentFrame(manager, nullptr, wxID_ANY, "Line Analyzer") {
-  // loads dialog from virtual xrc file system
+    : wxDocParentFrame(manager, nullptr, wxID_ANY, "Line Analyzer"),
+      autosave_(wxGetApp().config()) {
+  // loads menubar from virtual xrc file system
+  XrcLoader::LoadMenuBar();
   wxXmlResource::Get()->LoadMenuBar(this, "line_analyzer_menubar");
 
   // sets the frame icon
@@ -99,6 +109,11 @@ LineAnalyzerFrame::~LineAnalyzerFrame() {
   manager_.UnInit();
 }
 
+void LineAnalyzerFrame::OnIdle(wxIdleEvent& event) {
+  autosave_.OnIdle(wxGetApp().GetDocument());
+  event.Skip();
+}
+
 void LineAnalyzerFrame::OnMenuFilePreferences(wxCommandEvent& event) {
   // gets the application config
   LineAnalyzerConfig* config = wxGetApp().config();
@@ -120,6 +135,16 @@ void LineAnalyzerFrame::OnMenuFilePreferences(wxCommandEvent& event) {
   } else if (config->level_log == wxLOG_Info) {
     wxLog::SetVerbose(true);
   }
+
+  // notifies the views if the unit system changed
+  // the document is stored in fixed units, so only the display is updated
+  if (config->units != units_before) {
+    LineAnalyzerDoc* doc = wxGetApp().GetDocument();
+    if (doc != nullptr) {
+      UpdateHint hint(HintType::kPreferencesEdit);
+      doc->UpdateAllViews(nullptr, &hint);
+    }
+  }
 }
 
 void LineAnalyzerFrame::OnMenuHelpAbout(wxCommandEvent& event) {
@@ -158,6 +183,56 @@ void LineAnalyzerFrame::OnMenuViewLog(wxCommandEvent& event) {
   manager_.Update();
 }
 
+void LineAnalyzerFrame::OnMenuViewMemory(wxCommandEvent& event) {
+  const LineAnalyzerDoc* doc = wxGetApp().GetDocument();
+  if (doc == nullptr) {
+    wxLogMessage("No document is open.");
+    return;
+  }
+
+  // logs the report
+  const MemoryUsage usage = MemoryReport::Measure(*doc);
+  wxLogMessage("Memory report: %s\n%s", doc->GetFilename(),
+               MemoryReport::Format(usage));
+
+  // shows the log pane so the report is visible
+  wxAuiPaneInfo& info = manager_.GetPane("Log");
+  if (info.IsShown() == false) {
+    info.Show(true);
+    manager_.Update();
+  }
+}
+
+void LineAnalyzerFrame::OnMenuViewTraceExport(wxCommandEvent& event) {
+  // stops recording so spans aren't overwritten while exporting
+  Tracer::Stop();
+  GetMenuBar()->Check(XRCID("menuitem_view_trace_record"), false);
+
+  // gets a filepath from the user
+  wxFileDialog dialog(this, "Export Trace", "", "trace.json",
+                      "Trace files (*.json)|*.json",
+                      wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+  if (dialog.ShowModal() != wxID_OK) {
+    return;
+  }
+
+  const std::string filepath = dialog.GetPath().ToStdString();
+  if (Tracer::Export(filepath) == true) {
+    wxLogMessage("Trace exported: %s", filepath);
+  }
+}
+
+void LineAnalyzerFrame::OnMenuViewTraceRecord(wxCommandEvent& event) {
+  if (event.IsChecked() == true) {
+    Tracer::Clear();
+    Tracer::Start();
+    wxLogVerbose("Trace recording started.");
+  } else {
+    Tracer::Stop();
+    wxLogVerbose("Trace recording stopped.");
+  }
+}
+
 LogPane* LineAnalyzerFrame::pane_log() {
   return pane_log_;
 }
@@ -0,0 +1,339 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "line_extraction_stream.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+/// The number of bytes that are read from the source stream at a time.
+const size_t kSizeChunk = 65536;
+
+/// \brief Compares the text at a position to a prefix.
+/// \param[in] text
+///   The text.
+/// \param[in] pos
+///   The position.
+/// \param[in] prefix
+///   The prefix.
+/// \return 1 if the text starts with the prefix, 0 if it doesn't, or -1 if
+///   the text ends before it can be determined.
+int ComparePrefix(const std::string& text, const size_t& pos,
+                  const char* prefix) {
+  const size_t size = std::strlen(prefix);
+  for (size_t i = 0; i < size; i++) {
+    if (text.size() <= pos + i) {
+      return -1;
+    } else if (text[pos + i] != prefix[i]) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/// \brief Determines if a character ends an xml name.
+/// \param[in] c
+///   The character.
+/// \return If the character ends a name.
+bool IsNameEnd(const char& c) {
+  return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n')
+      || (c == '>') || (c == '/') || (c == '?');
+}
+
+}  // namespace
+
+LineExtractionStream::LineExtractionStream(wxInputStream& stream)
+    : wxFilterInputStream(stream) {
+  count_lines_ = 0;
+  is_cutting_ = false;
+  is_end_source_ = false;
+  is_passing_ = false;
+  is_started_ = false;
+  line_number_ = 1;
+  pos_input_ = 0;
+  pos_output_ = 0;
+}
+
+std::vector<UnparsedLine>& LineExtractionStream::lines() {
+  return lines_;
+}
+
+size_t LineExtractionStream::OnSysRead(void* buffer, size_t size) {
+  // filters until there is output, as returning nothing ends the stream
+  while (pos_output_ == output_.size()) {
+    output_.clear();
+    pos_output_ = 0;
+
+    if ((is_end_source_ == false) || (pos_input_ < input_.size())) {
+      if (is_end_source_ == false) {
+        Fill();
+      }
+      Process();
+    } else if (is_cutting_ == true) {
+      // the text ends inside a line
+      PassThrough();
+    } else {
+      if (m_parent_i_stream->GetLastError() == wxSTREAM_READ_ERROR) {
+        m_lasterror = wxSTREAM_READ_ERROR;
+      } else {
+        m_lasterror = wxSTREAM_EOF;
+      }
+      return 0;
+    }
+  }
+
+  const size_t count = std::min(size, output_.size() - pos_output_);
+  std::memcpy(buffer, output_.data() + pos_output_, count);
+  pos_output_ += count;
+  return count;
+}
+
+void LineExtractionStream::Fill() {
+  // drops the processed input, so only an incomplete token is kept
+  input_.erase(0, pos_input_);
+  pos_input_ = 0;
+
+  char buffer[kSizeChunk];
+  m_parent_i_stream->Read(buffer, sizeof(buffer));
+  const size_t size = m_parent_i_stream->LastRead();
+  input_.append(buffer, size);
+
+  // the source only reads less than requested at its end or on errors
+  if (size < sizeof(buffer)) {
+    is_end_source_ = true;
+  }
+}
+
+bool LineExtractionStream::FindToken(size_t& pos_end) const {
+  const size_t pos = pos_input_;
+
+  // character data runs to the next markup, and can be split between reads
+  if (input_[pos] != '<') {
+    pos_end = input_.find('<', pos);
+    if (pos_end == std::string::npos) {
+      pos_end = input_.size();
+    }
+    return true;
+  }
+
+  // comments, CDATA sections, and processing instructions can contain
+  // anything up to their terminator
+  const char* terminators[3][2] = {
+      {"<!--", "-->"}, {"<![CDATA[", "]]>"}, {"<?", "?>"}};
+  for (int i = 0; i < 3; i++) {
+    const int status = ComparePrefix(input_, pos, terminators[i][0]);
+    if (status == -1) {
+      return false;
+    } else if (status == 1) {
+      pos_end = input_.find(terminators[i][1],
+                            pos + std::strlen(terminators[i][0]));
+      if (pos_end == std::string::npos) {
+        return false;
+      }
+      pos_end += std::strlen(terminators[i][1]);
+      return true;
+    }
+  }
+
+  // tags end at the first '>' that isn't in a quoted attribute value
+  size_t pos_scan = pos + 1;
+  while (pos_scan < input_.size()) {
+    const char c = input_[pos_scan];
+    if ((c == '"') || (c == '\'')) {
+      pos_scan = input_.find(c, pos_scan + 1);
+      if (pos_scan == std::string::npos) {
+        return false;
+      }
+    } else if (c == '>') {
+      pos_end = pos_scan + 1;
+      return true;
+    }
+    pos_scan++;
+  }
+
+  return false;
+}
+
+void LineExtractionStream::HandleDeclaration(const size_t& pos_end) {
+  const std::string token = input_.substr(pos_input_, pos_end - pos_input_);
+  if ((token.size() < 6) || (token.compare(0, 5, "<?xml") != 0)
+      || (IsNameEnd(token[5]) == false)) {
+    return;
+  }
+
+  // gets the encoding pseudo-attribute value
+  // a declaration without one is UTF-8
+  size_t pos = token.find("encoding");
+  if (pos == std::string::npos) {
+    return;
+  }
+
+  pos = token.find_first_of("\"'", pos);
+  if (pos == std::string::npos) {
+    PassThrough();
+    return;
+  }
+
+  const size_t pos_value_end = token.find(token[pos], pos + 1);
+  if (pos_value_end == std::string::npos) {
+    PassThrough();
+    return;
+  }
+
+  std::string encoding = token.substr(pos + 1, pos_value_end - pos - 1);
+  std::transform(encoding.begin(), encoding.end(), encoding.begin(),
+                 [](const char& c) { return (char)std::tolower(c); });
+  if ((encoding != "utf-8") && (encoding != "us-ascii")) {
+    PassThrough();
+  }
+}
+
+void LineExtractionStream::HandleTag(const size_t& pos_end) {
+  const bool is_end = input_[pos_input_ + 1] == '/';
+
+  size_t pos_name = pos_input_ + 1;
+  if (is_end == true) {
+    pos_name++;
+  }
+
+  size_t pos_name_end = pos_name;
+  while ((pos_name_end < pos_end)
+         && (IsNameEnd(input_[pos_name_end]) == false)) {
+    pos_name_end++;
+  }
+  const std::string name = input_.substr(pos_name, pos_name_end - pos_name);
+
+  if (is_end == true) {
+    if ((names_.empty() == true) || (names_.back() != name)) {
+      // the parser reports the mismatched tag
+      PassThrough();
+      Route(pos_input_, pos_end);
+      return;
+    }
+
+    names_.pop_back();
+    Route(pos_input_, pos_end);
+  } else {
+    // the first line is left in the text
+    if ((names_.size() == 2) && (names_.back() == "transmission_lines")
+        && (name == "transmission_line")) {
+      count_lines_++;
+      if (1 < count_lines_) {
+        is_cutting_ = true;
+        line_.line_number = line_number_;
+        line_.units = LineAnalyzerDoc::kUnitSystem;
+        line_.xml.clear();
+      }
+    }
+
+    Route(pos_input_, pos_end);
+
+    // empty-element tags don't open an element
+    if (input_[pos_end - 2] != '/') {
+      names_.push_back(name);
+    }
+  }
+
+  // replaces a complete line with its line breaks
+  if ((is_cutting_ == true) && (names_.size() == 2)) {
+    output_.append(std::count(line_.xml.cbegin(), line_.xml.cend(), '\n'),
+                   '\n');
+    lines_.push_back(std::move(line_));
+    line_ = UnparsedLine();
+    is_cutting_ = false;
+  }
+}
+
+void LineExtractionStream::PassThrough() {
+  if (is_cutting_ == true) {
+    output_.append(line_.xml);
+    line_.xml.clear();
+    is_cutting_ = false;
+  }
+
+  is_passing_ = true;
+}
+
+void LineExtractionStream::Process() {
+  // checks for UTF-16 and UTF-32 text, which has zero bytes in the first
+  // characters
+  if (is_started_ == false) {
+    if ((input_.size() - pos_input_ < 4) && (is_end_source_ == false)) {
+      return;
+    }
+
+    const size_t size = std::min(input_.size() - pos_input_, (size_t)4);
+    if ((std::memchr(input_.data() + pos_input_, '\0', size) != nullptr)
+        || (ComparePrefix(input_, pos_input_, "\xFE\xFF") == 1)
+        || (ComparePrefix(input_, pos_input_, "\xFF\xFE") == 1)) {
+      PassThrough();
+    }
+
+    // skips the UTF-8 byte order mark
+    if (ComparePrefix(input_, pos_input_, "\xEF\xBB\xBF") == 1) {
+      Route(pos_input_, pos_input_ + 3);
+      pos_input_ += 3;
+    }
+
+    is_started_ = true;
+  }
+
+  while (pos_input_ < input_.size()) {
+    if (is_passing_ == true) {
+      Route(pos_input_, input_.size());
+      pos_input_ = input_.size();
+      break;
+    }
+
+    size_t pos_end = 0;
+    if (FindToken(pos_end) == false) {
+      if (is_end_source_ == false) {
+        // waits for the rest of the token
+        break;
+      }
+
+      // the text ends inside markup, which the parser reports
+      PassThrough();
+      continue;
+    }
+
+    const char c = input_[pos_input_];
+    const char c_next = (pos_input_ + 1 < pos_end) ? input_[pos_input_ + 1]
+                                                   : '\0';
+    if ((c == '<') && (c_next == '?')) {
+      HandleDeclaration(pos_end);
+      Route(pos_input_, pos_end);
+    } else if ((c == '<') && (c_next == '!')) {
+      // a document type declaration could define entities that the lines
+      // use, so they aren't cut
+      if ((ComparePrefix(input_, pos_input_, "<!--") != 1)
+          && (ComparePrefix(input_, pos_input_, "<![CDATA[") != 1)) {
+        PassThrough();
+      }
+      Route(pos_input_, pos_end);
+    } else if (c == '<') {
+      HandleTag(pos_end);
+    } else {
+      Route(pos_input_, pos_end);
+    }
+
+    pos_input_ = pos_end;
+  }
+}
+
+void LineExtractionStream::Route(const size_t& pos_begin,
+                                 const size_t& pos_end) {
+  if (is_cutting_ == true) {
+    line_.xml.append(input_, pos_begin, pos_end - pos_begin);
+  } else {
+    output_.append(input_, pos_begin, pos_end - pos_begin);
+  }
+
+  line_number_ += (int)std::count(input_.begin() + pos_begin,
+                                  input_.begin() + pos_end, '\n');
+}
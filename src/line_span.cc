@@ -0,0 +1,165 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "line_span.h"
+
+#include <cmath>
+#include <iterator>
+#include <unordered_map>
+
+#include "models/transmissionline/cable_unit_load_solver.h"
+
+#include "trace.h"
+
+namespace {
+
+/// The ratio of degrees to radians.
+const double kRadiansPerDegree = 3.14159265358979323846 / 180;
+
+}  // namespace
+
+void LineSpanBuilder::AxisLongitudinal(const LineStructure& line_structure,
+                                       const AlignmentPath& path, double& x,
+                                       double& y) {
+  // rotates the structure axes from the alignment direction
+  double direction_x = 0;
+  double direction_y = 0;
+  path.Direction(line_structure.station(), direction_x, direction_y);
+
+  const double angle = line_structure.rotation() * kRadiansPerDegree;
+  x = direction_x * std::cos(angle) - direction_y * std::sin(angle);
+  y = direction_x * std::sin(angle) + direction_y * std::cos(angle);
+}
+
+int LineSpanBuilder::Build(const TransmissionLine& line,
+                           const AlignmentPath& path,
+                           std::vector<LineSpan>& spans) {
+  TRACE_SCOPE("LineSpanBuilder::Build");
+
+  spans.clear();
+
+  // indexes the line structures so connections can be resolved
+  std::unordered_map<const LineStructure*, int> indexes_structure;
+  int index_structure = 0;
+  for (auto iter = line.line_structures()->cbegin();
+       iter != line.line_structures()->cend(); iter++) {
+    indexes_structure[&(*iter)] = index_structure;
+    index_structure++;
+  }
+
+  int count_skipped = 0;
+  int index_line_cable = 0;
+  for (auto iter = line.line_cables()->cbegin();
+       iter != line.line_cables()->cend(); iter++, index_line_cable++) {
+    const LineCable& line_cable = *iter;
+
+    // each pair of consecutive connections is a span
+    bool is_valid_back = false;
+    LineSpan span;
+    span.index_line_cable = index_line_cable;
+    span.line_cable = &line_cable;
+    for (auto it = line_cable.connections()->cbegin();
+         it != line_cable.connections()->cend(); it++) {
+      const LineCableConnection& connection = *it;
+
+      auto iter_index = indexes_structure.find(connection.line_structure);
+      bool is_valid = false;
+      if (iter_index != indexes_structure.cend()) {
+        is_valid = PointAttachment(*connection.line_structure,
+                                   connection.index_attachment, path,
+                                   span.x_ahead, span.y_ahead,
+                                   span.elevation_ahead,
+                                   span.hardware_ahead);
+      }
+
+      if (is_valid == false) {
+        count_skipped++;
+        is_valid_back = false;
+        continue;
+      }
+
+      span.index_attachment_ahead = connection.index_attachment;
+      span.index_structure_ahead = iter_index->second;
+      if (is_valid_back == true) {
+        spans.push_back(span);
+      }
+
+      // the ahead attachment is the back attachment of the next span
+      span.elevation_back = span.elevation_ahead;
+      span.hardware_back = span.hardware_ahead;
+      span.index_attachment_back = span.index_attachment_ahead;
+      span.index_structure_back = span.index_structure_ahead;
+      span.x_back = span.x_ahead;
+      span.y_back = span.y_ahead;
+      is_valid_back = true;
+    }
+  }
+
+  return count_skipped;
+}
+
+bool LineSpanBuilder::PointAttachment(const LineStructure& line_structure,
+                                      const int& index_attachment,
+                                      const AlignmentPath& path, double& x,
+                                      double& y, double& elevation,
+                                      const Hardware*& hardware) {
+  const Structure* structure = line_structure.structure();
+  if (structure == nullptr) {
+    return false;
+  }
+
+  if ((index_attachment < 0)
+      || ((int)structure->attachments.size() <= index_attachment)) {
+    return false;
+  }
+
+  const StructureAttachment& attachment =
+      structure->attachments[index_attachment];
+
+  const double station = line_structure.station();
+  double longitudinal_x = 0;
+  double longitudinal_y = 0;
+  AxisLongitudinal(line_structure, path, longitudinal_x, longitudinal_y);
+
+  path.PointXy(station, line_structure.offset(), x, y);
+  x += attachment.offset_longitudinal * longitudinal_x
+       - attachment.offset_transverse * longitudinal_y;
+  y += attachment.offset_longitudinal * longitudinal_y
+       + attachment.offset_transverse * longitudinal_x;
+
+  elevation = path.Elevation(station) + structure->height
+              + line_structure.height_adjustment()
+              - attachment.offset_vertical_top;
+
+  // suspension hardware hangs below the attachment
+  // the hardware list is parallel to the structure attachments
+  hardware = nullptr;
+  const std::list<const Hardware*>* hardwares = line_structure.hardwares();
+  if (index_attachment < (int)hardwares->size()) {
+    const Hardware* hardware_attachment =
+        *std::next(hardwares->cbegin(), index_attachment);
+    if ((hardware_attachment != nullptr)
+        && (hardware_attachment->type
+            == Hardware::HardwareType::kSuspension)) {
+      hardware = hardware_attachment;
+      elevation -= hardware->length;
+    }
+  }
+
+  return true;
+}
+
+void LineSpanBuilder::UnitWeight(const Cable& cable,
+                                 const WeatherLoadCase& weathercase,
+                                 double& weight_transverse,
+                                 double& weight_vertical) {
+  // uses the same unit load solver as the sag-tension reloader, so the
+  // weights are consistent with the solved tensions
+  CableUnitLoadSolver solver;
+  solver.set_diameter_cable(&cable.diameter);
+  solver.set_weight_unit_cable(&cable.weight_unit);
+
+  const Vector3d load = solver.UnitCableLoad(weathercase);
+  weight_transverse = load.y();
+  weight_vertical = load.z();
+}
@@ -0,0 +1,134 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+
+#include "wx/log.h"
+#include "wx/string.h"
+
+MappedFile::MappedFile() {
+  data_ = nullptr;
+  handle_file_ = nullptr;
+  handle_mapping_ = nullptr;
+  size_ = 0;
+}
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (handle_mapping_ != nullptr) {
+    CloseHandle(handle_mapping_);
+  }
+  if (handle_file_ != nullptr) {
+    CloseHandle(handle_file_);
+  }
+#else
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  if (handle_file_ != nullptr) {
+    close((int)(intptr_t)handle_file_ - 1);
+  }
+#endif
+
+  data_ = nullptr;
+  handle_file_ = nullptr;
+  handle_mapping_ = nullptr;
+  size_ = 0;
+}
+
+bool MappedFile::Open(const std::string& filepath) {
+  Close();
+
+#ifdef _WIN32
+  HANDLE handle_file = CreateFileW(wxString(filepath).wc_str(), GENERIC_READ,
+                                   FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                   FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (handle_file == INVALID_HANDLE_VALUE) {
+    wxLogError("File (%s) could not be opened.", filepath);
+    return false;
+  }
+  handle_file_ = handle_file;
+
+  LARGE_INTEGER size;
+  if (GetFileSizeEx(handle_file, &size) == FALSE) {
+    wxLogError("File (%s) size could not be read.", filepath);
+    Close();
+    return false;
+  }
+  size_ = (size_t)size.QuadPart;
+
+  if (size_ == 0) {
+    return true;
+  }
+
+  handle_mapping_ = CreateFileMappingW(handle_file, nullptr, PAGE_READONLY,
+                                       0, 0, nullptr);
+  if (handle_mapping_ != nullptr) {
+    data_ = static_cast<const char*>(
+        MapViewOfFile(handle_mapping_, FILE_MAP_READ, 0, 0, 0));
+  }
+#else
+  const int descriptor = open(filepath.c_str(), O_RDONLY);
+  if (descriptor == -1) {
+    wxLogError("File (%s) could not be opened.", filepath);
+    return false;
+  }
+  // the descriptor is offset by one so that a zero descriptor isn't null
+  handle_file_ = (void*)(intptr_t)(descriptor + 1);
+
+  struct stat status;
+  if (fstat(descriptor, &status) == -1) {
+    wxLogError("File (%s) size could not be read.", filepath);
+    Close();
+    return false;
+  }
+  size_ = (size_t)status.st_size;
+
+  if (size_ == 0) {
+    return true;
+  }
+
+  void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+  if (data != MAP_FAILED) {
+    data_ = static_cast<const char*>(data);
+
+    // the file is read front to back, so the kernel can read ahead and drop
+    // pages behind
+    madvise(data, size_, MADV_SEQUENTIAL);
+  }
+#endif
+
+  if (data_ == nullptr) {
+    wxLogError("File (%s) could not be mapped into memory.", filepath);
+    Close();
+    return false;
+  }
+
+  return true;
+}
+
+const char* MappedFile::data() const {
+  return data_;
+}
+
+size_t MappedFile::size() const {
+  return size_;
+}
@@ -0,0 +1,336 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "memory_report.h"
+
+#include <cstdio>
+#include <unordered_map>
+
+#include "wx/cmdproc.h"
+
+#include "shared_data_commands.h"
+#include "trace.h"
+#include "transmission_line_command.h"
+
+namespace {
+
+/// The overhead of a std::unordered_map node (next pointer and cached
+/// hash).
+const size_t kSizeHashNode = 2 * sizeof(void*);
+
+/// The overhead of a std::list node (previous and next pointers).
+const size_t kSizeListNode = 2 * sizeof(void*);
+
+/// The overhead of a std::map node (parent, child, and color).
+const size_t kSizeTreeNode = 4 * sizeof(void*);
+
+/// \brief Gets the heap size of a wxString.
+/// \param[in] str
+///   The string.
+/// \return The heap size, in bytes.
+size_t SizeHeapWx(const wxString& str) {
+  if (str.empty() == true) {
+    return 0;
+  } else {
+    return (str.length() + 1) * sizeof(wxStringCharType);
+  }
+}
+
+/// \brief Gets the heap size of a name index.
+/// \param[in] index
+///   The index.
+/// \return The heap size, in bytes.
+template<typename T>
+size_t SizeHeapIndex(const std::unordered_map<std::string, T>& index) {
+  size_t size = index.bucket_count() * sizeof(void*);
+  for (auto iter = index.cbegin(); iter != index.cend(); iter++) {
+    size += kSizeHashNode + sizeof(*iter) + MemoryReport::SizeHeap(iter->first);
+  }
+
+  return size;
+}
+
+/// \brief Gets the heap size of a vector.
+/// \param[in] vector
+///   The vector.
+/// \return The heap size, in bytes.
+template<typename T>
+size_t SizeHeapVector(const std::vector<T>& vector) {
+  return vector.capacity() * sizeof(T);
+}
+
+/// \brief Appends a formatted report line.
+/// \param[in] name
+///   The category name.
+/// \param[in] bytes
+///   The category size.
+/// \param[in] total
+///   The total size of all categories.
+/// \param[out] report
+///   The report to append to.
+void AppendLine(const char* name, const size_t& bytes, const size_t& total,
+                std::string& report) {
+  double percent = 0;
+  if (total != 0) {
+    percent = 100 * (double)bytes / (double)total;
+  }
+
+  char buffer[128];
+  std::snprintf(buffer, sizeof(buffer), "%-14s %12.1f KiB %6.1f %%\n",
+                name, (double)bytes / 1024, percent);
+  report += buffer;
+}
+
+}  // namespace
+
+size_t MemoryUsage::Total() const {
+  return cables + caches + hardwares + history + lines + structures
+         + weathercases;
+}
+
+std::string MemoryReport::Format(const MemoryUsage& usage) {
+  const size_t total = usage.Total();
+
+  std::string report;
+  AppendLine("Cables", usage.cables, total, report);
+  AppendLine("Hardware", usage.hardwares, total, report);
+  AppendLine("Structures", usage.structures, total, report);
+  AppendLine("Weathercases", usage.weathercases, total, report);
+  AppendLine("Lines", usage.lines, total, report);
+  AppendLine("Undo history", usage.history, total, report);
+  AppendLine("Caches", usage.caches, total, report);
+  AppendLine("Total", total, total, report);
+
+  return report;
+}
+
+MemoryUsage MemoryReport::Measure(const LineAnalyzerDoc& doc) {
+  MemoryUsage usage;
+
+  usage.cables = 0;
+  for (auto iter = doc.cables().cbegin(); iter != doc.cables().cend();
+       iter++) {
+    usage.cables += kSizeListNode + SizeCableFile(*iter);
+  }
+
+  usage.hardwares = 0;
+  for (auto iter = doc.hardwares().cbegin(); iter != doc.hardwares().cend();
+       iter++) {
+    usage.hardwares += kSizeListNode + SizeHardwareFile(*iter);
+  }
+
+  usage.structures = 0;
+  for (auto iter = doc.structures().cbegin(); iter != doc.structures().cend();
+       iter++) {
+    usage.structures += kSizeListNode + SizeStructureFile(*iter);
+  }
+
+  usage.weathercases = 0;
+  for (auto iter = doc.weathercases().cbegin();
+       iter != doc.weathercases().cend(); iter++) {
+    usage.weathercases += kSizeListNode + SizeWeathercase(*iter);
+  }
+
+  // lines that haven't been parsed are counted by their xml text, in
+  // addition to their empty placeholder
+  usage.lines = 0;
+  for (auto iter = doc.lines_stored().cbegin();
+       iter != doc.lines_stored().cend(); iter++) {
+    usage.lines += kSizeListNode + SizeLine(*iter);
+  }
+
+  for (auto iter = doc.lines_unparsed().cbegin();
+       iter != doc.lines_unparsed().cend(); iter++) {
+    usage.lines += kSizeTreeNode + sizeof(*iter)
+                   + SizeHeap(iter->second.xml);
+  }
+
+  usage.history = SizeHistory(doc);
+
+  const ReferenceIndex& references = doc.references();
+  usage.caches = Tracer::SizeBuffers();
+  usage.caches += SizeHeapIndex(references.cables());
+  usage.caches += SizeHeapIndex(references.hardwares());
+  usage.caches += SizeHeapIndex(references.structures());
+  usage.caches += SizeHeapIndex(references.weathercases());
+
+  return usage;
+}
+
+size_t MemoryReport::SizeHeap(const std::string& str) {
+  // strings that fit inside the object store their characters in it
+  const char* data = str.data();
+  const char* object = reinterpret_cast<const char*>(&str);
+  if (((object <= data) && (data < object + sizeof(std::string)))
+      || (str.capacity() == 0)) {
+    return 0;
+  } else {
+    return str.capacity() + 1;
+  }
+}
+
+size_t MemoryReport::SizeXmlNode(const wxXmlNode* node) {
+  size_t size = 0;
+
+  // iterates the sibling list, and recurses into the children
+  while (node != nullptr) {
+    size += sizeof(wxXmlNode);
+    size += SizeHeapWx(node->GetName());
+    size += SizeHeapWx(node->GetContent());
+
+    const wxXmlAttribute* attribute = node->GetAttributes();
+    while (attribute != nullptr) {
+      size += sizeof(wxXmlAttribute);
+      size += SizeHeapWx(attribute->GetName());
+      size += SizeHeapWx(attribute->GetValue());
+      attribute = attribute->GetNext();
+    }
+
+    size += SizeXmlNode(node->GetChildren());
+
+    node = node->GetNext();
+  }
+
+  return size;
+}
+
+size_t MemoryReport::SizeCableFile(const CableFile& cablefile) {
+  const Cable& cable = cablefile.cable;
+
+  size_t size = sizeof(CableFile);
+  size += SizeHeap(cablefile.filepath);
+  size += SizeHeap(cable.name);
+
+  const CableComponent* components[2] = {&cable.component_core,
+                                         &cable.component_shell};
+  for (int i = 0; i < 2; i++) {
+    const CableComponent* component = components[i];
+    size += SizeHeapVector(component->coefficients_polynomial_creep);
+    size += SizeHeapVector(component->coefficients_polynomial_loadstrain);
+  }
+
+  return size;
+}
+
+size_t MemoryReport::SizeHistory(const LineAnalyzerDoc& doc) {
+  const wxCommandProcessor* processor = doc.GetCommandProcessor();
+  if (processor == nullptr) {
+    return 0;
+  }
+
+  size_t size = 0;
+
+  const wxList& commands = processor->GetCommands();
+  for (wxList::compatibility_iterator node = commands.GetFirst();
+       node != nullptr; node = node->GetNext()) {
+    const wxObject* object = node->GetData();
+    size += kSizeListNode;
+
+    // transmission line commands hold xml nodes for do and undo
+    const TransmissionLineCommand* command_line =
+        dynamic_cast<const TransmissionLineCommand*>(object);
+    if (command_line != nullptr) {
+      size += sizeof(TransmissionLineCommand);
+      size += SizeXmlNode(command_line->node_transmission_line());
+      size += SizeXmlNode(command_line->node_undo());
+      continue;
+    }
+
+    // shared data commands hold a node with all lines, plus the exchanged
+    // shared data
+    const SharedDataCommandBase* command_shared =
+        dynamic_cast<const SharedDataCommandBase*>(object);
+    if (command_shared == nullptr) {
+      continue;
+    }
+
+    size += SizeXmlNode(command_shared->node_lines());
+
+    const CableFileCommand* command_cable =
+        dynamic_cast<const CableFileCommand*>(command_shared);
+    const HardwareFileCommand* command_hardware =
+        dynamic_cast<const HardwareFileCommand*>(command_shared);
+    const StructureFileCommand* command_structure =
+        dynamic_cast<const StructureFileCommand*>(command_shared);
+    const WeatherLoadCaseCommand* command_weathercase =
+        dynamic_cast<const WeatherLoadCaseCommand*>(command_shared);
+
+    if (command_cable != nullptr) {
+      size += sizeof(CableFileCommand);
+      const std::list<CableFile>& items = command_cable->cablefiles();
+      for (auto it = items.cbegin(); it != items.cend(); it++) {
+        size += kSizeListNode + SizeCableFile(*it);
+      }
+    } else if (command_hardware != nullptr) {
+      size += sizeof(HardwareFileCommand);
+      const std::list<HardwareFile>& items =
+          command_hardware->hardwarefiles();
+      for (auto it = items.cbegin(); it != items.cend(); it++) {
+        size += kSizeListNode + SizeHardwareFile(*it);
+      }
+    } else if (command_structure != nullptr) {
+      size += sizeof(StructureFileCommand);
+      const std::list<StructureFile>& items =
+          command_structure->structurefiles();
+      for (auto it = items.cbegin(); it != items.cend(); it++) {
+        size += kSizeListNode + SizeStructureFile(*it);
+      }
+    } else if (command_weathercase != nullptr) {
+      size += sizeof(WeatherLoadCaseCommand);
+      const std::list<WeatherLoadCase>& items =
+          command_weathercase->weathercases();
+      for (auto it = items.cbegin(); it != items.cend(); it++) {
+        size += kSizeListNode + SizeWeathercase(*it);
+      }
+    }
+  }
+
+  return size;
+}
+
+size_t MemoryReport::SizeHardwareFile(const HardwareFile& hardwarefile) {
+  size_t size = sizeof(HardwareFile);
+  size += SizeHeap(hardwarefile.filepath);
+  size += SizeHeap(hardwarefile.hardware.name);
+
+  return size;
+}
+
+size_t MemoryReport::SizeLine(const TransmissionLine& line) {
+  size_t size = sizeof(TransmissionLine);
+
+  // adds alignment points
+  const std::list<AlignmentPoint>* points = line.alignment()->points();
+  size += points->size() * (kSizeListNode + sizeof(AlignmentPoint));
+
+  // adds line cables
+  const std::list<LineCable>* line_cables = line.line_cables();
+  size += line_cables->size() * (kSizeListNode + sizeof(LineCable));
+
+  // adds line structures and their hardware references
+  const std::list<LineStructure>* line_structures = line.line_structures();
+  for (auto iter = line_structures->cbegin();
+       iter != line_structures->cend(); iter++) {
+    const LineStructure& line_structure = *iter;
+    size += kSizeListNode + sizeof(LineStructure);
+    size += line_structure.hardwares()->size()
+            * (kSizeListNode + sizeof(const Hardware*));
+  }
+
+  return size;
+}
+
+size_t MemoryReport::SizeStructureFile(const StructureFile& structurefile) {
+  const Structure& structure = structurefile.structure;
+
+  size_t size = sizeof(StructureFile);
+  size += SizeHeap(structurefile.filepath);
+  size += SizeHeap(structure.name);
+  size += SizeHeapVector(structure.attachments);
+
+  return size;
+}
+
+size_t MemoryReport::SizeWeathercase(const WeatherLoadCase& weathercase) {
+  return sizeof(WeatherLoadCase) + SizeHeap(weathercase.description);
+}
@@ -0,0 +1,453 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "monte_carlo_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "models/sagtension/line_cable_reloader.h"
+
+#include "csv_writer.h"
+#include "line_span.h"
+#include "parallel.h"
+#include "quantity.h"
+#include "trace.h"
+
+namespace {
+
+/// The number of bins in each histogram.
+const int kCountBins = 256;
+
+/// The number of counts that are accumulated for each histogram, which are
+/// the bins followed by the underflow and the overflow.
+const int kCountSlots = kCountBins + 2;
+
+/// The number of random numbers that are reserved for each sample.
+const uint64_t kCountRandomsSample = 8;
+
+/// The number of samples that are evaluated in a work item.
+const int kCountSamplesBlock = 256;
+
+/// The number of samples that set the histogram ranges.
+const int kCountSamplesPilot = 1024;
+
+/// \brief Gets a counter-based uniform random number.
+/// \param[in] seed
+///   The seed.
+/// \param[in] counter
+///   The counter.
+/// \return A random number between zero and one, exclusive.
+/// The counter is hashed with the SplitMix64 finalizer, so any counter can
+/// be generated directly without advancing a generator state.
+double Uniform(const uint64_t& seed, const uint64_t& counter) {
+  uint64_t z = seed + (counter + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  z = z ^ (z >> 31);
+  return ((z >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/// \brief Samples a distribution.
+/// \param[in] distribution
+///   The distribution.
+/// \param[in] value_base
+///   The base value that the distribution is centered on.
+/// \param[in] seed
+///   The seed.
+/// \param[in] counter
+///   The counter of the first of the two random numbers that are used.
+/// \return The sampled value.
+double Sample(const MonteCarloDistribution& distribution,
+              const double& value_base, const uint64_t& seed,
+              const uint64_t& counter) {
+  const double kEulerGamma = 0.57721566490153286;
+  const double kPi = 3.14159265358979323846;
+
+  typedef MonteCarloDistribution::DistributionType DistributionType;
+  const double u = Uniform(seed, counter);
+  if (distribution.type == DistributionType::kGumbel) {
+    return value_base - kEulerGamma * distribution.spread
+           - distribution.spread * std::log(-std::log(u));
+  } else if (distribution.type == DistributionType::kNormal) {
+    // box-muller transform
+    const double v = Uniform(seed, counter + 1);
+    return value_base + distribution.spread
+           * std::sqrt(-2 * std::log(u)) * std::cos(2 * kPi * v);
+  } else if (distribution.type == DistributionType::kUniform) {
+    return value_base + distribution.spread * (2 * u - 1);
+  } else {
+    return value_base;
+  }
+}
+
+/// \brief Adds a value to a histogram.
+/// \param[in] value
+///   The value.
+/// \param[in] histogram
+///   The histogram that defines the bins.
+/// \param[in,out] counts
+///   The bin counts, followed by the underflow and overflow counts.
+/// \param[in,out] extremes
+///   The smallest and largest values.
+void AddValue(const double& value, const MonteCarloHistogram& histogram,
+              uint64_t* counts, double* extremes) {
+  const double position = (value - histogram.value_begin)
+                          / histogram.width_bin;
+  int index = 0;
+  if (position < 0) {
+    index = kCountBins;
+  } else if (kCountBins <= position) {
+    index = kCountBins + 1;
+  } else {
+    index = (int)position;
+  }
+  counts[index]++;
+
+  extremes[0] = std::min(extremes[0], value);
+  extremes[1] = std::max(extremes[1], value);
+}
+
+/// \brief Gets the total number of samples in a histogram.
+/// \param[in] histogram
+///   The histogram.
+/// \return The number of samples, including the overflow and underflow.
+uint64_t CountTotal(const MonteCarloHistogram& histogram) {
+  uint64_t count_total = histogram.count_overflow + histogram.count_underflow;
+  for (auto iter = histogram.counts.cbegin();
+       iter != histogram.counts.cend(); iter++) {
+    count_total += *iter;
+  }
+
+  return count_total;
+}
+
+}  // namespace
+
+MonteCarloEngine::MonteCarloEngine() {
+  distribution_ice_ = MonteCarloDistribution{
+      0, MonteCarloDistribution::DistributionType::kFixed};
+  distribution_temperature_ = distribution_ice_;
+  distribution_wind_ = distribution_ice_;
+}
+
+bool MonteCarloEngine::Export(const std::string& filepath,
+                              const units::UnitSystem& units) const {
+  CsvWriter file;
+  if (file.Open(filepath, "Monte Carlo") == false) {
+    return false;
+  }
+
+  double scale_force = 1;
+  double scale_length = 1;
+  if (units == units::UnitSystem::kImperial) {
+    scale_force = quantity::FactorBetween(quantity::force::kNewtons,
+                                          quantity::force::kPounds).scale;
+    scale_length = quantity::FactorBetween(quantity::length::kMeters,
+                                           quantity::length::kFeet).scale;
+  }
+
+  file.Append("line_cable,quantity,value_lower,value_upper,count,"
+              "exceedance\n");
+  for (int i = 0; i < (int)histograms_tension_.size(); i++) {
+    for (int j = 0; j < 2; j++) {
+      const MonteCarloHistogram& histogram =
+          j == 0 ? histograms_tension_[i] : histograms_sag_[i];
+      const char* name = j == 0 ? "tension" : "sag";
+      const double scale = j == 0 ? scale_force : scale_length;
+
+      const uint64_t count_total = CountTotal(histogram);
+      const int count_bins = (int)histogram.counts.size();
+      const double value_end = histogram.value_begin
+                               + count_bins * histogram.width_bin;
+
+      // the exceedance of a bin is the fraction of samples above its lower
+      // bound
+      // the underflow and overflow rows are bounded by the sampled extremes
+      uint64_t count_above = count_total;
+      for (int k = -1; k <= count_bins; k++) {
+        uint64_t count = 0;
+        double value_lower = 0;
+        double value_upper = 0;
+        if (k == -1) {
+          count = histogram.count_underflow;
+          value_lower = histogram.value_min;
+          value_upper = histogram.value_begin;
+        } else if (k == count_bins) {
+          count = histogram.count_overflow;
+          value_lower = value_end;
+          value_upper = histogram.value_max;
+        } else {
+          count = histogram.counts[k];
+          value_lower = histogram.value_begin + k * histogram.width_bin;
+          value_upper = value_lower + histogram.width_bin;
+        }
+
+        if (count != 0) {
+          file.Append("%d,%s,%.3f,%.3f,%llu,%.8f\n", i, name,
+                      value_lower * scale, value_upper * scale,
+                      (unsigned long long)count,
+                      (double)count_above / count_total);
+        }
+        count_above -= count;
+      }
+    }
+  }
+
+  return file.Close();
+}
+
+uint64_t MonteCarloEngine::Run(const TransmissionLine& line,
+                               const WeatherLoadCase& weathercase,
+                               const CableConditionType& condition,
+                               const int& count_samples,
+                               const uint64_t& seed) {
+  TRACE_SCOPE("MonteCarloEngine::Run");
+
+  std::vector<const LineCable*> line_cables;
+  for (auto iter = line.line_cables()->cbegin();
+       iter != line.line_cables()->cend(); iter++) {
+    line_cables.push_back(&(*iter));
+  }
+
+  // values are stored by line cable, as a tension and then a sag
+  const int count_line_cables = (int)line_cables.size();
+  const int count_values = count_line_cables * 2;
+
+  // evaluates a sample, and stores NaN for failed solutions
+  auto evaluate = [&](const int& index_sample, double* values) {
+    const uint64_t counter = index_sample * kCountRandomsSample;
+
+    WeatherLoadCase weathercase_sample = weathercase;
+    weathercase_sample.thickness_ice = std::max(
+        Sample(distribution_ice_, weathercase.thickness_ice, seed, counter),
+        0.0);
+    weathercase_sample.temperature_cable = Sample(
+        distribution_temperature_, weathercase.temperature_cable, seed,
+        counter + 2);
+    weathercase_sample.pressure_wind = std::max(
+        Sample(distribution_wind_, weathercase.pressure_wind, seed,
+               counter + 4),
+        0.0);
+
+    for (int i = 0; i < count_line_cables; i++) {
+      values[i * 2] = std::numeric_limits<double>::quiet_NaN();
+      values[i * 2 + 1] = std::numeric_limits<double>::quiet_NaN();
+
+      const LineCable* line_cable = line_cables[i];
+      if (line_cable->cable() == nullptr) {
+        continue;
+      }
+
+      LineCableReloader reloader;
+      reloader.set_line_cable(line_cable);
+      reloader.set_weathercase_reloaded(&weathercase_sample);
+      reloader.set_condition_reloaded(condition);
+      if (reloader.Validate(false, nullptr) == false) {
+        continue;
+      }
+
+      double weight_transverse = 0;
+      double weight_vertical = 0;
+      LineSpanBuilder::UnitWeight(*line_cable->cable(), weathercase_sample,
+                                  weight_transverse, weight_vertical);
+      const double tension = reloader.TensionHorizontal();
+      const double constant =
+          tension / std::hypot(weight_transverse, weight_vertical);
+      const double ruling = line_cable->spacing_attachments_ruling_span().x();
+      values[i * 2] = tension;
+      values[i * 2 + 1] = constant * (std::cosh(ruling / (2 * constant)) - 1);
+    }
+  };
+
+  // evaluates the pilot samples, and sets the histogram ranges from them
+  const int count_pilot = std::min(kCountSamplesPilot, count_samples);
+  std::vector<double> values_pilot(count_pilot * count_values);
+  Parallel::For(count_pilot, [&](const int& index, const int& thread) {
+    evaluate(index, &values_pilot[index * count_values]);
+  });
+
+  std::vector<MonteCarloHistogram> histograms(count_values);
+  for (int k = 0; k < count_values; k++) {
+    double value_min = std::numeric_limits<double>::infinity();
+    double value_max = -std::numeric_limits<double>::infinity();
+    for (int i = 0; i < count_pilot; i++) {
+      const double value = values_pilot[i * count_values + k];
+      if (std::isfinite(value) == true) {
+        value_min = std::min(value_min, value);
+        value_max = std::max(value_max, value);
+      }
+    }
+
+    // pads the pilot range, since the full run reaches further into the
+    // tails
+    MonteCarloHistogram& histogram = histograms[k];
+    histogram.count_overflow = 0;
+    histogram.count_underflow = 0;
+    histogram.value_max = std::numeric_limits<double>::quiet_NaN();
+    histogram.value_min = std::numeric_limits<double>::quiet_NaN();
+    if (value_min <= value_max) {
+      const double range = std::max(value_max - value_min,
+                                    std::abs(value_max) * 0.01 + 1e-9);
+      histogram.value_begin = value_min - range / 2;
+      histogram.width_bin = range * 2 / kCountBins;
+    } else {
+      histogram.value_begin = 0;
+      histogram.width_bin = 1;
+    }
+  }
+
+  // each thread accumulates into its own counts and extremes
+  const int count_threads = Parallel::CountThreads();
+  const int count_slots_thread = count_values * kCountSlots;
+  std::vector<uint64_t> counts(count_threads * count_slots_thread, 0);
+  std::vector<uint64_t> counts_failed(count_threads, 0);
+  std::vector<double> extremes(count_threads * count_values * 2);
+  for (int i = 0; i < count_threads * count_values; i++) {
+    extremes[i * 2] = std::numeric_limits<double>::infinity();
+    extremes[i * 2 + 1] = -std::numeric_limits<double>::infinity();
+  }
+
+  for (int i = 0; i < count_pilot; i++) {
+    for (int k = 0; k < count_values; k++) {
+      const double value = values_pilot[i * count_values + k];
+      if (std::isfinite(value) == true) {
+        AddValue(value, histograms[k], &counts[k * kCountSlots],
+                 &extremes[k * 2]);
+      } else if (k % 2 == 0) {
+        counts_failed[0]++;
+      }
+    }
+  }
+
+  const int count_remaining = count_samples - count_pilot;
+  const int count_blocks =
+      (count_remaining + kCountSamplesBlock - 1) / kCountSamplesBlock;
+  Parallel::For(count_blocks, [&](const int& index, const int& thread) {
+    const int index_begin = count_pilot + index * kCountSamplesBlock;
+    const int index_end = std::min(index_begin + kCountSamplesBlock,
+                                   count_samples);
+    uint64_t* counts_thread = &counts[thread * count_slots_thread];
+    double* extremes_thread = &extremes[thread * count_values * 2];
+
+    std::vector<double> values(count_values);
+    for (int s = index_begin; s < index_end; s++) {
+      evaluate(s, values.data());
+      for (int k = 0; k < count_values; k++) {
+        if (std::isfinite(values[k]) == true) {
+          AddValue(values[k], histograms[k], &counts_thread[k * kCountSlots],
+                   &extremes_thread[k * 2]);
+        } else if (k % 2 == 0) {
+          counts_failed[thread]++;
+        }
+      }
+    }
+  });
+
+  // merges the thread counts
+  uint64_t count_failed = 0;
+  for (int t = 0; t < count_threads; t++) {
+    count_failed += counts_failed[t];
+  }
+
+  for (int k = 0; k < count_values; k++) {
+    MonteCarloHistogram& histogram = histograms[k];
+    histogram.counts.assign(kCountBins, 0);
+    double value_min = std::numeric_limits<double>::infinity();
+    double value_max = -std::numeric_limits<double>::infinity();
+    for (int t = 0; t < count_threads; t++) {
+      const uint64_t* counts_thread =
+          &counts[t * count_slots_thread + k * kCountSlots];
+      for (int b = 0; b < kCountBins; b++) {
+        histogram.counts[b] += counts_thread[b];
+      }
+      histogram.count_underflow += counts_thread[kCountBins];
+      histogram.count_overflow += counts_thread[kCountBins + 1];
+
+      const double* extremes_thread = &extremes[(t * count_values + k) * 2];
+      value_min = std::min(value_min, extremes_thread[0]);
+      value_max = std::max(value_max, extremes_thread[1]);
+    }
+
+    if (value_min <= value_max) {
+      histogram.value_max = value_max;
+      histogram.value_min = value_min;
+    }
+  }
+
+  histograms_sag_.clear();
+  histograms_tension_.clear();
+  for (int i = 0; i < count_line_cables; i++) {
+    histograms_tension_.push_back(histograms[i * 2]);
+    histograms_sag_.push_back(histograms[i * 2 + 1]);
+  }
+
+  return count_failed;
+}
+
+double MonteCarloEngine::ValueExceeded(const MonteCarloHistogram& histogram,
+                                       const double& probability) {
+  const uint64_t count_total = CountTotal(histogram);
+  if (count_total == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  // accumulates from the overflow down until the target count is reached
+  // the overflow and underflow are spread between the bin range and the
+  // sampled extremes
+  const int count_bins = (int)histogram.counts.size();
+  const double count_target = probability * count_total;
+  double count_above = 0;
+  for (int i = count_bins; -1 <= i; i--) {
+    double count = 0;
+    double value_lower = 0;
+    double value_upper = 0;
+    if (i == count_bins) {
+      count = (double)histogram.count_overflow;
+      value_lower = histogram.value_begin + count_bins * histogram.width_bin;
+      value_upper = histogram.value_max;
+    } else if (i == -1) {
+      count = (double)histogram.count_underflow;
+      value_lower = histogram.value_min;
+      value_upper = histogram.value_begin;
+    } else {
+      count = (double)histogram.counts[i];
+      value_lower = histogram.value_begin + i * histogram.width_bin;
+      value_upper = value_lower + histogram.width_bin;
+    }
+
+    if ((count_target <= count_above + count) && (0 < count)) {
+      const double fraction = (count_target - count_above) / count;
+      return value_upper - fraction * (value_upper - value_lower);
+    }
+    count_above += count;
+  }
+
+  return histogram.value_min;
+}
+
+const std::vector<MonteCarloHistogram>& MonteCarloEngine::histograms_sag()
+    const {
+  return histograms_sag_;
+}
+
+const std::vector<MonteCarloHistogram>&
+    MonteCarloEngine::histograms_tension() const {
+  return histograms_tension_;
+}
+
+void MonteCarloEngine::set_distribution_ice(
+    const MonteCarloDistribution& distribution) {
+  distribution_ice_ = distribution;
+}
+
+void MonteCarloEngine::set_distribution_temperature(
+    const MonteCarloDistribution& distribution) {
+  distribution_temperature_ = distribution;
+}
+
+void MonteCarloEngine::set_distribution_wind(
+    const MonteCarloDistribution& distribution) {
+  distribution_wind_ = distribution;
+}
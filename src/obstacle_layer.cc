@@ -0,0 +1,161 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "obstacle_layer.h"
+
+#include <algorithm>
+
+#include "trace.h"
+
+namespace {
+
+/// The most points in a leaf node.
+const uint32_t kCountPointsLeaf = 16;
+
+/// \brief Gets a coordinate of a point.
+/// \param[in] point
+///   The point.
+/// \param[in] axis
+///   The axis (0 = x, 1 = y, 2 = z).
+/// \return The coordinate.
+float Coordinate(const ObstaclePoint& point, const int& axis) {
+  if (axis == 0) {
+    return point.x;
+  } else if (axis == 1) {
+    return point.y;
+  } else {
+    return point.z;
+  }
+}
+
+}  // namespace
+
+ObstacleLayer::ObstacleLayer() {
+}
+
+void ObstacleLayer::Build(std::vector<ObstaclePoint>& points) {
+  TRACE_SCOPE("ObstacleLayer::Build");
+
+  Clear();
+  points_.swap(points);
+  if (points_.empty() == true) {
+    return;
+  }
+
+  // a balanced tree with small leaves has about 2n/leaf nodes
+  nodes_.reserve(2 * points_.size() / kCountPointsLeaf + 1);
+  BuildNode(0, (uint32_t)points_.size());
+}
+
+void ObstacleLayer::Clear() {
+  nodes_.clear();
+  points_.clear();
+}
+
+void ObstacleLayer::Query(const double bounds_min[3],
+                          const double bounds_max[3],
+                          std::vector<uint32_t>& indexes) const {
+  if (nodes_.empty() == true) {
+    return;
+  }
+
+  // walks the tree with an explicit stack
+  int32_t stack[64];
+  int count_stack = 0;
+  stack[count_stack++] = 0;
+  while (0 < count_stack) {
+    const Node& node = nodes_[stack[--count_stack]];
+
+    // skips nodes that are outside of the box, and takes nodes that are
+    // inside of it
+    bool is_inside = true;
+    bool is_outside = false;
+    for (int axis = 0; axis < 3; axis++) {
+      if ((node.bounds_max[axis] < bounds_min[axis])
+          || (bounds_max[axis] < node.bounds_min[axis])) {
+        is_outside = true;
+        break;
+      }
+
+      if ((node.bounds_min[axis] < bounds_min[axis])
+          || (bounds_max[axis] < node.bounds_max[axis])) {
+        is_inside = false;
+      }
+    }
+
+    if (is_outside == true) {
+      continue;
+    }
+
+    if (is_inside == true) {
+      for (uint32_t i = node.begin; i < node.end; i++) {
+        indexes.push_back(i);
+      }
+    } else if (node.index_left == -1) {
+      for (uint32_t i = node.begin; i < node.end; i++) {
+        const ObstaclePoint& point = points_[i];
+        if ((bounds_min[0] <= point.x) && (point.x <= bounds_max[0])
+            && (bounds_min[1] <= point.y) && (point.y <= bounds_max[1])
+            && (bounds_min[2] <= point.z) && (point.z <= bounds_max[2])) {
+          indexes.push_back(i);
+        }
+      }
+    } else {
+      stack[count_stack++] = node.index_left;
+      stack[count_stack++] = node.index_right;
+    }
+  }
+}
+
+const std::vector<ObstaclePoint>& ObstacleLayer::points() const {
+  return points_;
+}
+
+int32_t ObstacleLayer::BuildNode(const uint32_t& begin, const uint32_t& end) {
+  const int32_t index = (int32_t)nodes_.size();
+  nodes_.push_back(Node());
+
+  // bounds the points
+  Node node;
+  node.begin = begin;
+  node.end = end;
+  node.index_left = -1;
+  node.index_right = -1;
+  for (int axis = 0; axis < 3; axis++) {
+    node.bounds_min[axis] = Coordinate(points_[begin], axis);
+    node.bounds_max[axis] = node.bounds_min[axis];
+  }
+  for (uint32_t i = begin + 1; i < end; i++) {
+    for (int axis = 0; axis < 3; axis++) {
+      const float coordinate = Coordinate(points_[i], axis);
+      node.bounds_min[axis] = std::min(node.bounds_min[axis], coordinate);
+      node.bounds_max[axis] = std::max(node.bounds_max[axis], coordinate);
+    }
+  }
+
+  // splits at the median of the longest axis
+  if (kCountPointsLeaf < end - begin) {
+    int axis_split = 0;
+    for (int axis = 1; axis < 3; axis++) {
+      if (node.bounds_max[axis_split] - node.bounds_min[axis_split]
+          < node.bounds_max[axis] - node.bounds_min[axis]) {
+        axis_split = axis;
+      }
+    }
+
+    const uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(
+        points_.begin() + begin, points_.begin() + middle,
+        points_.begin() + end,
+        [axis_split](const ObstaclePoint& a, const ObstaclePoint& b) {
+          return Coordinate(a, axis_split) < Coordinate(b, axis_split);
+        });
+
+    node.index_left = BuildNode(begin, middle);
+    node.index_right = BuildNode(middle, end);
+  }
+
+  // the vector may have grown, so the node is written after the children
+  nodes_[index] = node;
+  return index;
+}
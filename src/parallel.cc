@@ -0,0 +1,206 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// An indicator that tells if the current thread is running work items, so
+/// nested calls are run on the thread instead of waiting on the pool.
+thread_local bool is_running_items = false;
+
+/// \par OVERVIEW
+///
+/// This class holds the worker threads. The threads are started once and
+/// wait for a run between calls. Every worker takes part in every run, and
+/// the run finishes when the last worker checks in.
+class WorkerPool {
+ public:
+  /// \brief Constructor.
+  /// \param[in] count_threads
+  ///   The number of threads, including the calling thread.
+  explicit WorkerPool(const int& count_threads);
+
+  /// \brief Destructor.
+  ~WorkerPool();
+
+  /// \brief Runs a function for every work item.
+  /// \param[in] count
+  ///   The number of work items.
+  /// \param[in] function
+  ///   The function.
+  void Run(const int& count,
+           const std::function<void(const int&, const int&)>& function);
+
+ private:
+  /// \brief Claims and runs work items until there are none left.
+  /// \param[in] thread
+  ///   The thread index.
+  void RunItems(const int& thread);
+
+  /// \brief Waits for runs on a worker thread.
+  /// \param[in] thread
+  ///   The thread index.
+  void Work(const int& thread);
+
+  /// The pool can't be copied.
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /// \var condition_done_
+  ///   The condition that the calling thread waits on for the workers.
+  std::condition_variable condition_done_;
+
+  /// \var condition_run_
+  ///   The condition that the workers wait on for a run.
+  std::condition_variable condition_run_;
+
+  /// \var count_
+  ///   The number of work items in the run.
+  int count_;
+
+  /// \var count_working_
+  ///   The number of workers that haven't finished the run.
+  int count_working_;
+
+  /// \var function_
+  ///   The function for the run.
+  const std::function<void(const int&, const int&)>* function_;
+
+  /// \var generation_
+  ///   The run number, which workers compare to the last run they joined.
+  unsigned long generation_;
+
+  /// \var index_next_
+  ///   The next work item to claim.
+  std::atomic<int> index_next_;
+
+  /// \var is_stopping_
+  ///   An indicator that tells if the workers should exit.
+  bool is_stopping_;
+
+  /// \var mutex_
+  ///   The mutex that guards the run state.
+  std::mutex mutex_;
+
+  /// \var mutex_run_
+  ///   The mutex that keeps runs from different threads apart.
+  std::mutex mutex_run_;
+
+  /// \var threads_
+  ///   The worker threads.
+  std::vector<std::thread> threads_;
+};
+
+WorkerPool::WorkerPool(const int& count_threads) : index_next_(0) {
+  count_ = 0;
+  count_working_ = 0;
+  function_ = nullptr;
+  generation_ = 0;
+  is_stopping_ = false;
+
+  // the calling thread is the last worker
+  for (int thread = 0; thread < count_threads - 1; thread++) {
+    threads_.push_back(std::thread(&WorkerPool::Work, this, thread));
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  condition_run_.notify_all();
+
+  for (auto iter = threads_.begin(); iter != threads_.end(); iter++) {
+    iter->join();
+  }
+}
+
+void WorkerPool::Run(
+    const int& count,
+    const std::function<void(const int&, const int&)>& function) {
+  std::lock_guard<std::mutex> lock_run(mutex_run_);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    count_ = count;
+    count_working_ = (int)threads_.size();
+    function_ = &function;
+    index_next_.store(0, std::memory_order_relaxed);
+    generation_++;
+  }
+  condition_run_.notify_all();
+
+  is_running_items = true;
+  RunItems((int)threads_.size());
+  is_running_items = false;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_done_.wait(lock, [this]() { return count_working_ == 0; });
+  function_ = nullptr;
+}
+
+void WorkerPool::RunItems(const int& thread) {
+  int index = index_next_.fetch_add(1, std::memory_order_relaxed);
+  while (index < count_) {
+    (*function_)(index, thread);
+    index = index_next_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void WorkerPool::Work(const int& thread) {
+  is_running_items = true;
+
+  unsigned long generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_run_.wait(lock, [this, &generation]() {
+        return (is_stopping_ == true) || (generation_ != generation);
+      });
+      if (is_stopping_ == true) {
+        return;
+      }
+      generation = generation_;
+    }
+
+    RunItems(thread);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    count_working_--;
+    if (count_working_ == 0) {
+      condition_done_.notify_one();
+    }
+  }
+}
+
+}  // namespace
+
+int Parallel::CountThreads() {
+  const int count = (int)std::thread::hardware_concurrency();
+  return std::max(count, 1);
+}
+
+void Parallel::For(
+    const int& count,
+    const std::function<void(const int&, const int&)>& function) {
+  const int count_threads = std::min(CountThreads(), count);
+  if ((count_threads <= 1) || (is_running_items == true)) {
+    for (int index = 0; index < count; index++) {
+      function(index, 0);
+    }
+    return;
+  }
+
+  // the pool is created on first use and lives until the program exits
+  static WorkerPool pool(CountThreads());
+  pool.Run(count, function);
+}
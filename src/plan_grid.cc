@@ -0,0 +1,63 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "plan_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+PlanGrid::PlanGrid() {
+  size_cell_ = 1;
+}
+
+void PlanGrid::Add(const double& x_start, const double& y_start,
+                   const double& x_end, const double& y_end,
+                   const int& count_cells, const int& index) {
+  const double length = std::hypot(x_end - x_start, y_end - y_start);
+  const double spacing = size_cell_ / 2;
+  const int count_samples = (int)std::ceil(length / spacing) + 1;
+  for (int i = 0; i < count_samples; i++) {
+    double fraction = 0;
+    if (0 < length) {
+      fraction = std::min(i * spacing / length, 1.0);
+    }
+    const double x = x_start + fraction * (x_end - x_start);
+    const double y = y_start + fraction * (y_end - y_start);
+
+    for (int dx = -count_cells; dx <= count_cells; dx++) {
+      for (int dy = -count_cells; dy <= count_cells; dy++) {
+        std::vector<int>& cell = cells_[Key(x + dx * size_cell_,
+                                            y + dy * size_cell_)];
+        // segments are added in order, so a repeat is always the last
+        if ((cell.empty() == true) || (cell.back() != index)) {
+          cell.push_back(index);
+        }
+      }
+    }
+  }
+}
+
+void PlanGrid::Clear(const double& size_cell) {
+  cells_.clear();
+  size_cell_ = size_cell;
+}
+
+const std::vector<int>* PlanGrid::Find(const double& x,
+                                       const double& y) const {
+  auto iter = cells_.find(Key(x, y));
+  if (iter == cells_.cend()) {
+    return nullptr;
+  }
+
+  return &iter->second;
+}
+
+double PlanGrid::size_cell() const {
+  return size_cell_;
+}
+
+int64_t PlanGrid::Key(const double& x, const double& y) const {
+  const int64_t column = (int64_t)std::floor(x / size_cell_);
+  const int64_t row = (int64_t)std::floor(y / size_cell_);
+  return (column << 32) ^ (row & 0xFFFFFFFF);
+}
@@ -6,6 +6,8 @@
 #include "wx/filepicker.h"
 #include "wx/xrc/xmlres.h"
 
+#include "xrc_loader.h"
+
 BEGIN_EVENT_TABLE(PreferencesDialog, wxDialog)
   EVT_BUTTON(wxID_CANCEL, PreferencesDialog::OnButtonCancel)
   EVT_BUTTON(wxID_OK, PreferencesDialog::OnButtonOk)
@@ -15,6 +17,8 @@ END_EVENT_TABLE()
 PreferencesDialog::PreferencesDialog(wxWindow* parent,
                                      LineAnalyzerConfig* config) {
   // loads dialog from virtual xrc file system
+  // the resource is only parsed the first time the dialog is shown
+  XrcLoader::LoadPreferencesDialog();
   wxXmlResource::Get()->LoadDialog(this, parent, "preferences_dialog");
 
   // saves doc reference
@@ -0,0 +1,130 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "reference_index.h"
+
+#include <unordered_set>
+
+namespace {
+
+/// \brief Adds an indexed item to a list, if it isn't already listed.
+/// \param[in] name
+///   The item name.
+/// \param[in] index
+///   The index to look the name up in.
+/// \param[in,out] names
+///   The names that have already been looked up.
+/// \param[in,out] list
+///   The list that the item is added to.
+template<typename T>
+void AddReference(const std::string& name,
+                  const std::unordered_map<std::string, const T*>& index,
+                  std::unordered_set<std::string>& names,
+                  std::list<const T*>& list) {
+  if (names.insert(name).second == false) {
+    return;
+  }
+
+  auto iter = index.find(name);
+  if (iter != index.cend()) {
+    list.push_back(iter->second);
+  }
+}
+
+}  // namespace
+
+void ReferenceIndex::AddCable(const Cable* cable) {
+  cables_.emplace(cable->name, cable);
+}
+
+void ReferenceIndex::AddHardware(const Hardware* hardware) {
+  hardwares_.emplace(hardware->name, hardware);
+}
+
+void ReferenceIndex::AddStructure(const Structure* structure) {
+  structures_.emplace(structure->name, structure);
+}
+
+void ReferenceIndex::AddWeathercase(const WeatherLoadCase* weathercase) {
+  weathercases_.emplace(weathercase->description, weathercase);
+}
+
+void ReferenceIndex::Clear() {
+  cables_.clear();
+  hardwares_.clear();
+  structures_.clear();
+  weathercases_.clear();
+}
+
+void ReferenceIndex::ListReferences(const wxXmlNode* node,
+                                    ReferenceLists& lists) const {
+  lists.cables.clear();
+  lists.hardwares.clear();
+  lists.structures.clear();
+  lists.weathercases.clear();
+
+  std::unordered_set<std::string> names_cables;
+  std::unordered_set<std::string> names_hardwares;
+  std::unordered_set<std::string> names_structures;
+  std::unordered_set<std::string> names_weathercases;
+
+  // walks the node tree without recursion
+  // references are element nodes that only contain the item name
+  const wxXmlNode* node_sub = node->GetChildren();
+  while (node_sub != nullptr) {
+    if (node_sub->GetType() == wxXML_ELEMENT_NODE) {
+      const wxString& title = node_sub->GetName();
+      const wxXmlNode* node_content = node_sub->GetChildren();
+      if ((node_content != nullptr)
+          && (node_content->GetType() == wxXML_TEXT_NODE)
+          && (node_content->GetNext() == nullptr)) {
+        const std::string name = node_content->GetContent().ToStdString();
+        if (title == "cable") {
+          AddReference(name, cables_, names_cables, lists.cables);
+        } else if (title == "hardware") {
+          AddReference(name, hardwares_, names_hardwares, lists.hardwares);
+        } else if (title == "structure") {
+          AddReference(name, structures_, names_structures, lists.structures);
+        } else if (title == "weather_load_case") {
+          AddReference(name, weathercases_, names_weathercases,
+                       lists.weathercases);
+        }
+      }
+    }
+
+    // moves to the next node, depth first
+    if ((node_sub->GetType() == wxXML_ELEMENT_NODE)
+        && (node_sub->GetChildren() != nullptr)) {
+      node_sub = node_sub->GetChildren();
+      continue;
+    }
+
+    while ((node_sub != node) && (node_sub->GetNext() == nullptr)) {
+      node_sub = node_sub->GetParent();
+    }
+    if (node_sub == node) {
+      break;
+    }
+    node_sub = node_sub->GetNext();
+  }
+}
+
+const std::unordered_map<std::string, const Cable*>&
+    ReferenceIndex::cables() const {
+  return cables_;
+}
+
+const std::unordered_map<std::string, const Hardware*>&
+    ReferenceIndex::hardwares() const {
+  return hardwares_;
+}
+
+const std::unordered_map<std::string, const Structure*>&
+    ReferenceIndex::structures() const {
+  return structures_;
+}
+
+const std::unordered_map<std::string, const WeatherLoadCase*>&
+    ReferenceIndex::weathercases() const {
+  return weathercases_;
+}
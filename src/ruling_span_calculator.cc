@@ -0,0 +1,181 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "ruling_span_calculator.h"
+
+#include <cmath>
+#include <iterator>
+
+#include "line_span.h"
+#include "parallel.h"
+#include "trace.h"
+
+RulingSpanCalculator::RulingSpanCalculator() {
+  tolerance_ = 0.05;
+}
+
+void RulingSpanCalculator::Calculate(const TransmissionLine& line,
+                                     const AlignmentPath& path) {
+  TRACE_SCOPE("RulingSpanCalculator::Calculate");
+
+  std::unordered_map<const LineStructure*, int> indexes_structure;
+  int index_structure = 0;
+  for (auto iter = line.line_structures()->cbegin();
+       iter != line.line_structures()->cend(); iter++) {
+    indexes_structure[&(*iter)] = index_structure;
+    index_structure++;
+  }
+
+  std::vector<const LineCable*> line_cables;
+  for (auto iter = line.line_cables()->cbegin();
+       iter != line.line_cables()->cend(); iter++) {
+    line_cables.push_back(&(*iter));
+  }
+
+  const int count_line_cables = (int)line_cables.size();
+  chains_.assign(count_line_cables, std::vector<ChainPoint>());
+  results_.assign(count_line_cables, RulingSpanResult());
+
+  Parallel::For(count_line_cables, [&](const int& index, const int& thread) {
+    Locate(*line_cables[index], indexes_structure, path, chains_[index]);
+    Sum(*line_cables[index], index);
+  });
+
+  Index();
+}
+
+int RulingSpanCalculator::CountDeviating() const {
+  int count = 0;
+  for (auto iter = results_.cbegin(); iter != results_.cend(); iter++) {
+    if (iter->is_deviating == true) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
+void RulingSpanCalculator::UpdateStructure(
+    const TransmissionLine& line, const AlignmentPath& path,
+    const int& index_structure, const LineStructure& line_structure) {
+  if ((index_structure < 0)
+      || ((int)connections_structure_.size() <= index_structure)) {
+    return;
+  }
+
+  // locates the connections to the structure again
+  // connections are grouped by line cable, so each line cable is summed once
+  const std::vector<std::pair<int, int>>& connections =
+      connections_structure_[index_structure];
+  for (auto iter = connections.cbegin(); iter != connections.cend(); iter++) {
+    ChainPoint& point = chains_[iter->first][iter->second];
+    double elevation = 0;
+    const Hardware* hardware = nullptr;
+    point.is_valid = LineSpanBuilder::PointAttachment(
+        line_structure, point.index_attachment, path, point.x, point.y,
+        elevation, hardware);
+
+    auto iter_next = std::next(iter);
+    if ((iter_next == connections.cend())
+        || (iter_next->first != iter->first)) {
+      Sum(*std::next(line.line_cables()->cbegin(), iter->first),
+          iter->first);
+    }
+  }
+}
+
+const std::vector<RulingSpanResult>& RulingSpanCalculator::results() const {
+  return results_;
+}
+
+void RulingSpanCalculator::set_tolerance(const double& tolerance) {
+  tolerance_ = tolerance;
+}
+
+double RulingSpanCalculator::tolerance() const {
+  return tolerance_;
+}
+
+void RulingSpanCalculator::Index() {
+  connections_structure_.clear();
+  for (int i = 0; i < (int)chains_.size(); i++) {
+    const std::vector<ChainPoint>& chain = chains_[i];
+    for (int j = 0; j < (int)chain.size(); j++) {
+      const int index_structure = chain[j].index_structure;
+      if (index_structure == -1) {
+        continue;
+      }
+
+      if ((int)connections_structure_.size() <= index_structure) {
+        connections_structure_.resize(index_structure + 1);
+      }
+      connections_structure_[index_structure].push_back(
+          std::make_pair(i, j));
+    }
+  }
+}
+
+void RulingSpanCalculator::Locate(
+    const LineCable& line_cable,
+    const std::unordered_map<const LineStructure*, int>& indexes_structure,
+    const AlignmentPath& path, std::vector<ChainPoint>& chain) {
+  chain.clear();
+  for (auto iter = line_cable.connections()->cbegin();
+       iter != line_cable.connections()->cend(); iter++) {
+    const LineCableConnection& connection = *iter;
+
+    ChainPoint point;
+    point.index_attachment = connection.index_attachment;
+    point.index_structure = -1;
+    point.is_valid = false;
+    point.x = 0;
+    point.y = 0;
+
+    auto iter_index = indexes_structure.find(connection.line_structure);
+    if (iter_index != indexes_structure.cend()) {
+      double elevation = 0;
+      const Hardware* hardware = nullptr;
+      point.index_structure = iter_index->second;
+      point.is_valid = LineSpanBuilder::PointAttachment(
+          *connection.line_structure, connection.index_attachment, path,
+          point.x, point.y, elevation, hardware);
+    }
+
+    chain.push_back(point);
+  }
+}
+
+void RulingSpanCalculator::Sum(const LineCable& line_cable,
+                               const int& index_line_cable) {
+  const std::vector<ChainPoint>& chain = chains_[index_line_cable];
+
+  // consecutive located connections are spans, like in LineSpanBuilder
+  double sum = 0;
+  double sum_cubed = 0;
+  int count_spans = 0;
+  for (int i = 1; i < (int)chain.size(); i++) {
+    const ChainPoint& point_back = chain[i - 1];
+    const ChainPoint& point_ahead = chain[i];
+    if ((point_back.is_valid == false) || (point_ahead.is_valid == false)) {
+      continue;
+    }
+
+    const double length = std::hypot(point_ahead.x - point_back.x,
+                                     point_ahead.y - point_back.y);
+    sum += length;
+    sum_cubed += length * length * length;
+    count_spans++;
+  }
+
+  RulingSpanResult& result = results_[index_line_cable];
+  result.count_spans = count_spans;
+  result.spacing_calculated = 0;
+  if (0 < sum) {
+    result.spacing_calculated = std::sqrt(sum_cubed / sum);
+  }
+
+  result.spacing_stored = line_cable.spacing_attachments_ruling_span().x();
+  result.is_deviating = (0 < count_spans)
+      && (tolerance_ * result.spacing_calculated
+          < std::abs(result.spacing_stored - result.spacing_calculated));
+}
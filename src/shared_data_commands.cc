@@ -3,13 +3,15 @@
 
 #include "shared_data_commands.h"
 
+#include "appcommon/xml/weather_load_case_xml_handler.h"
 #include "wx/wx.h"
 
-#include "line_analyzer_app.h"
+#include "trace.h"
 
-SharedDataCommandBase::SharedDataCommandBase(const std::string& name)
+SharedDataCommandBase::SharedDataCommandBase(const std::string& name,
+                                             LineAnalyzerDoc* doc)
     : wxCommand(true, name) {
-  doc_ = wxGetApp().GetDocument();
+  doc_ = doc;
   node_ = nullptr;
 }
 
@@ -18,12 +20,21 @@ SharedDataCommandBase::~SharedDataCommandBase() {
 }
 
 bool SharedDataCommandBase::Do() {
+  TRACE_SCOPE("SharedDataCommandBase::Do");
+
   // saves the document state of the transmission lines
+  // a node from a previous do (before an undo/redo) is replaced
+  delete node_;
   node_ = doc_->SaveTransmissionLinesToXml();
 
   // swaps command and document data
   DoModify();
 
+  // journals the new shared data
+  if (doc_->IsJournaling() == true) {
+    doc_->AppendJournal(CreateJournalRecord());
+  }
+
   // posts a view update
   UpdateHint hint(HintType::kSharedDataEdit);
   doc_->UpdateAllViews(nullptr, &hint);
@@ -32,6 +43,8 @@ bool SharedDataCommandBase::Do() {
 }
 
 bool SharedDataCommandBase::Undo() {
+  TRACE_SCOPE("SharedDataCommandBase::Undo");
+
   // swaps command and document data
   DoModify();
 
@@ -40,6 +53,18 @@ bool SharedDataCommandBase::Undo() {
   const bool status = doc_->CreateTransmissionLinesFromXml(node_, lines);
   doc_->ModifyTransmissionLines(lines);
 
+  // journals the restored shared data and transmission lines
+  if (doc_->IsJournaling() == true) {
+    doc_->AppendJournal(CreateJournalRecord());
+
+    JournalRecord record;
+    record.type = JournalRecordType::kLines;
+    record.index = -1;
+    record.index_to = -1;
+    record.xml = CommandJournal::WriteXml(node_);
+    doc_->AppendJournal(record);
+  }
+
   // posts a view update
   UpdateHint hint(HintType::kSharedDataEdit);
   doc_->UpdateAllViews(nullptr, &hint);
@@ -47,9 +72,13 @@ bool SharedDataCommandBase::Undo() {
   return status;
 }
 
+const wxXmlNode* SharedDataCommandBase::node_lines() const {
+  return node_;
+}
+
 
-CableFileCommand::CableFileCommand()
-    : SharedDataCommandBase("Modify Cable Files") {
+CableFileCommand::CableFileCommand(LineAnalyzerDoc* doc)
+    : SharedDataCommandBase("Modify Cable Files", doc) {
 }
 
 CableFileCommand::~CableFileCommand() {
@@ -59,10 +88,23 @@ void CableFileCommand::set_cablefiles(const std::list<CableFile>& cablefiles) {
   cablefiles_ = cablefiles;
 }
 
-const std::list<CableFile> CableFileCommand::cablefiles() const {
+const std::list<CableFile>& CableFileCommand::cablefiles() const {
   return cablefiles_;
 }
 
+JournalRecord CableFileCommand::CreateJournalRecord() const {
+  JournalRecord record;
+  record.type = JournalRecordType::kCables;
+  record.index = -1;
+  record.index_to = -1;
+  for (auto iter = doc_->cables().cbegin(); iter != doc_->cables().cend();
+       iter++) {
+    record.filepaths.push_back((*iter).filepath);
+  }
+
+  return record;
+}
+
 bool CableFileCommand::DoModify() {
   // swaps the data from the document and the command
   std::list<CableFile> cablefiles_tmp = doc_->cables();
@@ -73,8 +115,8 @@ bool CableFileCommand::DoModify() {
 }
 
 
-HardwareFileCommand::HardwareFileCommand()
-    : SharedDataCommandBase("Modify Hardware Files") {
+HardwareFileCommand::HardwareFileCommand(LineAnalyzerDoc* doc)
+    : SharedDataCommandBase("Modify Hardware Files", doc) {
 }
 
 HardwareFileCommand::~HardwareFileCommand() {
@@ -85,10 +127,23 @@ void HardwareFileCommand::set_hardwarefiles(
   hardwarefiles_ = hardwarefiles;
 }
 
-const std::list<HardwareFile> HardwareFileCommand::hardwarefiles() const {
+const std::list<HardwareFile>& HardwareFileCommand::hardwarefiles() const {
   return hardwarefiles_;
 }
 
+JournalRecord HardwareFileCommand::CreateJournalRecord() const {
+  JournalRecord record;
+  record.type = JournalRecordType::kHardwares;
+  record.index = -1;
+  record.index_to = -1;
+  for (auto iter = doc_->hardwares().cbegin();
+       iter != doc_->hardwares().cend(); iter++) {
+    record.filepaths.push_back((*iter).filepath);
+  }
+
+  return record;
+}
+
 bool HardwareFileCommand::DoModify() {
   // swaps the data from the document and the command
   std::list<HardwareFile> hardwarefiles_tmp = doc_->hardwares();
@@ -99,8 +154,8 @@ bool HardwareFileCommand::DoModify() {
 }
 
 
-StructureFileCommand::StructureFileCommand()
-    : SharedDataCommandBase("Modify Structure Files") {
+StructureFileCommand::StructureFileCommand(LineAnalyzerDoc* doc)
+    : SharedDataCommandBase("Modify Structure Files", doc) {
 }
 
 StructureFileCommand::~StructureFileCommand() {
@@ -111,10 +166,23 @@ void StructureFileCommand::set_structurefiles(
   structurefiles_ = structurefiles;
 }
 
-const std::list<StructureFile> StructureFileCommand::structurefiles() const {
+const std::list<StructureFile>& StructureFileCommand::structurefiles() const {
   return structurefiles_;
 }
 
+JournalRecord StructureFileCommand::CreateJournalRecord() const {
+  JournalRecord record;
+  record.type = JournalRecordType::kStructures;
+  record.index = -1;
+  record.index_to = -1;
+  for (auto iter = doc_->structures().cbegin();
+       iter != doc_->structures().cend(); iter++) {
+    record.filepaths.push_back((*iter).filepath);
+  }
+
+  return record;
+}
+
 bool StructureFileCommand::DoModify() {
   // swaps the data from the document and the command
   std::list<StructureFile> structurefiles_tmp = doc_->structures();
@@ -125,8 +193,8 @@ bool StructureFileCommand::DoModify() {
 }
 
 
-WeatherLoadCaseCommand::WeatherLoadCaseCommand()
-    : SharedDataCommandBase("Modify Weather Cases") {
+WeatherLoadCaseCommand::WeatherLoadCaseCommand(LineAnalyzerDoc* doc)
+    : SharedDataCommandBase("Modify Weather Cases", doc) {
 }
 
 WeatherLoadCaseCommand::~WeatherLoadCaseCommand() {
@@ -137,10 +205,30 @@ void WeatherLoadCaseCommand::set_weathercases(
   weathercases_ = weathercases;
 }
 
-const std::list<WeatherLoadCase> WeatherLoadCaseCommand::weathercases() const {
+const std::list<WeatherLoadCase>& WeatherLoadCaseCommand::weathercases()
+    const {
   return weathercases_;
 }
 
+JournalRecord WeatherLoadCaseCommand::CreateJournalRecord() const {
+  // the weathercases are written in the document units, so aren't converted
+  wxXmlNode* node = new wxXmlNode(wxXML_ELEMENT_NODE, "weather_load_cases");
+  for (auto iter = doc_->weathercases().cbegin();
+       iter != doc_->weathercases().cend(); iter++) {
+    node->AddChild(WeatherLoadCaseXmlHandler::CreateNode(
+        *iter, "", LineAnalyzerDoc::kUnitSystem));
+  }
+
+  JournalRecord record;
+  record.type = JournalRecordType::kWeathercases;
+  record.index = -1;
+  record.index_to = -1;
+  record.xml = CommandJournal::WriteXml(node);
+
+  delete node;
+  return record;
+}
+
 bool WeatherLoadCaseCommand::DoModify() {
   // swaps the data from the document and the command
   std::list<WeatherLoadCase> weathercases_tmp = doc_->weathercases();
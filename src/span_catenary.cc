@@ -0,0 +1,120 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "span_catenary.h"
+
+#include <cmath>
+
+SpanCatenary::SpanCatenary() {
+  constant_ = 0;
+  cosine_swing_ = 1;
+  height_ = 0;
+  length_ = 0;
+  position_low_ = 0;
+  sine_swing_ = 0;
+}
+
+void SpanCatenary::Point(const double& fraction, double& x, double& y,
+                         double& elevation) const {
+  const double sag = Sag(fraction);
+
+  // starts on the chord and displaces along the unit weight direction
+  x = span_.x_back + fraction * (span_.x_ahead - span_.x_back);
+  y = span_.y_back + fraction * (span_.y_ahead - span_.y_back);
+  elevation = span_.elevation_back + fraction * height_
+              - sag * cosine_swing_;
+
+  if (0 < length_) {
+    const double normal_x = -(span_.y_ahead - span_.y_back) / length_;
+    const double normal_y = (span_.x_ahead - span_.x_back) / length_;
+    x += sag * sine_swing_ * normal_x;
+    y += sag * sine_swing_ * normal_y;
+  }
+}
+
+double SpanCatenary::Sag(const double& fraction) const {
+  if (constant_ <= 0) {
+    return 0;
+  }
+
+  const double position = fraction * length_;
+  const double height_cable = constant_
+      * (std::cosh((position - position_low_) / constant_)
+         - std::cosh(position_low_ / constant_));
+  return fraction * height_ - height_cable;
+}
+
+void SpanCatenary::SagProfile(const int& count_samples,
+                              std::vector<double>& sags) const {
+  sags.assign(count_samples, 0);
+  if ((constant_ <= 0) || (count_samples < 2)) {
+    return;
+  }
+
+  const double spacing = length_ / (count_samples - 1);
+  const double slope_chord = height_ / length_;
+  const double cosh_back = std::cosh(position_low_ / constant_);
+  double* data = sags.data();
+  for (int i = 0; i < count_samples; i++) {
+    const double position = i * spacing;
+    data[i] = position * slope_chord - constant_
+        * (std::cosh((position - position_low_) / constant_) - cosh_back);
+  }
+}
+
+bool SpanCatenary::Set(const LineSpan& span, const double& tension_horizontal,
+                       const double& weight_transverse,
+                       const double& weight_vertical) {
+  span_ = span;
+  length_ = std::hypot(span.x_ahead - span.x_back,
+                       span.y_ahead - span.y_back);
+  height_ = span.elevation_ahead - span.elevation_back;
+
+  const double weight = std::hypot(weight_transverse, weight_vertical);
+  if ((tension_horizontal <= 0) || (weight <= 0) || (length_ <= 0)
+      || (std::isfinite(tension_horizontal) == false)) {
+    constant_ = 0;
+    cosine_swing_ = 1;
+    position_low_ = 0;
+    sine_swing_ = 0;
+    return false;
+  }
+
+  constant_ = tension_horizontal / weight;
+  cosine_swing_ = weight_vertical / weight;
+  sine_swing_ = weight_transverse / weight;
+
+  // positions the low point so the catenary passes through both attachments
+  position_low_ = length_ / 2 - constant_ * std::asinh(
+      height_ / (2 * constant_ * std::sinh(length_ / (2 * constant_))));
+
+  return true;
+}
+
+double SpanCatenary::SlopeAhead() const {
+  if (constant_ <= 0) {
+    return 0;
+  }
+
+  return std::sinh((length_ - position_low_) / constant_);
+}
+
+double SpanCatenary::SlopeBack() const {
+  if (constant_ <= 0) {
+    return 0;
+  }
+
+  return std::sinh(-position_low_ / constant_);
+}
+
+double SpanCatenary::length() const {
+  return length_;
+}
+
+double SpanCatenary::position_low() const {
+  return position_low_;
+}
+
+const LineSpan& SpanCatenary::span() const {
+  return span_;
+}
@@ -0,0 +1,481 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "spotting_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "csv_writer.h"
+#include "line_span.h"
+#include "parallel.h"
+#include "quantity.h"
+#include "span_catenary.h"
+#include "trace.h"
+
+namespace {
+
+/// \par OVERVIEW
+///
+/// This struct is a feasible span between two candidates.
+struct SpottingEdge {
+  /// \var index_ahead
+  ///   The ahead candidate index.
+  int index_ahead;
+
+  /// \var index_structure_ahead
+  ///   The structure type index at the ahead candidate.
+  int index_structure_ahead;
+
+  /// \var index_structure_back
+  ///   The structure type index at the back candidate.
+  int index_structure_back;
+};
+
+/// \brief Gets the maximum vertical sag of a catenary.
+/// \param[in] catenary
+///   The catenary.
+/// \param[in] constant
+///   The catenary constant.
+/// \param[in] height
+///   The height of the ahead attachment above the back attachment.
+/// \return The maximum sag below the chord.
+/// The sag is largest where the cable is parallel to the chord.
+double SagMax(const SpanCatenary& catenary, const double& constant,
+              const double& height) {
+  const double length = catenary.length();
+  const double fraction = constant
+      * (std::asinh(height / length) - std::asinh(catenary.SlopeBack()))
+      / length;
+  return catenary.Sag(std::min(std::max(fraction, 0.0), 1.0));
+}
+
+}  // namespace
+
+SpottingOptimizer::SpottingOptimizer() {
+  cost_ = 0;
+  count_checked_ = 0;
+  count_sampled_ = 0;
+  spacing_samples_ = 1;
+  station_start_ = 0;
+}
+
+bool SpottingOptimizer::Export(const std::string& filepath,
+                               const units::UnitSystem& units) const {
+  CsvWriter file;
+  if (file.Open(filepath, "Spotting") == false) {
+    return false;
+  }
+
+  double scale = 1;
+  if (units == units::UnitSystem::kImperial) {
+    scale = quantity::FactorBetween(quantity::length::kMeters,
+                                    quantity::length::kFeet).scale;
+  }
+
+  file.Append("structure,station,type,height,elevation_ground,cost,"
+              "span_back\n");
+  for (int i = 0; i < (int)placements_.size(); i++) {
+    const SpottedStructure& placement = placements_[i];
+    const SpottingStructure& structure =
+        structures_[placement.index_structure];
+
+    double span_back = 0;
+    if (0 < i) {
+      span_back = placement.station - placements_[i - 1].station;
+    }
+
+    file.Append("%d,%.2f,%d,%.2f,%.2f,%.2f,%.2f\n", i,
+                placement.station * scale, placement.index_structure,
+                structure.height_attachment * scale,
+                placement.elevation_ground * scale, structure.cost,
+                span_back * scale);
+  }
+
+  return file.Close();
+}
+
+int SpottingOptimizer::Optimize(
+    const AlignmentPath& path, const TerrainIndex& terrain,
+    const std::vector<double>& stations_fixed,
+    const SpottingCriteria& criteria,
+    const std::vector<SpottingStructure>& structures) {
+  TRACE_SCOPE("SpottingOptimizer::Optimize");
+
+  cost_ = 0;
+  count_checked_ = 0;
+  count_sampled_ = 0;
+  placements_.clear();
+  structures_ = structures;
+  spacing_samples_ = criteria.spacing_samples;
+
+  const double station_start = path.station_start();
+  const double station_end = path.station_end();
+  if ((structures_.empty() == true) || (criteria.cases.empty() == true)
+      || (criteria.spacing_candidates <= 0) || (spacing_samples_ <= 0)
+      || (station_end <= station_start)) {
+    return 1;
+  }
+
+  if (Profile(path, terrain) == false) {
+    return 1;
+  }
+
+  // gets the loading with the most vertical sag, which controls clearance
+  int index_case_clearance = 0;
+  for (int i = 1; i < (int)criteria.cases.size(); i++) {
+    const SpottingCase& spotting_case = criteria.cases[i];
+    const SpottingCase& case_clearance =
+        criteria.cases[index_case_clearance];
+    if (case_clearance.tension_horizontal * spotting_case.weight_vertical
+        > spotting_case.tension_horizontal * case_clearance.weight_vertical) {
+      index_case_clearance = i;
+    }
+  }
+
+  const SpottingCase& case_clearance = criteria.cases[index_case_clearance];
+  const double weight_clearance = std::hypot(
+      case_clearance.weight_transverse, case_clearance.weight_vertical);
+  const double constant_clearance = case_clearance.tension_horizontal
+                                    / weight_clearance;
+  const double cosine_clearance = case_clearance.weight_vertical
+                                  / weight_clearance;
+
+  // merges the fixed and evenly spaced candidates
+  // a regular candidate that is close to a fixed station is dropped
+  std::vector<std::pair<double, bool>> candidates;
+  candidates.push_back(std::make_pair(station_start, true));
+  candidates.push_back(std::make_pair(station_end, true));
+  for (auto iter = stations_fixed.cbegin(); iter != stations_fixed.cend();
+       iter++) {
+    if ((station_start < *iter) && (*iter < station_end)) {
+      candidates.push_back(std::make_pair(*iter, true));
+    }
+  }
+
+  const int count_regular = (int)std::ceil(
+      (station_end - station_start) / criteria.spacing_candidates);
+  for (int i = 1; i < count_regular; i++) {
+    candidates.push_back(std::make_pair(
+        station_start + i * criteria.spacing_candidates, false));
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::pair<double, bool>& a,
+               const std::pair<double, bool>& b) {
+              return a.first < b.first;
+            });
+
+  std::vector<double> stations;
+  std::vector<bool> is_fixed;
+  for (auto iter = candidates.cbegin(); iter != candidates.cend(); iter++) {
+    if ((stations.empty() == false)
+        && (iter->first - stations.back() < spacing_samples_ / 2)) {
+      if (iter->second == true) {
+        stations.back() = iter->first;
+        is_fixed.back() = true;
+      }
+      continue;
+    }
+
+    stations.push_back(iter->first);
+    is_fixed.push_back(iter->second);
+  }
+
+  const int count_candidates = (int)stations.size();
+  const int count_types = (int)structures_.size();
+
+  // locates the candidates
+  // spans end at the next fixed candidate, so they never cross an angle
+  std::vector<double> xs(count_candidates);
+  std::vector<double> ys(count_candidates);
+  std::vector<double> grounds(count_candidates);
+  std::vector<int> indexes_fixed_next(count_candidates);
+  int index_fixed_next = count_candidates - 1;
+  for (int i = count_candidates - 1; 0 <= i; i--) {
+    path.PointXy(stations[i], 0, xs[i], ys[i]);
+    grounds[i] = Ground(stations[i]);
+    indexes_fixed_next[i] = index_fixed_next;
+    if (is_fixed[i] == true) {
+      index_fixed_next = i;
+    }
+  }
+
+  double span_max = 0;
+  for (auto iter = structures_.cbegin(); iter != structures_.cend();
+       iter++) {
+    span_max = std::max(span_max, iter->span_max);
+  }
+
+  // finds the feasible spans that start at each candidate
+  std::vector<std::vector<SpottingEdge>> edges(count_candidates);
+  std::vector<uint64_t> counts_checked(count_candidates, 0);
+  std::vector<uint64_t> counts_sampled(count_candidates, 0);
+  Parallel::For(count_candidates - 1, [&](const int& index,
+                                          const int& thread) {
+    SpanCatenary catenary;
+    LineSpan span = LineSpan();
+    span.x_back = xs[index];
+    span.y_back = ys[index];
+
+    // tracks the highest ground under the span as it is extended
+    const double station_back = stations[index];
+    int index_sample_begin = (int)std::floor(
+        (station_back - station_start_) / spacing_samples_) + 1;
+    int index_sample_end = index_sample_begin;
+    double elevation_ground_max = -std::numeric_limits<double>::infinity();
+    double station_ground_max = station_back;
+
+    for (int j = index + 1; j <= indexes_fixed_next[index]; j++) {
+      const double length = stations[j] - station_back;
+      if (span_max < length) {
+        break;
+      }
+
+      while ((index_sample_end < (int)elevations_ground_.size())
+             && (station_start_ + index_sample_end * spacing_samples_
+                 < stations[j])) {
+        if (elevation_ground_max < elevations_ground_[index_sample_end]) {
+          elevation_ground_max = elevations_ground_[index_sample_end];
+          station_ground_max = station_start_
+                               + index_sample_end * spacing_samples_;
+        }
+        index_sample_end++;
+      }
+
+      span.x_ahead = xs[j];
+      span.y_ahead = ys[j];
+
+      for (int a = 0; a < count_types; a++) {
+        for (int b = 0; b < count_types; b++) {
+          if ((structures_[a].span_max < length)
+              || (structures_[b].span_max < length)) {
+            continue;
+          }
+
+          counts_checked[index]++;
+          span.elevation_back = grounds[index]
+                                + structures_[a].height_attachment;
+          span.elevation_ahead = grounds[j]
+                                 + structures_[b].height_attachment;
+          const double height = span.elevation_ahead - span.elevation_back;
+          if (catenary.Set(span, case_clearance.tension_horizontal,
+                           case_clearance.weight_transverse,
+                           case_clearance.weight_vertical) == false) {
+            continue;
+          }
+
+          // accepts if the lowest possible cable point clears the highest
+          // ground, and rejects if the cable doesn't clear the highest
+          // ground, before sampling the whole span
+          const double sag_max = SagMax(catenary, constant_clearance,
+                                        height);
+          const double elevation_low =
+              std::min(span.elevation_back, span.elevation_ahead)
+              - sag_max * cosine_clearance;
+          bool is_feasible = true;
+          if (elevation_low - elevation_ground_max < criteria.clearance) {
+            double fraction = (station_ground_max - station_back) / length;
+            double elevation = span.elevation_back + fraction * height
+                               - catenary.Sag(fraction) * cosine_clearance;
+            is_feasible = criteria.clearance
+                          <= elevation - elevation_ground_max;
+
+            if (is_feasible == true) {
+              counts_sampled[index]++;
+              for (int k = index_sample_begin; k < index_sample_end; k++) {
+                fraction = (station_start_ + k * spacing_samples_
+                            - station_back) / length;
+                elevation = span.elevation_back + fraction * height
+                            - catenary.Sag(fraction) * cosine_clearance;
+                if (elevation - elevations_ground_[k] < criteria.clearance) {
+                  is_feasible = false;
+                  break;
+                }
+              }
+            }
+          }
+
+          // checks the support tension and weight spans for every loading
+          const double weight_span_back =
+              structures_[a].weight_span_max / 2;
+          const double weight_span_ahead =
+              structures_[b].weight_span_max / 2;
+          const bool is_checking_loads = (0 < criteria.tension_support_max)
+                                         || (0 < weight_span_back)
+                                         || (0 < weight_span_ahead);
+          for (auto iter = criteria.cases.cbegin();
+               (iter != criteria.cases.cend()) && (is_feasible == true)
+               && (is_checking_loads == true); iter++) {
+            if (catenary.Set(span, iter->tension_horizontal,
+                             iter->weight_transverse,
+                             iter->weight_vertical) == false) {
+              continue;
+            }
+
+            const double slope = std::max(std::abs(catenary.SlopeBack()),
+                                          std::abs(catenary.SlopeAhead()));
+            if ((0 < criteria.tension_support_max)
+                && (criteria.tension_support_max
+                    < iter->tension_horizontal
+                      * std::sqrt(1 + slope * slope))) {
+              is_feasible = false;
+            }
+
+            const double position_low = catenary.position_low();
+            if (((0 < weight_span_back)
+                 && (weight_span_back < position_low))
+                || ((0 < weight_span_ahead)
+                    && (weight_span_ahead < length - position_low))) {
+              is_feasible = false;
+            }
+          }
+
+          if (is_feasible == true) {
+            edges[index].push_back(SpottingEdge{j, b, a});
+          }
+        }
+      }
+    }
+  });
+
+  for (int i = 0; i < count_candidates; i++) {
+    count_checked_ += counts_checked[i];
+    count_sampled_ += counts_sampled[i];
+  }
+
+  // solves the cheapest placement in station order
+  // every span starts at a lower station, so each candidate is final
+  // before its spans are extended
+  const double cost_none = std::numeric_limits<double>::infinity();
+  std::vector<double> costs(count_candidates * count_types, cost_none);
+  std::vector<int> parents(count_candidates * count_types, -1);
+  for (int a = 0; a < count_types; a++) {
+    costs[a] = structures_[a].cost;
+  }
+
+  for (int i = 0; i < count_candidates; i++) {
+    for (auto iter = edges[i].cbegin(); iter != edges[i].cend(); iter++) {
+      const int state_back = i * count_types + iter->index_structure_back;
+      if (costs[state_back] == cost_none) {
+        continue;
+      }
+
+      const int state_ahead = iter->index_ahead * count_types
+                              + iter->index_structure_ahead;
+      const double cost = costs[state_back]
+          + structures_[iter->index_structure_ahead].cost;
+      if (cost < costs[state_ahead]) {
+        costs[state_ahead] = cost;
+        parents[state_ahead] = state_back;
+      }
+    }
+  }
+
+  int state = -1;
+  for (int b = 0; b < count_types; b++) {
+    const int state_end = (count_candidates - 1) * count_types + b;
+    if ((costs[state_end] != cost_none)
+        && ((state == -1) || (costs[state_end] < costs[state]))) {
+      state = state_end;
+    }
+  }
+
+  if (state == -1) {
+    return 1;
+  }
+
+  cost_ = costs[state];
+  while (state != -1) {
+    const int index_candidate = state / count_types;
+    placements_.push_back(SpottedStructure{
+        grounds[index_candidate], state % count_types,
+        stations[index_candidate]});
+    state = parents[state];
+  }
+  std::reverse(placements_.begin(), placements_.end());
+
+  return 0;
+}
+
+double SpottingOptimizer::cost() const {
+  return cost_;
+}
+
+uint64_t SpottingOptimizer::count_checked() const {
+  return count_checked_;
+}
+
+uint64_t SpottingOptimizer::count_sampled() const {
+  return count_sampled_;
+}
+
+const std::vector<SpottedStructure>& SpottingOptimizer::placements() const {
+  return placements_;
+}
+
+double SpottingOptimizer::Ground(const double& station) const {
+  const int count_samples = (int)elevations_ground_.size();
+  const double position = (station - station_start_) / spacing_samples_;
+  const int index = std::min(std::max((int)std::floor(position), 0),
+                             count_samples - 1);
+  if (index == count_samples - 1) {
+    return elevations_ground_[index];
+  }
+
+  const double fraction = std::min(std::max(position - index, 0.0), 1.0);
+  return elevations_ground_[index] + fraction
+         * (elevations_ground_[index + 1] - elevations_ground_[index]);
+}
+
+bool SpottingOptimizer::Profile(const AlignmentPath& path,
+                                const TerrainIndex& terrain) {
+  station_start_ = path.station_start();
+  const int count_samples = (int)std::ceil(
+      (path.station_end() - station_start_) / spacing_samples_) + 1;
+
+  // takes the highest ground near the centerline at each sample
+  const double radius = spacing_samples_ / 2;
+  elevations_ground_.assign(count_samples,
+                            std::numeric_limits<double>::quiet_NaN());
+  Parallel::For(count_samples, [&](const int& index, const int& thread) {
+    const double station = station_start_ + index * spacing_samples_;
+    TerrainPoint point;
+    if (terrain.Highest(station - radius, station + radius, -radius, radius,
+                        point) == true) {
+      elevations_ground_[index] = point.elevation;
+    }
+  });
+
+  // fills the samples without ground from their neighbors
+  int index_previous = -1;
+  for (int i = 0; i < count_samples; i++) {
+    if (std::isnan(elevations_ground_[i]) == true) {
+      continue;
+    }
+
+    for (int k = index_previous + 1; k < i; k++) {
+      if (index_previous == -1) {
+        elevations_ground_[k] = elevations_ground_[i];
+      } else {
+        const double fraction = (double)(k - index_previous)
+                                / (i - index_previous);
+        elevations_ground_[k] = elevations_ground_[index_previous] + fraction
+            * (elevations_ground_[i] - elevations_ground_[index_previous]);
+      }
+    }
+    index_previous = i;
+  }
+
+  if (index_previous == -1) {
+    return false;
+  }
+
+  for (int k = index_previous + 1; k < count_samples; k++) {
+    elevations_ground_[k] = elevations_ground_[index_previous];
+  }
+
+  return true;
+}
@@ -0,0 +1,254 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "structure_load_engine.h"
+
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+
+#include "wx/filename.h"
+
+#include "csv_writer.h"
+#include "parallel.h"
+#include "quantity.h"
+#include "span_catenary.h"
+#include "trace.h"
+
+namespace {
+
+/// \par OVERVIEW
+///
+/// This struct is a span end that is connected to an attachment.
+struct SpanEnd {
+  /// \var index_span
+  ///   The span index.
+  int index_span;
+
+  /// \var is_ahead
+  ///   An indicator that tells if the attachment is at the ahead end of the
+  ///   span.
+  bool is_ahead;
+};
+
+}  // namespace
+
+StructureLoadEngine::StructureLoadEngine() {
+}
+
+void StructureLoadEngine::Calculate(const TransmissionLine& line,
+                                    const AlignmentPath& path,
+                                    const std::vector<LineSpan>& spans,
+                                    const TensionTable& tensions) {
+  TRACE_SCOPE("StructureLoadEngine::Calculate");
+
+  conditions_ = tensions.conditions();
+  weathercases_ = tensions.weathercases();
+
+  // gets the longitudinal axis of every structure
+  std::vector<double> axes;
+  for (auto iter = line.line_structures()->cbegin();
+       iter != line.line_structures()->cend(); iter++) {
+    double x = 0;
+    double y = 0;
+    LineSpanBuilder::AxisLongitudinal(*iter, path, x, y);
+    axes.push_back(x);
+    axes.push_back(y);
+  }
+
+  // gathers the span ends at each attachment
+  std::map<std::pair<int, int>, std::vector<SpanEnd>> ends_attachment;
+  for (int i = 0; i < (int)spans.size(); i++) {
+    const LineSpan& span = spans[i];
+    ends_attachment[std::make_pair(span.index_structure_back,
+                                   span.index_attachment_back)]
+        .push_back(SpanEnd{i, false});
+    ends_attachment[std::make_pair(span.index_structure_ahead,
+                                   span.index_attachment_ahead)]
+        .push_back(SpanEnd{i, true});
+  }
+
+  attachments_.clear();
+  std::vector<const std::vector<SpanEnd>*> ends;
+  for (auto iter = ends_attachment.cbegin(); iter != ends_attachment.cend();
+       iter++) {
+    attachments_.push_back(
+        LoadedAttachment{iter->first.second, iter->first.first});
+    ends.push_back(&iter->second);
+  }
+
+  const int count_conditions = (int)conditions_.size();
+  const int count_cases = (int)weathercases_.size() * count_conditions;
+  const int count_loads = (int)attachments_.size() * count_cases;
+  loads_.assign(count_loads, AttachmentLoad{0, 0, 0});
+
+  Parallel::For(count_loads, [&](const int& index, const int& thread) {
+    const int index_attachment = index / count_cases;
+    const int index_weathercase = (index % count_cases) / count_conditions;
+    const int index_condition = index % count_conditions;
+    const WeatherLoadCase& weathercase = *weathercases_[index_weathercase];
+    AttachmentLoad& load = loads_[index];
+
+    // sums the span contributions in plan coordinates
+    double force_x = 0;
+    double force_y = 0;
+    double force_vertical = 0;
+    double wind_x = 0;
+    double wind_y = 0;
+    const Hardware* hardware = nullptr;
+
+    SpanCatenary catenary;
+    const std::vector<SpanEnd>& ends_load = *ends[index_attachment];
+    for (auto iter = ends_load.cbegin(); iter != ends_load.cend(); iter++) {
+      const LineSpan& span = spans[iter->index_span];
+      const Cable* cable = span.line_cable->cable();
+
+      // a missing solution makes the whole load unknown
+      double weight_transverse = 0;
+      double weight_vertical = 0;
+      double tension = std::numeric_limits<double>::quiet_NaN();
+      if (cable != nullptr) {
+        LineSpanBuilder::UnitWeight(*cable, weathercase, weight_transverse,
+                                    weight_vertical);
+        tension = tensions.Tension(span.index_line_cable, index_weathercase,
+                                   index_condition);
+      }
+
+      if ((cable == nullptr)
+          || (catenary.Set(span, tension, weight_transverse, weight_vertical)
+              == false)) {
+        load.longitudinal = std::numeric_limits<double>::quiet_NaN();
+        load.transverse = std::numeric_limits<double>::quiet_NaN();
+        load.vertical = std::numeric_limits<double>::quiet_NaN();
+        return;
+      }
+
+      const double direction_x = (span.x_ahead - span.x_back)
+                                 / catenary.length();
+      const double direction_y = (span.y_ahead - span.y_back)
+                                 / catenary.length();
+      const double weight = std::hypot(weight_transverse, weight_vertical);
+
+      // the cable pulls the attachment toward the span
+      double reaction = 0;
+      double sign = 1;
+      if (iter->is_ahead == true) {
+        reaction = tension * catenary.SlopeAhead();
+        sign = -1;
+        hardware = span.hardware_ahead;
+      } else {
+        reaction = -tension * catenary.SlopeBack();
+        hardware = span.hardware_back;
+      }
+
+      // the reaction acts in the loaded plane, which swings to the left of
+      // the chord
+      const double reaction_transverse = reaction * weight_transverse
+                                         / weight;
+      force_x += sign * tension * direction_x
+                 - reaction_transverse * direction_y;
+      force_y += sign * tension * direction_y
+                 + reaction_transverse * direction_x;
+      force_vertical += reaction * weight_vertical / weight;
+      wind_x -= direction_y;
+      wind_y += direction_x;
+    }
+
+    // adds the hardware weight and wind
+    if (hardware != nullptr) {
+      force_vertical += hardware->weight;
+
+      const double length_wind = std::hypot(wind_x, wind_y);
+      if (0 < length_wind) {
+        const double force_wind = weathercase.pressure_wind
+                                  * hardware->area_cross_section;
+        force_x += force_wind * wind_x / length_wind;
+        force_y += force_wind * wind_y / length_wind;
+      }
+    }
+
+    // projects onto the structure axes
+    const int index_structure = attachments_[index_attachment].index_structure;
+    const double longitudinal_x = axes[index_structure * 2];
+    const double longitudinal_y = axes[index_structure * 2 + 1];
+    load.longitudinal = force_x * longitudinal_x + force_y * longitudinal_y;
+    load.transverse = -force_x * longitudinal_y + force_y * longitudinal_x;
+    load.vertical = force_vertical;
+  });
+}
+
+int StructureLoadEngine::Export(const std::string& dirpath,
+                                const units::UnitSystem& units) const {
+  double scale = 1;
+  if (units == units::UnitSystem::kImperial) {
+    scale = quantity::FactorBetween(quantity::force::kNewtons,
+                                    quantity::force::kPounds).scale;
+  }
+
+  const int count_weathercases = (int)weathercases_.size();
+  const int count_conditions = (int)conditions_.size();
+
+  // attachments are sorted by structure, so each structure is a range
+  int count_files = 0;
+  int index_begin = 0;
+  while (index_begin < (int)attachments_.size()) {
+    const int index_structure = attachments_[index_begin].index_structure;
+    int index_end = index_begin;
+    while ((index_end < (int)attachments_.size())
+           && (attachments_[index_end].index_structure == index_structure)) {
+      index_end++;
+    }
+
+    const wxFileName filename(
+        dirpath, wxString::Format("structure_%d.csv", index_structure));
+    CsvWriter file;
+    if (file.Open(filename.GetFullPath().ToStdString(), "Structure load")
+        == false) {
+      return -1;
+    }
+
+    file.Append("attachment,weathercase,condition,vertical,transverse,"
+                "longitudinal\n");
+    for (int i = index_begin; i < index_end; i++) {
+      for (int w = 0; w < count_weathercases; w++) {
+        for (int c = 0; c < count_conditions; c++) {
+          const AttachmentLoad& load = Load(i, w, c);
+          if (std::isfinite(load.vertical) == false) {
+            continue;
+          }
+
+          file.Append("%d,\"%s\",%s,%.1f,%.1f,%.1f\n",
+                      attachments_[i].index_attachment,
+                      weathercases_[w]->description.c_str(),
+                      TensionTable::NameCondition(conditions_[c]),
+                      load.vertical * scale, load.transverse * scale,
+                      load.longitudinal * scale);
+        }
+      }
+    }
+
+    if (file.Close() == false) {
+      return -1;
+    }
+
+    count_files++;
+    index_begin = index_end;
+  }
+
+  return count_files;
+}
+
+const AttachmentLoad& StructureLoadEngine::Load(
+    const int& index_attachment, const int& index_weathercase,
+    const int& index_condition) const {
+  const int index =
+      (index_attachment * (int)weathercases_.size() + index_weathercase)
+      * (int)conditions_.size() + index_condition;
+  return loads_[index];
+}
+
+const std::vector<LoadedAttachment>& StructureLoadEngine::attachments()
+    const {
+  return attachments_;
+}
@@ -0,0 +1,420 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "sweep_runner.h"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "models/sagtension/line_cable_reloader.h"
+#include "wx/log.h"
+
+#include "csv_writer.h"
+#include "parallel.h"
+#include "quantity.h"
+#include "span_catenary.h"
+#include "trace.h"
+
+SweepRunner::SweepRunner() {
+}
+
+void SweepRunner::ClearCache() {
+  cache_.clear();
+}
+
+int SweepRunner::CountVariants() const {
+  int count = 1;
+  for (auto iter = parameters_.cbegin(); iter != parameters_.cend();
+       iter++) {
+    count *= (int)iter->values.size();
+  }
+
+  return count;
+}
+
+bool SweepRunner::Export(
+    const std::string& filepath,
+    const std::vector<const WeatherLoadCase*>& weathercases,
+    const units::UnitSystem& units) const {
+  CsvWriter file;
+  if (file.Open(filepath, "Sweep") == false) {
+    return false;
+  }
+
+  double scale_force = 1;
+  double scale_length = 1;
+  if (units == units::UnitSystem::kImperial) {
+    scale_force = quantity::FactorBetween(quantity::force::kNewtons,
+                                          quantity::force::kPounds).scale;
+    scale_length = quantity::FactorBetween(quantity::length::kMeters,
+                                           quantity::length::kFeet).scale;
+  }
+
+  typedef SweepParameter::ParameterType ParameterType;
+
+  // writes a column for every parameter
+  file.Append("variant,");
+  for (auto iter = parameters_.cbegin(); iter != parameters_.cend();
+       iter++) {
+    const char* name = "station";
+    if (iter->type == ParameterType::kConstraintLimit) {
+      name = "limit";
+    } else if (iter->type == ParameterType::kConstraintWeathercase) {
+      name = "weathercase";
+    }
+
+    file.Append("%s_%d,", name, iter->index);
+  }
+  file.Append("tension_max,sag_max,count_failed\n");
+
+  for (int i = 0; i < (int)results_.size(); i++) {
+    file.Append("%d,", i);
+
+    for (int j = 0; j < (int)parameters_.size(); j++) {
+      const SweepParameter& parameter = parameters_[j];
+      const double value = Value(i, j);
+      if (parameter.type == ParameterType::kConstraintLimit) {
+        file.Append("%.1f,", value * scale_force);
+      } else if (parameter.type == ParameterType::kConstraintWeathercase) {
+        file.Append("\"%s\",",
+                    weathercases[(int)value]->description.c_str());
+      } else {
+        file.Append("%.2f,", value * scale_length);
+      }
+    }
+
+    const SweepResult& result = results_[i];
+    file.Append("%.1f,%.3f,%d\n", result.tension_max * scale_force,
+                result.sag_max * scale_length, result.count_failed);
+  }
+
+  return file.Close();
+}
+
+int SweepRunner::Run(const TransmissionLine& line, const AlignmentPath& path,
+                     const RulingSpanCalculator& rulings,
+                     const std::vector<LineSpan>& spans,
+                     const std::vector<const WeatherLoadCase*>& weathercases,
+                     const std::vector<CableConditionType>& conditions) {
+  TRACE_SCOPE("SweepRunner::Run");
+
+  typedef SweepParameter::ParameterType ParameterType;
+
+  std::vector<const LineCable*> line_cables;
+  for (auto iter = line.line_cables()->cbegin();
+       iter != line.line_cables()->cend(); iter++) {
+    line_cables.push_back(&(*iter));
+  }
+
+  std::vector<const LineStructure*> line_structures;
+  for (auto iter = line.line_structures()->cbegin();
+       iter != line.line_structures()->cend(); iter++) {
+    line_structures.push_back(&(*iter));
+  }
+
+  // checks that the parameters reference the line
+  for (auto iter = parameters_.cbegin(); iter != parameters_.cend();
+       iter++) {
+    int count_items = (int)line_cables.size();
+    if (iter->type == ParameterType::kStation) {
+      count_items = (int)line_structures.size();
+    }
+
+    bool is_valid = (0 <= iter->index) && (iter->index < count_items);
+    if (iter->type == ParameterType::kConstraintWeathercase) {
+      for (auto it = iter->values.cbegin(); it != iter->values.cend();
+           it++) {
+        if ((*it < 0) || ((int)weathercases.size() <= (int)*it)) {
+          is_valid = false;
+        }
+      }
+    }
+
+    if (is_valid == false) {
+      wxLogError("Sweep parameter references an invalid line item.");
+      results_.clear();
+      return -1;
+    }
+  }
+
+  const int count_line_cables = (int)line_cables.size();
+  if ((int)rulings.results().size() != count_line_cables) {
+    wxLogError("Sweep ruling spans weren't calculated for the line.");
+    results_.clear();
+    return -1;
+  }
+
+  const int count_variants = CountVariants();
+  const int count_weathercases = (int)weathercases.size();
+  const int count_conditions = (int)conditions.size();
+
+  // gets the ruling spans of every variant
+  // only the variants that move structures copy and update the calculator
+  std::vector<double> spacings_ruling(count_variants * count_line_cables);
+  Parallel::For(count_variants, [&](const int& index, const int& thread) {
+    RulingSpanCalculator rulings_variant;
+    const RulingSpanCalculator* rulings_moved = &rulings;
+    for (int p = 0; p < (int)parameters_.size(); p++) {
+      const SweepParameter& parameter = parameters_[p];
+      if (parameter.type != ParameterType::kStation) {
+        continue;
+      }
+
+      if (rulings_moved == &rulings) {
+        rulings_variant = rulings;
+        rulings_moved = &rulings_variant;
+      }
+
+      LineStructure line_structure = *line_structures[parameter.index];
+      line_structure.set_station(Value(index, p));
+      rulings_variant.UpdateStructure(line, path, parameter.index,
+                                      line_structure);
+    }
+
+    for (int j = 0; j < count_line_cables; j++) {
+      const double spacing_base = rulings.results()[j].spacing_calculated;
+      const double spacing_moved =
+          rulings_moved->results()[j].spacing_calculated;
+
+      double spacing = line_cables[j]->spacing_attachments_ruling_span().x();
+      if ((0 < spacing_base) && (spacing_moved != spacing_base)) {
+        spacing *= spacing_moved / spacing_base;
+      }
+      spacings_ruling[index * count_line_cables + j] = spacing;
+    }
+  });
+
+  // collects the solutions that aren't cached
+  std::vector<SolutionKey> keys;
+  std::vector<CableConstraint> constraints;
+  for (int i = 0; i < count_variants; i++) {
+    for (int j = 0; j < count_line_cables; j++) {
+      CableConstraint constraint = line_cables[j]->constraint();
+      ApplyConstraint(i, j, weathercases, constraint);
+      const double spacing_ruling =
+          spacings_ruling[i * count_line_cables + j];
+
+      for (int w = 0; w < count_weathercases; w++) {
+        for (int c = 0; c < count_conditions; c++) {
+          const SolutionKey key{conditions[c], constraint.limit,
+                                line_cables[j], spacing_ruling,
+                                weathercases[w], constraint.case_weather};
+          if (cache_.find(key) != cache_.cend()) {
+            continue;
+          }
+
+          // a NaN placeholder keeps the key from being collected twice
+          cache_[key] = std::numeric_limits<double>::quiet_NaN();
+          keys.push_back(key);
+          constraints.push_back(constraint);
+        }
+      }
+    }
+  }
+
+  // solves the new solutions
+  // the line cable is copied only to apply the variant constraint and
+  // ruling span
+  const int count_solved = (int)keys.size();
+  std::vector<double> tensions(count_solved,
+                               std::numeric_limits<double>::quiet_NaN());
+  Parallel::For(count_solved, [&](const int& index, const int& thread) {
+    const SolutionKey& key = keys[index];
+    LineCable line_cable = *key.line_cable;
+    line_cable.set_constraint(constraints[index]);
+    if (line_cable.cable() == nullptr) {
+      return;
+    }
+
+    Vector3d spacing = line_cable.spacing_attachments_ruling_span();
+    spacing.set_x(key.spacing_ruling);
+    line_cable.set_spacing_attachments_ruling_span(spacing);
+
+    LineCableReloader reloader;
+    reloader.set_line_cable(&line_cable);
+    reloader.set_weathercase_reloaded(key.weathercase);
+    reloader.set_condition_reloaded(key.condition);
+    if (reloader.Validate(false, nullptr) == false) {
+      return;
+    }
+
+    tensions[index] = reloader.TensionHorizontal();
+  });
+
+  for (int i = 0; i < count_solved; i++) {
+    cache_[keys[i]] = tensions[i];
+  }
+
+  // evaluates the variants
+  // the cache is only read from here, so it is shared by every thread
+  results_.assign(count_variants, SweepResult{0, 0, 0});
+  Parallel::For(count_variants, [&](const int& index, const int& thread) {
+    SweepResult& result = results_[index];
+
+    // gets the tensions of the variant
+    std::vector<double> tensions_variant(
+        count_line_cables * count_weathercases * count_conditions);
+    for (int j = 0; j < count_line_cables; j++) {
+      CableConstraint constraint = line_cables[j]->constraint();
+      ApplyConstraint(index, j, weathercases, constraint);
+      const double spacing_ruling =
+          spacings_ruling[index * count_line_cables + j];
+
+      for (int w = 0; w < count_weathercases; w++) {
+        for (int c = 0; c < count_conditions; c++) {
+          const SolutionKey key{conditions[c], constraint.limit,
+                                line_cables[j], spacing_ruling,
+                                weathercases[w], constraint.case_weather};
+          const double tension = cache_.find(key)->second;
+          tensions_variant[(j * count_weathercases + w) * count_conditions
+                           + c] = tension;
+          if (std::isnan(tension) == true) {
+            result.count_failed++;
+          } else if (result.tension_max < tension) {
+            result.tension_max = tension;
+          }
+        }
+      }
+    }
+
+    // copies the moved line structures
+    std::vector<std::pair<int, LineStructure>> structures_moved;
+    for (int p = 0; p < (int)parameters_.size(); p++) {
+      const SweepParameter& parameter = parameters_[p];
+      if (parameter.type != ParameterType::kStation) {
+        continue;
+      }
+
+      LineStructure line_structure = *line_structures[parameter.index];
+      line_structure.set_station(Value(index, p));
+      structures_moved.push_back(
+          std::make_pair(parameter.index, line_structure));
+    }
+
+    // solves the span sags
+    // spans are only copied if they end at a moved structure
+    SpanCatenary catenary;
+    LineSpan span_moved;
+    for (auto iter = spans.cbegin(); iter != spans.cend(); iter++) {
+      const LineSpan* span = &(*iter);
+      for (auto it = structures_moved.cbegin();
+           it != structures_moved.cend(); it++) {
+        if ((it->first != iter->index_structure_back)
+            && (it->first != iter->index_structure_ahead)) {
+          continue;
+        }
+
+        if (span != &span_moved) {
+          span_moved = *iter;
+          span = &span_moved;
+        }
+
+        if (it->first == iter->index_structure_back) {
+          LineSpanBuilder::PointAttachment(
+              it->second, span_moved.index_attachment_back, path,
+              span_moved.x_back, span_moved.y_back,
+              span_moved.elevation_back, span_moved.hardware_back);
+        } else {
+          LineSpanBuilder::PointAttachment(
+              it->second, span_moved.index_attachment_ahead, path,
+              span_moved.x_ahead, span_moved.y_ahead,
+              span_moved.elevation_ahead, span_moved.hardware_ahead);
+        }
+      }
+
+      const Cable* cable = span->line_cable->cable();
+      if (cable == nullptr) {
+        continue;
+      }
+
+      for (int w = 0; w < count_weathercases; w++) {
+        double weight_transverse = 0;
+        double weight_vertical = 0;
+        LineSpanBuilder::UnitWeight(*cable, *weathercases[w],
+                                    weight_transverse, weight_vertical);
+
+        for (int c = 0; c < count_conditions; c++) {
+          const double tension = tensions_variant[
+              (span->index_line_cable * count_weathercases + w)
+              * count_conditions + c];
+          if (catenary.Set(*span, tension, weight_transverse,
+                           weight_vertical) == false) {
+            continue;
+          }
+
+          const double sag = catenary.Sag(0.5);
+          if (result.sag_max < sag) {
+            result.sag_max = sag;
+          }
+        }
+      }
+    }
+  });
+
+  return count_solved;
+}
+
+double SweepRunner::Value(const int& index_variant,
+                          const int& index_parameter) const {
+  int index = index_variant;
+  for (int i = 0; i < index_parameter; i++) {
+    index /= (int)parameters_[i].values.size();
+  }
+
+  const std::vector<double>& values = parameters_[index_parameter].values;
+  return values[index % (int)values.size()];
+}
+
+int SweepRunner::count_cached() const {
+  return (int)cache_.size();
+}
+
+const std::vector<SweepParameter>& SweepRunner::parameters() const {
+  return parameters_;
+}
+
+const std::vector<SweepResult>& SweepRunner::results() const {
+  return results_;
+}
+
+void SweepRunner::set_parameters(
+    const std::vector<SweepParameter>& parameters) {
+  parameters_ = parameters;
+}
+
+void SweepRunner::ApplyConstraint(
+    const int& index_variant, const int& index_line_cable,
+    const std::vector<const WeatherLoadCase*>& weathercases,
+    CableConstraint& constraint) const {
+  typedef SweepParameter::ParameterType ParameterType;
+
+  for (int i = 0; i < (int)parameters_.size(); i++) {
+    const SweepParameter& parameter = parameters_[i];
+    if (parameter.index != index_line_cable) {
+      continue;
+    }
+
+    if (parameter.type == ParameterType::kConstraintLimit) {
+      constraint.limit = Value(index_variant, i);
+    } else if (parameter.type == ParameterType::kConstraintWeathercase) {
+      constraint.case_weather = weathercases[(int)Value(index_variant, i)];
+    }
+  }
+}
+
+bool SweepRunner::SolutionKey::operator<(const SolutionKey& other) const {
+  if (line_cable != other.line_cable) {
+    return line_cable < other.line_cable;
+  } else if (weathercase != other.weathercase) {
+    return weathercase < other.weathercase;
+  } else if (condition != other.condition) {
+    return condition < other.condition;
+  } else if (limit != other.limit) {
+    return limit < other.limit;
+  } else if (spacing_ruling != other.spacing_ruling) {
+    return spacing_ruling < other.spacing_ruling;
+  } else {
+    return weathercase_constraint < other.weathercase_constraint;
+  }
+}
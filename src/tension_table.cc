@@ -0,0 +1,102 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "tension_table.h"
+
+#include <cmath>
+#include <limits>
+
+#include "parallel.h"
+#include "trace.h"
+
+TensionTable::TensionTable() {
+  count_line_cables_ = 0;
+}
+
+int TensionTable::Build(
+    const TransmissionLine& line,
+    const std::vector<const WeatherLoadCase*>& weathercases,
+    const std::vector<CableConditionType>& conditions) {
+  TRACE_SCOPE("TensionTable::Build");
+
+  conditions_ = conditions;
+  weathercases_ = weathercases;
+
+  std::vector<const LineCable*> line_cables;
+  for (auto iter = line.line_cables()->cbegin();
+       iter != line.line_cables()->cend(); iter++) {
+    line_cables.push_back(&(*iter));
+  }
+  count_line_cables_ = (int)line_cables.size();
+
+  const int count_weathercases = (int)weathercases_.size();
+  const int count_conditions = (int)conditions_.size();
+  const int count_solutions =
+      count_line_cables_ * count_weathercases * count_conditions;
+  tensions_.assign(count_solutions,
+                   std::numeric_limits<double>::quiet_NaN());
+
+  // solves every combination
+  // the reloader caches its solution, so each work item gets its own
+  Parallel::For(count_solutions, [&](const int& index, const int& thread) {
+    const int index_condition = index % count_conditions;
+    const int index_weathercase = (index / count_conditions)
+                                  % count_weathercases;
+    const int index_line_cable = index / count_conditions
+                                 / count_weathercases;
+
+    LineCableReloader reloader;
+    reloader.set_line_cable(line_cables[index_line_cable]);
+    reloader.set_weathercase_reloaded(weathercases_[index_weathercase]);
+    reloader.set_condition_reloaded(conditions_[index_condition]);
+    if (reloader.Validate(false, nullptr) == false) {
+      return;
+    }
+
+    tensions_[index] = reloader.TensionHorizontal();
+  });
+
+  int count_failed = 0;
+  for (auto iter = tensions_.cbegin(); iter != tensions_.cend(); iter++) {
+    if (std::isnan(*iter) == true) {
+      count_failed++;
+    }
+  }
+
+  return count_failed;
+}
+
+const char* TensionTable::NameCondition(
+    const CableConditionType& condition) {
+  if (condition == CableConditionType::kInitial) {
+    return "Initial";
+  } else if (condition == CableConditionType::kCreep) {
+    return "Creep";
+  } else if (condition == CableConditionType::kLoad) {
+    return "Load";
+  } else {
+    return "";
+  }
+}
+
+double TensionTable::Tension(const int& index_line_cable,
+                             const int& index_weathercase,
+                             const int& index_condition) const {
+  const int index =
+      (index_line_cable * (int)weathercases_.size() + index_weathercase)
+      * (int)conditions_.size() + index_condition;
+  return tensions_[index];
+}
+
+const std::vector<CableConditionType>& TensionTable::conditions() const {
+  return conditions_;
+}
+
+int TensionTable::count_line_cables() const {
+  return count_line_cables_;
+}
+
+const std::vector<const WeatherLoadCase*>& TensionTable::weathercases()
+    const {
+  return weathercases_;
+}
@@ -0,0 +1,243 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "terrain_index.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "trace.h"
+
+TerrainIndex::TerrainIndex() {
+  count_columns_ = 0;
+  count_rows_ = 0;
+  offset_min_ = 0;
+  size_cell_ = 1;
+  station_min_ = 0;
+}
+
+void TerrainIndex::Build(std::vector<TerrainPoint>& points,
+                         const double& size_cell) {
+  TRACE_SCOPE("TerrainIndex::Build");
+
+  Clear();
+  if (points.empty() == true) {
+    return;
+  }
+
+  size_cell_ = size_cell;
+
+  // sizes the grid to the point bounds
+  double station_max = points.front().station;
+  double offset_max = points.front().offset;
+  station_min_ = station_max;
+  offset_min_ = offset_max;
+  for (auto iter = points.cbegin(); iter != points.cend(); iter++) {
+    station_min_ = std::min(station_min_, (double)iter->station);
+    station_max = std::max(station_max, (double)iter->station);
+    offset_min_ = std::min(offset_min_, (double)iter->offset);
+    offset_max = std::max(offset_max, (double)iter->offset);
+  }
+  count_columns_ = (int)((station_max - station_min_) / size_cell_) + 1;
+  count_rows_ = (int)((offset_max - offset_min_) / size_cell_) + 1;
+
+  const int count_cells = count_columns_ * count_rows_;
+
+  // sorts the points by cell with a counting sort
+  std::vector<uint32_t> indexes_cell(points.size());
+  cells_.assign(count_cells + 1, 0);
+  for (size_t i = 0; i < points.size(); i++) {
+    const TerrainPoint& point = points[i];
+    const uint32_t index_cell =
+        Column(point.station) * count_rows_ + Row(point.offset);
+    indexes_cell[i] = index_cell;
+    cells_[index_cell + 1]++;
+  }
+
+  for (int i = 0; i < count_cells; i++) {
+    cells_[i + 1] += cells_[i];
+  }
+
+  std::vector<uint32_t> positions(cells_.cbegin(), cells_.cend() - 1);
+  points_.resize(points.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    points_[positions[indexes_cell[i]]++] = points[i];
+  }
+
+  // releases the unsorted points
+  std::vector<TerrainPoint>().swap(points);
+
+  // caches the highest point in each cell
+  highest_.assign(count_cells, 0);
+  for (int index_cell = 0; index_cell < count_cells; index_cell++) {
+    uint32_t index_highest = cells_[index_cell];
+    for (uint32_t i = cells_[index_cell]; i < cells_[index_cell + 1]; i++) {
+      if (points_[index_highest].elevation < points_[i].elevation) {
+        index_highest = i;
+      }
+    }
+    highest_[index_cell] = index_highest;
+  }
+}
+
+void TerrainIndex::Clear() {
+  cells_.clear();
+  count_columns_ = 0;
+  count_rows_ = 0;
+  highest_.clear();
+  points_.clear();
+}
+
+bool TerrainIndex::Highest(const double& station_min,
+                           const double& station_max,
+                           const double& offset_min,
+                           const double& offset_max,
+                           TerrainPoint& point) const {
+  if (points_.empty() == true) {
+    return false;
+  }
+
+  const int column_min = Column(station_min);
+  const int column_max = Column(station_max);
+  const int row_min = Row(offset_min);
+  const int row_max = Row(offset_max);
+
+  bool is_found = false;
+  for (int column = column_min; column <= column_max; column++) {
+    // determines if the column is entirely inside the station range
+    const double station_cell = station_min_ + column * size_cell_;
+    const bool is_inside_column = (station_min <= station_cell)
+        && (station_cell + size_cell_ <= station_max);
+
+    for (int row = row_min; row <= row_max; row++) {
+      const int index_cell = column * count_rows_ + row;
+      if (cells_[index_cell] == cells_[index_cell + 1]) {
+        continue;
+      }
+
+      // uses the cached highest point for cells that are entirely inside
+      const double offset_cell = offset_min_ + row * size_cell_;
+      if ((is_inside_column == true) && (offset_min <= offset_cell)
+          && (offset_cell + size_cell_ <= offset_max)) {
+        const TerrainPoint& highest = points_[highest_[index_cell]];
+        if ((is_found == false) || (point.elevation < highest.elevation)) {
+          point = highest;
+          is_found = true;
+        }
+        continue;
+      }
+
+      for (uint32_t i = cells_[index_cell]; i < cells_[index_cell + 1];
+           i++) {
+        const TerrainPoint& candidate = points_[i];
+        if ((candidate.station < station_min)
+            || (station_max < candidate.station)
+            || (candidate.offset < offset_min)
+            || (offset_max < candidate.offset)) {
+          continue;
+        }
+
+        if ((is_found == false) || (point.elevation < candidate.elevation)) {
+          point = candidate;
+          is_found = true;
+        }
+      }
+    }
+  }
+
+  return is_found;
+}
+
+bool TerrainIndex::Nearest(const double& station, const double& offset,
+                           const double& elevation,
+                           const double& distance_max,
+                           TerrainPoint& point) const {
+  if (points_.empty() == true) {
+    return false;
+  }
+
+  const int column_center = Column(station);
+  const int row_center = Row(offset);
+  const int count_rings = std::max(count_columns_, count_rows_);
+
+  double distance_best_squared = distance_max * distance_max;
+  bool is_found = false;
+  for (int ring = 0; ring <= count_rings; ring++) {
+    // the closest a point in this ring can be in plan
+    const double distance_ring = std::max(ring - 1, 0) * size_cell_;
+    if (distance_best_squared < distance_ring * distance_ring) {
+      break;
+    }
+
+    for (int column = column_center - ring; column <= column_center + ring;
+         column++) {
+      if ((column < 0) || (count_columns_ <= column)) {
+        continue;
+      }
+
+      // only the ring edges are visited
+      const bool is_edge_column = (column == column_center - ring)
+                                  || (column == column_center + ring);
+      const int step = is_edge_column == true ? 1 : 2 * ring;
+      for (int row = row_center - ring; row <= row_center + ring;
+           row += std::max(step, 1)) {
+        if ((row < 0) || (count_rows_ <= row)) {
+          continue;
+        }
+
+        const int index_cell = column * count_rows_ + row;
+        for (uint32_t i = cells_[index_cell]; i < cells_[index_cell + 1];
+             i++) {
+          const TerrainPoint& candidate = points_[i];
+          const double ds = candidate.station - station;
+          const double doff = candidate.offset - offset;
+          const double de = candidate.elevation - elevation;
+          const double distance_squared = ds * ds + doff * doff + de * de;
+          if (distance_squared <= distance_best_squared) {
+            distance_best_squared = distance_squared;
+            point = candidate;
+            is_found = true;
+          }
+        }
+      }
+    }
+  }
+
+  return is_found;
+}
+
+std::vector<TerrainPoint> TerrainIndex::Profile(const double& station_start,
+                                                const double& station_end,
+                                                const double& spacing,
+                                                const double& offset_max)
+    const {
+  std::vector<TerrainPoint> profile;
+  if (spacing <= 0) {
+    return profile;
+  }
+
+  for (double station = station_start; station < station_end;
+       station += spacing) {
+    TerrainPoint point;
+    if (Highest(station, std::min(station + spacing, station_end),
+                -offset_max, offset_max, point) == true) {
+      profile.push_back(point);
+    }
+  }
+
+  return profile;
+}
+
+const std::vector<TerrainPoint>& TerrainIndex::points() const {
+  return points_;
+}
+
+int TerrainIndex::Column(const double& station) const {
+  const int column = (int)std::floor((station - station_min_) / size_cell_);
+  return std::min(std::max(column, 0), count_columns_ - 1);
+}
+
+int TerrainIndex::Row(const double& offset) const {
+  const int row = (int)std::floor((offset - offset_min_) / size_cell_);
+  return std::min(std::max(row, 0), count_rows_ - 1);
+}
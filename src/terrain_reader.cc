@@ -0,0 +1,359 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "terrain_reader.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "wx/filename.h"
+#include "wx/log.h"
+
+#include "mapped_file.h"
+#include "parallel.h"
+#include "trace.h"
+
+namespace {
+
+/// The size of the chunks that the file is split into for parsing.
+const size_t kSizeChunk = 16 * 1024 * 1024;
+
+/// The most values that are parsed for a point.
+const int kCountValuesMax = 4;
+
+/// \brief Gets a power of ten.
+/// \param[in] exponent
+///   The exponent.
+/// \return The power of ten.
+double PowerOfTen(const int& exponent) {
+  static const double kPowers[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+      1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  if ((0 <= exponent) && (exponent <= 22)) {
+    return kPowers[exponent];
+  } else if ((-22 <= exponent) && (exponent < 0)) {
+    return 1 / kPowers[-exponent];
+  } else {
+    return std::pow(10.0, exponent);
+  }
+}
+
+/// \brief Parses a number from a character range.
+/// \param[in,out] pos
+///   The position to start parsing at. It is moved past the number.
+/// \param[in] end
+///   The end of the range.
+/// \param[out] value
+///   The number.
+/// \return If a number was parsed. Leading separators are skipped.
+/// The range isn't null terminated, so the standard library parsing
+/// functions can't be used on the mapped file.
+bool ParseNumber(const char*& pos, const char* end, double& value) {
+  while ((pos < end)
+         && ((*pos == ' ') || (*pos == '\t') || (*pos == ','))) {
+    pos++;
+  }
+
+  const char* start = pos;
+
+  bool is_negative = false;
+  if ((pos < end) && ((*pos == '-') || (*pos == '+'))) {
+    is_negative = *pos == '-';
+    pos++;
+  }
+
+  double mantissa = 0;
+  int count_digits = 0;
+  int exponent = 0;
+  while ((pos < end) && ('0' <= *pos) && (*pos <= '9')) {
+    mantissa = mantissa * 10 + (*pos - '0');
+    count_digits++;
+    pos++;
+  }
+
+  if ((pos < end) && (*pos == '.')) {
+    pos++;
+    while ((pos < end) && ('0' <= *pos) && (*pos <= '9')) {
+      mantissa = mantissa * 10 + (*pos - '0');
+      count_digits++;
+      exponent--;
+      pos++;
+    }
+  }
+
+  if (count_digits == 0) {
+    pos = start;
+    return false;
+  }
+
+  if ((pos < end) && ((*pos == 'e') || (*pos == 'E'))) {
+    const char* pos_exponent = pos + 1;
+    bool is_negative_exponent = false;
+    if ((pos_exponent < end)
+        && ((*pos_exponent == '-') || (*pos_exponent == '+'))) {
+      is_negative_exponent = *pos_exponent == '-';
+      pos_exponent++;
+    }
+
+    int value_exponent = 0;
+    const char* pos_digits = pos_exponent;
+    while ((pos_exponent < end) && ('0' <= *pos_exponent)
+           && (*pos_exponent <= '9')) {
+      value_exponent = value_exponent * 10 + (*pos_exponent - '0');
+      pos_exponent++;
+    }
+
+    if (pos_exponent != pos_digits) {
+      exponent += is_negative_exponent ? -value_exponent : value_exponent;
+      pos = pos_exponent;
+    }
+  }
+
+  value = mantissa * PowerOfTen(exponent);
+  if (is_negative == true) {
+    value = -value;
+  }
+
+  return true;
+}
+
+/// \brief Parses a chunk of an ASCII file.
+/// \param[in] begin
+///   The start of the chunk, which is the start of a line.
+/// \param[in] end
+///   The end of the chunk, which is the end of a line.
+/// \param[in] scale
+///   The factor that converts the file units to the document units.
+/// \param[in] function
+///   The function that is called with the values of each point. The
+///   coordinates are scaled, and the optional fourth value is zero if it
+///   isn't in the file.
+/// \return The number of points that were parsed.
+template<typename Function>
+uint64_t ParseChunkAscii(const char* begin, const char* end,
+                         const double& scale, const Function& function) {
+  uint64_t count = 0;
+  const char* pos = begin;
+  while (pos < end) {
+    double values[kCountValuesMax] = {0, 0, 0, 0};
+    if ((ParseNumber(pos, end, values[0]) == true)
+        && (ParseNumber(pos, end, values[1]) == true)
+        && (ParseNumber(pos, end, values[2]) == true)) {
+      // the fourth value is optional
+      // numbers aren't parsed across line breaks
+      ParseNumber(pos, end, values[3]);
+
+      values[0] *= scale;
+      values[1] *= scale;
+      values[2] *= scale;
+      function(values);
+      count++;
+    }
+
+    // moves to the next line
+    const void* pos_end_line = std::memchr(pos, '\n', end - pos);
+    if (pos_end_line == nullptr) {
+      break;
+    }
+    pos = static_cast<const char*>(pos_end_line) + 1;
+  }
+
+  return count;
+}
+
+/// \brief Parses a chunk of a binary file.
+/// \param[in] begin
+///   The start of the chunk, which is the start of a point.
+/// \param[in] end
+///   The end of the chunk.
+/// \param[in] count_values
+///   The number of values in each point.
+/// \param[in] scale
+///   The factor that converts the file units to the document units.
+/// \param[in] function
+///   The function that is called with the values of each point. The
+///   coordinates are scaled.
+/// \return The number of points that were parsed.
+template<typename Function>
+uint64_t ParseChunkBinary(const char* begin, const char* end,
+                          const int& count_values, const double& scale,
+                          const Function& function) {
+  const size_t size_point = count_values * sizeof(double);
+
+  uint64_t count = 0;
+  for (const char* pos = begin; pos + size_point <= end;
+       pos += size_point) {
+    // the mapped data may not be aligned for doubles
+    double values[kCountValuesMax] = {0, 0, 0, 0};
+    std::memcpy(values, pos, size_point);
+    values[0] *= scale;
+    values[1] *= scale;
+    values[2] *= scale;
+    function(values);
+    count++;
+  }
+
+  return count;
+}
+
+/// \brief Reads a point file.
+/// \param[in] filepath
+///   The file path.
+/// \param[in] units
+///   The length units of the file.
+/// \param[in] count_values_binary
+///   The number of values in each point of a binary file.
+/// \param[out] points
+///   The points that were kept.
+/// \param[out] count_read
+///   The number of points that were read from the file.
+/// \param[in] function
+///   The function that adds a point to a vector, if it is kept. It is
+///   called from multiple threads with a vector per thread.
+/// \return 0 if no errors, -1 if file related errors, or 1 if the file has
+///   no points.
+template<typename Point, typename Function>
+int ReadPoints(const std::string& filepath,
+               const quantity::Unit<quantity::Length>& units,
+               const int& count_values_binary, std::vector<Point>& points,
+               uint64_t& count_read, const Function& function) {
+  points.clear();
+  count_read = 0;
+
+  MappedFile file;
+  if (file.Open(filepath) == false) {
+    return -1;
+  }
+
+  const bool is_binary = wxFileName(filepath).GetExt().Lower() == "bin";
+  const size_t size_point = count_values_binary * sizeof(double);
+  const double scale =
+      quantity::FactorBetween(units, quantity::length::kMeters).scale;
+
+  // splits the file into chunks
+  // ascii chunks end at a line break, and binary chunks end at a point
+  const char* data = file.data();
+  const char* data_end = data + file.size();
+  std::vector<const char*> boundaries;
+  boundaries.push_back(data);
+  while (boundaries.back() < data_end) {
+    const char* boundary = boundaries.back();
+    if (kSizeChunk < (size_t)(data_end - boundary)) {
+      boundary += kSizeChunk;
+      if (is_binary == true) {
+        boundary -= (boundary - data) % size_point;
+      } else {
+        const void* pos_end_line =
+            std::memchr(boundary, '\n', data_end - boundary);
+        if (pos_end_line == nullptr) {
+          boundary = data_end;
+        } else {
+          boundary = static_cast<const char*>(pos_end_line) + 1;
+        }
+      }
+    } else {
+      boundary = data_end;
+    }
+    boundaries.push_back(boundary);
+  }
+
+  // parses the chunks on all cores
+  // each thread keeps its own points, which are merged afterwards
+  const int count_chunks = (int)boundaries.size() - 1;
+  const int count_threads = Parallel::CountThreads();
+  std::vector<std::vector<Point>> points_threads(count_threads);
+  std::vector<uint64_t> counts_chunks(count_chunks, 0);
+  Parallel::For(count_chunks, [&](const int& index, const int& thread) {
+    std::vector<Point>& points_thread = points_threads[thread];
+    auto add = [&function, &points_thread](const double* values) {
+      function(values, points_thread);
+    };
+
+    if (is_binary == true) {
+      counts_chunks[index] = ParseChunkBinary(
+          boundaries[index], boundaries[index + 1], count_values_binary,
+          scale, add);
+    } else {
+      counts_chunks[index] = ParseChunkAscii(
+          boundaries[index], boundaries[index + 1], scale, add);
+    }
+  });
+
+  for (auto iter = counts_chunks.cbegin(); iter != counts_chunks.cend();
+       iter++) {
+    count_read += *iter;
+  }
+
+  size_t count_kept = 0;
+  for (auto iter = points_threads.cbegin(); iter != points_threads.cend();
+       iter++) {
+    count_kept += iter->size();
+  }
+
+  points.reserve(count_kept);
+  for (auto iter = points_threads.begin(); iter != points_threads.end();
+       iter++) {
+    points.insert(points.end(), iter->cbegin(), iter->cend());
+    std::vector<Point>().swap(*iter);
+  }
+
+  if (count_read == 0) {
+    wxLogError("Point file (%s) doesn't contain any points.", filepath);
+    return 1;
+  }
+
+  return 0;
+}
+
+}  // namespace
+
+int TerrainReader::Read(const std::string& filepath,
+                        const quantity::Unit<quantity::Length>& units,
+                        const AlignmentPath& path,
+                        std::vector<TerrainPoint>& points,
+                        uint64_t& count_read) {
+  TRACE_SCOPE("TerrainReader::Read");
+
+  // projects each point and keeps it if it is inside the corridor
+  return ReadPoints(
+      filepath, units, 3, points, count_read,
+      [&path](const double* values, std::vector<TerrainPoint>& kept) {
+        double station = 0;
+        double offset = 0;
+        if (path.Project(values[0], values[1], station, offset) == false) {
+          return;
+        }
+
+        TerrainPoint point;
+        point.elevation = (float)values[2];
+        point.offset = (float)offset;
+        point.station = (float)station;
+        kept.push_back(point);
+      });
+}
+
+int TerrainReader::ReadObstacles(
+    const std::string& filepath,
+    const quantity::Unit<quantity::Length>& units, const AlignmentPath& path,
+    std::vector<ObstaclePoint>& points, uint64_t& count_read) {
+  TRACE_SCOPE("TerrainReader::ReadObstacles");
+
+  // keeps points inside the corridor in plan coordinates
+  return ReadPoints(
+      filepath, units, 4, points, count_read,
+      [&path](const double* values, std::vector<ObstaclePoint>& kept) {
+        double station = 0;
+        double offset = 0;
+        if (path.Project(values[0], values[1], station, offset) == false) {
+          return;
+        }
+
+        ObstaclePoint point;
+        point.classification = (int)values[3];
+        point.x = (float)values[0];
+        point.y = (float)values[1];
+        point.z = (float)values[2];
+        kept.push_back(point);
+      });
+}
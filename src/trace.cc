@@ -0,0 +1,249 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "wx/ffile.h"
+#include "wx/log.h"
+
+namespace {
+
+/// \par OVERVIEW
+///
+/// This struct is a recorded span.
+struct TraceSpan {
+  /// \var name
+  ///   The span name.
+  const char* name;
+
+  /// \var time_start
+  ///   The start time, in microseconds.
+  int64_t time_start;
+
+  /// \var time_end
+  ///   The end time, in microseconds.
+  int64_t time_end;
+};
+
+/// \par OVERVIEW
+///
+/// This struct is a ring buffer of spans that is owned by a single thread.
+///
+/// The mutex is only contended while exporting or clearing, so recording
+/// threads normally acquire it without waiting.
+struct TraceBuffer {
+  /// \var count
+  ///   The total number of spans that have been recorded. This can exceed the
+  ///   buffer capacity, in which case the oldest spans have been overwritten.
+  uint64_t count;
+
+  /// \var id_thread
+  ///   The sequential id of the buffer, which is exported as the thread id.
+  int id_thread;
+
+  /// \var is_free
+  ///   An indicator that tells if the recording thread has exited, so the
+  ///   buffer can be taken by another thread. This is guarded by the buffer
+  ///   list mutex.
+  bool is_free;
+
+  /// \var mutex
+  ///   The mutex that guards the spans and count.
+  std::mutex mutex;
+
+  /// \var spans
+  ///   The spans.
+  std::vector<TraceSpan> spans;
+};
+
+/// The number of spans that each thread buffer can hold.
+const size_t kSizeBuffer = 65536;
+
+/// The trace clock start time.
+const std::chrono::steady_clock::time_point time_origin =
+    std::chrono::steady_clock::now();
+
+/// The buffers that have been created. Buffers are never deleted, so spans
+/// can still be exported after the recording thread exits, and the buffer of
+/// an exited thread is reused by the next thread that records a span. The
+/// list only grows to the largest number of recording threads that are alive
+/// at once.
+std::vector<std::unique_ptr<TraceBuffer>>& Buffers() {
+  static std::vector<std::unique_ptr<TraceBuffer>> buffers;
+  return buffers;
+}
+
+/// The mutex that guards the buffer list.
+std::mutex& BuffersMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+/// \par OVERVIEW
+///
+/// This struct holds the buffer that a thread records into, and frees the
+/// buffer when the thread exits.
+struct TraceBufferLease {
+  /// \brief Destructor.
+  ~TraceBufferLease() {
+    if (buffer != nullptr) {
+      std::lock_guard<std::mutex> lock(BuffersMutex());
+      buffer->is_free = true;
+    }
+  }
+
+  /// \var buffer
+  ///   The buffer, which is a nullptr until the thread records a span.
+  TraceBuffer* buffer = nullptr;
+};
+
+/// \brief Gets the buffer for the calling thread.
+/// \return The buffer for the calling thread.
+/// The first time a thread records a span, it takes the buffer of a thread
+/// that has exited, or creates a buffer if there isn't one. A taken buffer
+/// keeps its spans and id, so threads that don't overlap in time share a
+/// track in the trace.
+TraceBuffer* ThreadBuffer() {
+  thread_local TraceBufferLease lease;
+  if (lease.buffer != nullptr) {
+    return lease.buffer;
+  }
+
+  std::lock_guard<std::mutex> lock(BuffersMutex());
+  for (auto iter = Buffers().begin(); iter != Buffers().end(); iter++) {
+    TraceBuffer* buffer = iter->get();
+    if (buffer->is_free == true) {
+      buffer->is_free = false;
+      lease.buffer = buffer;
+      return buffer;
+    }
+  }
+
+  std::unique_ptr<TraceBuffer> buffer(new TraceBuffer());
+  buffer->count = 0;
+  buffer->id_thread = (int)Buffers().size() + 1;
+  buffer->is_free = false;
+  buffer->spans.resize(kSizeBuffer);
+  lease.buffer = buffer.get();
+  Buffers().push_back(std::move(buffer));
+
+  return lease.buffer;
+}
+
+/// \brief Appends a json-escaped string.
+/// \param[in] str
+///   The string to escape.
+/// \param[out] out
+///   The string to append to.
+void AppendEscaped(const char* str, std::string& out) {
+  for (const char* c = str; *c != '\0'; c++) {
+    if ((*c == '"') || (*c == '\\')) {
+      out += '\\';
+    }
+    out += *c;
+  }
+}
+
+}  // namespace
+
+std::atomic<bool> Tracer::is_enabled_(false);
+
+void Tracer::Clear() {
+  std::lock_guard<std::mutex> lock(BuffersMutex());
+  for (auto iter = Buffers().begin(); iter != Buffers().end(); iter++) {
+    TraceBuffer& buffer = **iter;
+    std::lock_guard<std::mutex> lock_buffer(buffer.mutex);
+    buffer.count = 0;
+  }
+}
+
+bool Tracer::Export(const std::string& filepath) {
+  wxFFile file(filepath, "w");
+  if (file.IsOpened() == false) {
+    wxLogError("Trace file (%s) could not be opened.", filepath);
+    return false;
+  }
+
+  // builds the trace-event json
+  // complete events ("X") carry both the start time and duration
+  std::string str = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool is_first = true;
+  char buffer_number[96];
+
+  std::lock_guard<std::mutex> lock(BuffersMutex());
+  for (auto iter = Buffers().cbegin(); iter != Buffers().cend(); iter++) {
+    TraceBuffer& buffer = **iter;
+    std::lock_guard<std::mutex> lock_buffer(buffer.mutex);
+
+    // determines the oldest span that has not been overwritten
+    uint64_t index_begin = 0;
+    if (kSizeBuffer < buffer.count) {
+      index_begin = buffer.count - kSizeBuffer;
+    }
+
+    for (uint64_t i = index_begin; i < buffer.count; i++) {
+      const TraceSpan& span = buffer.spans[i % kSizeBuffer];
+
+      if (is_first == false) {
+        str += ",";
+      }
+      is_first = false;
+
+      str += "\n{\"name\":\"";
+      AppendEscaped(span.name, str);
+      std::snprintf(buffer_number, sizeof(buffer_number),
+                    "\",\"cat\":\"lineanalyzer\",\"ph\":\"X\",\"pid\":1,"
+                    "\"tid\":%d,\"ts\":%lld,\"dur\":%lld}",
+                    buffer.id_thread, (long long)span.time_start,
+                    (long long)(span.time_end - span.time_start));
+      str += buffer_number;
+    }
+  }
+
+  str += "\n]}\n";
+
+  if (file.Write(str.c_str(), str.size()) != str.size()) {
+    wxLogError("Trace file (%s) could not be written.", filepath);
+    return false;
+  }
+
+  return file.Close();
+}
+
+void Tracer::Record(const char* name, const int64_t& time_start,
+                    const int64_t& time_end) {
+  TraceBuffer* buffer = ThreadBuffer();
+
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  TraceSpan& span = buffer->spans[buffer->count % kSizeBuffer];
+  span.name = name;
+  span.time_start = time_start;
+  span.time_end = time_end;
+  buffer->count++;
+}
+
+size_t Tracer::SizeBuffers() {
+  std::lock_guard<std::mutex> lock(BuffersMutex());
+  return Buffers().size() * (sizeof(TraceBuffer)
+                             + kSizeBuffer * sizeof(TraceSpan));
+}
+
+void Tracer::Start() {
+  is_enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::Stop() {
+  is_enabled_.store(false, std::memory_order_relaxed);
+}
+
+int64_t Tracer::TimeNow() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - time_origin).count();
+}
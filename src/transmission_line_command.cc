@@ -6,7 +6,41 @@
 #include "appcommon/xml/transmission_line_xml_handler.h"
 #include "wx/wx.h"
 
-#include "line_analyzer_app.h"
+#include "trace.h"
+
+namespace {
+
+/// \brief Appends a line change to the document journal.
+/// \param[in] doc
+///   The document.
+/// \param[in] type
+///   The record type.
+/// \param[in] index
+///   The line index.
+/// \param[in] index_to
+///   The line index to move to.
+/// \param[in] node
+///   The transmission line xml node, or a nullptr if not needed.
+void AppendJournal(LineAnalyzerDoc* doc, const JournalRecordType& type,
+                   const int& index, const int& index_to,
+                   const wxXmlNode* node) {
+  // skips creating the record if it won't be written
+  if (doc->IsJournaling() == false) {
+    return;
+  }
+
+  JournalRecord record;
+  record.type = type;
+  record.index = index;
+  record.index_to = index_to;
+  if (node != nullptr) {
+    record.xml = CommandJournal::WriteXml(node);
+  }
+
+  doc->AppendJournal(record);
+}
+
+}  // namespace
 
 // These are the string definitions for the various command types.
 const std::string TransmissionLineCommand::kNameActivate = "Activate Line";
@@ -16,8 +50,10 @@ const std::string TransmissionLineCommand::kNameModify = "Modify Line";
 const std::string TransmissionLineCommand::kNameMoveDown = "Move Line Down";
 const std::string TransmissionLineCommand::kNameMoveUp = "Move Line Up";
 
-TransmissionLineCommand::TransmissionLineCommand(const std::string& name) {
-  doc_ = wxGetApp().GetDocument();
+TransmissionLineCommand::TransmissionLineCommand(const std::string& name,
+                                                 LineAnalyzerDoc* doc)
+    : wxCommand(true, name) {
+  doc_ = doc;
   index_ = -1;
   node_do_ = nullptr;
   node_undo_ = nullptr;
@@ -30,12 +66,14 @@ TransmissionLineCommand::~TransmissionLineCommand() {
 
 wxXmlNode* TransmissionLineCommand::CreateTransmissionLineXmlNode(
     const TransmissionLine& line) {
-  units::UnitSystem units = wxGetApp().config()->units;
-
-  return TransmissionLineXmlHandler::CreateNode(line, "", units);;
+  // the node is only used within the document, so values aren't converted
+  return TransmissionLineXmlHandler::CreateNode(line, "",
+                                                LineAnalyzerDoc::kUnitSystem);
 }
 
 bool TransmissionLineCommand::Do() {
+  TRACE_SCOPE("TransmissionLineCommand::Do");
+
   bool status = false;
 
   // selects based on command name
@@ -44,6 +82,8 @@ bool TransmissionLineCommand::Do() {
     status = DoActivate();
   } else if (name == kNameDelete) {
     // saves the document state of the transmission lines
+    // a node from a previous do (before an undo/redo) is replaced
+    delete node_undo_;
     node_undo_ = doc_->SaveTransmissionLineToXml();
 
     status = DoDelete();
@@ -80,6 +120,8 @@ bool TransmissionLineCommand::Do() {
 }
 
 bool TransmissionLineCommand::Undo() {
+  TRACE_SCOPE("TransmissionLineCommand::Undo");
+
   bool status = false;
 
   // selects based on command name
@@ -121,6 +163,10 @@ const wxXmlNode* TransmissionLineCommand::node_transmission_line() const {
   return node_do_;
 }
 
+const wxXmlNode* TransmissionLineCommand::node_undo() const {
+  return node_undo_;
+}
+
 void TransmissionLineCommand::set_index(const int& index) {
   index_ = index;
 }
@@ -132,7 +178,7 @@ void TransmissionLineCommand::set_node_transmission_line(
 
 bool TransmissionLineCommand::DoActivate() {
   // checks index
-  if (doc_->IsValidIndex(index_, doc_->lines().size(), false) == false) {
+  if (doc_->IsValidIndex(index_, doc_->count_lines(), false) == false) {
     wxLogError("Invalid index. Aborting activate command.");
     return false;
   }
@@ -142,6 +188,7 @@ bool TransmissionLineCommand::DoActivate() {
 
   // activates the line
   doc_->set_index_active(index_);
+  AppendJournal(doc_, JournalRecordType::kLineActivate, index_, -1, nullptr);
 
   // saves the old index
   index_ = index;
@@ -151,18 +198,23 @@ bool TransmissionLineCommand::DoActivate() {
 
 bool TransmissionLineCommand::DoDelete() {
   // checks index
-  if (doc_->IsValidIndex(index_, doc_->lines().size(), false) == false) {
+  if (doc_->IsValidIndex(index_, doc_->count_lines(), false) == false) {
     wxLogError("Invalid index. Aborting delete command.");
     return false;
   }
 
   // deletes from document
-  return doc_->DeleteTransmissionLine(index_);
+  const bool status = doc_->DeleteTransmissionLine(index_);
+  if (status == true) {
+    AppendJournal(doc_, JournalRecordType::kLineDelete, index_, -1, nullptr);
+  }
+
+  return status;
 }
 
 bool TransmissionLineCommand::DoInsert(const wxXmlNode* node) {
   // checks index
-  if (doc_->IsValidIndex(index_, doc_->lines().size(), true) == false) {
+  if (doc_->IsValidIndex(index_, doc_->count_lines(), true) == false) {
     wxLogError("Invalid index. Aborting insert command.");
     return false;
   }
@@ -172,14 +224,19 @@ bool TransmissionLineCommand::DoInsert(const wxXmlNode* node) {
   bool status = doc_->CreateTransmissionLineFromXml(node, line);
   if (status == false) {
     return false;
-  } else {
-    return doc_->InsertTransmissionLine(index_, line);
   }
+
+  status = doc_->InsertTransmissionLine(index_, line);
+  if (status == true) {
+    AppendJournal(doc_, JournalRecordType::kLineInsert, index_, -1, node);
+  }
+
+  return status;
 }
 
 bool TransmissionLineCommand::DoModify(const wxXmlNode* node) {
   // checks index
-  if (doc_->IsValidIndex(index_, doc_->lines().size(), true) == false) {
+  if (doc_->IsValidIndex(index_, doc_->count_lines(), true) == false) {
     wxLogError("Invalid index. Aborting modify command.");
     return false;
   }
@@ -188,14 +245,19 @@ bool TransmissionLineCommand::DoModify(const wxXmlNode* node) {
   bool status = doc_->CreateTransmissionLineFromXml(node, line);
   if (status == false) {
     return false;
-  } else {
-    return doc_->ModifyTransmissionLine(line);
   }
+
+  status = doc_->ModifyTransmissionLine(line);
+  if (status == true) {
+    AppendJournal(doc_, JournalRecordType::kLineModify, -1, -1, node);
+  }
+
+  return status;
 }
 
 bool TransmissionLineCommand::DoMoveDown() {
   // checks index, and checks against the last valid index
-  const int kSize = doc_->lines().size();
+  const int kSize = doc_->count_lines();
   if ((doc_->IsValidIndex(index_, kSize, false) == false)
       || (index_ == kSize - 1)) {
     wxLogError("Invalid index. Aborting move down command.");
@@ -203,17 +265,29 @@ bool TransmissionLineCommand::DoMoveDown() {
   }
 
   // swaps within the document
-  return doc_->MoveTransmissionLine(index_, index_ + 2);
+  const bool status = doc_->MoveTransmissionLine(index_, index_ + 2);
+  if (status == true) {
+    AppendJournal(doc_, JournalRecordType::kLineMove, index_, index_ + 2,
+                  nullptr);
+  }
+
+  return status;
 }
 
 bool TransmissionLineCommand::DoMoveUp() {
   // checks index, and checks against the first valid index
-  if ((doc_->IsValidIndex(index_, doc_->lines().size(), false) == false)
+  if ((doc_->IsValidIndex(index_, doc_->count_lines(), false) == false)
       || (index_ == 0)) {
     wxLogError("Invalid index. Aborting move down command.");
     return false;
   }
 
   // swaps the within the document
-  return doc_->MoveTransmissionLine(index_, index_ - 1);
+  const bool status = doc_->MoveTransmissionLine(index_, index_ - 1);
+  if (status == true) {
+    AppendJournal(doc_, JournalRecordType::kLineMove, index_, index_ - 1,
+                  nullptr);
+  }
+
+  return status;
 }
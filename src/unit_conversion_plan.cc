@@ -0,0 +1,100 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "unit_conversion_plan.h"
+
+namespace {
+
+// weathercase factors from imperial to metric consistent units
+// these are folded by the compiler
+constexpr quantity::Factor kFactorDensity = quantity::FactorBetween(
+    quantity::density::kPoundsPerCubicFoot,
+    quantity::density::kNewtonsPerCubicMeter);
+constexpr quantity::Factor kFactorLength = quantity::FactorBetween(
+    quantity::length::kFeet, quantity::length::kMeters);
+constexpr quantity::Factor kFactorPressure = quantity::FactorBetween(
+    quantity::pressure::kPoundsPerSquareFoot, quantity::pressure::kPascals);
+constexpr quantity::Factor kFactorTemperature = quantity::FactorBetween(
+    quantity::temperature::kFahrenheit, quantity::temperature::kCelsius);
+
+}  // namespace
+
+UnitConversionPlan::UnitConversionPlan() {
+}
+
+void UnitConversionPlan::AddWeathercases(
+    const units::UnitSystem& system_from,
+    const units::UnitSystem& system_to,
+    std::list<WeatherLoadCase>& weathercases) {
+  if ((system_from == system_to) || (weathercases.empty() == true)) {
+    return;
+  }
+
+  // reserves the groups so the references below aren't invalidated when a
+  // group is added
+  groups_.reserve(groups_.size() + 4);
+
+  // selects the direction of the factors
+  const bool is_metric = (system_to == units::UnitSystem::kMetric);
+  std::vector<double*>& density = Group(
+      is_metric ? kFactorDensity : quantity::Inverse(kFactorDensity));
+  std::vector<double*>& length = Group(
+      is_metric ? kFactorLength : quantity::Inverse(kFactorLength));
+  std::vector<double*>& pressure = Group(
+      is_metric ? kFactorPressure : quantity::Inverse(kFactorPressure));
+  std::vector<double*>& temperature = Group(
+      is_metric ? kFactorTemperature : quantity::Inverse(kFactorTemperature));
+
+  for (auto iter = weathercases.begin(); iter != weathercases.end(); iter++) {
+    WeatherLoadCase& weathercase = *iter;
+    density.push_back(&weathercase.density_ice);
+    length.push_back(&weathercase.thickness_ice);
+    pressure.push_back(&weathercase.pressure_wind);
+    temperature.push_back(&weathercase.temperature_cable);
+  }
+}
+
+void UnitConversionPlan::Clear() {
+  groups_.clear();
+}
+
+void UnitConversionPlan::Execute() const {
+  for (auto iter = groups_.cbegin(); iter != groups_.cend(); iter++) {
+    const FactorGroup& group = *iter;
+    const double scale = group.factor.scale;
+    const double offset = group.factor.offset;
+
+    double* const* values = group.values.data();
+    const size_t size = group.values.size();
+    for (size_t i = 0; i < size; i++) {
+      *values[i] = *values[i] * scale + offset;
+    }
+  }
+}
+
+size_t UnitConversionPlan::Size() const {
+  size_t size = 0;
+  for (auto iter = groups_.cbegin(); iter != groups_.cend(); iter++) {
+    size += iter->values.size();
+  }
+
+  return size;
+}
+
+std::vector<double*>& UnitConversionPlan::Group(
+    const quantity::Factor& factor) {
+  // searches for a group with a matching factor
+  // plans only have a few distinct factors, so a linear search is used
+  for (auto iter = groups_.begin(); iter != groups_.end(); iter++) {
+    FactorGroup& group = *iter;
+    if ((group.factor.scale == factor.scale)
+        && (group.factor.offset == factor.offset)) {
+      return group.values;
+    }
+  }
+
+  FactorGroup group;
+  group.factor = factor;
+  groups_.push_back(group);
+  return groups_.back().values;
+}
@@ -0,0 +1,206 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "weather_series_evaluator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "models/sagtension/line_cable_reloader.h"
+#include "wx/log.h"
+
+#include "csv_writer.h"
+#include "line_span.h"
+#include "parallel.h"
+#include "quantity.h"
+#include "tension_table.h"
+#include "trace.h"
+
+namespace {
+
+/// The number of rows that are evaluated together.
+const int kCountRowsBlock = 4096;
+
+/// The weight density of glaze ice, in the document units.
+constexpr double kDensityIce = quantity::Quantity<quantity::Density>(
+    57, quantity::density::kPoundsPerCubicFoot).In(
+        quantity::density::kNewtonsPerCubicMeter);
+
+/// \brief Determines if a weather row sorts before another.
+/// \param[in] a
+///   The first row.
+/// \param[in] b
+///   The second row.
+/// \return If the first row sorts before the second.
+bool IsLessWeather(const WeatherSeriesRow& a, const WeatherSeriesRow& b) {
+  if (a.temperature != b.temperature) {
+    return a.temperature < b.temperature;
+  } else if (a.pressure_wind != b.pressure_wind) {
+    return a.pressure_wind < b.pressure_wind;
+  } else {
+    return a.thickness_ice < b.thickness_ice;
+  }
+}
+
+}  // namespace
+
+int WeatherSeriesEvaluator::Evaluate(
+    const TransmissionLine& line,
+    const std::vector<CableConditionType>& conditions,
+    WeatherSeriesReader& reader,
+    const std::string& filepath,
+    const units::UnitSystem& units,
+    uint64_t& count_rows) {
+  TRACE_SCOPE("WeatherSeriesEvaluator::Evaluate");
+
+  count_rows = 0;
+
+  std::vector<const LineCable*> line_cables;
+  for (auto iter = line.line_cables()->cbegin();
+       iter != line.line_cables()->cend(); iter++) {
+    line_cables.push_back(&(*iter));
+  }
+
+  const int count_line_cables = (int)line_cables.size();
+  const int count_conditions = (int)conditions.size();
+  const int count_columns = count_line_cables * count_conditions;
+
+  double scale_force = 1;
+  double scale_length = 1;
+  if (units == units::UnitSystem::kImperial) {
+    scale_force = quantity::FactorBetween(quantity::force::kNewtons,
+                                          quantity::force::kPounds).scale;
+    scale_length = quantity::FactorBetween(quantity::length::kMeters,
+                                           quantity::length::kFeet).scale;
+  }
+
+  CsvWriter file;
+  if (file.Open(filepath, "Weather series") == false) {
+    return -1;
+  }
+
+  file.Append("time");
+  for (int i = 0; i < count_line_cables; i++) {
+    for (int j = 0; j < count_conditions; j++) {
+      const char* name = TensionTable::NameCondition(conditions[j]);
+      file.Append(",tension_%d_%s,sag_%d_%s", i, name, i, name);
+    }
+  }
+  file.Append("\n");
+
+  std::vector<WeatherSeriesRow> rows;
+  std::vector<int> indexes_sorted;
+  std::vector<int> indexes_state(kCountRowsBlock);
+  std::vector<WeatherLoadCase> states;
+  std::vector<double> tensions;
+  std::vector<double> weights;
+  std::vector<double> sags;
+
+  while (true) {
+    const int count = reader.Read(kCountRowsBlock, rows);
+    if (count == 0) {
+      break;
+    }
+
+    // reduces the rows to unique weather states
+    indexes_sorted.resize(count);
+    std::iota(indexes_sorted.begin(), indexes_sorted.end(), 0);
+    std::sort(indexes_sorted.begin(), indexes_sorted.end(),
+              [&](const int& a, const int& b) {
+      return IsLessWeather(rows[a], rows[b]);
+    });
+
+    states.clear();
+    for (int i = 0; i < count; i++) {
+      const WeatherSeriesRow& row = rows[indexes_sorted[i]];
+      if ((i == 0) || (IsLessWeather(rows[indexes_sorted[i - 1]], row)
+                       == true)) {
+        WeatherLoadCase state;
+        state.density_ice = kDensityIce;
+        state.pressure_wind = row.pressure_wind;
+        state.temperature_cable = row.temperature;
+        state.thickness_ice = row.thickness_ice;
+        states.push_back(state);
+      }
+      indexes_state[indexes_sorted[i]] = (int)states.size() - 1;
+    }
+
+    // solves every state, line cable, and condition
+    // the reloader caches its solution, so each work item gets its own
+    const int count_solutions = (int)states.size() * count_columns;
+    tensions.assign(count_solutions,
+                    std::numeric_limits<double>::quiet_NaN());
+    weights.assign(count_solutions, 0);
+    Parallel::For(count_solutions, [&](const int& index, const int& thread) {
+      const int index_condition = index % count_conditions;
+      const int index_line_cable = (index / count_conditions)
+                                   % count_line_cables;
+      const int index_state = index / count_columns;
+
+      const LineCable* line_cable = line_cables[index_line_cable];
+      if (line_cable->cable() == nullptr) {
+        return;
+      }
+
+      LineCableReloader reloader;
+      reloader.set_line_cable(line_cable);
+      reloader.set_weathercase_reloaded(&states[index_state]);
+      reloader.set_condition_reloaded(conditions[index_condition]);
+      if (reloader.Validate(false, nullptr) == false) {
+        return;
+      }
+
+      double weight_transverse = 0;
+      double weight_vertical = 0;
+      LineSpanBuilder::UnitWeight(*line_cable->cable(), states[index_state],
+                                  weight_transverse, weight_vertical);
+      tensions[index] = reloader.TensionHorizontal();
+      weights[index] = std::hypot(weight_transverse, weight_vertical);
+    });
+
+    // calculates the ruling span sags in one pass over the block
+    sags.resize(count_solutions);
+    for (int i = 0; i < count_solutions; i++) {
+      const LineCable* line_cable =
+          line_cables[(i / count_conditions) % count_line_cables];
+      const double ruling = line_cable->spacing_attachments_ruling_span().x();
+      const double constant = tensions[i] / weights[i];
+      sags[i] = constant * (std::cosh(ruling / (2 * constant)) - 1);
+    }
+
+    // writes the block
+    for (int i = 0; i < count; i++) {
+      file.Append("%s", rows[i].time.c_str());
+      const int index_begin = indexes_state[i] * count_columns;
+      for (int j = index_begin; j < index_begin + count_columns; j++) {
+        if ((std::isfinite(tensions[j]) == false)
+            || (std::isfinite(sags[j]) == false)) {
+          file.Append(",,");
+          continue;
+        }
+        file.Append(",%.1f,%.3f", tensions[j] * scale_force,
+                    sags[j] * scale_length);
+      }
+      file.Append("\n");
+    }
+
+    if (file.Flush() == false) {
+      return -1;
+    }
+
+    count_rows += count;
+  }
+
+  if (file.Close() == false) {
+    return -1;
+  }
+
+  if (count_rows == 0) {
+    wxLogError("Weather series doesn't contain any rows.");
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,158 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "weather_series_reader.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+/// The longest line that is parsed.
+const size_t kSizeLineMax = 256;
+
+/// \brief Parses a number field.
+/// \param[in,out] pos
+///   The position to start parsing at. It is moved past the field separator.
+/// \param[out] value
+///   The number.
+/// \return If a number was parsed.
+bool ParseField(const char*& pos, double& value) {
+  char* end = nullptr;
+  value = std::strtod(pos, &end);
+  if (end == pos) {
+    return false;
+  }
+
+  pos = end;
+  while ((*pos == ' ') || (*pos == '\t')) {
+    pos++;
+  }
+  if (*pos == ',') {
+    pos++;
+  }
+  return true;
+}
+
+/// \brief Parses a line.
+/// \param[in] line
+///   The null terminated line.
+/// \param[out] row
+///   The row, in the file units.
+/// \return If the line was parsed.
+bool ParseLine(const char* line, WeatherSeriesRow& row) {
+  const char* separator = std::strchr(line, ',');
+  if (separator == nullptr) {
+    return false;
+  }
+
+  // the time stamp is trimmed of whitespace and quotes
+  const char* begin = line;
+  const char* end = separator;
+  while ((begin < end) && ((*begin == ' ') || (*begin == '"'))) {
+    begin++;
+  }
+  while ((begin < end) && ((*(end - 1) == ' ') || (*(end - 1) == '"'))) {
+    end--;
+  }
+  row.time.assign(begin, end);
+
+  const char* pos = separator + 1;
+  return (ParseField(pos, row.temperature) == true)
+      && (ParseField(pos, row.pressure_wind) == true)
+      && (ParseField(pos, row.thickness_ice) == true);
+}
+
+}  // namespace
+
+WeatherSeriesReader::WeatherSeriesReader() {
+  count_skipped_ = 0;
+  factor_length_ = quantity::Factor{1, 0};
+  factor_pressure_ = quantity::Factor{1, 0};
+  factor_temperature_ = quantity::Factor{1, 0};
+  position_ = 0;
+}
+
+void WeatherSeriesReader::Close() {
+  file_.Close();
+  position_ = 0;
+}
+
+bool WeatherSeriesReader::Open(const std::string& filepath,
+                               const units::UnitSystem& units) {
+  Close();
+  count_skipped_ = 0;
+
+  if (units == units::UnitSystem::kImperial) {
+    factor_length_ = quantity::FactorBetween(quantity::length::kInches,
+                                             quantity::length::kMeters);
+    factor_pressure_ = quantity::FactorBetween(
+        quantity::pressure::kPoundsPerSquareFoot,
+        quantity::pressure::kPascals);
+    factor_temperature_ = quantity::FactorBetween(
+        quantity::temperature::kFahrenheit,
+        quantity::temperature::kCelsius);
+  } else {
+    factor_length_ = quantity::FactorBetween(quantity::length::kCentimeters,
+                                             quantity::length::kMeters);
+    factor_pressure_ = quantity::Factor{1, 0};
+    factor_temperature_ = quantity::Factor{1, 0};
+  }
+
+  return file_.Open(filepath);
+}
+
+int WeatherSeriesReader::Read(const int& count_max,
+                              std::vector<WeatherSeriesRow>& rows) {
+  if ((int)rows.size() < count_max) {
+    rows.resize(count_max);
+  }
+
+  const char* data = file_.data();
+  const size_t size = file_.size();
+  char line[kSizeLineMax];
+
+  int count = 0;
+  while ((count < count_max) && (position_ < size)) {
+    // finds the end of the line
+    const char* begin = data + position_;
+    const void* pos_end = std::memchr(begin, '\n', size - position_);
+    const char* end = pos_end == nullptr ? data + size : (const char*)pos_end;
+    position_ = end - data + 1;
+
+    // copies the line so it can be parsed as a null terminated string
+    const size_t size_line = end - begin;
+    if (kSizeLineMax <= size_line) {
+      count_skipped_++;
+      continue;
+    }
+    std::memcpy(line, begin, size_line);
+    line[size_line] = '\0';
+
+    // skips blank lines silently
+    if (std::strspn(line, " \t\r") == size_line) {
+      continue;
+    }
+
+    WeatherSeriesRow& row = rows[count];
+    if (ParseLine(line, row) == false) {
+      count_skipped_++;
+      continue;
+    }
+
+    row.pressure_wind = row.pressure_wind * factor_pressure_.scale
+                        + factor_pressure_.offset;
+    row.temperature = row.temperature * factor_temperature_.scale
+                      + factor_temperature_.offset;
+    row.thickness_ice = row.thickness_ice * factor_length_.scale
+                        + factor_length_.offset;
+    count++;
+  }
+
+  rows.resize(count);
+  return count;
+}
+
+uint64_t WeatherSeriesReader::count_skipped() const {
+  return count_skipped_;
+}
@@ -0,0 +1,59 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <http://unlicense.org/>
+
+#include "xrc_loader.h"
+
+#include "wx/xrc/xh_bttn.h"
+#include "wx/xrc/xh_dlg.h"
+#include "wx/xrc/xh_menu.h"
+#include "wx/xrc/xh_panel.h"
+#include "wx/xrc/xh_radbx.h"
+#include "wx/xrc/xh_sizer.h"
+#include "wx/xrc/xmlres.h"
+
+#include "trace.h"
+
+/// These functions load the xrc files that are processed by the wxWidgets
+/// resource compiler. Each xrc file is compiled into a separate function so
+/// that resources can be loaded independently. They are declared in external
+/// files so this file doesn't have to be recompiled every time the resources
+/// are updated.
+extern void InitXmlResourceMenuBar();
+extern void InitXmlResourcePreferencesDialog();
+
+void XrcLoader::LoadMenuBar() {
+  static bool is_loaded = false;
+  if (is_loaded == true) {
+    return;
+  }
+
+  TRACE_SCOPE("XrcLoader::LoadMenuBar");
+
+  // registers handlers for the menubar controls
+  wxXmlResource* resource = wxXmlResource::Get();
+  resource->AddHandler(new wxMenuBarXmlHandler);
+  resource->AddHandler(new wxMenuXmlHandler);
+
+  InitXmlResourceMenuBar();
+  is_loaded = true;
+}
+
+void XrcLoader::LoadPreferencesDialog() {
+  static bool is_loaded = false;
+  if (is_loaded == true) {
+    return;
+  }
+
+  TRACE_SCOPE("XrcLoader::LoadPreferencesDialog");
+
+  // registers handlers for the dialog controls
+  wxXmlResource* resource = wxXmlResource::Get();
+  resource->AddHandler(new wxDialogXmlHandler);
+  resource->AddHandler(new wxPanelXmlHandler);
+  resource->AddHandler(new wxButtonXmlHandler);
+  resource->AddHandler(new wxRadioBoxXmlHandler);
+  resource->AddHandler(new wxSizerXmlHandler);
+
+  InitXmlResourcePreferencesDialog();
+  is_loaded = true;
+}